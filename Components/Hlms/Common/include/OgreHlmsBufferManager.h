@@ -119,6 +119,27 @@ namespace Ogre
         /// have many skeletally animated meshes with lots of bones.
         size_t mTextureBufferDefaultSize;
 
+        struct DeferredWorldMatrix
+        {
+            Matrix4 const   *worldMat;
+            float           *texBufferPtr;
+        };
+        typedef FastArray<DeferredWorldMatrix> DeferredWorldMatrixArray;
+
+        /// World matrices whose region in the tex. buffer has already been reserved
+        /// (and whose commands have already been issued) but haven't been written yet.
+        /// @see flushDeferredWorldMatrices
+        DeferredWorldMatrixArray mDeferredWorldMatrices;
+        /// Whose worker threads write mDeferredWorldMatrices. Set on every pass.
+        SceneManager            *mSceneManager;
+        bool                    mParallelFill;
+
+        /// Writes all the entries in mDeferredWorldMatrices, splitting them in
+        /// contiguous ranges across the SceneManager's worker threads if mParallelFill
+        /// is set and it's worth it.
+        /// Must be called before the tex. buffer they point to gets unmapped.
+        void flushDeferredWorldMatrices(void);
+
         /// For compatibility reasons with D3D11 and GLES3, Const buffers are mapped.
         /// Once we're done with it (even if we didn't fully use it) we discard it
         /// and get a new one. We will at least have to get a new one on every pass.
@@ -180,6 +201,24 @@ namespace Ogre
         /// Changes the default suggested size for the texture buffer.
         /// Actual size may be lower if the GPU can't honour the request.
         void setTextureBufferDefaultSize( size_t defaultSize );
+
+        /** Implementations that overload _fillDeferredWorldMatrices only reserve the
+            space for the world matrices of each renderable in fillBuffersFor; the
+            matrices themselves are computed and written in batches right before the
+            texture buffer gets unmapped.
+            When enabled, those batches are split across the SceneManager's worker threads.
+        @remarks
+            The command buffer is still built in order by the main thread.
+            Worth enabling with large amounts of draws (i.e. several thousands).
+        */
+        void setParallelFill( bool bEnable );
+        bool getParallelFill(void) const                    { return mParallelFill; }
+
+        /** Writes the entries in range [start; end) of the deferred world matrices.
+            Called from the worker threads (or from the main thread if there's too
+            little work to be worth splitting).
+        */
+        virtual void _fillDeferredWorldMatrices( size_t start, size_t end ) {}
     };
 
     /** @} */
@@ -30,6 +30,8 @@ THE SOFTWARE.
 
 #include "OgreHlmsBufferManager.h"
 #include "OgreRenderSystem.h"
+#include "OgreSceneManager.h"
+#include "Threading/OgreChunkedTask.h"
 
 #include "Vao/OgreVaoManager.h"
 #include "Vao/OgreConstBufferPacked.h"
@@ -40,6 +42,30 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    /// Don't bother waking up the worker threads for less than this amount of entries per chunk.
+    static const size_t c_minDeferredWorldMatricesPerChunk = 64;
+
+    /// Splits HlmsBufferManager's deferred world matrices in contiguous ranges.
+    class DeferredWorldMatricesTask : public ChunkedTask
+    {
+        HlmsBufferManager   *mHlms;
+        size_t              mNumEntries;
+        size_t              mNumChunks;
+
+    public:
+        DeferredWorldMatricesTask( HlmsBufferManager *hlms, size_t numEntries, size_t numChunks ) :
+            mHlms( hlms ), mNumEntries( numEntries ), mNumChunks( numChunks ) {}
+
+        virtual size_t getNumChunks(void) const     { return mNumChunks; }
+
+        virtual void executeChunk( size_t chunkIdx, size_t threadId )
+        {
+            const size_t start  = (mNumEntries * chunkIdx) / mNumChunks;
+            const size_t end    = (mNumEntries * (chunkIdx + 1u)) / mNumChunks;
+            mHlms->_fillDeferredWorldMatrices( start, end );
+        }
+    };
+    //-----------------------------------------------------------------------------------
     HlmsBufferManager::HlmsBufferManager( HlmsTypes type, const String &typeName, Archive *dataFolder,
                                           ArchiveVec *libraryFolders ) :
         Hlms( type, typeName, dataFolder, libraryFolders ),
@@ -55,7 +81,9 @@ namespace Ogre
         mCurrentTexBufferSize( 0 ),
         mTexLastOffset( 0 ),
         mLastTexBufferCmdOffset( (size_t)~0 ),
-        mTextureBufferDefaultSize( 4 * 1024 * 1024 )
+        mTextureBufferDefaultSize( 4 * 1024 * 1024 ),
+        mSceneManager( 0 ),
+        mParallelFill( false )
     {
     }
     //-----------------------------------------------------------------------------------
@@ -83,6 +111,8 @@ namespace Ogre
     {
         HlmsCache retVal = Hlms::preparePassHash( shadowNode, casterPass, dualParaboloid, sceneManager );
 
+        mSceneManager = sceneManager;
+
         //mTexBuffers must hold at least one buffer to prevent out of bound exceptions.
         if( mTexBuffers.empty() )
         {
@@ -141,8 +171,39 @@ namespace Ogre
         return mStartMappedConstBuffer;
     }
     //-----------------------------------------------------------------------------------
+    void HlmsBufferManager::flushDeferredWorldMatrices(void)
+    {
+        const size_t numEntries = mDeferredWorldMatrices.size();
+
+        if( !numEntries )
+            return;
+
+        size_t numChunks = 1u;
+        if( mSceneManager && mParallelFill )
+        {
+            //A few chunks per thread so that the threads can balance the load.
+            numChunks = std::min( mSceneManager->getNumWorkerThreads() * 4u,
+                                  numEntries / c_minDeferredWorldMatricesPerChunk );
+        }
+
+        if( numChunks > 1u )
+        {
+            DeferredWorldMatricesTask task( this, numEntries, numChunks );
+            mSceneManager->executeUserChunkedTask( &task );
+        }
+        else
+        {
+            _fillDeferredWorldMatrices( 0, numEntries );
+        }
+
+        mDeferredWorldMatrices.clear();
+    }
+    //-----------------------------------------------------------------------------------
     void HlmsBufferManager::unmapTexBuffer( CommandBuffer *commandBuffer )
     {
+        //The pointers will become invalid after unmapping.
+        flushDeferredWorldMatrices();
+
         //Save our progress
         const size_t bytesWritten = (mCurrentMappedTexBuffer - mRealStartMappedTexBuffer) *
                                                                             sizeof(float);
@@ -264,6 +325,8 @@ namespace Ogre
     //-----------------------------------------------------------------------------------
     void HlmsBufferManager::destroyAllBuffers(void)
     {
+        mDeferredWorldMatrices.clear();
+
         mCurrentConstBuffer = 0;
         mCurrentTexBuffer   = 0;
         mTexLastOffset      = 0;
@@ -346,4 +409,11 @@ namespace Ogre
     {
         mTextureBufferDefaultSize = defaultSize;
     }
+    //-----------------------------------------------------------------------------------
+    void HlmsBufferManager::setParallelFill( bool bEnable )
+    {
+        assert( mDeferredWorldMatrices.empty() &&
+                "Can't change this setting while rendering!" );
+        mParallelFill = bEnable;
+    }
 }
@@ -97,6 +97,7 @@ namespace Ogre
             FastArray<float>    pixelShaderSharedBuffer;
 
             Matrix4 viewMatrix;
+            bool    casterPass;
         };
 
         PassData                mPreparedPass;
@@ -118,6 +119,44 @@ namespace Ogre
         ShadowFilter mShadowFilter;
         AmbientLightMode mAmbientLightMode;
 
+        struct SharedWorldMatrixSlot
+        {
+            /// Points to the parent node's full transform. Null when the slot is empty.
+            Matrix4 const   *worldMat;
+            /// Index to mTexBuffers where the matrix was written to.
+            uint32          texBufferIdx;
+            /// Offset (in units of 16 floats) from the start of the tex. buffer.
+            uint32          matrixIdx;
+        };
+        typedef FastArray<SharedWorldMatrixSlot> SharedWorldMatrixSlotArray;
+
+        struct SharedBonePaletteSlot
+        {
+            /// SkeletonInstance (v2) or Renderable (v1) the palette belongs to.
+            /// Null when the slot is empty.
+            void const      *owner;
+            /// The blend index to bone index map (v2). Null for v1.
+            void const      *indexMap;
+            /// Index to mTexBuffers where the palette was written to.
+            uint32          texBufferIdx;
+            /// Offset (in units of 4 floats) from the start of the tex. buffer.
+            uint32          paletteIdx;
+        };
+        typedef FastArray<SharedBonePaletteSlot> SharedBonePaletteSlotArray;
+
+        /// @see setSharedWorldMatrices
+        bool                        mSharedWorldMatrices;
+        /// Open addressed hash table (size is always power of 2, load factor <= 0.5)
+        /// of the world matrices already written this frame. Cleared every frame.
+        SharedWorldMatrixSlotArray  mSharedWorldMatrixSlots;
+        size_t                      mNumUsedSharedWorldMatrixSlots;
+        /// Same as mSharedWorldMatrixSlots, for the skeletal animation bone palettes.
+        SharedBonePaletteSlotArray  mSharedBonePaletteSlots;
+        size_t                      mNumUsedSharedBonePaletteSlots;
+        /// Index to mTexBuffers of the buffer currently bound to the
+        /// vertex shader's slot 0. ~0 if we don't know.
+        uint32                      mLastBoundSharedTexBuffer;
+
         virtual const HlmsCache* createShaderCacheEntry( uint32 renderableHash,
                                                          const HlmsCache &passCache,
                                                          uint32 finalHash,
@@ -141,6 +180,40 @@ namespace Ogre
 
         virtual void destroyAllBuffers(void);
 
+        /// Writes the mat4x3 world matrix followed by the mat4 worldView
+        /// (the latter only when not a caster pass). Returns the advanced pointer.
+        FORCEINLINE float* fillWorldMatrices( float * RESTRICT_ALIAS texBuffer,
+                                              const Matrix4 &worldMat, bool casterPass ) const;
+
+        /// Number of 4x3 matrices fillBonePalette will write.
+        static size_t getNumBones( const QueuedRenderable &queuedRenderable, bool isV1 );
+        /// Writes the 4x3 bone matrices of a skeletally animated renderable.
+        /// Returns the advanced pointer.
+        static float* fillBonePalette( float * RESTRICT_ALIAS texBuffer,
+                                       const QueuedRenderable &queuedRenderable, bool isV1 );
+
+        /// Binds the whole mTexBuffers[texBufferIdx] to the vertex shader, if it isn't already.
+        void bindSharedTexBuffer( uint32 texBufferIdx, CommandBuffer *commandBuffer );
+
+        /** Reserves numFloats from the mapped tex. buffer, mapping a new one if needed.
+            Used only with shared world matrices, where the whole buffer is bound.
+        @param outOffset
+            Offset to the returned pointer, in floats, from the start of the tex. buffer.
+        */
+        float* reserveSharedTexBuffer( size_t numFloats, size_t alignment,
+                                       CommandBuffer *commandBuffer, size_t &outOffset );
+
+        /// Returns the index of the world matrix in the shared buffer (in units of 16 floats),
+        /// reserving room for it (and deferring the write) the first time it's seen this frame.
+        uint32 getSharedWorldMatrixIdx( const Matrix4 *worldMat, CommandBuffer *commandBuffer );
+        void growSharedWorldMatrixSlots(void);
+
+        /// Returns the index of the bone palette in the shared buffer (in units of 4 floats),
+        /// writing it the first time it's seen this frame.
+        uint32 getSharedBonePaletteIdx( const QueuedRenderable &queuedRenderable, bool isV1,
+                                        CommandBuffer *commandBuffer );
+        void growSharedBonePaletteSlots(void);
+
         FORCEINLINE uint32 fillBuffersFor( const HlmsCache *cache,
                                            const QueuedRenderable &queuedRenderable,
                                            bool casterPass, uint32 lastCacheHash,
@@ -171,12 +244,31 @@ namespace Ogre
 
         virtual void frameEnded(void);
 
+        virtual void _fillDeferredWorldMatrices( size_t start, size_t end );
+
         void setShadowSettings( ShadowFilter filter );
         ShadowFilter getShadowFilter(void) const            { return mShadowFilter; }
 
         void setAmbientLightMode( AmbientLightMode mode );
         AmbientLightMode getAmbientLightMode(void) const    { return mAmbientLightMode; }
 
+        /** When enabled, the world matrix of each object is written once per frame into
+            the tex. buffer, and every pass that renders that object (i.e. the main pass
+            and each shadow map) refers to it by index via worldMaterialIdx.
+            The worldView matrix is no longer uploaded; the shader computes it instead.
+        @remarks
+            Off by default. Worth enabling when the same objects get rendered
+            in many passes, as it cuts the upload bandwidth by about the number
+            of passes.
+            Skeletal animation bone palettes are shared the same way: each
+            SkeletonInstance writes its palette once per frame for every
+            submesh blend index map it's drawn with (v1 objects: once per
+            SubEntity).
+            Can't be changed while rendering.
+        */
+        void setSharedWorldMatrices( bool bEnable );
+        bool getSharedWorldMatrices(void) const             { return mSharedWorldMatrices; }
+
 #if !OGRE_NO_JSON
         /// @copydoc Hlms::_loadJson
         virtual void _loadJson( const rapidjson::Value &jsonValue, const HlmsJson::NamedBlocks &blocks,
@@ -197,6 +289,7 @@ namespace Ogre
         static const IdString SignedIntTex;
         static const IdString MaterialsPerBuffer;
         static const IdString LowerGpuOverhead;
+        static const IdString SharedWorldMatrices;
 
         static const IdString NumTextures;
         static const char *DiffuseMap;
@@ -56,6 +56,8 @@ THE SOFTWARE.
 
 #include "Animation/OgreSkeletonInstance.h"
 
+#include "Math/Array/OgreArrayMatrixAf4x3.h"
+
 namespace Ogre
 {
     const IdString PbsProperty::HwGammaRead       = IdString( "hw_gamma_read" );
@@ -63,6 +65,7 @@ namespace Ogre
     const IdString PbsProperty::SignedIntTex      = IdString( "signed_int_textures" );
     const IdString PbsProperty::MaterialsPerBuffer= IdString( "materials_per_buffer" );
     const IdString PbsProperty::LowerGpuOverhead  = IdString( "lower_gpu_overhead" );
+    const IdString PbsProperty::SharedWorldMatrices=IdString( "shared_world_matrices" );
 
     const IdString PbsProperty::NumTextures     = IdString( "num_textures" );
     const char *PbsProperty::DiffuseMap         = "diffuse_map";
@@ -204,7 +207,11 @@ namespace Ogre
         mLastBoundPool( 0 ),
         mLastTextureHash( 0 ),
         mShadowFilter( PCF_3x3 ),
-        mAmbientLightMode( AmbientAuto )
+        mAmbientLightMode( AmbientAuto ),
+        mSharedWorldMatrices( false ),
+        mNumUsedSharedWorldMatrixSlots( 0 ),
+        mNumUsedSharedBonePaletteSlots( 0 ),
+        mLastBoundSharedTexBuffer( ~0u )
     {
         //Override defaults
         mLightGatheringMode = LightGatherForwardPlus;
@@ -672,6 +679,9 @@ namespace Ogre
 
         //The properties need to be set before preparePassHash so that
         //they are considered when building the HlmsCache's hash.
+        if( mSharedWorldMatrices )
+            setProperty( PbsProperty::SharedWorldMatrices, 1 );
+
         if( shadowNode && !casterPass )
         {
             //Shadow receiving can be improved in performance by using gather sampling.
@@ -761,6 +771,9 @@ namespace Ogre
                                                             RSC_TEXTURE_SIGNED_INT ) );
         retVal.setProperties = mSetProperties;
 
+        mSceneManager = sceneManager;
+        mPreparedPass.casterPass = casterPass;
+
         Camera *camera = sceneManager->getCameraInProgress();
         Matrix4 viewMatrix = camera->getViewMatrix(true);
 
@@ -1125,6 +1138,8 @@ namespace Ogre
 
         mLastBoundPool = 0;
 
+        mLastBoundSharedTexBuffer = ~0u;
+
         if( mShadowmapSamplerblock && !getProperty( HlmsBaseProp::ShadowUsesDepthTexture ) )
             mCurrentShadowmapSamplerblock = mShadowmapSamplerblock;
         else
@@ -1135,6 +1150,391 @@ namespace Ogre
         return retVal;
     }
     //-----------------------------------------------------------------------------------
+    FORCEINLINE float* HlmsPbs::fillWorldMatrices( float * RESTRICT_ALIAS texBuffer,
+                                                   const Matrix4 &worldMat, bool casterPass ) const
+    {
+        //mat4x3 world
+#if !OGRE_DOUBLE_PRECISION
+        memcpy( texBuffer, &worldMat, 4 * 3 * sizeof( float ) );
+        texBuffer += 16;
+#else
+        for( int y = 0; y < 3; ++y )
+        {
+            for( int x = 0; x < 4; ++x )
+            {
+                *texBuffer++ = worldMat[ y ][ x ];
+            }
+        }
+        texBuffer += 4;
+#endif
+
+        //mat4 worldView
+        Matrix4 tmp = mPreparedPass.viewMatrix.concatenateAffine( worldMat );
+    #ifdef OGRE_GLES2_WORKAROUND_1
+        tmp = tmp.transpose();
+#endif
+#if !OGRE_DOUBLE_PRECISION
+        memcpy( texBuffer, &tmp, sizeof( Matrix4 ) * !casterPass );
+        texBuffer += 16 * !casterPass;
+#else
+        if( !casterPass )
+        {
+            for( int y = 0; y < 4; ++y )
+            {
+                for( int x = 0; x < 4; ++x )
+                {
+                    *texBuffer++ = tmp[ y ][ x ];
+                }
+            }
+        }
+#endif
+
+        return texBuffer;
+    }
+    //-----------------------------------------------------------------------------------
+    void HlmsPbs::_fillDeferredWorldMatrices( size_t start, size_t end )
+    {
+        const bool casterPass = mPreparedPass.casterPass;
+
+        DeferredWorldMatrixArray::const_iterator itor = mDeferredWorldMatrices.begin() + start;
+        DeferredWorldMatrixArray::const_iterator en   = mDeferredWorldMatrices.begin() + end;
+
+        if( mSharedWorldMatrices )
+        {
+            //Only the mat4x3 world. The shader calculates the worldView.
+            while( itor != en )
+            {
+#if !OGRE_DOUBLE_PRECISION
+                memcpy( itor->texBufferPtr, itor->worldMat, 4 * 3 * sizeof( float ) );
+#else
+                float * RESTRICT_ALIAS texBuffer = itor->texBufferPtr;
+                for( int y = 0; y < 3; ++y )
+                {
+                    for( int x = 0; x < 4; ++x )
+                        *texBuffer++ = (*itor->worldMat)[ y ][ x ];
+                }
+#endif
+                ++itor;
+            }
+
+            return;
+        }
+
+#if OGRE_USE_SIMD == 1 && !OGRE_DOUBLE_PRECISION && !defined( OGRE_GLES2_WORKAROUND_1 )
+        //Process ARRAY_PACKED_REALS renderables at a time: the worldView
+        //concatenations are done in SoA form, the rest is just copying.
+        const ArrayMatrixAf4x3 viewMat =
+                ArrayMatrixAf4x3::createAllFromMatrix4( mPreparedPass.viewMatrix );
+
+        OGRE_ALIGNED_DECL( SimpleMatrixAf4x3, matrices[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+
+        while( static_cast<size_t>( en - itor ) >= ARRAY_PACKED_REALS )
+        {
+            //mat4x3 world. Copy to an aligned location too, since the
+            //source isn't guaranteed to be aligned (i.e. TagPoints)
+            for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+            {
+                memcpy( itor[i].texBufferPtr, itor[i].worldMat, 4 * 3 * sizeof( float ) );
+                memcpy( reinterpret_cast<float*>( &matrices[i] ),
+                        reinterpret_cast<const float*>( itor[i].worldMat ), 4 * 3 * sizeof( float ) );
+            }
+
+            if( !casterPass )
+            {
+                //mat4 worldView
+                ArrayMatrixAf4x3 worldView;
+                worldView.loadFromAoS( matrices );
+                worldView = viewMat * worldView;
+                worldView.storeToAoS( matrices );
+
+                for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+                {
+                    float * RESTRICT_ALIAS texBuffer = itor[i].texBufferPtr + 16;
+                    memcpy( texBuffer, &matrices[i], 4 * 3 * sizeof( float ) );
+                    texBuffer[12] = 0;
+                    texBuffer[13] = 0;
+                    texBuffer[14] = 0;
+                    texBuffer[15] = 1;
+                }
+            }
+
+            itor += ARRAY_PACKED_REALS;
+        }
+#endif
+
+        while( itor != en )
+        {
+            fillWorldMatrices( itor->texBufferPtr, *itor->worldMat, casterPass );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    size_t HlmsPbs::getNumBones( const QueuedRenderable &queuedRenderable, bool isV1 )
+    {
+        if( isV1 )
+        {
+            const uint16 numWorldTransforms = queuedRenderable.renderable->getNumWorldTransforms();
+            assert( numWorldTransforms <= 256u );
+            return numWorldTransforms;
+        }
+
+#if OGRE_DEBUG_MODE
+        assert( dynamic_cast<const RenderableAnimated*>( queuedRenderable.renderable ) );
+#endif
+        const RenderableAnimated *renderableAnimated = static_cast<const RenderableAnimated*>(
+                                                                queuedRenderable.renderable );
+        return renderableAnimated->getBlendIndexToBoneIndexMap()->size();
+    }
+    //-----------------------------------------------------------------------------------
+    float* HlmsPbs::fillBonePalette( float * RESTRICT_ALIAS texBuffer,
+                                     const QueuedRenderable &queuedRenderable, bool isV1 )
+    {
+        if( isV1 )
+        {
+            //TODO: Don't rely on a virtual function + make a direct 4x3 copy
+            const uint16 numWorldTransforms = queuedRenderable.renderable->getNumWorldTransforms();
+            Matrix4 tmp[256];
+            queuedRenderable.renderable->getWorldTransforms( tmp );
+            for( size_t i=0; i<numWorldTransforms; ++i )
+            {
+#if !OGRE_DOUBLE_PRECISION
+                memcpy( texBuffer, &tmp[ i ], 12 * sizeof( float ) );
+                texBuffer += 12;
+#else
+                for( int y = 0; y < 3; ++y )
+                {
+                    for( int x = 0; x < 4; ++x )
+                    {
+                        *texBuffer++ = tmp[ i ][ y ][ x ];
+                    }
+                }
+#endif
+            }
+        }
+        else
+        {
+            SkeletonInstance *skeleton = queuedRenderable.movableObject->getSkeletonInstance();
+
+            const RenderableAnimated *renderableAnimated = static_cast<const RenderableAnimated*>(
+                                                                    queuedRenderable.renderable );
+
+            const RenderableAnimated::IndexMap *indexMap =
+                    renderableAnimated->getBlendIndexToBoneIndexMap();
+
+            RenderableAnimated::IndexMap::const_iterator itBone = indexMap->begin();
+            RenderableAnimated::IndexMap::const_iterator enBone = indexMap->end();
+
+            while( itBone != enBone )
+            {
+                const SimpleMatrixAf4x3 &mat4x3 = skeleton->_getBoneFullTransform( *itBone );
+                mat4x3.streamTo4x3( texBuffer );
+                texBuffer += 12;
+
+                ++itBone;
+            }
+        }
+
+        return texBuffer;
+    }
+    //-----------------------------------------------------------------------------------
+    void HlmsPbs::bindSharedTexBuffer( uint32 texBufferIdx, CommandBuffer *commandBuffer )
+    {
+        if( mLastBoundSharedTexBuffer != texBufferIdx )
+        {
+            *commandBuffer->addCommand<CbShaderBuffer>() =
+                    CbShaderBuffer( VertexShader, 0, mTexBuffers[texBufferIdx], 0, 0 );
+            mLastBoundSharedTexBuffer = texBufferIdx;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    float* HlmsPbs::reserveSharedTexBuffer( size_t numFloats, size_t alignment,
+                                            CommandBuffer *commandBuffer, size_t &outOffset )
+    {
+        //We never rebind with an offset, thus mStartMappedTexBuffer == mRealStartMappedTexBuffer
+        size_t offset = mTexLastOffset / sizeof(float) +
+                        (mCurrentMappedTexBuffer - mRealStartMappedTexBuffer);
+        size_t padding = alignToNextMultiple( offset, alignment ) - offset;
+
+        if( (size_t)(mCurrentMappedTexBuffer - mStartMappedTexBuffer) + padding + numFloats >=
+                mCurrentTexBufferSize )
+        {
+            mapNextTexBuffer( commandBuffer, (numFloats + alignment) * sizeof(float) );
+
+            //mapNextTexBuffer binds from the mapped region onwards, but
+            //the offsets we hand out are relative to the buffer's start.
+            CbShaderBuffer *shaderBufferCmd = reinterpret_cast<CbShaderBuffer*>(
+                        commandBuffer->getCommandFromOffset( mLastTexBufferCmdOffset ) );
+            shaderBufferCmd->bindOffset = 0;
+            mLastBoundSharedTexBuffer = mCurrentTexBuffer;
+
+            offset  = mTexLastOffset / sizeof(float);
+            padding = alignToNextMultiple( offset, alignment ) - offset;
+        }
+
+        float *retVal = mCurrentMappedTexBuffer + padding;
+        mCurrentMappedTexBuffer = retVal + numFloats;
+        outOffset = offset + padding;
+
+        return retVal;
+    }
+    //-----------------------------------------------------------------------------------
+    uint32 HlmsPbs::getSharedWorldMatrixIdx( const Matrix4 *worldMat, CommandBuffer *commandBuffer )
+    {
+        if( (mNumUsedSharedWorldMatrixSlots + 1u) * 2u > mSharedWorldMatrixSlots.size() )
+            growSharedWorldMatrixSlots();
+
+        const size_t mask = mSharedWorldMatrixSlots.size() - 1u;
+        size_t idx = ((reinterpret_cast<size_t>( worldMat ) >> 4u) * 2654435761u) & mask;
+
+        while( mSharedWorldMatrixSlots[idx].worldMat &&
+               mSharedWorldMatrixSlots[idx].worldMat != worldMat )
+        {
+            idx = (idx + 1u) & mask;
+        }
+
+        SharedWorldMatrixSlot &slot = mSharedWorldMatrixSlots[idx];
+
+        if( !slot.worldMat )
+        {
+            //First time we see it this frame. Reserve the space;
+            //the matrix gets written before the buffer gets unmapped.
+            size_t offset;
+            DeferredWorldMatrix deferred;
+            deferred.worldMat       = worldMat;
+            deferred.texBufferPtr   = reserveSharedTexBuffer( 16u, 16u, commandBuffer, offset );
+            mDeferredWorldMatrices.push_back( deferred );
+
+            slot.worldMat       = worldMat;
+            slot.texBufferIdx   = mCurrentTexBuffer;
+            slot.matrixIdx      = static_cast<uint32>( offset >> 4u );
+            ++mNumUsedSharedWorldMatrixSlots;
+        }
+
+        bindSharedTexBuffer( slot.texBufferIdx, commandBuffer );
+
+        return slot.matrixIdx;
+    }
+    //-----------------------------------------------------------------------------------
+    void HlmsPbs::growSharedWorldMatrixSlots(void)
+    {
+        SharedWorldMatrixSlot emptySlot;
+        emptySlot.worldMat      = 0;
+        emptySlot.texBufferIdx  = 0;
+        emptySlot.matrixIdx     = 0;
+
+        SharedWorldMatrixSlotArray oldSlots;
+        oldSlots.swap( mSharedWorldMatrixSlots );
+        mSharedWorldMatrixSlots.resize( std::max<size_t>( oldSlots.size() * 2u, 1024u ), emptySlot );
+
+        const size_t mask = mSharedWorldMatrixSlots.size() - 1u;
+
+        SharedWorldMatrixSlotArray::const_iterator itor = oldSlots.begin();
+        SharedWorldMatrixSlotArray::const_iterator end  = oldSlots.end();
+
+        while( itor != end )
+        {
+            if( itor->worldMat )
+            {
+                size_t idx = ((reinterpret_cast<size_t>( itor->worldMat ) >> 4u) *
+                              2654435761u) & mask;
+                while( mSharedWorldMatrixSlots[idx].worldMat )
+                    idx = (idx + 1u) & mask;
+                mSharedWorldMatrixSlots[idx] = *itor;
+            }
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    static inline size_t hashBonePaletteOwner( const void *owner, const void *indexMap )
+    {
+        return ((reinterpret_cast<size_t>( owner ) >> 4u) * 2654435761u) ^
+               ((reinterpret_cast<size_t>( indexMap ) >> 3u) * 40503u);
+    }
+    //-----------------------------------------------------------------------------------
+    uint32 HlmsPbs::getSharedBonePaletteIdx( const QueuedRenderable &queuedRenderable, bool isV1,
+                                             CommandBuffer *commandBuffer )
+    {
+        //v2 palettes depend on the skeleton and the submesh's blend index map. v1 palettes
+        //come from the renderable itself (getWorldTransforms).
+        const void *owner;
+        const void *indexMap;
+        if( isV1 )
+        {
+            owner       = queuedRenderable.renderable;
+            indexMap    = 0;
+        }
+        else
+        {
+            owner       = queuedRenderable.movableObject->getSkeletonInstance();
+            indexMap    = static_cast<const RenderableAnimated*>( queuedRenderable.renderable )->
+                                getBlendIndexToBoneIndexMap();
+        }
+
+        if( (mNumUsedSharedBonePaletteSlots + 1u) * 2u > mSharedBonePaletteSlots.size() )
+            growSharedBonePaletteSlots();
+
+        const size_t mask = mSharedBonePaletteSlots.size() - 1u;
+        size_t idx = hashBonePaletteOwner( owner, indexMap ) & mask;
+
+        while( mSharedBonePaletteSlots[idx].owner &&
+               (mSharedBonePaletteSlots[idx].owner != owner ||
+                mSharedBonePaletteSlots[idx].indexMap != indexMap) )
+        {
+            idx = (idx + 1u) & mask;
+        }
+
+        SharedBonePaletteSlot &slot = mSharedBonePaletteSlots[idx];
+
+        if( !slot.owner )
+        {
+            //First time we see it this frame. vec4 worldMat[][3]
+            size_t offset;
+            const size_t numFloats = 12 * getNumBones( queuedRenderable, isV1 );
+            float *texBuffer = reserveSharedTexBuffer( numFloats, 4u, commandBuffer, offset );
+            fillBonePalette( texBuffer, queuedRenderable, isV1 );
+
+            slot.owner          = owner;
+            slot.indexMap       = indexMap;
+            slot.texBufferIdx   = mCurrentTexBuffer;
+            slot.paletteIdx     = static_cast<uint32>( offset >> 2u );
+            ++mNumUsedSharedBonePaletteSlots;
+        }
+
+        bindSharedTexBuffer( slot.texBufferIdx, commandBuffer );
+
+        return slot.paletteIdx;
+    }
+    //-----------------------------------------------------------------------------------
+    void HlmsPbs::growSharedBonePaletteSlots(void)
+    {
+        SharedBonePaletteSlot emptySlot;
+        emptySlot.owner         = 0;
+        emptySlot.indexMap      = 0;
+        emptySlot.texBufferIdx  = 0;
+        emptySlot.paletteIdx    = 0;
+
+        SharedBonePaletteSlotArray oldSlots;
+        oldSlots.swap( mSharedBonePaletteSlots );
+        mSharedBonePaletteSlots.resize( std::max<size_t>( oldSlots.size() * 2u, 256u ), emptySlot );
+
+        const size_t mask = mSharedBonePaletteSlots.size() - 1u;
+
+        SharedBonePaletteSlotArray::const_iterator itor = oldSlots.begin();
+        SharedBonePaletteSlotArray::const_iterator end  = oldSlots.end();
+
+        while( itor != end )
+        {
+            if( itor->owner )
+            {
+                size_t idx = hashBonePaletteOwner( itor->owner, itor->indexMap ) & mask;
+                while( mSharedBonePaletteSlots[idx].owner )
+                    idx = (idx + 1u) & mask;
+                mSharedBonePaletteSlots[idx] = *itor;
+            }
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
     uint32 HlmsPbs::fillBuffersFor( const HlmsCache *cache, const QueuedRenderable &queuedRenderable,
                                     bool casterPass, uint32 lastCacheHash,
                                     uint32 lastTextureHash )
@@ -1227,7 +1627,10 @@ namespace Ogre
                         CbShaderBuffer( PixelShader, 2, mConstBuffers[mCurrentConstBuffer], 0, 0 );
             }
 
-            rebindTexBuffer( commandBuffer );
+            if( !mSharedWorldMatrices )
+                rebindTexBuffer( commandBuffer );
+            else
+                mLastBoundSharedTexBuffer = ~0u;
 
             mListener->hlmsTypeChanged( casterPass, commandBuffer, datablock );
         }
@@ -1257,7 +1660,35 @@ namespace Ogre
         //                          ---- VERTEX SHADER ----
         //---------------------------------------------------------------------------
 
-        if( !hasSkeletonAnimation )
+        if( mSharedWorldMatrices )
+        {
+            //The const buffer is no longer in sync with the tex. buffer; the draw
+            //tells the shader where its matrices are via worldMaterialIdx.
+            if( (size_t)((currentMappedConstBuffer - mStartMappedConstBuffer) + 4) >
+                    mCurrentConstBufferSize )
+            {
+                currentMappedConstBuffer = mapNextConstBuffer( commandBuffer );
+            }
+
+            size_t instanceIdx;
+            if( !hasSkeletonAnimation )
+            {
+                instanceIdx = getSharedWorldMatrixIdx( &worldMat, commandBuffer );
+            }
+            else
+            {
+                instanceIdx = getSharedBonePaletteIdx( queuedRenderable, isV1, commandBuffer );
+            }
+
+            assert( instanceIdx < (1u << 23u) );
+
+            //uint worldMaterialIdx[]
+            *currentMappedConstBuffer = (static_cast<uint32>( instanceIdx ) << 9 ) |
+                    (datablock->getAssignedSlot() & 0x1FF);
+
+            currentMappedTexBuffer = mCurrentMappedTexBuffer;
+        }
+        else if( !hasSkeletonAnimation )
         {
             //We need to correct currentMappedConstBuffer to point to the right texture buffer's
             //offset, which may not be in sync if the previous draw had skeletal animation.
@@ -1286,141 +1717,44 @@ namespace Ogre
             //uint worldMaterialIdx[]
             *currentMappedConstBuffer = datablock->getAssignedSlot() & 0x1FF;
 
-            //mat4x3 world
-#if !OGRE_DOUBLE_PRECISION
-            memcpy( currentMappedTexBuffer, &worldMat, 4 * 3 * sizeof( float ) );
-            currentMappedTexBuffer += 16;
-#else
-            for( int y = 0; y < 3; ++y )
-            {
-                for( int x = 0; x < 4; ++x )
-                {
-                    *currentMappedTexBuffer++ = worldMat[ y ][ x ];
-                }
-            }
-            currentMappedTexBuffer += 4;
-#endif
-
-            //mat4 worldView
-            Matrix4 tmp = mPreparedPass.viewMatrix.concatenateAffine( worldMat );
-    #ifdef OGRE_GLES2_WORKAROUND_1
-            tmp = tmp.transpose();
-#endif
-#if !OGRE_DOUBLE_PRECISION
-            memcpy( currentMappedTexBuffer, &tmp, sizeof( Matrix4 ) * !casterPass );
-            currentMappedTexBuffer += 16 * !casterPass;
-#else
-            if( !casterPass )
-            {
-                for( int y = 0; y < 4; ++y )
-                {
-                    for( int x = 0; x < 4; ++x )
-                    {
-                        *currentMappedTexBuffer++ = tmp[ y ][ x ];
-                    }
-                }
-            }
-#endif
+            //Just reserve the space. The matrices get written in batches (and by the
+            //worker threads if mParallelFill) before the buffer gets unmapped.
+            //@see flushDeferredWorldMatrices
+            DeferredWorldMatrix deferred;
+            deferred.worldMat       = &worldMat;
+            deferred.texBufferPtr   = currentMappedTexBuffer;
+            mDeferredWorldMatrices.push_back( deferred );
+            currentMappedTexBuffer += 16 + 16 * !casterPass;
         }
         else
         {
             bool exceedsConstBuffer = (size_t)((currentMappedConstBuffer - mStartMappedConstBuffer) + 4)
                                         > mCurrentConstBufferSize;
 
-            if( isV1 )
-            {
-                uint16 numWorldTransforms = queuedRenderable.renderable->getNumWorldTransforms();
-                assert( numWorldTransforms <= 256u );
-
-                const size_t minimumTexBufferSize = 12 * numWorldTransforms;
-                bool exceedsTexBuffer = (currentMappedTexBuffer - mStartMappedTexBuffer) +
-                        minimumTexBufferSize >= mCurrentTexBufferSize;
-
-                if( exceedsConstBuffer || exceedsTexBuffer )
-                {
-                    currentMappedConstBuffer = mapNextConstBuffer( commandBuffer );
-
-                    if( exceedsTexBuffer )
-                        mapNextTexBuffer( commandBuffer, minimumTexBufferSize * sizeof(float) );
-                    else
-                        rebindTexBuffer( commandBuffer, true, minimumTexBufferSize * sizeof(float) );
-
-                    currentMappedTexBuffer = mCurrentMappedTexBuffer;
-                }
+            const size_t minimumTexBufferSize = 12 * getNumBones( queuedRenderable, isV1 );
+            bool exceedsTexBuffer = (currentMappedTexBuffer - mStartMappedTexBuffer) +
+                                        minimumTexBufferSize >= mCurrentTexBufferSize;
 
-                //uint worldMaterialIdx[]
-                size_t distToWorldMatStart = mCurrentMappedTexBuffer - mStartMappedTexBuffer;
-                distToWorldMatStart >>= 2;
-                *currentMappedConstBuffer = (distToWorldMatStart << 9 ) |
-                        (datablock->getAssignedSlot() & 0x1FF);
-
-                //vec4 worldMat[][3]
-                //TODO: Don't rely on a virtual function + make a direct 4x3 copy
-                Matrix4 tmp[256];
-                queuedRenderable.renderable->getWorldTransforms( tmp );
-                for( size_t i=0; i<numWorldTransforms; ++i )
-                {
-#if !OGRE_DOUBLE_PRECISION
-                    memcpy( currentMappedTexBuffer, &tmp[ i ], 12 * sizeof( float ) );
-                    currentMappedTexBuffer += 12;
-#else
-                    for( int y = 0; y < 3; ++y )
-                    {
-                        for( int x = 0; x < 4; ++x )
-                        {
-                            *currentMappedTexBuffer++ = tmp[ i ][ y ][ x ];
-                        }
-                    }
-#endif
-                }
-            }
-            else
+            if( exceedsConstBuffer || exceedsTexBuffer )
             {
-                SkeletonInstance *skeleton = queuedRenderable.movableObject->getSkeletonInstance();
-
-#if OGRE_DEBUG_MODE
-                assert( dynamic_cast<const RenderableAnimated*>( queuedRenderable.renderable ) );
-#endif
-
-                const RenderableAnimated *renderableAnimated = static_cast<const RenderableAnimated*>(
-                                                                        queuedRenderable.renderable );
-
-                const RenderableAnimated::IndexMap *indexMap = renderableAnimated->getBlendIndexToBoneIndexMap();
-
-                const size_t minimumTexBufferSize = 12 * indexMap->size();
-                bool exceedsTexBuffer = (currentMappedTexBuffer - mStartMappedTexBuffer) +
-                                            minimumTexBufferSize >= mCurrentTexBufferSize;
-
-                if( exceedsConstBuffer || exceedsTexBuffer )
-                {
-                    currentMappedConstBuffer = mapNextConstBuffer( commandBuffer );
-
-                    if( exceedsTexBuffer )
-                        mapNextTexBuffer( commandBuffer, minimumTexBufferSize * sizeof(float) );
-                    else
-                        rebindTexBuffer( commandBuffer, true, minimumTexBufferSize * sizeof(float) );
-
-                    currentMappedTexBuffer = mCurrentMappedTexBuffer;
-                }
+                currentMappedConstBuffer = mapNextConstBuffer( commandBuffer );
 
-                //uint worldMaterialIdx[]
-                size_t distToWorldMatStart = mCurrentMappedTexBuffer - mStartMappedTexBuffer;
-                distToWorldMatStart >>= 2;
-                *currentMappedConstBuffer = (distToWorldMatStart << 9 ) |
-                        (datablock->getAssignedSlot() & 0x1FF);
+                if( exceedsTexBuffer )
+                    mapNextTexBuffer( commandBuffer, minimumTexBufferSize * sizeof(float) );
+                else
+                    rebindTexBuffer( commandBuffer, true, minimumTexBufferSize * sizeof(float) );
 
-                RenderableAnimated::IndexMap::const_iterator itBone = indexMap->begin();
-                RenderableAnimated::IndexMap::const_iterator enBone = indexMap->end();
+                currentMappedTexBuffer = mCurrentMappedTexBuffer;
+            }
 
-                while( itBone != enBone )
-                {
-                    const SimpleMatrixAf4x3 &mat4x3 = skeleton->_getBoneFullTransform( *itBone );
-                    mat4x3.streamTo4x3( currentMappedTexBuffer );
-                    currentMappedTexBuffer += 12;
+            //uint worldMaterialIdx[]
+            size_t distToWorldMatStart = mCurrentMappedTexBuffer - mStartMappedTexBuffer;
+            distToWorldMatStart >>= 2;
+            *currentMappedConstBuffer = (distToWorldMatStart << 9 ) |
+                    (datablock->getAssignedSlot() & 0x1FF);
 
-                    ++itBone;
-                }
-            }
+            //vec4 worldMat[][3]
+            currentMappedTexBuffer = fillBonePalette( currentMappedTexBuffer, queuedRenderable, isV1 );
 
             //If the next entity will not be skeletally animated, we'll need
             //currentMappedTexBuffer to be 16/32-byte aligned.
@@ -1478,6 +1812,12 @@ namespace Ogre
 
         mCurrentPassBuffer  = 0;
 
+        mSharedWorldMatrixSlots.clear();
+        mNumUsedSharedWorldMatrixSlots = 0;
+        mSharedBonePaletteSlots.clear();
+        mNumUsedSharedBonePaletteSlots = 0;
+        mLastBoundSharedTexBuffer = ~0u;
+
         {
             ConstBufferPackedVec::const_iterator itor = mPassBuffers.begin();
             ConstBufferPackedVec::const_iterator end  = mPassBuffers.end();
@@ -1498,6 +1838,31 @@ namespace Ogre
     {
         HlmsBufferManager::frameEnded();
         mCurrentPassBuffer  = 0;
+
+        //The shared world matrices are only valid for the frame they were written.
+        if( mNumUsedSharedWorldMatrixSlots )
+        {
+            SharedWorldMatrixSlotArray::iterator itor = mSharedWorldMatrixSlots.begin();
+            SharedWorldMatrixSlotArray::iterator end  = mSharedWorldMatrixSlots.end();
+            while( itor != end )
+            {
+                itor->worldMat = 0;
+                ++itor;
+            }
+            mNumUsedSharedWorldMatrixSlots = 0;
+        }
+
+        if( mNumUsedSharedBonePaletteSlots )
+        {
+            SharedBonePaletteSlotArray::iterator itor = mSharedBonePaletteSlots.begin();
+            SharedBonePaletteSlotArray::iterator end  = mSharedBonePaletteSlots.end();
+            while( itor != end )
+            {
+                itor->owner = 0;
+                ++itor;
+            }
+            mNumUsedSharedBonePaletteSlots = 0;
+        }
     }
     //-----------------------------------------------------------------------------------
     void HlmsPbs::setShadowSettings( ShadowFilter filter )
@@ -1509,6 +1874,13 @@ namespace Ogre
     {
         mAmbientLightMode = mode;
     }
+    //-----------------------------------------------------------------------------------
+    void HlmsPbs::setSharedWorldMatrices( bool bEnable )
+    {
+        assert( mDeferredWorldMatrices.empty() &&
+                "Can't change this setting while rendering!" );
+        mSharedWorldMatrices = bEnable;
+    }
 #if !OGRE_NO_JSON
     //-----------------------------------------------------------------------------------
     void HlmsPbs::_loadJson( const rapidjson::Value &jsonValue, const HlmsJson::NamedBlocks &blocks,
@@ -62,6 +62,9 @@ namespace Ogre
         */
         FastArray<size_t>               threadStarts;
 
+        /// Given to each new instance. @see SkeletonInstance::_setUpdateFrameOffset
+        uint16                          nextUpdateFrameOffset;
+
         BySkeletonDef( const SkeletonDef *skeletonDef, size_t threadCount );
 
         void initializeMemoryManager(void);
@@ -169,7 +169,12 @@ namespace Ogre
         void setEnabled( bool bEnable );
         bool getEnabled(void) const                                 { return mEnabled; }
 
-        void _applyAnimation( const TransformArray &boneTransforms );
+        /** Applies the animation to the given bone transforms.
+        @param numDepthLevels
+            Only bones in the first numDepthLevels levels of the hierarchy are animated.
+            Deeper bones are left untouched. @see SkeletonUpdatePolicy::boneLodDepthLevels
+        */
+        void _applyAnimation( const TransformArray &boneTransforms, size_t numDepthLevels );
 
         void _swapBoneWeightsUniquePtr( RawSimdUniquePtr<ArrayReal, MEMCATEGORY_ANIMATION>
                                         &inOutBoneWeights );
@@ -58,6 +58,8 @@ namespace Ogre
         SkeletonDef const   *mSkeletonDef;
 
         KfTransformArrayMemoryManager *mKfTransformMemoryManager;
+        /// Compressed keyframes of all mTracks, contiguous. @see compressKeyFrames
+        uint8               *mCompressedKeyFrames;
 
         typedef vector<Real>::type TimestampVec;
         typedef map<size_t, TimestampVec>::type TimestampsPerBlock;
@@ -94,6 +96,18 @@ namespace Ogre
 
         void build( const v1::Skeleton *skeleton, const v1::Animation *animation, Real frameRate );
 
+        /** Compresses the keyframes of all tracks to reduce memory and bandwidth usage.
+            Positions & scales that don't change are stored once; otherwise quantized to
+            16 bits per component, rotations to 15 bits per component ("smallest three").
+            Channels that can't be compressed within the error budget are kept as-is.
+        @remarks
+            Must be called after build() and before any SkeletonInstance uses this
+            animation. Keyframes can no longer be modified afterwards.
+            Calling it again does nothing.
+        */
+        void compressKeyFrames( const KfCompressionSettings &settings );
+        bool isCompressed(void) const                                   { return mCompressedKeyFrames != 0; }
+
         /// Dumps all the tracks in CSV format to the output string argument.
         /// Mostly for debugging purposes. (also easy example to show how to
         /// enumerate all the tracks and get the bones back from its block index)
@@ -148,6 +148,11 @@ namespace Ogre
                                 getReverseBindPose(void) const          { return mReverseBindPose; }
         void getBonesPerDepth( vector<size_t>::type &out ) const;
 
+        /** Compresses the keyframes of all animations. @see SkeletonAnimationDef::compressKeyFrames
+            Must be called before creating any SkeletonInstance out of this definition.
+        */
+        void compressAnimations( const KfCompressionSettings &settings );
+
         /** Returns the total number of bone blocks to reach the given level. i.e On SSE2,
             If the skeleton has 1 root node, 3 children, and 5 children of children;
             then the total number of blocks is 1 + 1 + 2 = 4
@@ -45,6 +45,40 @@ namespace Ogre
     *  @{
     */
 
+    /** Controls how often a SkeletonInstance evaluates its animations when updated by the
+        SceneManager. @see SkeletonInstance::setUpdatePolicy
+    @remarks
+        Visibility & distance come from the cullFrustum calls of the previous frame, using
+        the closest object (i.e. Item) that shares this skeleton. Throttled instances keep
+        their last pose in the frames they skip, but their derived transforms are still
+        updated, thus they follow their SceneNode. Animation time is not affected, so the
+        next evaluation samples the animation at its current time.
+        The default values always evaluate everything, every frame.
+    */
+    struct _OgreExport SkeletonUpdatePolicy
+    {
+        /// Beyond this distance to the camera, animations are evaluated once every
+        /// farUpdateInterval frames.
+        Real    farDistance;
+        uint16  farUpdateInterval;
+        /// Animations are evaluated once every invisibleUpdateInterval frames while nothing
+        /// using this skeleton was visible in the last frame. 0 to stop evaluating them.
+        uint16  invisibleUpdateInterval;
+        /// Beyond this distance to the camera, only the first boneLodDepthLevels levels
+        /// of the bone hierarchy are animated. Deeper (leaf) bones keep their last pose.
+        Real    boneLodDistance;
+        uint16  boneLodDepthLevels;
+
+        SkeletonUpdatePolicy() :
+            farDistance( std::numeric_limits<Real>::max() ),
+            farUpdateInterval( 1u ),
+            invisibleUpdateInterval( 1u ),
+            boneLodDistance( std::numeric_limits<Real>::max() ),
+            boneLodDepthLevels( std::numeric_limits<uint16>::max() )
+        {
+        }
+    };
+
     /** Instance of a Skeleton, main external interface for retrieving bone positions and applying
         animations.
     @remarks
@@ -107,6 +141,18 @@ namespace Ogre
 
         uint16 mRefCount;
 
+        SkeletonUpdatePolicy    mUpdatePolicy;
+        /// Staggers throttled updates so that instances don't evaluate all in the same frame
+        uint16                  mUpdateFrameOffset;
+        /// Frame (@see Root::getNextFrameNumber) in which we were last found visible
+        uint32                  mLastVisibleFrame;
+        /// Closest distance to the camera in mLastVisibleFrame
+        Real                    mLastVisibleDistance;
+
+        /// Applies the active animations to the first numDepthLevels levels of bones.
+        void updateDepthLevels( size_t numDepthLevels );
+        void resetDepthLevelsToPose( size_t numDepthLevels );
+
     public:
         SkeletonInstance( const SkeletonDef *skeletonDef, BoneMemoryManager *boneMemoryManager );
         ~SkeletonInstance();
@@ -115,6 +161,34 @@ namespace Ogre
 
         void update(void);
 
+        /** Sets the policy the SceneManager uses to decide when and how much of this skeleton
+            gets animated. See SkeletonUpdatePolicy. Calling update() directly ignores it.
+        */
+        void setUpdatePolicy( const SkeletonUpdatePolicy &policy )  { mUpdatePolicy = policy; }
+        const SkeletonUpdatePolicy& getUpdatePolicy(void) const     { return mUpdatePolicy; }
+
+        /** Evaluates the animations as allowed by the update policy. @see setUpdatePolicy
+        @param frameNumber
+            Current frame number. @see Root::getNextFrameNumber
+        @return
+            True if any animation was evaluated.
+        */
+        bool _updateFromPolicy( uint32 frameNumber );
+
+        /** Called after cullFrustum when an object using this skeleton was visible.
+        @remarks
+            Not thread safe. The SceneManager calls it from the main thread once the
+            cull threads are done. @see SceneManager::applyVisibleSkeletons
+        */
+        void _notifyVisible( uint32 frameNumber, Real distanceToCamera )
+        {
+            if( mLastVisibleFrame != frameNumber || distanceToCamera < mLastVisibleDistance )
+                mLastVisibleDistance = distanceToCamera;
+            mLastVisibleFrame = frameNumber;
+        }
+
+        void _setUpdateFrameOffset( uint16 offset )                 { mUpdateFrameOffset = offset; }
+
         /// Resets the transform of all bones to the binding pose. Manual bones are not reset
         void resetToPose(void);
 
@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include "OgreResourceManager.h"
 #include "OgreSingleton.h"
+#include "Animation/OgreSkeletonTrack.h"
 
 namespace Ogre {
 
@@ -52,11 +53,24 @@ namespace Ogre {
         typedef map<IdString, SkeletonDefPtr>::type SkeletonDefMap;
         SkeletonDefMap mSkeletonDefs;
 
+        bool                    mCompressKeyFrames;
+        KfCompressionSettings   mKfCompressionSettings;
+
     public:
         /// Constructor
         SkeletonManager();
         ~SkeletonManager();
 
+        /** When enabled, the keyframes of skeletons created from now on by getSkeletonDef
+            are compressed. @see SkeletonAnimationDef::compressKeyFrames
+            Disabled by default. Skeletons that already exist are not affected.
+        */
+        void setKeyFrameCompression( bool bEnabled,
+                                     const KfCompressionSettings &settings = KfCompressionSettings() );
+        bool getKeyFrameCompression(void) const                 { return mCompressKeyFrames; }
+        const KfCompressionSettings& getKfCompressionSettings(void) const
+                                                                { return mKfCompressionSettings; }
+
         /** Creates a skeletondef based on an existing one from the legacy skeleton system.
             If a skeleton def with the same name already exists, returns that one instead.
         */
@@ -50,6 +50,27 @@ namespace Ogre
 
     typedef FastArray<BoneTransform> TransformArray;
 
+    /** Error budget used when compressing keyframes. @see SkeletonTrack::_prepareCompression
+        Each channel (position, rotation, scale) of a track is compressed as much as these
+        limits allow, and left uncompressed if not even quantization can honour them.
+    */
+    struct _OgreExport KfCompressionSettings
+    {
+        /// Maximum absolute error per translation component (in the bone's parent space units)
+        Real maxPositionError;
+        /// Maximum absolute error per (normalized) quaternion component
+        Real maxRotationError;
+        /// Maximum absolute error per scale component
+        Real maxScaleError;
+
+        KfCompressionSettings() :
+            maxPositionError( 1e-3f ),
+            maxRotationError( 2e-4f ),
+            maxScaleError( 1e-4f )
+        {
+        }
+    };
+
     class _OgreExport SkeletonTrack : public AnimationAlloc
     {
     protected:
@@ -78,7 +99,47 @@ namespace Ogre
 
         KfTransformArrayMemoryManager *mLocalMemoryManager;
 
+        /** When not null, the keyframes are compressed and KeyFrameRig::mBoneTransform is null.
+            The memory is owned by our SkeletonAnimationDef. Layout:
+                Header: per channel (position, rotation, scale, in that order)
+                    KfConstant:  the value (ArrayVector3 or ArrayQuaternion)
+                    KfQuantized: ArrayVector3 minimum & ArrayVector3 step (vectors only)
+                    KfRaw:       nothing
+                Then one block of mCompressedKeyStride bytes per keyframe:
+                    All KfRaw channels as ArrayVector3 / ArrayQuaternion,
+                    followed by uint16[3][ARRAY_PACKED_REALS] per KfQuantized channel.
+            Rotations are quantized as the "smallest three" components of the normalized
+            quaternion (15 bits each); the index of the dropped component is stored in the
+            top bit of the first two.
+        */
+        uint8 const         *mCompressedData;
+        uint32              mCompressedHeaderSize;
+        uint32              mCompressedKeyStride;
+        uint8               mPositionEncoding;
+        uint8               mRotationEncoding;
+        uint8               mScaleEncoding;
+
+        /// Gets the min & max values of the given channel across all keyframes
+        void getChannelRange( ArrayVector3 KfTransform::*channel,
+                              ArrayVector3 &outMin, ArrayVector3 &outMax ) const;
+        uint8 chooseVectorEncoding( ArrayVector3 KfTransform::*channel, Real maxError ) const;
+        uint8 chooseRotationEncoding( Real maxError ) const;
+
+        /// Decompresses the whole keyframe. Must only be called when mCompressedData != 0
+        inline void decompressKeyFrame( size_t keyFrameIdx, ArrayVector3 &outPos,
+                                        ArrayQuaternion &outRot, ArrayVector3 &outScale ) const;
+
     public:
+        enum KfChannelEncoding
+        {
+            /// Stored as-is, one value per keyframe
+            KfRaw,
+            /// Stored as 16-bit values per keyframe
+            KfQuantized,
+            /// The same value is used by all keyframes, stored only once
+            KfConstant
+        };
+
         SkeletonTrack( uint32 boneBlockIdx, KfTransformArrayMemoryManager *kfTransformMemoryManager );
         ~SkeletonTrack();
 
@@ -93,6 +154,24 @@ namespace Ogre
         void _setMaxUsedSlot( uint32 slot )
                                         { mUsedSlots = std::max( slot+1, mUsedSlots ); }
 
+        /** Retrieves the transform of a keyframe. Works whether the keyframes
+            are compressed or not; but it's not meant to be fast.
+        @param keyFrameIdx
+            Index to the keyframe in getKeyFrames()
+        @param slot
+            SIMD slot. Must be in range [0; ARRAY_PACKED_REALS)
+        */
+        void getKeyFrameTransform( size_t keyFrameIdx, uint32 slot, Vector3 &outPos,
+                                   Quaternion &outRot, Vector3 &outScale ) const;
+
+        bool isCompressed(void) const                           { return mCompressedData != 0; }
+        KfChannelEncoding getPositionEncoding(void) const
+                                        { return static_cast<KfChannelEncoding>( mPositionEncoding ); }
+        KfChannelEncoding getRotationEncoding(void) const
+                                        { return static_cast<KfChannelEncoding>( mRotationEncoding ); }
+        KfChannelEncoding getScaleEncoding(void) const
+                                        { return static_cast<KfChannelEncoding>( mScaleEncoding ); }
+
         const KeyFrameRigVec& getKeyFrames(void) const          { return mKeyFrameRigs; }
         KeyFrameRigVec& _getKeyFrames(void)                     { return mKeyFrameRigs; }
 
@@ -126,6 +205,21 @@ namespace Ogre
             mUsedSlots <= (ARRAY_PACKED_REALS >> 1). Otherwise it does nothing.
         */
         void _bakeUnusedSlots(void);
+
+        /** Chooses the encoding of each channel according to the error budget.
+            Must be called after _bakeUnusedSlots, and followed by _compress.
+        @return
+            Bytes needed by _compress. Always a multiple of sizeof(ArrayReal).
+        */
+        size_t _prepareCompression( const KfCompressionSettings &settings );
+
+        /** Compresses all keyframes into the given memory and stops referencing the
+            KfTransforms. The KfTransformArrayMemoryManager can be destroyed afterwards.
+        @param dstData
+            Must be SIMD aligned, hold the size returned by _prepareCompression, and
+            outlive this track.
+        */
+        void _compress( uint8 *dstData );
     };
 
     typedef vector<SkeletonTrack>::type SkeletonTrackVec;
@@ -133,6 +133,11 @@ namespace Ogre
         CompositorChannel createShadowTexture( const ShadowTextureDefinition &textureDef,
                                                 const RenderTarget *finalTarget );
 
+        /** Culls the cameras of all the scene passes we're about to execute in a single
+            pass over the scene. @See SceneManager::cullFrustumBatch
+        */
+        void cullShadowMapsBatch( const Camera *lodCamera, SceneManager *sceneManager );
+
     public:
         CompositorShadowNode( IdType id, const CompositorShadowNodeDef *definition,
                               CompositorWorkspace *workspace, RenderSystem *renderSys,
@@ -88,6 +88,13 @@ namespace Ogre
 
         CompositorShadowNode* getShadowNode() const             { return mShadowNode; }
         Camera* getCamera() const                               { return mCamera; }
+
+        /// Returns the camera used for LOD when executed with the given lodCamera. @See execute
+        const Camera* _getUsedLodCamera( const Camera *lodCamera ) const
+        {
+            return (lodCamera && mCamera == mLodCamera) ? lodCamera : mLodCamera;
+        }
+
         void _setCustomCamera( Camera *camera )                 { mCamera = camera; }
         void _setUpdateShadowNode( bool update )                { mUpdateShadowNode = update; }
 
@@ -32,7 +32,58 @@ THE SOFTWARE.
 #include "OgrePlatformInformation.h"
 
 #if OGRE_USE_SIMD == 1
-    #if OGRE_CPU == OGRE_CPU_X86
+    #if OGRE_CPU == OGRE_CPU_X86 && __OGRE_HAVE_AVX
+        //x86/x64 - AVX2 + FMA3
+        #if OGRE_DOUBLE_PRECISION == 1
+            #error Double precision with the AVX backend is not supported
+        #endif
+        #include <immintrin.h>
+        #define ARRAY_PACKED_REALS 8
+        namespace Ogre {
+            typedef __m256 ArrayReal;
+            typedef __m256 ArrayMaskR;
+            typedef __m256i ArrayInt;
+            typedef __m256i ArrayMaskI;
+
+            #define ARRAY_REAL_ZERO _mm256_setzero_ps()
+            #define ARRAY_INT_ZERO _mm256_setzero_si256()
+            #define ARRAY_MASK_ZERO _mm256_setzero_ps()
+
+            class ArrayRadian;
+        }
+
+        #define OGRE_PREFETCH_T0( x ) _mm_prefetch( x, _MM_HINT_T0 )
+        #define OGRE_PREFETCH_T1( x ) _mm_prefetch( x, _MM_HINT_T1 )
+        #define OGRE_PREFETCH_T2( x ) _mm_prefetch( x, _MM_HINT_T2 )
+        #define OGRE_PREFETCH_NTA( x ) _mm_prefetch( x, _MM_HINT_NTA )
+
+        //Distance (in ArrayMemoryManager's slots) used to keep fetching data. This also
+        //means the memory manager needs to allocate extra memory for them.
+        #define OGRE_PREFETCH_SLOT_DISTANCE     4*ARRAY_PACKED_REALS //Must be multiple of ARRAY_PACKED_REALS
+
+        ///r = (a * b) + c
+        #define _mm256_madd_ps( a, b, c )   _mm256_fmadd_ps( a, b, c )
+        ///r = -(a * b) + c
+        #define _mm256_nmsub_ps( a, b, c )  _mm256_fnmadd_ps( a, b, c )
+
+        //4-wide versions, still used by AoS code (i.e. SimpleMatrixAf4x3)
+        #define _mm_madd_ps( a, b, c )      _mm_fmadd_ps( a, b, c )
+        #define _mm_nmsub_ps( a, b, c )     _mm_fnmadd_ps( a, b, c )
+
+        /// Does not convert, just cast ArrayReal to ArrayInt
+        #define CastRealToInt( x )          _mm256_castps_si256( x )
+        #define CastIntToReal( x )          _mm256_castsi256_ps( x )
+        /// Input must be 32-byte aligned
+        #define CastArrayToReal( outFloatPtr, arraySimd )       _mm256_store_ps( outFloatPtr, arraySimd )
+
+        /// Loads two 16-byte aligned groups of 4 floats into the low & high 128-bit lanes
+        #define _mm256_load2_m128_ps( loPtr, hiPtr ) \
+            _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_load_ps( loPtr ) ), _mm_load_ps( hiPtr ), 1 )
+        /// Joins two __m128 into the low & high 128-bit lanes
+        #define _mm256_combine_m128_ps( lo, hi ) \
+            _mm256_insertf128_ps( _mm256_castps128_ps256( lo ), hi, 1 )
+
+    #elif OGRE_CPU == OGRE_CPU_X86
         //x86/x64 - SSE2
         #if OGRE_DOUBLE_PRECISION == 1
             #include <emmintrin.h>
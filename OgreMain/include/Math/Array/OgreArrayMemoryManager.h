@@ -317,6 +317,7 @@ namespace Ogre
             WorldMat,
             InheritOrientation,
             InheritScale,
+            Dirty,
             NumMemoryTypes
         };
 
@@ -192,6 +192,16 @@ namespace Ogre
             mVisibilityFlags    += ARRAY_PACKED_REALS;
         }
 
+        void advanceFrustumPack( size_t numAdvance )
+        {
+            mOwner              += ARRAY_PACKED_REALS * numAdvance;
+            mWorldAabb          += numAdvance;
+            mWorldRadius        += ARRAY_PACKED_REALS * numAdvance;
+            mDistanceToCamera   += ARRAY_PACKED_REALS * numAdvance;
+            mUpperDistance      += ARRAY_PACKED_REALS * numAdvance;
+            mVisibilityFlags    += ARRAY_PACKED_REALS * numAdvance;
+        }
+
         /** Advances all pointers needed by InstanceBatch::_updateBounds to the next pack,
             i.e. if we're processing 4 elements at a time, move to the next 4 elements.
         */
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "Math/Array/OgreArrayMemoryManager.h"
 
 #include "Math/Array/OgreTransform.h"
+#include "OgreFastArray.h"
 
 namespace Ogre
 {
@@ -55,10 +56,31 @@ namespace Ogre
     */
     class _OgreExport ObjectMemoryManager : ArrayMemoryManager::RebaseListener
     {
+    public:
+        /// Number of consecutive packs (of ARRAY_PACKED_REALS objects each)
+        /// covered by a single cluster. @see setPackClusterCulling
+        static const size_t NUM_PACKS_PER_CLUSTER;
+
+    private:
         typedef vector<ObjectDataArrayMemoryManager>::type ArrayMemoryManagerVec;
         /// ArrayMemoryManagers grouped by hierarchy depth
         ArrayMemoryManagerVec                   mMemoryManagers;
 
+        struct PackClusters
+        {
+            /// World Aabb enclosing every object in each group of NUM_PACKS_PER_CLUSTER packs.
+            FastArray<Aabb> aabbs;
+            bool            enabled;
+            /// Objects were added, removed or relocated since aabbs was built.
+            bool            dirty;
+
+            PackClusters() : enabled( false ), dirty( true ) {}
+        };
+        typedef vector<PackClusters>::type PackClustersVec;
+
+        /// One entry per render queue, same as mMemoryManagers. @see setPackClusterCulling
+        PackClustersVec                         mPackClusters;
+
         /// Tracks total number of objects in all render queues.
         size_t                                  mTotalObjects;
 
@@ -167,6 +189,40 @@ namespace Ogre
         */
         size_t getFirstObjectData( ObjectData &outObjectData, size_t renderQueue );
 
+        /** Enables keeping a bounding box around every group of NUM_PACKS_PER_CLUSTER packs
+            in the given render queue, so that frustum culling can reject (or accept) all of
+            them at once without testing each object.
+        @remarks
+            This only pays off when objects don't move, which is why it's meant for
+            the SCENE_STATIC memory manager. The clusters are not updated automatically:
+            whoever updates the objects' world bounds must call _updatePackClusters
+            afterwards (SceneManager does this for its static objects).
+        @par
+            Objects are clustered in memory order, which is normally creation order.
+            Creating objects that are close to each other together yields tighter clusters.
+        @param renderQueue
+            Render queue ID.
+        @param bEnable
+            True to enable. Disabled by default.
+        */
+        void setPackClusterCulling( size_t renderQueue, bool bEnable );
+        bool getPackClusterCulling( size_t renderQueue ) const;
+
+        /** Rebuilds the cluster bounds of render queues with pack cluster culling enabled.
+        @param forceRebuild
+            When false, only render queues whose objects were created, removed or
+            relocated are rebuilt. Set it to true if the world bounds have changed.
+        */
+        void _updatePackClusters( bool forceRebuild );
+
+        /** Returns the cluster bounds of the given render queue, to be used for culling.
+            @see setPackClusterCulling
+        @return
+            Null if disabled, or if the clusters are out of date.
+            Otherwise, an array with one Aabb per NUM_PACKS_PER_CLUSTER packs.
+        */
+        const Aabb* _getPackClusters( size_t renderQueue ) const;
+
         //Derived from ArrayMemoryManager::RebaseListener
         virtual void buildDiffList( ArrayMemoryManager::ManagerType managerType, uint16 level,
                                     const MemoryPoolVec &basePtrs,
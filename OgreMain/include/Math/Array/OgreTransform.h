@@ -74,6 +74,10 @@ namespace Ogre
         /// Ours is mInheritScale[mIndex]
         bool    * RESTRICT_ALIAS mInheritScale;
 
+        /// Stores whether this node's transform (or its parent's) changed and needs to be
+        /// recomputed in the next Node::updateAllTransforms. Ours is mDirty[mIndex]
+        bool    * RESTRICT_ALIAS mDirty;
+
         Transform() :
             mIndex( 0 ),
             mParents( 0 ),
@@ -86,7 +90,8 @@ namespace Ogre
             mDerivedScale( 0 ),
             mDerivedTransform( 0 ),
             mInheritOrientation( 0 ),
-            mInheritScale( 0 )
+            mInheritScale( 0 ),
+            mDirty( 0 )
         {
         }
 
@@ -101,6 +106,8 @@ namespace Ogre
             explicit functions are much preferred. @See rebasePtrs
 
             Note that we do NOT copy the mIndex member.
+            The copy is always flagged as dirty, since it's usually made
+            because our parent or depth level is about to change.
         */
         void copy( const Transform &inCopy )
         {
@@ -138,6 +145,7 @@ namespace Ogre
 
             mInheritOrientation[mIndex] = inCopy.mInheritOrientation[inCopy.mIndex];
             mInheritScale[mIndex]       = inCopy.mInheritScale[inCopy.mIndex];
+            mDirty[mIndex]              = true;
         }
 
         /** Rebases all the pointers from our SoA structs so that they point to a new location
@@ -174,6 +182,8 @@ namespace Ogre
                                     newBasePtrs[NodeArrayMemoryManager::InheritOrientation] + diff );
             mInheritScale       = reinterpret_cast<bool*>(
                                     newBasePtrs[NodeArrayMemoryManager::InheritScale] + diff );
+            mDirty              = reinterpret_cast<bool*>(
+                                    newBasePtrs[NodeArrayMemoryManager::Dirty] + diff );
         }
 
         /** Advances all pointers to the next pack, i.e. if we're processing 4 elements at a time, move to
@@ -192,6 +202,7 @@ namespace Ogre
             mDerivedTransform   += ARRAY_PACKED_REALS;
             mInheritOrientation += ARRAY_PACKED_REALS;
             mInheritScale       += ARRAY_PACKED_REALS;
+            mDirty              += ARRAY_PACKED_REALS;
         }
 
         void advancePack( size_t numAdvance )
@@ -207,6 +218,7 @@ namespace Ogre
             mDerivedTransform   += ARRAY_PACKED_REALS * numAdvance;
             mInheritOrientation += ARRAY_PACKED_REALS * numAdvance;
             mInheritScale       += ARRAY_PACKED_REALS * numAdvance;
+            mDirty              += ARRAY_PACKED_REALS * numAdvance;
         }
     };
 }
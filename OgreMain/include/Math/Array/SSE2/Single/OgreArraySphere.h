@@ -79,7 +79,7 @@ namespace Ogre
             Vector3 center;
             mCenter.getAsVector3( center, index );
             out.setCenter( center );
-            out.setRadius( *aliasedRadius );
+            out.setRadius( aliasedRadius[index] );
         }
 
         /// Prefer using @see getAsSphere() because this function may have more
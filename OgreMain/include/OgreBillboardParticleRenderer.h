@@ -203,7 +203,7 @@ namespace v1 {
         const String& getType(void) const;
         /// @copydoc ParticleSystemRenderer::_updateRenderQueue
         void _updateRenderQueue(RenderQueue* queue, Camera *camera, const Camera *lodCamera,
-            list<Particle*>::type& currentParticles, bool cullIndividually,
+            vector<Particle*>::type& currentParticles, bool cullIndividually,
             RenderableArray &outRenderables );
         /// @copydoc ParticleSystemRenderer::_setDatablock
         virtual void _setDatablock( HlmsDatablock *datablock );
@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include "OgrePrerequisites.h"
 #include "Vao/OgreBufferPacked.h"
+#include "Vao/OgreStagingBuffer.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre
@@ -74,6 +75,21 @@ namespace Ogre
                                bool _useTextureBuffers = true );
         };
 
+        /// Accumulated since the last call to resetUploadStats.
+        struct _OgreExport UploadStats
+        {
+            /// Bytes written to the staging buffer (material + extra buffers).
+            size_t  bytesUploaded;
+            /// Amount of ConstBufferPoolUsers that were uploaded.
+            size_t  numDirtyUsers;
+            /// Amount of copies from the staging buffer, after merging contiguous dirty slots.
+            size_t  numCopies;
+            /// Amount of times the staging buffer was mapped.
+            size_t  numUploads;
+
+            UploadStats();
+        };
+
         enum OptimizationStrategy
         {
             /// Optimize for low CPU overhead. Use this on slow CPUs (i.e. older AMD CPU
@@ -109,8 +125,18 @@ namespace Ogre
 
         OptimizationStrategy    mOptimizationStrategy;
 
+        /// Kept around to avoid reallocating every upload.
+        StagingBuffer::DestinationVec   mUploadDestinations;
+        StagingBuffer::DestinationVec   mUploadExtraDestinations;
+
+        UploadStats             mUploadStats;
+
         void destroyAllPools(void);
 
+        /** Uploads all the users scheduled for update using a single staging buffer.
+            Dirty users that sit in consecutive slots of the same pool get merged
+            into a single copy.
+        */
         void uploadDirtyDatablocks(void);
 
     public:
@@ -137,6 +163,9 @@ namespace Ogre
         virtual void setOptimizationStrategy( OptimizationStrategy optimizationStrategy );
         OptimizationStrategy getOptimizationStrategy() const;
 
+        const UploadStats& getUploadStats(void) const                   { return mUploadStats; }
+        void resetUploadStats(void);
+
         virtual void _changeRenderSystem( RenderSystem *newRs );
     };
 
@@ -171,7 +200,8 @@ namespace Ogre
     inline bool OrderConstBufferPoolUserByPoolThenSlot( const ConstBufferPoolUser *_l,
                                                         const ConstBufferPoolUser *_r )
     {
-        return _l->mAssignedPool < _r->mAssignedPool && _l->mAssignedSlot < _r->mAssignedSlot;
+        return  _l->mAssignedPool < _r->mAssignedPool ||
+                (_l->mAssignedPool == _r->mAssignedPool && _l->mAssignedSlot < _r->mAssignedSlot);
     }
 
     /** @} */
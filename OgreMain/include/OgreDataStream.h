@@ -475,6 +475,35 @@ namespace Ogre {
         void setFreeOnClose(bool free) { mFreeOnClose = free; }
     };
 
+    /** Common subclass of DataStream for handling read-only files mapped into memory.
+    @remarks
+        Reading from the stream copies straight from the mapped pages, without
+        reading the whole file upfront. Users that can consume the data in place
+        (see MemoryDataStream::getCurrentPtr) avoid copying it altogether.
+    */
+    class _OgreExport MappedFileDataStream : public MemoryDataStream
+    {
+    public:
+        /** Wraps a file mapped with mapFile. The stream takes ownership of the mapping.
+        @param name The name to give the stream
+        @param mappedData The value returned by mapFile
+        @param size The size of the file in bytes
+        */
+        MappedFileDataStream( const String &name, void *mappedData, size_t size );
+        ~MappedFileDataStream();
+
+        /** Maps the whole file as read only.
+        @return
+            Null if the file couldn't be mapped or the platform doesn't support it,
+            in which case the caller should fall back to regular file streams.
+        */
+        static void* mapFile( const String &fullPath, size_t size );
+
+        /** @copydoc DataStream::close
+        */
+        void close(void);
+    };
+
     /** Common subclass of DataStream for handling data from 
         std::basic_istream.
     */
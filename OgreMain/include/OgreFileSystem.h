@@ -120,7 +120,26 @@ namespace Ogre {
             return msIgnoreHidden;
         }
 
+        /** Set whether files opened as read only get mapped into memory instead of
+            being read through a file stream (@see MappedFileDataStream).
+            Loaders that can consume the data in place (i.e. v2 meshes) can then
+            skip copying the file contents around. Falls back to regular streams
+            when the platform doesn't support it or the mapping fails.
+            The default is false.
+        */
+        static void setUseMemoryMapping(bool useMemoryMapping)
+        {
+            msUseMemoryMapping = useMemoryMapping;
+        }
+
+        /// Get whether read only files are mapped into memory.
+        static bool getUseMemoryMapping()
+        {
+            return msUseMemoryMapping;
+        }
+
         static bool msIgnoreHidden;
+        static bool msUseMemoryMapping;
     };
 
     /** Specialisation of ArchiveFactory for FileSystem files. */
@@ -30,8 +30,13 @@ THE SOFTWARE.
 
 #include "OgrePrerequisites.h"
 #include "OgreCommon.h"
+#include "OgreMatrix4.h"
+#include "OgreSphere.h"
 #include "OgreHeaderPrefix.h"
 
+/// Unit tests, which need access to the internals of Forward3D.
+class Forward3DTests;
+
 namespace Ogre
 {
     /** \addtogroup Core
@@ -42,10 +47,16 @@ namespace Ogre
     */
 
     class CompositorShadowNode;
+    class Forward3DLightProjectTask;
+    class Forward3DGridFillTask;
 
     /** Forward3D */
     class _OgreExport Forward3D : public PassAlloc
     {
+        friend class Forward3DLightProjectTask;
+        friend class Forward3DGridFillTask;
+        friend class ::Forward3DTests;
+
         struct Resolution
         {
             uint32 width;
@@ -56,6 +67,27 @@ namespace Ogre
                 width( w ), height( h ), zEnd( _zEnd ) {}
         };
 
+        /// Cells occupied by a light in a given slice, in grid space (inclusive).
+        /// Slices the light doesn't touch have startY > endY.
+        struct LightRect
+        {
+            uint32  startX;
+            uint32  startY;
+            uint32  endX;
+            uint32  endY;
+        };
+
+        /// Projection of a static light from the last time the grid was built.
+        struct StaticLightEntry
+        {
+            Light const *light;
+            /// World space bounding sphere used to project the light. If it changed,
+            /// the light was moved (@see SceneManager::notifyStaticDirty).
+            Sphere      worldSphere;
+            /// Index to the first of mNumSlices rects in CachedGrid::staticLightRects
+            uint32      rectStart;
+        };
+
         struct CachedGrid
         {
             Camera                  *camera;
@@ -70,6 +102,14 @@ namespace Ogre
 
             TexBufferPacked         *gridBuffer;
             TexBufferPacked         *globalLightListBuffer;
+
+            /// View & projection matrices the grid was last built with.
+            Matrix4                 viewMatrix;
+            Matrix4                 projMatrix;
+            /// Rects of the static lights, sorted by Light pointer. Only filled while the
+            /// camera stays still, so they can be reused instead of projected again.
+            FastArray<StaticLightEntry> staticLights;
+            FastArray<LightRect>        staticLightRects;
         };
 
         typedef vector<CachedGrid>::type CachedGridVec;
@@ -85,9 +125,16 @@ namespace Ogre
         FastArray<Resolution>   mResolutionAtSlice;
         FastArray<uint32>       mLightCountInCell;
 
+        /// mNumSlices rects per light in mCurrentLightList.
+        FastArray<LightRect>    mLightRects;
+        /// World space bounding sphere of each light in mCurrentLightList.
+        FastArray<Sphere>       mLightWorldSpheres;
+
         float   mMinDistance;
         float   mMaxDistance;
         float   mInvMaxDistance;
+        float   mDepthSliceExponent;
+        float   mExpSliceScale; /// 2^mDepthSliceExponent - 1
 
         VaoManager      *mVaoManager;
         SceneManager    *mSceneManager;
@@ -96,7 +143,7 @@ namespace Ogre
         bool    mFadeAttenuationRange;
 
         /// Performs the reverse of getSliceAtDepth. @see getSliceAtDepth.
-        inline Real getDepthAtSlice( uint32 slice ) const;
+        Real getDepthAtSlice( uint32 slice ) const;
 
         /** Returns the slice index at the given depth
         @param depth
@@ -104,7 +151,7 @@ namespace Ogre
         @return
             Slice index, in range [0; mNumSlices)
         */
-        inline uint32 getSliceAtDepth( Real depth ) const;
+        uint32 getSliceAtDepth( Real depth ) const;
 
         /** Converts a vector in projection space to grid space from the specified slice index.
         @param projSpace
@@ -121,6 +168,57 @@ namespace Ogre
         inline void projectionSpaceToGridSpace( const Vector2 &projSpace, uint32 slice,
                                                 uint32 &outX, uint32 &outY ) const;
 
+        /// Recalculates mResolutionAtSlice[i].zEnd after the slicing changed.
+        void updateSliceDepths(void);
+
+        /** Projects the lights in range [lightStart; lightEnd) from mCurrentLightList onto
+            the slices of the grid, writing their rects to mLightRects. Thread safe.
+        @param lightStart
+            Index to the first light. Must be a multiple of ARRAY_PACKED_REALS.
+        @param cachedGrid
+            Grid whose static light rects from the previous update can be reused.
+            Null if there's nothing to reuse (i.e. the camera moved).
+        */
+        void projectLights( size_t lightStart, size_t lightEnd, const Matrix4 &viewMatrix,
+                            const Matrix4 &projMatrix, const Real *projSpaceSliceEnd,
+                            Real nearPlane, Real farPlane, const CachedGrid *cachedGrid );
+
+        /** Calculates the rects of a single light, given the corners of the front
+            and back faces of its bounds in projection space. Thread safe.
+        @param bottomLeft
+            [0] = bottom left corner of the front face, [1] = of the back face.
+            x & y in range [0; 1], z is projection space depth.
+        @param topRight
+            Same as bottomLeft, for the top right corners.
+        @param outRects [out]
+            Array of mNumSlices rects to fill.
+        */
+        void calculateLightRects( const Vector3 bottomLeft[2], const Vector3 topRight[2],
+                                  uint32 minSlice, uint32 maxSlice,
+                                  const Real *projSpaceSliceEnd, LightRect *outRects ) const;
+
+        /** Assigns the lights to the cells of the given rows of a slice, in mCurrentLightList
+            order (closest first), and writes the light count of those cells. Thread safe,
+            as long as every call writes to different rows.
+        */
+        void fillGridRows( uint16 * RESTRICT_ALIAS gridBuffer, uint32 slice,
+                           uint32 rowStart, uint32 rowEnd );
+
+        /** Projects the lights in mCurrentLightList and assigns them to the cells of the grid.
+        @param gridBuffer
+            Mapped grid buffer to fill. Cells with fewer lights than mLightsPerCell - 1
+            keep whatever was in their unused slots.
+        @param numChunks
+            How many chunks to split the work in. 0 or 1 runs everything serially on the
+            calling thread; otherwise the chunks are run on the SceneManager's worker threads.
+            The result is the same either way.
+        */
+        void fillGrid( Camera *camera, CachedGrid *cachedGrid,
+                       uint16 * RESTRICT_ALIAS gridBuffer, size_t numChunks );
+
+        /// Keeps the rects of the static lights from mCurrentLightList in the cache.
+        void cacheStaticLights( CachedGrid *cachedGrid );
+
         void fillGlobalLightListBuffer( Camera *camera, TexBufferPacked *globalLightListBuffer );
 
         /** Finds a grid already cached in mCachedGrid that can be used for the given camera.
@@ -166,6 +264,17 @@ namespace Ogre
         void fillConstBufferData( RenderTarget *renderTarget,
                                   float * RESTRICT_ALIAS passBufferPtr ) const;
 
+        /** Distributes the depth slices exponentially instead of linearly, making the
+            slices near the camera thinner and the distant ones thicker. Each slice is
+            2^(exponent / (numSlices - 1)) times thicker than the previous one.
+        @remarks
+            The shaders need to be regenerated, which happens automatically.
+        @param exponent
+            0 to use linear slices (default). Must not be negative.
+        */
+        void setDepthSliceExponent( float exponent );
+        float getDepthSliceExponent(void) const                         { return mDepthSliceExponent; }
+
         /// Turns on visualization of light cell occupancy
         void setDebugMode( bool debugMode )                             { mDebugMode = debugMode; }
         bool getDebugMode(void) const                                   { return mDebugMode; }
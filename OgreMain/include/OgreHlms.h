@@ -78,10 +78,13 @@ namespace Ogre
         {
             HlmsPropertyVec setProperties;
             PiecesMap       pieces[NumShaderTypes];
+            /// Hash of setProperties & pieces. @see calculateRenderableCacheHash
+            uint64          hash;
 
             RenderableCache( const HlmsPropertyVec &properties,
                              const PiecesMap *_pieces ) :
-                setProperties( properties )
+                setProperties( properties ),
+                hash( 0 )
             {
                 if( _pieces )
                 {
@@ -96,7 +99,7 @@ namespace Ogre
                 for( size_t i=0; i<NumShaderTypes; ++i )
                     piecesEqual &= pieces[i] == _r.pieces[i];
 
-                return setProperties == _r.setProperties && piecesEqual;
+                return hash == _r.hash && setProperties == _r.setProperties && piecesEqual;
             }
         };
 
@@ -117,6 +120,56 @@ namespace Ogre
         PassCacheVec        mPassCache;
         RenderableCacheVec  mRenderableCache;
         HlmsCacheVec        mShaderCache;
+        /// Open addressed hash tables (size is always power of 2, load factor <= 0.5)
+        /// to find entries in mRenderableCache & mShaderCache in O(1).
+        /// mRenderableCacheIndex holds the index + 1 (0 means empty slot).
+        vector<uint32>::type    mRenderableCacheIndex;
+        HlmsCacheVec            mShaderCacheIndex;
+        /// Incremented every time mShaderCache is cleared, so that those
+        /// holding on to HlmsCache pointers know they're now dangling.
+        uint32              mShaderCacheGeneration;
+
+        /// The output of parsing the templates for a given set of input properties
+        /// and pieces. @see setShaderCodeCacheEnabled
+        struct ShaderCodeCache
+        {
+            /// Hash of inProperties & piecesHash. Used for sorting.
+            uint32          hash;
+            /// Properties before parsing the templates.
+            HlmsPropertyVec inProperties;
+            /// Hash of the renderable's pieces for all stages.
+            uint64          piecesHash[2];
+            /// Properties after parsing the templates (they may set properties).
+            HlmsPropertyVec outProperties;
+            /// Generated source code. Empty if the stage doesn't exist or was disabled.
+            String          source[NumShaderTypes];
+
+            bool operator < ( const ShaderCodeCache &_r ) const     { return hash < _r.hash; }
+        };
+
+        typedef vector<ShaderCodeCache>::type ShaderCodeCacheVec;
+
+        ShaderCodeCacheVec  mShaderCodeCache;
+        bool                mShaderCodeCacheEnabled;
+        size_t              mShaderCodeCacheHits;
+        size_t              mTemplateParses;
+
+        /// Max number of shaders getMaterial may create per frame when the caller
+        /// can skip the renderable. 0 for no limit. @see setShaderCreationBudget
+        uint32              mShaderCreationBudget;
+        uint32              mShadersCreatedThisFrame;
+        unsigned long       mShaderCreationFrame;
+        /// Number of times getMaterial returned null due to mShaderCreationBudget.
+        size_t              mNumDeferredShaders;
+
+        /// When false, mTemplateSources & the pieceFileSources need to be (re)loaded
+        /// from the archives. @see loadTemplateSources
+        bool            mTemplateSourcesLoaded;
+        /// Contents of the main template file for each stage (empty if it doesn't exist)
+        String          mTemplateSources[NumShaderTypes];
+        /// Scratch buffers used by the parser. Kept around so that their capacity
+        /// survives across shaders and parsing doesn't hit the heap.
+        String          mParseBuffer[2];
 
         HlmsPropertyVec mSetProperties;
         PiecesMap       mPieces;
@@ -126,6 +179,8 @@ namespace Ogre
         {
             Archive         *dataFolder;
             StringVector    pieceFiles[NumShaderTypes];
+            /// Contents of pieceFiles. Empty for files of other shading languages.
+            StringVector    pieceFileSources[NumShaderTypes];
         };
 
         typedef vector<Library>::type LibraryVec;
@@ -133,6 +188,7 @@ namespace Ogre
         LibraryVec      mLibrary;
         Archive         *mDataFolder;
         StringVector    mPieceFiles[NumShaderTypes];
+        StringVector    mPieceFileSources[NumShaderTypes];
         HlmsManager     *mHlmsManager;
 
         LightGatheringMode  mLightGatheringMode;
@@ -263,11 +319,39 @@ namespace Ogre
         /// Retrieves a cache entry using the returned value from @addRenderableCache
         const RenderableCache& getRenderableCache( uint32 hash ) const;
 
+        /// Hashes the contents of all the template & piece files (from the libraries too).
+        void calculateTemplatesHash( uint64 outHash[2] ) const;
+        /// Hashes the contents of all the pieces (i.e. NumShaderTypes maps).
+        static void calculatePiecesHash( const PiecesMap *pieces, uint64 outHash[2] );
+        /// Hashes the keys & values of the properties.
+        static uint32 calculatePropertiesHash( const HlmsPropertyVec &properties, uint32 seed );
+        static uint64 calculateRenderableCacheHash( const RenderableCache &renderableCache );
+
+        /// Slot in an open addressed table of size mask+1 where to start looking for the hash.
+        static size_t getHashTableSlot( uint64 hash, size_t mask );
+        void rebuildRenderableCacheIndex( size_t newSize );
+        void rebuildShaderCacheIndex( size_t newSize );
+
+        /// Returns the entry in mShaderCodeCache that matches mSetProperties and
+        /// the given pieces; null if not found. outPiecesHash & outHash are always filled.
+        const ShaderCodeCache* findShaderCodeCache( const PiecesMap *pieces,
+                                                    uint64 outPiecesHash[2],
+                                                    uint32 &outHash ) const;
+
         const HlmsCache* addShaderCache( uint32 hash, const HlmsPso &pso );
         const HlmsCache* getShaderCache( uint32 hash ) const;
         virtual void clearShaderCache(void);
 
-        void processPieces( Archive *archive, const StringVector &pieceFiles );
+        /** Reads the template & piece files matching mShaderFileExt into memory, so that
+            generating a shader doesn't need to open the archives again. Does nothing
+            if they're already loaded.
+        */
+        void loadTemplateSources(void);
+        /// Reads the file from the archive if it exists, otherwise clears outSource.
+        static void readTemplateSource( Archive *archive, const String &filename,
+                                        String &outSource );
+        /// Runs the piece files' source (see loadTemplateSources) through the parser.
+        void processPieces( const StringVector &pieceFileSources );
 
         /** Creates a shader based on input parameters. Caller is responsible for ensuring
             this shader hasn't already been created.
@@ -328,6 +412,8 @@ namespace Ogre
         const String& getTypeNameStr(void) const            { return mTypeNameStr; }
         void _notifyManager( HlmsManager *manager )         { mHlmsManager = manager; }
         HlmsManager* getHlmsManager(void) const             { return mHlmsManager; }
+        /// @See mShaderCacheGeneration
+        uint32 _getShaderCacheGeneration(void) const        { return mShaderCacheGeneration; }
 
         /** Sets the quality of the Hlms. This function is most relevant for mobile and
             almost or completely ignored by Desktop.
@@ -495,12 +581,34 @@ namespace Ogre
             should cast shadows)
         @param casterPass
             True if this pass is the shadow mapping caster pass, false otherwise
+        @param canDefer
+            True if the caller can cope with a null return value, by skipping the renderable.
+            @see setShaderCreationBudget
         @return
-            Structure containing all necessary shaders
+            Structure containing all necessary shaders. Null only if canDefer is true and
+            the shader has been deferred to a later frame.
         */
         const HlmsCache* getMaterial( HlmsCache const *lastReturnedValue, const HlmsCache &passCache,
                                       const QueuedRenderable &queuedRenderable, uint8 inputLayout,
-                                      bool casterPass );
+                                      bool casterPass, bool canDefer=false );
+
+        /** Limits how many new shaders may be created per frame for renderables that can
+            be skipped (i.e. the RenderQueue's FAST & V1_FAST modes). Renderables whose
+            shaders don't fit in this frame's budget are not drawn, and their shaders
+            get created in the next frames as they keep becoming visible.
+        @remarks
+            Trades a few frames of missing objects for the big frame time spikes of
+            parsing & compiling many shaders at once (i.e. when new materials stream in).
+            The shaders can't be generated in other threads, because the template parser
+            works on this Hlms' state and programs must be created in the rendering thread.
+        @param maxShadersPerFrame
+            0 to disable (default). Otherwise the max number of shaders to create per frame.
+        */
+        void setShaderCreationBudget( uint32 maxShadersPerFrame );
+        uint32 getShaderCreationBudget(void) const          { return mShaderCreationBudget; }
+
+        /// Number of times a renderable was skipped because its shader was deferred.
+        size_t getNumDeferredShaders(void) const            { return mNumDeferredShaders; }
 
         /** Fills the constant buffers. Gets executed right before drawing the mesh.
         @param cache
@@ -551,6 +659,38 @@ namespace Ogre
         */
         void setDebugOutputPath( bool enableDebugOutput, const String &path = BLANKSTRING );
 
+        /** When enabled, the source code generated from the templates is kept in memory,
+            keyed by the properties and pieces that generated it, so that shaders can be
+            recreated without parsing the templates again (i.e. after clearShaderCache,
+            or in the next run via saveShaderCodeCache & loadShaderCodeCache).
+        @remarks
+            The program binaries aren't stored here. Since the generated source code
+            is identical, enable GpuProgramManager::setSaveMicrocodesToCache and
+            save/load its microcode cache as well to also skip shader compilation
+            in RenderSystems that support it.
+            Disabling it frees the cached code.
+        */
+        void setShaderCodeCacheEnabled( bool bEnable );
+        bool getShaderCodeCacheEnabled(void) const          { return mShaderCodeCacheEnabled; }
+
+        /** Saves the shader code cache to a stream. The templates' contents are hashed
+            so that the cache is discarded on load if the templates were modified.
+        */
+        void saveShaderCodeCache( DataStreamPtr &dataStream ) const;
+
+        /** Loads a shader code cache saved with saveShaderCodeCache. Enables the cache.
+            The contents will be ignored (and a message logged) if it was generated with
+            different templates or for another shading language.
+        @remarks
+            Must be called after the RenderSystem has been set.
+        */
+        void loadShaderCodeCache( DataStreamPtr &dataStream );
+
+        /// Number of shaders created from the shader code cache, without parsing templates.
+        size_t getShaderCodeCacheHits(void) const           { return mShaderCodeCacheHits; }
+        /// Number of shaders that had to be created by parsing the templates.
+        size_t getNumTemplateParses(void) const             { return mTemplateParses; }
+
         /** Sets a listener to extend an existing Hlms implementation's with custom code,
             without having to rewrite it or modify the source code directly.
         @remarks
@@ -649,6 +789,7 @@ namespace Ogre
         static const IdString Forward3DFlipY;
         static const IdString Forward3DDebug;
         static const IdString Forward3DFadeAttenRange;
+        static const IdString Forward3DExponential;
         static const IdString VPos;
 
         //Change per material (hash can be cached on the renderable)
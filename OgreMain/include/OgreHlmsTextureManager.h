@@ -185,6 +185,8 @@ namespace Ogre
         };
 
         RenderSystem        *mRenderSystem;
+        /// When not null, its worker threads are used to generate mipmaps.
+        SceneManager        *mWorkerThreadsSceneManager;
 
         typedef vector<TextureEntry>::type TextureEntryVec;
         typedef vector<TextureArray>::type TextureArrayVec;
@@ -291,6 +293,19 @@ namespace Ogre
         void dumpMemoryUsage(void) const;
 
         DefaultTextureParameters* getDefaultTextureParameters(void) { return mDefaultTextureParameters; }
+
+        /** Sets the SceneManager whose worker threads will be used to generate the mipmaps
+            of the textures loaded from now on. See Image::generateMipmaps.
+        @remarks
+            Textures must then not be loaded while the SceneManager is updating, or from
+            one of its worker threads.
+            Don't forget to set it back to null before destroying the SceneManager.
+        @param sceneManager
+            Null to generate them in the calling thread (default).
+        */
+        void setWorkerThreadsSceneManager( SceneManager *sceneManager )
+                                                        { mWorkerThreadsSceneManager = sceneManager; }
+        SceneManager* getWorkerThreadsSceneManager(void) const { return mWorkerThreadsSceneManager; }
     };
 
     /** @} */
@@ -479,10 +479,15 @@ namespace Ogre {
             True if the filter should be applied in linear space.
         @param filter
             The type of filter to use.
+        @param sceneManager
+            Optional. When present, each mip is split in bands of rows that are
+            downsampled in its worker threads. Don't use it while the SceneManager
+            is updating, or from one of its worker threads.
         @return
             False if failed to generate and mipmaps properties won't be changed. True on success.
         */
-        bool generateMipmaps( bool gammaCorrected, Filter filter = FILTER_BILINEAR );
+        bool generateMipmaps( bool gammaCorrected, Filter filter = FILTER_BILINEAR,
+                              SceneManager *sceneManager = 0 );
         
         /// Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static size_t calculateSize(size_t mipmaps, size_t faces, uint32 width, uint32 height, uint32 depth, PixelFormat format);
@@ -46,13 +46,19 @@ namespace Ogre
     @param kernelEndX
     @param kernelStartY
     @param kernelEndY
+    @param dstRowStart
+        First row of dstPtr to write. Range is [dstRowStart; dstRowEnd)
+        dstPtr & srcPtr always point to the start of the image, so that
+        different rows can be written from different threads.
+    @param dstRowEnd
      */
     typedef void (ImageDownsampler2D)( uint8 *dstPtr, uint8 const *srcPtr,
                                        int32 dstWidth, int32 dstHeight,
                                        int32 srcWidth,
                                        const uint8 kernel[5][5],
                                        const int8 kernelStartX, const int8 kernelEndX,
-                                       const int8 kernelStartY, const int8 kernelEndY );
+                                       const int8 kernelStartY, const int8 kernelEndY,
+                                       int32 dstRowStart, int32 dstRowEnd );
 
     ImageDownsampler2D downscale2x_XXXA8888;
     ImageDownsampler2D downscale2x_XXX888;
@@ -71,7 +77,7 @@ namespace Ogre
                                        const uint8 kernel[5][5],
                                        const int8 kernelStartX, const int8 kernelEndX,
                                        const int8 kernelStartY, const int8 kernelEndY,
-                                       uint8 currentFace );
+                                       uint8 currentFace, int32 dstRowStart, int32 dstRowEnd );
 
     ImageDownsamplerCube downscale2x_XXXA8888_cube;
     ImageDownsamplerCube downscale2x_XXX888_cube;
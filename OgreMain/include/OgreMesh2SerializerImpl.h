@@ -179,6 +179,16 @@ namespace Ogre {
         virtual void createSubMeshVao( SubMesh *sm, const SubMeshLodVec &submeshLods,
                                        uint8 numVaoPasses );
 
+        /// Frees the vertex and/or index data of the submesh lods that we own
+        /// (i.e. the one not read in place, nor handed to the VaoManager as shadow copy).
+        void freeSubMeshLodData( SubMeshLodVec &submeshLods, bool vertexData, bool indexData );
+
+        /// When the stream is a MemoryDataStream (i.e. prebuffered or a mapped file) we can
+        /// point straight into it instead of allocating and copying the vertex & index data.
+        /// Only possible when there's no endian conversion and the data isn't kept as a
+        /// shadow copy (the VaoManager would take ownership of the pointer).
+        void prepareInPlaceReads( DataStreamPtr &stream, const Mesh *pMesh );
+
         /// Flip an entire vertex buffer to/from little endian
         /// working on the data pointer passed in pData
         void flipLittleEndian( void* pData, VertexBufferPacked *vertexBuffer );
@@ -196,6 +206,11 @@ namespace Ogre {
 
         ushort exportedLodCount; // Needed to limit exported Edge data, when exporting
         VaoManager *mVaoManager;
+
+        /// @see prepareInPlaceReads
+        MemoryDataStream    *mInPlaceStream;
+        bool                mInPlaceVertexData;
+        bool                mInPlaceIndexData;
     };
 
     class _OgrePrivate MeshSerializerImpl_v2_1_R1 : public MeshSerializerImpl
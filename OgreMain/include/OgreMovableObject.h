@@ -248,11 +248,47 @@ namespace Ogre {
             Camera in which lod levels calculations are based (i.e. during shadow pass renders)
             Note however, we only use this camera to calulate if should be visible according to
             mUpperDistance
+        @param packClusters
+            Optional. Bounds of each group of ObjectMemoryManager::NUM_PACKS_PER_CLUSTER packs
+            (@see ObjectMemoryManager::_getPackClusters). Clusters that are fully outside
+            the frustum are skipped without looking at their objects.
+        @param firstPackIdx
+            Index of the pack 't' points to, relative to the first pack in packClusters.
+            Ignored if packClusters is null.
         */
         typedef FastArray<MovableObject*> MovableObjectArray;
         static void cullFrustum( const size_t numNodes, ObjectData t, const Camera *frustum,
                                  uint32 sceneVisibilityFlags, MovableObjectArray &outCulledObjects,
-                                 const Camera *lodCamera );
+                                 const Camera *lodCamera, const Aabb *packClusters=0,
+                                 size_t firstPackIdx=0 );
+
+        /// Maximum number of frustums that can be passed to cullFrustumBatch at once.
+        static const size_t MAX_FRUSTUMS_PER_BATCH;
+
+        /** Same as cullFrustum, but tests every object against multiple frustums in a single
+            pass, so that the object data is only read once from memory for all of them.
+            @See SceneManager::cullFrustumBatch
+        @remarks
+            Unlike cullFrustum, this function does not update the cached distance to the
+            camera, since there is more than one. @See _updateCachedDistanceToCamera
+        @param frustums
+            Array of numFrustums frustums to clip against.
+        @param lodCameras
+            Array of numFrustums cameras. @See cullFrustum's lodCamera param
+        @param sceneVisibilityFlags
+            Array of numFrustums visibility flags. @See cullFrustum
+        @param numFrustums
+            Number of frustums. Must not be greater than MAX_FRUSTUMS_PER_BATCH
+        @param outCulledObjects
+            Array of numFrustums pointers. Out. Each list receives the
+            objects that are visible from the frustum at the same index.
+        */
+        static void cullFrustumBatch( const size_t numNodes, ObjectData t,
+                                      const Camera * const *frustums,
+                                      const Camera * const *lodCameras,
+                                      const uint32 *sceneVisibilityFlags, size_t numFrustums,
+                                      MovableObjectArray * const *outCulledObjects,
+                                      const Aabb *packClusters=0, size_t firstPackIdx=0 );
 
         /// @See InstancingTheadedCullingMethod, @see InstanceBatch::instanceBatchCullFrustumThreaded
         virtual void instanceBatchCullFrustumThreaded( const Frustum *frustum, const Camera *lodCamera,
@@ -462,6 +498,11 @@ namespace Ogre {
         /// Returns the distance to camera as calculated in @cullFrustum
         inline Real getCachedDistanceToCameraAsReal(void) const;
 
+        /** Recalculates the distance to camera that is normally calculated in @cullFrustum.
+            Needed when the object was culled with @cullFrustumBatch.
+        */
+        inline void _updateCachedDistanceToCamera( const Vector3 &cameraPos );
+
         /** Sets the visibility flags for this object.
         @remarks
             As well as a simple true/false value for visibility (as seen in setVisible), 
@@ -50,6 +50,13 @@ namespace Ogre
         return (reinterpret_cast<Real*RESTRICT_ALIAS>(mObjectData.mDistanceToCamera))[mObjectData.mIndex];
     }
     //-----------------------------------------------------------------------------------
+    inline void MovableObject::_updateCachedDistanceToCamera( const Vector3 &cameraPos )
+    {
+        const Real distance = cameraPos.distance( getWorldAabb().mCenter ) - getWorldRadius();
+        (reinterpret_cast<Real*RESTRICT_ALIAS>(mObjectData.mDistanceToCamera))[mObjectData.mIndex] =
+                distance;
+    }
+    //-----------------------------------------------------------------------------------
     inline void MovableObject::setVisibilityFlags( uint32 flags )
     {
         mObjectData.mVisibilityFlags[mObjectData.mIndex] =
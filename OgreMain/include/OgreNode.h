@@ -235,6 +235,12 @@ namespace Ogre {
         /// Returns a direct access to the Transform state
         Transform& _getTransform()                                      { return mTransform; }
 
+        /** Flags our transform to be recomputed in the next updateAllTransforms.
+            All setters (setPosition, rotate, etc) already do this. Only needed
+            when modifying the Transform directly through _getTransform.
+        */
+        void _setTransformDirty(void)                   { mTransform.mDirty[mTransform.mIndex] = true; }
+
         /// Called by SceneManager when it is telling we're a static node being dirty
         /// Don't call this directly. @see SceneManager::notifyStaticDirty
         virtual void _notifyStaticDirty(void) const;
@@ -677,8 +683,13 @@ namespace Ogre {
         /** @See SceneManager::updateAllTransforms()
         @remarks
             We don't pass by reference on purpose (avoid implicit aliasing)
+            Packs where neither the nodes nor their parents are dirty are skipped.
+            Recomputed nodes stay flagged as dirty so their children get updated
+            too; the caller must clear the flags once all depth levels are done.
+        @return
+            The number of nodes whose transforms were actually recomputed.
         */
-        static void updateAllTransforms( const size_t numNodes, Transform t );
+        static size_t updateAllTransforms( const size_t numNodes, Transform t );
         
         /** Gets the local position, relative to this node, of the given world-space position */
         virtual_l2 Vector3 convertWorldToLocalPosition( const Vector3 &worldPos );
@@ -354,6 +354,38 @@ namespace Ogre {
         */
         ParticleIterator _getIterator(void);
 
+        /** Returns the active particles, for affectors that want to process them in blocks.
+        @remarks
+            The order of the particles is not stable; expired particles are swapped with
+            the last active one. Do not add or remove particles while iterating.
+        */
+        const vector<Particle*>::type& _getActiveParticles(void) const { return mActiveParticles; }
+
+        /** Queues an update of the particles for the next SceneManager::updateSceneGraph.
+        @remarks
+            This is called automatically every frame by OGRE. Queued systems are updated in
+            parallel using the SceneManager's worker threads. Calling this more than once
+            before the update executes accumulates the elapsed time.
+            If threaded updates are disabled (see setDefaultThreadedUpdate) or the system
+            has no SceneManager, this is equivalent to calling _update.
+        @param
+            timeElapsed The amount of time, in seconds, since the last frame.
+        */
+        void _queueUpdate(Real timeElapsed);
+
+        /** Performs the work of _update that must happen in the main thread (i.e. creating
+            renderer buffers, cloning emitted emitters) before the queued update executes.
+        @remarks
+            Called by the SceneManager; don't call this directly.
+        */
+        void _prepareQueuedUpdate(void);
+
+        /** Executes the update queued with _queueUpdate. May be called from a worker thread.
+        @remarks
+            Called by the SceneManager; don't call this directly.
+        */
+        void _executeQueuedUpdate(void);
+
         /** Sets the name of the material to be used for this billboard set.
             @param
                 name The new name of the material to use for this set.
@@ -463,6 +495,20 @@ namespace Ogre {
         */
         static Real getDefaultNonVisibleUpdateTimeout(void) { return msDefaultNonvisibleTimeout; }
 
+        /** Sets whether ParticleSystem instances are updated in parallel by the SceneManager.
+        @remarks
+            When true, the time controller queues the update which is then
+            executed from the worker threads in SceneManager::updateSceneGraph, after the
+            node transforms have been updated. Custom emitters and affectors must then be
+            safe to run concurrently on different systems.
+            When false (default), systems are updated serially by the ControllerManager.
+        */
+        static void setDefaultThreadedUpdate(bool threaded) { msDefaultThreadedUpdate = threaded; }
+
+        /** Gets whether ParticleSystem instances are updated in parallel by the SceneManager.
+        */
+        static bool getDefaultThreadedUpdate(void) { return msDefaultThreadedUpdate; }
+
         /** Overridden from MovableObject */
         const String& getMovableType(void) const;
 
@@ -666,8 +712,15 @@ namespace Ogre {
         /// Used to control if the particle system should emit particles or not.
         bool mIsEmitting;
 
-        typedef list<Particle*>::type ActiveParticleList;
-        typedef list<Particle*>::type FreeParticleList;
+        /// Time accumulated by _queueUpdate, pending execution
+        Real mQueuedUpdateTime;
+        /// Whether this system is in its SceneManager's queue of particle system updates
+        bool mUpdateQueued;
+        /// Whether _update is being called from _executeQueuedUpdate
+        bool mExecutingQueuedUpdate;
+
+        typedef vector<Particle*>::type ActiveParticleList;
+        typedef vector<Particle*>::type FreeParticleList;
         typedef vector<Particle*>::type ParticlePool;
 
         /** Sort by direction functor */
@@ -694,12 +747,12 @@ namespace Ogre {
 
         /** Active particle list.
             @remarks
-                This is a linked list of pointers to particles in the particle pool.
+                This is a contiguous array of pointers to particles in the particle pool.
             @par
-                This allows very fast insertions and deletions from anywhere in 
-                the list to activate / deactivate particles as well as reuse of 
-                Particle instances in the pool without construction & destruction 
-                which avoids memory thrashing.
+                Particles are appended when emitted and removed by swapping with the
+                last element, so activation / deactivation are O(1) while iterating
+                stays cache friendly. Particle instances in the pool are reused
+                without construction & destruction which avoids memory thrashing.
         */
         ActiveParticleList mActiveParticles;
 
@@ -708,7 +761,7 @@ namespace Ogre {
                 This contains a list of the particles free for use as new instances
                 as required by the set. Particle instances are preconstructed up 
                 to the estimated size in the mParticlePool vector and are 
-                referenced on this deque at startup. As they get used this list
+                referenced on this stack at startup. As they get used this list
                 reduces, as they get released back to to the set they get added
                 back to the list.
         */
@@ -720,6 +773,15 @@ namespace Ogre {
         */
         ParticlePool mParticlePool;
 
+        /** Arrays of Particle the pool points to. Each increase of the pool allocates
+            a single contiguous block, so particles emitted together are adjacent in memory.
+        */
+        ParticlePool mParticlePoolBlocks;
+
+        /// Per-emitter particle counts requested by _triggerEmitters, kept to avoid reallocations
+        vector<unsigned>::type mEmissionRequested;
+        vector<unsigned>::type mEmittedEmissionRequested;
+
         typedef list<ParticleEmitter*>::type FreeEmittedEmitterList;
         typedef list<ParticleEmitter*>::type ActiveEmittedEmitterList;
         typedef vector<ParticleEmitter*>::type EmittedEmitterList;
@@ -779,6 +841,8 @@ namespace Ogre {
         static Real msDefaultIterationInterval;
         /// Default nonvisible update timeout
         static Real msDefaultNonvisibleTimeout;
+        /// Default threaded update setting
+        static bool msDefaultThreadedUpdate;
 
         /** Internal method used to expire dead particles. */
         void _expire(Real timeElapsed);
@@ -50,9 +50,15 @@ namespace Ogre {
     */
     class _OgreExport ParticleSystemRenderer : public StringInterface, public FXAlloc
     {
+        /// False once we know the deprecated list<Particle*> callbacks aren't
+        /// overridden, so that we stop converting the particles for them.
+        bool mForwardParticleMovedAsList;
+        bool mForwardParticleClearedAsList;
+
     public:
         /// Constructor
-        ParticleSystemRenderer() {}
+        ParticleSystemRenderer() :
+            mForwardParticleMovedAsList( true ), mForwardParticleClearedAsList( true ) {}
         /// Destructor
         virtual ~ParticleSystemRenderer() {}
 
@@ -65,7 +71,7 @@ namespace Ogre {
             instance(s) it wishes.
         */
         virtual void _updateRenderQueue(RenderQueue* queue, Camera *camera,
-            const Camera *lodCamera, list<Particle*>::type& currentParticles,
+            const Camera *lodCamera, vector<Particle*>::type& currentParticles,
             bool cullIndividually, RenderableArray &outRenderables ) = 0;
 
         /** Sets the HLMS material this renderer must use; called by ParticleSystem. */
@@ -88,10 +94,46 @@ namespace Ogre {
         virtual void _notifyParticleEmitted(Particle* particle) {}
         /** Optional callback notified when particle expired */
         virtual void _notifyParticleExpired(Particle* particle) {}
-        /** Optional callback notified when particles moved */
-        virtual void _notifyParticleMoved(list<Particle*>::type& currentParticles) {}
-        /** Optional callback notified when particles cleared */
-        virtual void _notifyParticleCleared(list<Particle*>::type& currentParticles) {}
+        /** Optional callback notified when particles moved
+        @remarks
+            The default implementation calls the deprecated list<Particle*> overload.
+        */
+        virtual void _notifyParticleMoved(vector<Particle*>::type& currentParticles)
+        {
+            if( mForwardParticleMovedAsList )
+            {
+                list<Particle*>::type particles( currentParticles.begin(), currentParticles.end() );
+                _notifyParticleMoved( particles );
+            }
+        }
+        /** Optional callback notified when particles cleared
+        @remarks
+            The default implementation calls the deprecated list<Particle*> overload.
+        */
+        virtual void _notifyParticleCleared(vector<Particle*>::type& currentParticles)
+        {
+            if( mForwardParticleClearedAsList )
+            {
+                list<Particle*>::type particles( currentParticles.begin(), currentParticles.end() );
+                _notifyParticleCleared( particles );
+            }
+        }
+        /** @deprecated Override the vector<Particle*> overload instead. This one still
+            gets called (with a copy of the particles) as long as that one isn't overridden.
+        */
+        virtual void _notifyParticleMoved(list<Particle*>::type& currentParticles)
+        {
+            //Not overridden either; don't bother converting the particles anymore.
+            mForwardParticleMovedAsList = false;
+        }
+        /** @deprecated Override the vector<Particle*> overload instead. This one still
+            gets called (with a copy of the particles) as long as that one isn't overridden.
+        */
+        virtual void _notifyParticleCleared(list<Particle*>::type& currentParticles)
+        {
+            //Not overridden either; don't bother converting the particles anymore.
+            mForwardParticleClearedAsList = false;
+        }
         /** Create a new ParticleVisualData instance for attachment to a particle.
         @remarks
             If this renderer needs additional data in each particle, then this should
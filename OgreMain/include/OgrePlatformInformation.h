@@ -78,7 +78,11 @@ namespace Ogre {
 /** Find perfect alignment (should supports SIMD alignment if SIMD available)
 */
 #if OGRE_CPU == OGRE_CPU_X86
-#   define OGRE_SIMD_ALIGNMENT  16
+#   if OGRE_USE_SIMD == 1 && OGRE_USE_AVX == 1
+#       define OGRE_SIMD_ALIGNMENT  32
+#   else
+#       define OGRE_SIMD_ALIGNMENT  16
+#   endif
 
 #else
 #   define OGRE_SIMD_ALIGNMENT  16
@@ -110,6 +114,18 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  0
 #endif
 
+/* Define whether or not Ogre compiled with the 8-wide AVX2 ArrayMath backend.
+   Implies __OGRE_HAVE_SSE (SSE is still used for scalar & AoS code paths).
+*/
+#if __OGRE_HAVE_SSE && OGRE_USE_AVX == 1
+#   if !defined( __AVX2__ )
+#       error "OGRE_USE_AVX requires compiling with AVX2 & FMA support (i.e. -mavx2 -mfma or /arch:AVX2)"
+#   endif
+#   define __OGRE_HAVE_AVX  1
+#else
+#   define __OGRE_HAVE_AVX  0
+#endif
+
 #if OGRE_USE_SIMD == 0 || !defined(__OGRE_HAVE_NEON)
 #   define __OGRE_HAVE_NEON  0
 #endif
@@ -114,21 +114,97 @@ namespace Ogre {
         struct ThreadRenderQueue
         {
             QueuedRenderableArray   q;
+            /// True if q is already sorted (@see _sortThreadQueues).
+            /// Reset whenever a new Renderable is added.
+            bool                    sorted;
             /// The padding prevents false cache sharing when multithreading.
             uint8                   padding[128];
+
+            ThreadRenderQueue() : sorted( false ) {}
         };
 
         typedef FastArray<ThreadRenderQueue> QueuedRenderableArrayPerThread;
 
+        /// Sort order from the previous frame, indices into the
+        /// Renderables as they were concatenated from all threads.
+        /// The SceneManager culls with a fixed chunk to thread mapping while temporal
+        /// coherence is on, so that the indices still refer to the same Renderables.
+        typedef FastArray<uint32> SortOrderArray;
+        typedef map<Camera const *, SortOrderArray>::type SortOrderPerCameraMap;
+
+        /// What renderGL3 resolved for a Renderable the last time. Only
+        /// reused while the Renderable still has the same Vao & Hlms hash.
+        struct CachedDraw
+        {
+            VertexArrayObject       *vao;
+            uint32                  hlmsHash;
+            HlmsCache const         *hlmsCache;
+        };
+
+        /// @see setRenderQueueDrawCaching
+        struct DrawCache
+        {
+            /// Renderables from all threads sorted by hash, then Renderable & MovableObject.
+            /// Doesn't depend on which thread added what; used to detect changes.
+            QueuedRenderableArray   canonicalRenderables;
+            /// Renderables as they were sorted and rendered.
+            QueuedRenderableArray   sortedRenderables;
+            /// One per sortedRenderables entry.
+            FastArray<CachedDraw>   draws;
+            /// Pass hash & shader cache generation of each Hlms when draws was built.
+            FastArray<uint32>       passHashes;
+            FastArray<uint32>       shaderCacheGenerations;
+            bool                    casterPass;
+            /// True when sortedRenderables was reused this frame (i.e. nothing changed)
+            bool                    hit;
+
+            DrawCache() : casterPass( false ), hit( false ) {}
+        };
+
+        typedef map<Camera const *, DrawCache>::type DrawCachePerCameraMap;
+
         struct RenderQueueGroup
         {
             QueuedRenderableArrayPerThread mQueuedRenderablesPerThread;
             QueuedRenderableArray   mQueuedRenderables;
             bool                    mDoSort;
             bool                    mSorted;
+            bool                    mTemporalCoherence;
+            bool                    mDrawCaching;
             Modes                   mMode;
+            SortOrderPerCameraMap   mPrevFrameSortOrder;
+            DrawCachePerCameraMap   mDrawCache;
+            /// Entry of mDrawCache that mQueuedRenderables was sorted with since the
+            /// last clear. Null if none.
+            DrawCache               *mCurrentDrawCache;
+
+            RenderQueueGroup() :
+                mDoSort( true ), mSorted( false ), mTemporalCoherence( false ),
+                mDrawCaching( false ), mMode( V1_FAST ), mCurrentDrawCache( 0 ) {}
+        };
 
-            RenderQueueGroup() : mDoSort( true ), mSorted( false ), mMode( V1_FAST ) {}
+        /// Read position inside one thread's already sorted queue while merging.
+        struct ThreadQueueCursor
+        {
+            QueuedRenderable const *itor;
+            QueuedRenderable const *end;
+
+            /// Reversed so that the std heap functions keep the smallest hash at the front.
+            bool operator < ( const ThreadQueueCursor &_r ) const
+            {
+                return _r.itor->hash < this->itor->hash;
+            }
+        };
+
+        struct IndexedSortKey
+        {
+            uint64  hash;
+            uint32  idx;
+
+            bool operator < ( const IndexedSortKey &_r ) const
+            {
+                return this->hash < _r.hash;
+            }
         };
 
         typedef vector<IndirectBufferPacked*>::type IndirectBufferPackedVec;
@@ -149,6 +225,11 @@ namespace Ogre {
         IndirectBufferPackedVec mFreeIndirectBuffers;
         IndirectBufferPackedVec mUsedIndirectBuffers;
 
+        /// Scratch memory for sorting, kept around to avoid per-frame allocations.
+        FastArray<ThreadQueueCursor>    mMergeCursors;
+        FastArray<IndexedSortKey>       mIndexedSortKeys;
+        QueuedRenderableArray           mTmpQueuedRenderables;
+
         /** Returns a new (or an existing) indirect buffer that can hold the requested number of draws.
         @param numDraws
             Number of draws the indirect buffer is expected to hold. It must be an upper limit.
@@ -162,14 +243,37 @@ namespace Ogre {
                                         Renderable* pRend, const MovableObject *pMovableObject,
                                         bool isV1 );
 
+        /// Sorts each thread's queue (unless already sorted), then performs
+        /// a k-way merge of all of them into renderQueueGroup.mQueuedRenderables
+        void mergeSortedThreadQueues( RenderQueueGroup &renderQueueGroup );
+
+        /// Sorts renderQueueGroup.mQueuedRenderables starting from the order used in
+        /// the previous frame by the current camera, finishing with an insertion sort.
+        void sortWithTemporalCoherence( RenderQueueGroup &renderQueueGroup );
+
+        /** Checks whether the Renderables added from all threads are exactly the same as the
+            last time the current camera rendered this queue, regardless of which thread added
+            them. If so, reuses the sorted list and returns the cache, marked as hit. Otherwise
+            returns the cache after recording the new Renderables; the caller must call
+            updateDrawCache after sorting. May mark the queue as sorted in both cases.
+        */
+        DrawCache& findDrawCache( RenderQueueGroup &renderQueueGroup );
+        /// Stores the freshly sorted list and invalidates the resolved draws.
+        void updateDrawCache( DrawCache &drawCache, const RenderQueueGroup &renderQueueGroup );
+
+        /// @see _sortRenderQueue. Returns the draw cache to render with; can be null.
+        DrawCache* sortRenderQueue( RenderQueueGroup &renderQueueGroup );
+
         void renderES2( RenderSystem *rs, bool casterPass, bool dualParaboloid,
                         HlmsCache passCache[], const RenderQueueGroup &renderQueueGroup );
 
         /// Renders in a compatible way with GL 3.3 and D3D11. Can only render V2 objects
         /// (i.e. Items, VertexArrayObject)
+        /// @param drawCache
+        ///     Cache matching renderQueueGroup.mQueuedRenderables. Can be null.
         unsigned char* renderGL3( bool casterPass, bool dualParaboloid,
                         HlmsCache passCache[],
-                        const RenderQueueGroup &renderQueueGroup,
+                        const RenderQueueGroup &renderQueueGroup, DrawCache *drawCache,
                         IndirectBufferPacked *indirectBuffer,
                         unsigned char *indirectDraw, unsigned char *startIndirectDraw );
         void renderGL3V1( bool casterPass, bool dualParaboloid,
@@ -191,6 +295,11 @@ namespace Ogre {
         */
         void clearState(void);
 
+        /** Frees the sort order & draw cache kept for the given camera, in every
+            RenderQueue ID. Called by the SceneManager when the camera gets destroyed.
+        */
+        void _cameraDestroyed( const Camera *camera );
+
         /// Add a renderable (Ogre v1.x) object to the queue. @see addRenderable
         void addRenderableV1( uint8 renderQueueId, bool casterPass, Renderable* pRend,
                               const MovableObject *pMovableObject );
@@ -212,6 +321,25 @@ namespace Ogre {
         void addRenderableV2( size_t threadIdx, uint8 renderQueueId, bool casterPass,
                               Renderable* pRend, const MovableObject *pMovableObject );
 
+        /** Sorts all the queues filled by the given thread, in the range [firstRq; lastRq)
+            so that RenderQueue::render only has to merge them.
+        @remarks
+            Called by the SceneManager from its worker threads right after culling.
+            Render queues with sorting disabled or using temporal coherence are skipped.
+        @param threadIdx
+            The unique index of the thread from which this function is called from.
+            Valid range is [0; SceneManager::mNumWorkerThreads)
+        */
+        void _sortThreadQueues( size_t threadIdx, uint8 firstRq, uint8 lastRq );
+
+        /** Gathers the Renderables added from all threads to the given queue and sorts
+            them, unless it was already done since the last clear. Called by render().
+        @return
+            True if the draw cache was hit, i.e. the current camera sees the exact same
+            Renderables as last time. @see setRenderQueueDrawCaching
+        */
+        bool _sortRenderQueue( uint8 rqId );
+
         void render( RenderSystem *rs, uint8 firstRq, uint8 lastRq,
                      bool casterPass, bool dualParaboloid );
 
@@ -242,6 +370,44 @@ namespace Ogre {
         */
         void setSortRenderQueue( uint8 rqId, bool bSort );
         bool getSortRenderQueue( uint8 rqId ) const;
+
+        /** Sets whether sorting the render queue ID should exploit temporal coherence.
+        @remarks
+            When enabled, the sorted order of each frame is remembered per camera and
+            applied to the next frame's Renderables, followed by an insertion sort.
+            This is very fast when the visible set barely changes across frames, but
+            gets no help from the worker threads. It also makes the worker threads cull
+            the objects of these queues in a fixed order instead of balancing the load
+            between them.
+            When disabled (default) each worker thread sorts its own Renderables after
+            culling, and they're merged together when rendering.
+            Has no effect when sorting is disabled. @see setSortRenderQueue
+        @param rqId
+            ID of the render queue
+        @param bEnable
+            True to enable temporal coherence. Disabling it releases the remembered orders.
+        */
+        void setRenderQueueTemporalCoherence( uint8 rqId, bool bEnable );
+        bool getRenderQueueTemporalCoherence( uint8 rqId ) const;
+
+        /** Sets whether the render queue ID should remember what it rendered for each camera
+            and reuse it when the exact same Renderables are queued again.
+        @remarks
+            Only affects FAST queues. When the queued Renderables, the pass and the shaders
+            didn't change since the last time the camera rendered the queue, sorting is
+            skipped and the Hlms shaders resolved for each Renderable are reused (as long as
+            its Vao and datablock are still the same).
+            The Hlms still fills the per-object data and records the buffer bindings every
+            frame, as those buffers are re-mapped each frame.
+            Useful for static cameras looking at static scenes. Costs a bit of extra memory
+            and a linear comparison every frame for scenes that change constantly.
+        @param rqId
+            ID of the render queue
+        @param bEnable
+            True to enable. Disabling it releases the remembered draws.
+        */
+        void setRenderQueueDrawCaching( uint8 rqId, bool bEnable );
+        bool getRenderQueueDrawCaching( uint8 rqId ) const;
     };
 
     #define OGRE_RQ_MAKE_MASK( x ) ( (1 << (x)) - 1 )
@@ -552,6 +552,27 @@ namespace Ogre {
         void loadResourceGroup(const String& name, bool loadMainResources = true, 
             bool loadWorldGeom = true);
 
+        /** Loads a resource group like loadResourceGroup, but prepares all of its
+            resources concurrently first.
+        @remarks
+            The CPU side of each resource (reading from disk, decompressing, decoding
+            images, parsing meshes) is done via Resource::prepare in the SceneManager's
+            worker threads. Once every resource is prepared, loadResourceGroup runs in
+            the calling thread to finish them (i.e. GPU uploads), still ordered by
+            ResourceManager::getLoadingOrder so dependencies are respected.
+        @par
+            Resources that fail to prepare in a worker thread are retried by
+            loadResourceGroup, which will raise the exception in the calling thread.
+            When Ogre is built without thread support the resources are prepared
+            serially in the calling thread.
+        @param sceneManager
+            SceneManager whose worker threads are used. Must not be updating its scene.
+        @see ResourceGroupManager::loadResourceGroup
+        */
+        void loadResourceGroupParallel( const String& name, SceneManager *sceneManager,
+                                        bool loadMainResources = true,
+                                        bool loadWorldGeom = true );
+
         /** Unloads a resource group.
         @remarks
             This method unloads all the resources that have been declared as
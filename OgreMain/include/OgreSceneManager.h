@@ -53,6 +53,7 @@ Torus Knot Software Ltd.
 #include "Animation/OgreSkeletonAnimManager.h"
 #include "Compositor/Pass/OgreCompositorPass.h"
 #include "Threading/OgreThreads.h"
+#include "Threading/OgreLightweightMutex.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -145,6 +146,8 @@ namespace Ogre {
     struct EntityMaterialLodChangedEvent;
     class CompositorShadowNode;
     class UniformScalableTask;
+    class ChunkedTask;
+    class SoftwareOcclusionCuller;
 
     namespace v1
     {
@@ -172,10 +175,13 @@ namespace Ogre {
         Camera const                    *camera;
         /// Camera whose frustum we're to cull against. Must be const (read only for all threads).
         Camera const                    *lodCamera;
+        /// When not null, objects that passed the frustum test are tested against its
+        /// depth buffer (which must already be rasterized for 'camera'). Read only.
+        SoftwareOcclusionCuller const   *occlusionCuller;
 
         CullFrustumRequest() :
             firstRq( 0 ), lastRq( 0 ), casterPass( false ), addToRenderQueue( true ),
-            objectMemManager( 0 ), camera( 0 ), lodCamera( 0 )
+            objectMemManager( 0 ), camera( 0 ), lodCamera( 0 ), occlusionCuller( 0 )
         {
         }
         CullFrustumRequest( uint8 _firstRq, uint8 _lastRq, bool _casterPass,
@@ -184,11 +190,49 @@ namespace Ogre {
                             const Camera *_camera, const Camera *_lodCamera ) :
             firstRq( _firstRq ), lastRq( _lastRq ), casterPass( _casterPass ),
             addToRenderQueue( _addToRenderQueue ), objectMemManager( _objectMemManager ),
-            camera( _camera ), lodCamera( _lodCamera )
+            camera( _camera ), lodCamera( _lodCamera ), occlusionCuller( 0 )
         {
         }
     };
 
+    /// A camera to cull along with others in a single pass. @See SceneManager::cullFrustumBatch
+    struct CullFrustumBatchEntry
+    {
+        Camera const    *camera;
+        Camera const    *lodCamera;
+        /// Visibility mask of the viewport the camera will render to. @See Viewport::getVisibilityMask
+        uint32          viewportVisibilityMask;
+        /// First RenderQueue ID to render (inclusive)
+        uint8           firstRq;
+        /// Last RenderQueue ID to render (exclusive)
+        uint8           lastRq;
+
+        CullFrustumBatchEntry() :
+            camera( 0 ), lodCamera( 0 ), viewportVisibilityMask( 0 ), firstRq( 0 ), lastRq( 0 )
+        {
+        }
+        CullFrustumBatchEntry( const Camera *_camera, const Camera *_lodCamera,
+                               uint32 _viewportVisibilityMask, uint8 _firstRq, uint8 _lastRq ) :
+            camera( _camera ), lodCamera( _lodCamera ),
+            viewportVisibilityMask( _viewportVisibilityMask ), firstRq( _firstRq ), lastRq( _lastRq )
+        {
+        }
+    };
+
+    typedef FastArray<CullFrustumBatchEntry> CullFrustumBatchEntryArray;
+
+    /// Per thread scratch of SceneManager::cullFrustumBatchThread: the entries that
+    /// want the render queue of the chunk being culled.
+    struct CullFrustumBatchScratch
+    {
+        FastArray<Camera const*>    cameras;
+        FastArray<Camera const*>    lodCameras;
+        FastArray<uint32>           visibilityFlags;
+        FastArray<MovableObject::MovableObjectArray*> outVisibleObjects;
+        /// Prevents false cache sharing between threads.
+        uint8                       padding[64];
+    };
+
     struct UpdateLodRequest : public CullFrustumRequest
     {
         Real    lodBias;
@@ -210,15 +254,37 @@ namespace Ogre {
     struct UpdateTransformRequest
     {
         Transform t;
-        /// Number of nodes to process for each thread. Must be multiple of ARRAY_PACKED_REALS
-        size_t numNodesPerThread;
+        /// Number of nodes to process for each chunk. Must be multiple of ARRAY_PACKED_REALS
+        size_t numNodesPerChunk;
         size_t numTotalNodes;
 
         UpdateTransformRequest() :
-            numNodesPerThread( 0 ), numTotalNodes( 0 ) {}
+            numNodesPerChunk( 0 ), numTotalNodes( 0 ) {}
 
-        UpdateTransformRequest( const Transform &_t, size_t _numNodesPerThread, size_t _numTotalNodes ) :
-            t( _t ), numNodesPerThread( _numNodesPerThread ), numTotalNodes( _numTotalNodes )
+        UpdateTransformRequest( const Transform &_t, size_t _numNodesPerChunk, size_t _numTotalNodes ) :
+            t( _t ), numNodesPerChunk( _numNodesPerChunk ), numTotalNodes( _numTotalNodes )
+        {
+        }
+    };
+
+    /** A contiguous range of packs from a render queue inside an ObjectMemoryManager.
+        Worker threads grab these one at a time until there are none left, so that
+        the work gets balanced even if the cost per object is uneven.
+    */
+    struct ObjectDataChunk
+    {
+        ObjectMemoryManager *objectMemManager;
+        size_t              renderQueue;
+        /// Index of the first pack (in multiples of ARRAY_PACKED_REALS) of the chunk
+        size_t              firstPack;
+        /// Number of objects to process. Only the last chunk of a render
+        /// queue may not be a multiple of ARRAY_PACKED_REALS
+        size_t              numObjs;
+
+        ObjectDataChunk( ObjectMemoryManager *_objectMemManager, size_t _renderQueue,
+                         size_t _firstPack, size_t _numObjs ) :
+            objectMemManager( _objectMemManager ), renderQueue( _renderQueue ),
+            firstPack( _firstPack ), numObjs( _numObjs )
         {
         }
     };
@@ -249,6 +315,20 @@ namespace Ogre {
         }
     };
 
+    /// A SkeletonInstance found visible by a worker thread. @See SceneManager::notifyVisibleSkeletons
+    struct VisibleSkeleton
+    {
+        SkeletonInstance    *skeletonInstance;
+        Real                distanceToCamera;
+
+        VisibleSkeleton() :
+            skeletonInstance( 0 ), distanceToCamera( 0 ) {}
+        VisibleSkeleton( SkeletonInstance *_skeletonInstance, Real _distanceToCamera ) :
+            skeletonInstance( _skeletonInstance ), distanceToCamera( _distanceToCamera )
+        {
+        }
+    };
+
     /** Manages the organisation and rendering of a 'scene' i.e. a collection 
         of objects and potentially world geometry.
     @remarks
@@ -477,6 +557,8 @@ namespace Ogre {
 
         Forward3D   *mForward3DImpl;
 
+        SoftwareOcclusionCuller *mSoftwareOcclusionCuller;
+
         /// Updated every frame, has enough memory to hold all lights.
         /// The order is not deterministic, it depends on the number
         /// of worker threads.
@@ -486,6 +568,12 @@ namespace Ogre {
         LightArrayPerThread             mGlobalLightListPerThread;
         BuildLightListRequestPerThread  mBuildLightListRequestPerThread;
 
+        /// Skeletons found visible by each worker thread during the current cull phase.
+        /// Several threads may see Items sharing a SkeletonInstance, thus they're only
+        /// told on the main thread. @See applyVisibleSkeletons
+        typedef FastArray<VisibleSkeleton> VisibleSkeletonArray;
+        FastArray<VisibleSkeletonArray> mVisibleSkeletonsPerThread;
+
         /// Current ambient light.
         ColourValue mAmbientLight[2];
         Vector3     mAmbientLightHemisphereDir;
@@ -890,6 +978,8 @@ namespace Ogre {
         enum RequestType
         {
             CULL_FRUSTUM,
+            CULL_FRUSTUM_BATCH,
+            COLLECT_CULL_FRUSTUM_BATCH,
             UPDATE_ALL_ANIMATIONS,
             UPDATE_ALL_TRANSFORMS,
             UPDATE_ALL_BONE_TO_TAG_TRANSFORMS,
@@ -901,6 +991,8 @@ namespace Ogre {
             BUILD_LIGHT_LIST01,
             BUILD_LIGHT_LIST02,
             USER_UNIFORM_SCALABLE_TASK,
+            USER_CHUNKED_TASK,
+            RASTERIZE_OCCLUDERS,
             STOP_THREADS,
             NUM_REQUESTS
         };
@@ -910,10 +1002,40 @@ namespace Ogre {
         CullFrustumRequest              mCurrentCullFrustumRequest;
         UpdateLodRequest                mUpdateLodRequest;
         UpdateTransformRequest          mUpdateTransformRequest;
-        ObjectMemoryManagerVec const    *mUpdateBoundsRequest;
+        /// Nodes recomputed by each worker thread in the current updateAllTransforms call
+        FastArray<size_t>               mNumUpdatedTransformsPerThread;
+        /// Nodes recomputed in the last updateAllTransforms call
+        size_t                          mNumUpdatedTransforms;
         InstancingThreadedCullingMethod mInstancingThreadedCullingMethod;
         InstanceBatchCullRequest        mInstanceBatchCullRequest;
         UniformScalableTask *mUserTask;
+        ChunkedTask         *mUserChunkedTask;
+        size_t              mNumUserChunks;
+
+        /// ParticleSystems whose update has been queued via ParticleSystem::_queueUpdate
+        FastArray<ParticleSystem*>      mQueuedParticleSystemUpdates;
+
+        /// Work to be grabbed by worker threads in CULL_FRUSTUM, UPDATE_ALL_BOUNDS
+        /// and UPDATE_ALL_LODS requests. Filled from the main thread.
+        FastArray<ObjectDataChunk>      mObjectDataChunks;
+        /// Index of the next chunk to be grabbed by a worker thread. Protected by mChunkMutex.
+        size_t                          mNextChunkIdx;
+        /// When true, the cull phase hands out chunks round robin (thread i takes chunks
+        /// i, i + mNumWorkerThreads, ...) instead of on demand, so that each thread adds
+        /// the same Renderables in the same order every frame. Render queues with temporal
+        /// coherence rely on it. @See grabNextCullChunkIdx
+        bool                            mFixedCullChunks;
+        LightweightMutex                mChunkMutex;
+
+        /// Cameras culled by cullFrustumBatch that haven't been picked up by
+        /// _cullPhase01 yet. Picked up entries get their camera set to null.
+        CullFrustumBatchEntryArray      mCullFrustumBatch;
+        /// Results of cullFrustumBatch. Indexed as [entry][threadIdx][renderQueue]
+        FastArray<VisibleObjectsPerThreadArray> mCullFrustumBatchResults;
+        /// Entry being picked up by the worker threads in COLLECT_CULL_FRUSTUM_BATCH
+        size_t                          mCullFrustumBatchIdx;
+        typedef FastArray<CullFrustumBatchScratch> CullFrustumBatchScratchPerThread;
+        CullFrustumBatchScratchPerThread mCullFrustumBatchScratchPerThread;
         RequestType         mRequestType;
         Barrier             *mWorkerThreadsBarrier;
         ThreadHandleVec     mWorkerThreads;
@@ -1011,12 +1133,41 @@ namespace Ogre {
         void updateAllTransformsTagOnTagThread( const UpdateTransformRequest &request,
                                                 size_t threadIdx );
 
-        /** Updates the world aabbs from the given request inside a thread. @See updateAllTransforms
+        /** Returns the number of packs (in multiples of ARRAY_PACKED_REALS) each chunk
+            should contain when splitting numPacks across all worker threads. Aims for a
+            few chunks per thread, and is always a multiple of
+            ObjectMemoryManager::NUM_PACKS_PER_CLUSTER.
+        */
+        size_t calculateNumPacksPerChunk( size_t numPacks ) const;
+
+        /** Splits the objects from [firstRq; lastRq) of the given memory managers in chunks
+            and appends them to mObjectDataChunks. @See ObjectDataChunk
+        */
+        void addObjectDataChunks( const ObjectMemoryManagerVec &objectMemManager,
+                                  size_t firstRq, size_t lastRq );
+
+        /** Returns the index of the next chunk to process and advances the counter.
+            Called from the worker threads; each index is returned exactly once
+            until the next call to fireWorkerThreadsAndWait.
+        */
+        size_t grabNextChunkIdx(void);
+
+        /** Same as grabNextChunkIdx, but for the cull phase, which may need a fixed
+            chunk to thread mapping. @See mFixedCullChunks
+        @param prevChunkIdx
+            Chunk this thread processed last. std::numeric_limits<size_t>::max() to get the first one.
+        */
+        size_t grabNextCullChunkIdx( size_t threadIdx, size_t prevChunkIdx );
+
+        /// True if any render queue in [firstRq; lastRq) sorts with temporal coherence.
+        bool needsFixedCullChunks( uint8 firstRq, uint8 lastRq ) const;
+
+        /** Updates the world aabbs from mObjectDataChunks inside a thread. @See updateAllTransforms
         @param threadIdx
             Thread index so we know at which point we should start at.
             Must be unique for each worker thread
         */
-        void updateAllBoundsThread( const ObjectMemoryManagerVec &objectMemManager, size_t threadIdx );
+        void updateAllBoundsThread( size_t threadIdx );
 
         /**
         @param threadIdx
@@ -1025,6 +1176,48 @@ namespace Ogre {
         */
         void updateAllLodsThread( const UpdateLodRequest &request, size_t threadIdx );
 
+        /** Culls all cameras from mCullFrustumBatch inside a thread, grabbing chunks
+            from mObjectDataChunks. Results go to mCullFrustumBatchResults.
+            @See cullFrustumBatch
+        */
+        void cullFrustumBatchThread( size_t threadIdx );
+
+        /** Fills mVisibleObjects[threadIdx] (and adds v2 objects to the render queue)
+            from the results of a previous cullFrustumBatch, as if cullFrustum had been
+            called with the given request.
+        */
+        void collectCullFrustumBatchThread( const CullFrustumRequest &request, size_t threadIdx );
+
+        /// Clears all lists from mVisibleObjects[threadIdx] and returns them.
+        VisibleObjectsPerRq& resetVisibleObjects( size_t threadIdx );
+
+        /** Adds the v2 objects to the render queue, from a worker thread. Only called for
+            render queues in FAST mode. Clears inOutVisibleObjects afterwards.
+        */
+        void addVisibleObjectsToRenderQueue( size_t threadIdx, uint8 rqId, bool casterPass,
+                                             MovableObject::MovableObjectArray &inOutVisibleObjects );
+
+        /** Records the SkeletonInstances of visibleObjects[firstIdx:] as visible, from
+            a worker thread. Needed by their update policies. @see SkeletonUpdatePolicy
+            They're told once the threads are done. @see applyVisibleSkeletons
+        @param casterPass
+            When true the distance isn't relevant (it's to the shadow camera), thus the
+            skeletons are notified as visible but at the farthest distance.
+        */
+        void notifyVisibleSkeletons( const MovableObject::MovableObjectArray &visibleObjects,
+                                     size_t firstIdx, bool casterPass, size_t threadIdx );
+
+        /// Tells the SkeletonInstances recorded by notifyVisibleSkeletons that they're
+        /// visible. Main thread only; must be called after the cull threads finished.
+        void applyVisibleSkeletons(void);
+
+        /** Returns the index of the entry in mCullFrustumBatch that matches the parameters.
+            Returns mCullFrustumBatch.size() if there's none.
+        */
+        size_t findCullFrustumBatchEntry( const Camera *camera, const Camera *lodCamera,
+                                          uint32 viewportVisibilityMask,
+                                          uint8 firstRq, uint8 lastRq ) const;
+
         /** Traverses mVisibleObjects[threadIdx] from each thread to call
             MovableObject::instanceBatchCullFrustumThreaded (which is supposed to cull objects)
         @param threadIdx
@@ -1107,6 +1300,12 @@ namespace Ogre {
 
         size_t getNumWorkerThreads() const                          { return mNumWorkerThreads; }
 
+        /** Returns the number of nodes whose derived transforms were recomputed in the last
+            updateAllTransforms call (i.e. last frame). Nodes that didn't move are skipped,
+            although they may still be counted if they share a SIMD pack with one that did.
+        */
+        size_t getNumUpdatedTransforms(void) const                  { return mNumUpdatedTransforms; }
+
         /** Creates a camera to be managed by this scene manager.
             @remarks
                 This camera is automatically added to the scene by being attached to the Root
@@ -1305,6 +1504,26 @@ namespace Ogre {
 
         Forward3D* getForward3D(void)                       { return mForward3DImpl; }
 
+        /** Enables or disables software occlusion culling for regular (non-shadow) passes.
+            Objects that survived frustum culling are tested against a low resolution depth
+            buffer rasterized from the occluders registered in the culler.
+        @remarks
+            Occluders aren't gathered automatically; they must be added via
+            getSoftwareOcclusionCuller()->addOccluder. Use simplified geometry (i.e. a
+            few boxes for a building) that is fully contained inside the real mesh.
+            Calling this function destroys all registered occluders.
+        @param bEnable
+            True to enable it. False to disable it.
+        @param width
+            Width in pixels of the depth buffer. 256 is a good starting point.
+        @param height
+            Height in pixels of the depth buffer. 128 is a good starting point.
+        */
+        void setSoftwareOcclusionCulling( bool bEnable, uint32 width, uint32 height );
+
+        SoftwareOcclusionCuller* getSoftwareOcclusionCuller(void)
+                                                            { return mSoftwareOcclusionCuller; }
+
         NodeMemoryManager& _getNodeMemoryManager(SceneMemoryMgrTypes sceneType)
                                                                 { return mNodeMemoryManager[sceneType]; }
         NodeMemoryManager& _getTagPointNodeMemoryManager(void)  { return mTagPointNodeMemoryManager; }
@@ -1318,6 +1537,20 @@ namespace Ogre {
         ObjectMemoryManager& _getEntityMemoryManager(SceneMemoryMgrTypes sceneType)
                                                             { return mEntityMemoryManager[sceneType]; }
 
+        /** Enables culling static objects in the given render queue in clusters of packs,
+            which can reject many objects at once when they're out of the frustum.
+            Recommended for scenes with large amounts of static objects.
+            @see ObjectMemoryManager::setPackClusterCulling
+        */
+        void setStaticPackClusterCulling( uint8 rqId, bool bEnable )
+        {
+            mEntityMemoryManager[SCENE_STATIC].setPackClusterCulling( rqId, bEnable );
+        }
+        bool getStaticPackClusterCulling( uint8 rqId ) const
+        {
+            return mEntityMemoryManager[SCENE_STATIC].getPackClusterCulling( rqId );
+        }
+
         /** Create an Item (instance of a discrete mesh).
             @param
                 meshName The name of the Mesh it is to be based on (e.g. 'knot.oof'). The
@@ -1561,6 +1794,12 @@ namespace Ogre {
         */
         virtual void destroyAllParticleSystems(void);       
 
+        /// Queues the ParticleSystem to be updated in the next updateSceneGraph.
+        /// @see ParticleSystem::_queueUpdate
+        void _queueParticleSystemUpdate( ParticleSystem *particleSystem );
+        /// Removes a ParticleSystem from the queue of updates. Called when it gets destroyed.
+        void _removeQueuedParticleSystemUpdate( ParticleSystem *particleSystem );
+
         /** Empties the entire scene, inluding all SceneNodes, Entities, Lights, 
             BillboardSets etc. Cameras are not deleted at this stage since
             they are still referenced by viewports, which are not destroyed during
@@ -1840,6 +2079,10 @@ namespace Ogre {
             Don't call this function from another thread other than Ogre's main one (we use worker
             threads that may be in use for something else, and touching the sync barrier
             could deadlock in the best of cases).
+        @par
+            Only nodes that changed since the last call (or whose parents changed) are
+            recomputed, at the granularity of ARRAY_PACKED_REALS nodes.
+            @See getNumUpdatedTransforms
         */
         void updateAllTransforms();
 
@@ -1850,6 +2093,15 @@ namespace Ogre {
         */
         void updateAllTagPoints(void);
 
+        /** Updates all ParticleSystems queued since the last call, in parallel using
+            executeUserChunkedTask.
+        @remarks
+            Must be called after updateAllTransforms and updateAllTagPoints so emitters see
+            the current derived transforms, and before UPDATE_ALL_BOUNDS so the particle
+            systems' world aabbs are up to date.
+        */
+        void updateAllParticleSystems(void);
+
         /** Updates the world aabbs from all entities in the scene. Ought to be called right after
             updateAllTransforms. @See updateAllTransforms
         @remarks
@@ -1910,6 +2162,23 @@ namespace Ogre {
         void cullLights( Camera *camera, Light::LightTypes startType,
                          Light::LightTypes endType, LightArray &outLights );
 
+        /** Performs the frustum culling of many cameras at once, in a single pass over
+            all the objects, instead of one full pass per camera (i.e. all the shadow
+            maps from a shadow node).
+            The results are kept until _cullPhase01 gets called with a matching camera,
+            lod camera, viewport visibility mask and render queue range, which will then
+            only add the already culled objects to the render queue.
+        @remarks
+            The cameras, as well as the scene, must not change between this call and
+            their _cullPhase01. Pending results from a previous call are discarded,
+            and so are all of them when the scene graph gets updated.
+        @param entries
+            Array of cameras to cull.
+        @param numEntries
+            Number of elements in entries.
+        */
+        void cullFrustumBatch( const CullFrustumBatchEntry *entries, size_t numEntries );
+
         /// Called when the frame has fully ended (ALL passes have been executed to all RTTs)
         void _frameEnded(void);
 
@@ -3110,6 +3379,16 @@ namespace Ogre {
         */
         void waitForPendingUserScalableTask();
 
+        /** Processes a user-defined ChunkedTask in the worker threads spawned by
+            SceneManager. Each worker thread grabs chunks until there are none left.
+        @remarks
+            Blocks until all the chunks have been processed.
+            Don't call this function while a non-blocking UniformScalableTask is pending.
+        @param task
+            Task to perform.
+        */
+        void executeUserChunkedTask( ChunkedTask *task );
+
         /** Called from the worker thread, polls to process frustum culling
             requests when a sync is performed
         */
@@ -0,0 +1,213 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _OgreSoftwareOcclusionCuller_H_
+#define _OgreSoftwareOcclusionCuller_H_
+
+#include "OgrePrerequisites.h"
+#include "OgreMovableObject.h"
+#include "OgreMatrix4.h"
+#include "OgreVector4.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+
+    /** Rejects objects that passed frustum culling but are completely hidden behind
+        occluders (i.e. walls, buildings, terrain), before they reach the RenderQueue.
+    @remarks
+        The occluders are rasterized on the CPU into a small depth buffer that is split
+        in tiles of TILE_WIDTH x TILE_HEIGHT pixels. Triangles are binned per tile from
+        the main thread, and each tile is then rasterized by one of SceneManager's worker
+        threads, ARRAY_PACKED_REALS pixels at a time. Afterwards, the worker threads
+        test the world Aabb of each visible object against that depth buffer.
+    @par
+        Occluder geometry is provided by the user and should be a simplified version of
+        the object it belongs to, fully contained inside its real mesh (otherwise objects
+        that should be visible may get culled). The GPU buffers are not read back.
+    @par
+        Rasterization is conservative: occluders only hide the pixels they cover
+        entirely, while objects are tested against every pixel they touch. As a
+        consequence pixels along the edges shared by two occluder triangles don't
+        occlude anything; prefer few big triangles.
+    @par
+        Everything is done on the CPU, so it works with any RenderSystem, including
+        the NULL one.
+    @par
+        Enable it with SceneManager::setSoftwareOcclusionCulling. Only cameras not used
+        for shadow mapping are affected.
+    */
+    class _OgreExport SoftwareOcclusionCuller : public SceneMgtAlloc
+    {
+    public:
+        /// Width of each tile, in pixels. Multiple of ARRAY_PACKED_REALS
+        static const uint32 TILE_WIDTH;
+        /// Height of each tile, in pixels.
+        static const uint32 TILE_HEIGHT;
+
+    protected:
+        struct Occluder
+        {
+            MovableObject const *movableObject;
+            /// In the local space of movableObject's parent node
+            vector<Vector3>::type   vertices;
+            /// Triangle list
+            vector<uint32>::type    indices;
+        };
+
+        typedef vector<Occluder>::type OccluderVec;
+
+        /// Triangle in screen space, ready to be rasterized
+        struct ScreenTriangle
+        {
+            /// Edge functions, so that edgeA * x + edgeB * y + edgeC >= 0 for all
+            /// three edges when (x, y) is inside the triangle
+            Real    edgeA[3];
+            Real    edgeB[3];
+            Real    edgeC[3];
+            /// Depth (z / w) as a plane in screen space: depthA * x + depthB * y + depthC
+            Real    depthA;
+            Real    depthB;
+            Real    depthC;
+            /// Bounding rectangle, in pixels (max is exclusive)
+            uint32  minX, minY, maxX, maxY;
+        };
+
+        typedef FastArray<ScreenTriangle> ScreenTriangleArray;
+        typedef FastArray<uint32> TriangleIndexArray;
+
+        OccluderVec         mOccluders;
+
+        ScreenTriangleArray mTriangles;
+        /// Indices to mTriangles of the triangles overlapping each tile
+        FastArray<TriangleIndexArray> mTileBins;
+
+        uint32              mWidth;
+        uint32              mHeight;
+        uint32              mNumTilesX;
+        uint32              mNumTilesY;
+
+        /** Stores the depth in normalized device coordinates (z / w) of the closest occluder,
+            per pixel. Unlike view space depth, it can be linearly interpolated in screen space.
+            Only occluders covering the whole pixel are taken into account, using their
+            farthest depth inside that pixel; so the buffer never hides more than it should.
+            std::numeric_limits<Real>::max() means there's no occluder.
+        */
+        Real                *mDepthBuffer;
+
+        Matrix4             mViewProjMatrix;
+
+        /// Scratch buffer for transformAndBinOccluder. x & y in pixels, z / w, and w.
+        FastArray<Vector4>  mScreenVertices;
+
+        void transformAndBinOccluder( const Occluder &occluder );
+
+    public:
+        /**
+        @param width
+            Width of the depth buffer, in pixels. Gets rounded up to multiple of TILE_WIDTH.
+        @param height
+            Height of the depth buffer, in pixels. Gets rounded up to multiple of TILE_HEIGHT.
+        */
+        SoftwareOcclusionCuller( uint32 width, uint32 height );
+        ~SoftwareOcclusionCuller();
+
+        /** Registers geometry that will hide the objects behind it.
+        @remarks
+            Call removeOccluder before the MovableObject gets destroyed.
+            The same MovableObject can have more than one occluder.
+        @param movableObject
+            The geometry follows the transform of its parent node. The occluder is
+            ignored while the object is not attached or not visible.
+        @param vertices
+            Vertex positions, in local space. Gets copied.
+        @param numVertices
+            Number of elements in vertices.
+        @param indices
+            Triangle list, in counter clockwise order (clockwise ones are rasterized too,
+            so that single sided walls occlude from both sides). Gets copied.
+        @param numIndices
+            Number of elements in indices. Must be multiple of 3.
+        */
+        void addOccluder( const MovableObject *movableObject,
+                          const Vector3 *vertices, size_t numVertices,
+                          const uint32 *indices, size_t numIndices );
+
+        /// Removes all occluders that were added with the given MovableObject.
+        void removeOccluder( const MovableObject *movableObject );
+
+        /// Removes all occluders.
+        void removeAllOccluders(void);
+
+        size_t getNumOccluders(void) const                      { return mOccluders.size(); }
+
+        uint32 getWidth(void) const                             { return mWidth; }
+        uint32 getHeight(void) const                            { return mHeight; }
+
+        /// Returns the depth buffer from the last rasterization. @See mDepthBuffer
+        const Real* getDepthBuffer(void) const                  { return mDepthBuffer; }
+
+        /** Transforms the occluders to the camera's screen space, and bins them
+            per tile. Must be called from the main thread, before _rasterizeTile.
+        @return
+            False if there are no occluders in view (there's nothing to test against).
+        */
+        bool _prepare( const Camera *camera );
+
+        size_t _getNumTiles(void) const                         { return mTileBins.size(); }
+
+        /** Clears the given tile and rasterizes all the occluders overlapping it.
+            Can be called from multiple threads, as long as each tile is only
+            processed once.
+        */
+        void _rasterizeTile( size_t tileIdx );
+
+        /** Returns true if the given Aabb is completely hidden behind the occluders.
+            All tiles must have been rasterized. Thread safe.
+        */
+        bool isOccluded( const Aabb &worldAabb ) const;
+
+        /** Removes the objects in range [firstIdx; inOutObjects.size()) that are hidden
+            behind the occluders, preserving the order of the rest. Thread safe.
+        */
+        void _cullOccluded( MovableObject::MovableObjectArray &inOutObjects, size_t firstIdx ) const;
+    };
+
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -0,0 +1,180 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __OgreTimelineProfiler_H__
+#define __OgreTimelineProfiler_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Records when each phase of the frame starts and ends, in a separate timeline per
+        thread, so that load imbalance between the worker threads can be inspected.
+    @remarks
+        Unlike Profiler, it doesn't build a hierarchy nor averages anything. Each thread
+        owns a track (a ring buffer of events) and is the only one writing to it, so no
+        locking is needed. Once the ring buffer is full, the oldest events are overwritten.
+        Use the macro OgreTimelineScope( name, trackIdx ) to time the rest of a scope.
+        When disabled, the cost of a scope is a single branch.
+        By convention track 0 belongs to the main thread and track 1 + i to the
+        SceneManager's worker thread i. Since tracks aren't locked, never use the
+        same track from two threads at the same time.
+    @par
+        Code that may run in any thread should pass CurrentThreadTrack instead of a
+        track index; it resolves to the track assigned to the calling thread with
+        setCurrentThreadTrack (the SceneManager's worker threads and the thread that
+        called enable are assigned automatically). Threads without a track don't
+        record anything.
+        The results can be saved with exportChromeTrace and loaded in chrome://tracing
+    */
+    class _OgreExport TimelineProfiler
+    {
+    public:
+        /// Pass it as trackIdx to record into the calling thread's own track.
+        static const size_t CurrentThreadTrack;
+
+        struct Event
+        {
+            /// Must point to a string with static storage (i.e. a literal).
+            const char  *name;
+            uint64      start;
+            uint64      end;
+        };
+
+        struct Track
+        {
+            Timer   *timer;
+            Event   *events;
+            /// Capacity of events - 1. Capacity is always power of 2.
+            size_t  mask;
+            /// Total events written. May be bigger than the capacity
+            size_t  numWritten;
+            String  name;
+        };
+
+    private:
+        static bool     msEnabled;
+        static Track    *msTracks;
+        static size_t   msNumTracks;
+
+        static void destroyTracks(void);
+
+    public:
+        /** Starts recording. Must be called from the main thread while the worker
+            threads are idle (i.e. between frames). Previous recordings are discarded.
+            The calling thread gets assigned track 0.
+        @param numTracks
+            Number of tracks. Usually 1 + SceneManager::getNumWorkerThreads()
+        @param eventsPerTrack
+            Size of each ring buffer. Gets rounded up to the next power of 2.
+        */
+        static void enable( size_t numTracks, size_t eventsPerTrack = 4096u );
+
+        /// Stops recording. Recorded events are kept so they can be exported.
+        static void disable(void);
+
+        /// Frees all memory. Must be called while the worker threads are idle.
+        static void shutdown(void);
+
+        static bool isEnabled(void)                 { return msEnabled; }
+        static size_t getNumTracks(void)            { return msNumTracks; }
+
+        /// Names the track in the exported trace. Default is "Main" for track 0,
+        /// "Worker #" for the rest.
+        static void setTrackName( size_t trackIdx, const String &name );
+
+        /** Assigns a track to the calling thread, used when recording with
+            CurrentThreadTrack. Can be called at any time, even while disabled.
+        @param trackIdx
+            Track to use. CurrentThreadTrack means the thread has no track.
+        */
+        static void setCurrentThreadTrack( size_t trackIdx );
+
+        /// Returns the track assigned to the calling thread, CurrentThreadTrack if none.
+        static size_t getCurrentThreadTrack(void);
+
+        /// Returns null if the track doesn't exist.
+        /// Resolves CurrentThreadTrack to the calling thread's track.
+        static Track* _getTrack( size_t trackIdx );
+        static uint64 _getTime( Track *track );
+        static void _addEvent( Track *track, const char *name, uint64 start );
+
+        /** Writes the events that are still in the ring buffers in Chrome's trace event
+            format (JSON). Must not be called while other threads are recording.
+        @param outString
+            String to append the JSON to.
+        */
+        static void exportChromeTrace( String &outString );
+    };
+
+    /// Times its lifetime. Use the OgreTimelineScope macro instead.
+    class TimelineScope
+    {
+        TimelineProfiler::Track *mTrack;
+        const char              *mName;
+        uint64                  mStart;
+
+    public:
+        TimelineScope( const char *name, size_t trackIdx ) :
+            mTrack( 0 ),
+            mName( name ),
+            mStart( 0 )
+        {
+            if( TimelineProfiler::isEnabled() )
+            {
+                mTrack = TimelineProfiler::_getTrack( trackIdx );
+                if( mTrack )
+                    mStart = TimelineProfiler::_getTime( mTrack );
+            }
+        }
+
+        ~TimelineScope()
+        {
+            if( mTrack )
+                TimelineProfiler::_addEvent( mTrack, mName, mStart );
+        }
+    };
+
+    /** @} */
+    /** @} */
+}
+
+#define OgreTimelineScope( name, trackIdx ) \
+    Ogre::TimelineScope _ogreTimelineScope( (name), (trackIdx) )
+
+#include "OgreHeaderSuffix.h"
+
+#endif
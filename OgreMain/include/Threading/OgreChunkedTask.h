@@ -0,0 +1,67 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __OgreChunkedTask_H__
+#define __OgreChunkedTask_H__
+
+#include "OgrePrerequisites.h"
+
+namespace Ogre
+{
+    /** A chunked task is a parallelizable task that is divided in many small, independent
+        chunks of work. Unlike UniformScalableTask, chunks are not bound to a particular
+        thread: idle worker threads keep grabbing the next unprocessed chunk until there are
+        none left, so chunks that take longer than others don't leave the rest of the
+        threads waiting.
+        As a rule of thumb, split your work in a few chunks per worker thread (i.e. 4x to 8x);
+        too many tiny chunks will waste time fighting over which thread grabs the next one.
+        Use it wherever it is accepted in Ogre.
+        For example @see SceneManager::executeUserChunkedTask
+    */
+    class _OgreExport ChunkedTask
+    {
+    public:
+        virtual ~ChunkedTask() {}
+
+        /// Returns the number of chunks. Will be called once, before any call to executeChunk.
+        virtual size_t getNumChunks(void) const = 0;
+
+        /** Overload this function to perform whatever you want. It will be
+            called from all worker threads at the same time, but each chunk
+            is executed exactly once.
+        @param chunkIdx
+            The index of the chunk to process. In range [0; getNumChunks())
+        @param threadId
+            The index of the thread it is being called from. Useful to write
+            to per-thread outputs without locking.
+        */
+        virtual void executeChunk( size_t chunkIdx, size_t threadId ) = 0;
+    };
+};
+
+#endif
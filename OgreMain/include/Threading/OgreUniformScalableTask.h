@@ -41,6 +41,9 @@ namespace Ogre
         physics engine.
         Use it wherever it is accepted in Ogre.
         For example @see SceneManager::processUserScalableTask
+    @remarks
+        If the work per thread is not uniform, prefer ChunkedTask instead, which
+        balances the load dynamically across all worker threads.
     */
     class _OgreExport UniformScalableTask
     {
@@ -38,7 +38,8 @@ namespace Ogre
 {
     BySkeletonDef::BySkeletonDef( const SkeletonDef *_skeletonDef, size_t threadCount ) :
         skeletonDef( _skeletonDef ),
-        skeletonDefName( _skeletonDef->getName() )
+        skeletonDefName( _skeletonDef->getName() ),
+        nextUpdateFrameOffset( 0 )
     {
         threadStarts.resize( threadCount + 1, 0 );
     }
@@ -115,6 +116,9 @@ namespace Ogre
 
         skeletonsArray.insert( it, newInstance );
 
+        //Spread throttled updates (@see SkeletonUpdatePolicy) evenly across frames
+        newInstance->_setUpdateFrameOffset( bySkelDef.nextUpdateFrameOffset++ );
+
 #if OGRE_DEBUG_MODE
         {
             //Check all depth levels respect the same ordering
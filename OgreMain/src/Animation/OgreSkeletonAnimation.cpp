@@ -195,7 +195,8 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
-    void SkeletonAnimation::_applyAnimation( const TransformArray &boneTransforms )
+    void SkeletonAnimation::_applyAnimation( const TransformArray &boneTransforms,
+                                             size_t numDepthLevels )
     {
         SkeletonTrackVec::const_iterator itor = mDefinition->mTracks.begin();
         SkeletonTrackVec::const_iterator end  = mDefinition->mTracks.end();
@@ -205,7 +206,8 @@ namespace Ogre
         ArrayReal simdWeight = Mathlib::SetAll( mWeight );
         ArrayReal * RESTRICT_ALIAS boneWeights = mBoneWeights.get();
 
-        while( itor != end )
+        //Tracks are sorted by block index, which has the depth level in the high bits
+        while( itor != end && (itor->getBoneBlockIdx() >> 24u) < numDepthLevels )
         {
             itor->applyKeyFrameRigAt( *itLastKnownKeyFrame, mCurrentFrame, simdWeight,
                                         boneWeights, boneTransforms );
@@ -47,7 +47,8 @@ namespace Ogre
         mNumFrames( 0 ),
         mOriginalFrameRate( 25.0f ),
         mSkeletonDef( 0 ),
-        mKfTransformMemoryManager( 0 )
+        mKfTransformMemoryManager( 0 ),
+        mCompressedKeyFrames( 0 )
     {
     }
     //-----------------------------------------------------------------------------------
@@ -61,6 +62,12 @@ namespace Ogre
             delete mKfTransformMemoryManager;
             mKfTransformMemoryManager = 0;
         }
+
+        if( mCompressedKeyFrames )
+        {
+            OGRE_FREE_SIMD( mCompressedKeyFrames, MEMCATEGORY_ANIMATION );
+            mCompressedKeyFrames = 0;
+        }
     }
     //-----------------------------------------------------------------------------------
     void SkeletonAnimationDef::build( const v1::Skeleton *skeleton, const v1::Animation *animation,
@@ -203,6 +210,48 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    void SkeletonAnimationDef::compressKeyFrames( const KfCompressionSettings &settings )
+    {
+        if( mCompressedKeyFrames || mTracks.empty() )
+            return;
+
+        vector<size_t>::type trackSizes;
+        trackSizes.reserve( mTracks.size() );
+
+        size_t totalSize = 0;
+        SkeletonTrackVec::iterator itor = mTracks.begin();
+        SkeletonTrackVec::iterator end  = mTracks.end();
+
+        while( itor != end )
+        {
+            trackSizes.push_back( itor->_prepareCompression( settings ) );
+            totalSize += trackSizes.back();
+            ++itor;
+        }
+
+        //All tracks share one allocation, in the same order they're evaluated
+        mCompressedKeyFrames = reinterpret_cast<uint8*>( OGRE_MALLOC_SIMD( totalSize,
+                                                                           MEMCATEGORY_ANIMATION ) );
+
+        uint8 *dstData = mCompressedKeyFrames;
+        vector<size_t>::type::const_iterator itSize = trackSizes.begin();
+        itor = mTracks.begin();
+
+        while( itor != end )
+        {
+            itor->_compress( dstData );
+            dstData += *itSize++;
+            ++itor;
+        }
+
+        if( mKfTransformMemoryManager )
+        {
+            mKfTransformMemoryManager->destroy();
+            delete mKfTransformMemoryManager;
+            mKfTransformMemoryManager = 0;
+        }
+    }
+    //-----------------------------------------------------------------------------------
     void SkeletonAnimationDef::getInterpolatedUnnormalizedKeyFrame( v1::OldNodeAnimationTrack *oldTrack,
                                                                     const v1::TimeIndex& timeIndex,
                                                                     v1::TransformKeyFrame* kf )
@@ -394,22 +443,14 @@ namespace Ogre
                     outText += boneDef.name;
                     outText += ",";
 
-                    KeyFrameRigVec::const_iterator itKeyFrames = keyFrames.begin();
-                    KeyFrameRigVec::const_iterator enKeyFrames = keyFrames.end();
-
-                    while( itKeyFrames != enKeyFrames )
+                    for( size_t j=0; j<keyFrames.size(); ++j )
                     {
-                        outText += StringConverter::toString( itKeyFrames->mFrame );
+                        outText += StringConverter::toString( keyFrames[j].mFrame );
                         outText += ",";
 
-                        const KfTransform * RESTRICT_ALIAS boneTransform = itKeyFrames->mBoneTransform;
-
                         Vector3 vPos, vScale;
                         Quaternion qRot;
-
-                        boneTransform->mPosition.getAsVector3( vPos, i );
-                        boneTransform->mOrientation.getAsQuaternion( qRot, i );
-                        boneTransform->mScale.getAsVector3( vScale, i );
+                        track.getKeyFrameTransform( j, static_cast<uint32>( i ), vPos, qRot, vScale );
 
                         outText += StringConverter::toString( vPos.x ) + ",";
                         outText += StringConverter::toString( vPos.y ) + ",";
@@ -421,7 +462,6 @@ namespace Ogre
                         outText += StringConverter::toString( vScale.x ) + ",";
                         outText += StringConverter::toString( vScale.y ) + ",";
                         outText += StringConverter::toString( vScale.z ) + ",";
-                        ++itKeyFrames;
                     }
 
                     outText += "\n";
@@ -325,6 +325,18 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    void SkeletonDef::compressAnimations( const KfCompressionSettings &settings )
+    {
+        SkeletonAnimationDefVec::iterator itor = mAnimationDefs.begin();
+        SkeletonAnimationDefVec::iterator end  = mAnimationDefs.end();
+
+        while( itor != end )
+        {
+            itor->compressKeyFrames( settings );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
     size_t SkeletonDef::getNumberOfBoneBlocks( size_t numLevels ) const
     {
         size_t numBlocks = 0;
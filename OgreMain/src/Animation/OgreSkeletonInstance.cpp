@@ -44,7 +44,10 @@ namespace Ogre
                                         BoneMemoryManager *boneMemoryManager ) :
             mDefinition( skeletonDef ),
             mParentNode( 0 ),
-            mRefCount( 1 )
+            mRefCount( 1 ),
+            mUpdateFrameOffset( 0 ),
+            mLastVisibleFrame( 0 ),
+            mLastVisibleDistance( 0 )
     {
         mBones.resize( mDefinition->getBones().size(), Bone() );
 
@@ -232,21 +235,64 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------------------
     void SkeletonInstance::update(void)
+    {
+        updateDepthLevels( mBoneStartTransforms.size() );
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonInstance::updateDepthLevels( size_t numDepthLevels )
     {
         if( !mActiveAnimations.empty() )
-            resetToPose();
+            resetDepthLevelsToPose( numDepthLevels );
 
         ActiveAnimationsVec::iterator itor = mActiveAnimations.begin();
         ActiveAnimationsVec::iterator end  = mActiveAnimations.end();
 
         while( itor != end )
         {
-            (*itor)->_applyAnimation( mBoneStartTransforms );
+            (*itor)->_applyAnimation( mBoneStartTransforms, numDepthLevels );
             ++itor;
         }
     }
     //-----------------------------------------------------------------------------------
+    bool SkeletonInstance::_updateFromPolicy( uint32 frameNumber )
+    {
+        if( mActiveAnimations.empty() )
+            return false;
+
+        //cullFrustum ran after the animations were updated, thus it's from the previous frame.
+        const bool wasVisible = frameNumber - mLastVisibleFrame <= 1u;
+
+        uint16 updateInterval = mUpdatePolicy.invisibleUpdateInterval;
+        size_t numDepthLevels = mBoneStartTransforms.size();
+
+        if( wasVisible )
+        {
+            updateInterval = 1u;
+            if( mLastVisibleDistance > mUpdatePolicy.farDistance )
+                updateInterval = mUpdatePolicy.farUpdateInterval;
+            if( mLastVisibleDistance > mUpdatePolicy.boneLodDistance )
+            {
+                numDepthLevels = std::min<size_t>( numDepthLevels,
+                                                   mUpdatePolicy.boneLodDepthLevels );
+            }
+        }
+
+        if( !updateInterval || !numDepthLevels ||
+            (frameNumber + mUpdateFrameOffset) % updateInterval )
+        {
+            return false;
+        }
+
+        updateDepthLevels( numDepthLevels );
+        return true;
+    }
+    //-----------------------------------------------------------------------------------
     void SkeletonInstance::resetToPose(void)
+    {
+        resetDepthLevelsToPose( mBoneStartTransforms.size() );
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonInstance::resetDepthLevelsToPose( size_t numDepthLevels )
     {
         KfTransform const * RESTRICT_ALIAS bindPose = mDefinition->getBindPose();
         ArrayReal const * RESTRICT_ALIAS manualBones = mManualBones.get();
@@ -255,7 +301,8 @@ namespace Ogre
                                                 mDefinition->getDepthLevelInfo().begin();
 
         TransformArray::iterator itor = mBoneStartTransforms.begin();
-        TransformArray::iterator end  = mBoneStartTransforms.end();
+        TransformArray::iterator end  = mBoneStartTransforms.begin() +
+                                            std::min( numDepthLevels, mBoneStartTransforms.size() );
 
         while( itor != end )
         {
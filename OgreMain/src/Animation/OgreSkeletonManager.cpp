@@ -45,7 +45,8 @@ namespace Ogre
         assert( msSingleton );  return ( *msSingleton );  
     }
     //-----------------------------------------------------------------------
-    SkeletonManager::SkeletonManager()
+    SkeletonManager::SkeletonManager() :
+        mCompressKeyFrames( false )
     {
     }
     //-----------------------------------------------------------------------
@@ -53,6 +54,12 @@ namespace Ogre
     {
     }
     //-----------------------------------------------------------------------
+    void SkeletonManager::setKeyFrameCompression( bool bEnabled, const KfCompressionSettings &settings )
+    {
+        mCompressKeyFrames      = bEnabled;
+        mKfCompressionSettings  = settings;
+    }
+    //-----------------------------------------------------------------------
     SkeletonDefPtr SkeletonManager::getSkeletonDef( v1::Skeleton *oldSkeletonBase )
     {
         IdString idName( oldSkeletonBase->getName() );
@@ -62,6 +69,8 @@ namespace Ogre
         {
             oldSkeletonBase->load();
             retVal = SkeletonDefPtr( new SkeletonDef( oldSkeletonBase, 1.0f ) );
+            if( mCompressKeyFrames )
+                retVal->compressAnimations( mKfCompressionSettings );
             mSkeletonDefs[idName] = retVal;
         }
         else
@@ -95,6 +104,8 @@ namespace Ogre
             if( oldSkeleton->isLoaded() )
             {
                 retVal = SkeletonDefPtr( new SkeletonDef( oldSkeleton.get(), 1.0f ) );
+                if( mCompressKeyFrames )
+                    retVal->compressAnimations( mKfCompressionSettings );
                 if( wasUnloaded )
                     oldSkeleton->unload();
                 if( wasNonExistent )
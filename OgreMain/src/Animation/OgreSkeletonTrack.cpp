@@ -38,13 +38,134 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    /// Quaternion components other than the largest are in range [-1/sqrt(2); 1/sqrt(2)]
+    static const Real c_quatComponentMax    = 0.707106781f;
+    static const Real c_quatQuantizeScale   = 32767.0f / (2.0f * c_quatComponentMax);
+    static const Real c_quatDequantizeScale = (2.0f * c_quatComponentMax) / 32767.0f;
+    /// Vectors are quantized to 16 bits. The encoder's error test and _compress must
+    /// derive the step with the very same expression, or they would disagree.
+    static const Real c_vectorDequantizeScale = 1.0f / 65535.0f;
+
+    /// Converts ARRAY_PACKED_REALS uint16 to ArrayReal
+    static inline ArrayReal loadQuantized( const uint16 * RESTRICT_ALIAS src )
+    {
+#if OGRE_USE_SIMD == 1 && OGRE_CPU == OGRE_CPU_X86 && ARRAY_PACKED_REALS == 8
+        return _mm256_cvtepi32_ps( _mm256_cvtepu16_epi32(
+                                       _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) ) ) );
+#elif OGRE_USE_SIMD == 1 && OGRE_CPU == OGRE_CPU_X86 && ARRAY_PACKED_REALS == 4
+        return _mm_cvtepi32_ps( _mm_unpacklo_epi16(
+                                    _mm_loadl_epi64( reinterpret_cast<const __m128i*>( src ) ),
+                                    _mm_setzero_si128() ) );
+#else
+        OGRE_ALIGNED_DECL( Real, tmp[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+        for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+            tmp[i] = static_cast<Real>( src[i] );
+        return *reinterpret_cast<const ArrayReal*>( tmp );
+#endif
+    }
+    //-----------------------------------------------------------------------------------
+    static inline ArrayVector3 decodeVector3( const uint16 * RESTRICT_ALIAS src,
+                                              const ArrayVector3 &vMin, const ArrayVector3 &vStep )
+    {
+        ArrayVector3 retVal( loadQuantized( src ),
+                             loadQuantized( src + ARRAY_PACKED_REALS ),
+                             loadQuantized( src + ARRAY_PACKED_REALS * 2 ) );
+        return vMin + retVal * vStep;
+    }
+    //-----------------------------------------------------------------------------------
+    static inline ArrayQuaternion decodeQuaternion( const uint16 * RESTRICT_ALIAS src )
+    {
+        ArrayReal a = loadQuantized( src );
+        ArrayReal b = loadQuantized( src + ARRAY_PACKED_REALS );
+        ArrayReal c = loadQuantized( src + ARRAY_PACKED_REALS * 2 );
+
+        //The top bits of a & b contain the index of the component that wasn't stored
+        const ArrayReal topBit = Mathlib::SetAll( 32768.0f );
+        ArrayMaskR noTopBitA = Mathlib::CompareLess( a, topBit );
+        ArrayMaskR noTopBitB = Mathlib::CompareLess( b, topBit );
+        a = Mathlib::Cmov4( a, a - topBit, noTopBitA );
+        b = Mathlib::Cmov4( b, b - topBit, noTopBitB );
+        ArrayReal largestIdx = Mathlib::Cmov4( ARRAY_REAL_ZERO, Mathlib::ONE, noTopBitA ) +
+                               Mathlib::Cmov4( ARRAY_REAL_ZERO, Mathlib::SetAll( 2.0f ), noTopBitB );
+
+        const ArrayReal dequantizeScale = Mathlib::SetAll( c_quatDequantizeScale );
+        const ArrayReal componentMax    = Mathlib::SetAll( c_quatComponentMax );
+        a = a * dequantizeScale - componentMax;
+        b = b * dequantizeScale - componentMax;
+        c = c * dequantizeScale - componentMax;
+
+        //d = sqrt( 1 - a^2 - b^2 - c^2 )
+        ArrayReal dSq = Mathlib::Max( Mathlib::ONE - (a * a + b * b + c * c), Mathlib::fSqEpsilon );
+        ArrayReal d = dSq * Mathlib::InvSqrtNonZero4( dSq );
+
+        ArrayMaskR isIdx0 = Mathlib::CompareLess( largestIdx, Mathlib::HALF );
+        ArrayMaskR isIdx1OrLess = Mathlib::CompareLess( largestIdx, Mathlib::SetAll( 1.5f ) );
+        ArrayMaskR isIdx2OrLess = Mathlib::CompareLess( largestIdx, Mathlib::SetAll( 2.5f ) );
+
+        return ArrayQuaternion( Mathlib::Cmov4( d, a, isIdx0 ),
+                                Mathlib::Cmov4( a, Mathlib::Cmov4( d, b, isIdx1OrLess ), isIdx0 ),
+                                Mathlib::Cmov4( b, Mathlib::Cmov4( d, c, isIdx2OrLess ),
+                                                isIdx1OrLess ),
+                                Mathlib::Cmov4( c, d, isIdx2OrLess ) );
+    }
+    //-----------------------------------------------------------------------------------
+    /// Scalar version of decodeQuaternion, which also writes the largest component positive
+    static void encodeQuaternion( const Quaternion &q, uint16 * RESTRICT_ALIAS dst )
+    {
+        Quaternion qNorm( q );
+        qNorm.normalise();
+        Real components[4] = { qNorm.w, qNorm.x, qNorm.y, qNorm.z };
+
+        size_t largestIdx = 0;
+        for( size_t i=1; i<4; ++i )
+        {
+            if( Math::Abs( components[i] ) > Math::Abs( components[largestIdx] ) )
+                largestIdx = i;
+        }
+
+        const Real sign = components[largestIdx] < 0 ? -1.0f : 1.0f;
+
+        size_t j = 0;
+        for( size_t i=0; i<4; ++i )
+        {
+            if( i != largestIdx )
+            {
+                Real value = (components[i] * sign + c_quatComponentMax) * c_quatQuantizeScale;
+                value = Math::Clamp( value + 0.5f, 0.0f, 32767.0f );
+                dst[ARRAY_PACKED_REALS * j++] = static_cast<uint16>( value );
+            }
+        }
+
+        dst[0]                  |= static_cast<uint16>( (largestIdx & 0x01) << 15u );
+        dst[ARRAY_PACKED_REALS] |= static_cast<uint16>( (largestIdx >> 1u) << 15u );
+    }
+    //-----------------------------------------------------------------------------------
+    /// Quantizes each component to [0; 65535] using the given range
+    static void encodeVector3( const Vector3 &v, const Vector3 &vMin, const Vector3 &vStep,
+                               uint16 * RESTRICT_ALIAS dst )
+    {
+        for( size_t i=0; i<3; ++i )
+        {
+            Real value = 0;
+            if( vStep[i] > 0 )
+                value = Math::Clamp( (v[i] - vMin[i]) / vStep[i] + 0.5f, 0.0f, 65535.0f );
+            dst[ARRAY_PACKED_REALS * i] = static_cast<uint16>( value );
+        }
+    }
+    //-----------------------------------------------------------------------------------
     SkeletonTrack::SkeletonTrack( uint32 boneBlockIdx,
                                     KfTransformArrayMemoryManager *kfTransformMemoryManager ) :
         mKeyFrameRigs( 0 ),
         mNumFrames( 0 ),
         mBoneBlockIdx( boneBlockIdx ),
         mUsedSlots( 0 ),
-        mLocalMemoryManager( kfTransformMemoryManager )
+        mLocalMemoryManager( kfTransformMemoryManager ),
+        mCompressedData( 0 ),
+        mCompressedHeaderSize( 0 ),
+        mCompressedKeyStride( 0 ),
+        mPositionEncoding( KfRaw ),
+        mRotationEncoding( KfRaw ),
+        mScaleEncoding( KfRaw )
     {
     }
     //-----------------------------------------------------------------------------------
@@ -60,6 +181,7 @@ namespace Ogre
     void SkeletonTrack::addKeyFrame( Real timestamp, Real frameRate )
     {
         assert( mKeyFrameRigs.empty() || timestamp > mKeyFrameRigs.back().mFrame );
+        assert( !mCompressedData && "Can't add keyframes to a compressed track" );
 
         mKeyFrameRigs.push_back( KeyFrameRig() );
         KeyFrameRig &keyFrame = mKeyFrameRigs.back();
@@ -77,6 +199,12 @@ namespace Ogre
     void SkeletonTrack::setKeyFrameTransform( Real frame, uint32 slot, const Vector3 &vPos,
                                                 const Quaternion &qRot, const Vector3 vScale )
     {
+        if( mCompressedData )
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, "Keyframes can't be modified once compressed.",
+                         "SkeletonTrack::setKeyFrameTransform" );
+        }
+
         KeyFrameRigVec::iterator itor = mKeyFrameRigs.begin();
         KeyFrameRigVec::iterator end  = mKeyFrameRigs.end();
 
@@ -118,6 +246,70 @@ namespace Ogre
         outNextFrame    = nextFrame;
     }
     //-----------------------------------------------------------------------------------
+    inline void SkeletonTrack::decompressKeyFrame( size_t keyFrameIdx, ArrayVector3 &outPos,
+                                                   ArrayQuaternion &outRot,
+                                                   ArrayVector3 &outScale ) const
+    {
+        const uint8 * RESTRICT_ALIAS header = mCompressedData;
+        const uint8 * RESTRICT_ALIAS rawData = mCompressedData + mCompressedHeaderSize +
+                                               keyFrameIdx * mCompressedKeyStride;
+        const ArrayReal * RESTRICT_ALIAS rawReals = reinterpret_cast<const ArrayReal*>( rawData );
+        const uint16 * RESTRICT_ALIAS quantized = reinterpret_cast<const uint16*>(
+                    rawData + ((mPositionEncoding == KfRaw) + (mScaleEncoding == KfRaw)) *
+                    sizeof(ArrayVector3) + (mRotationEncoding == KfRaw) * sizeof(ArrayQuaternion) );
+
+        //Position
+        if( mPositionEncoding == KfConstant )
+        {
+            outPos = *reinterpret_cast<const ArrayVector3*>( header );
+            header += sizeof(ArrayVector3);
+        }
+        else if( mPositionEncoding == KfQuantized )
+        {
+            const ArrayVector3 *minStep = reinterpret_cast<const ArrayVector3*>( header );
+            outPos = decodeVector3( quantized, minStep[0], minStep[1] );
+            header += sizeof(ArrayVector3) * 2u;
+            quantized += ARRAY_PACKED_REALS * 3u;
+        }
+        else
+        {
+            outPos = *reinterpret_cast<const ArrayVector3*>( rawReals );
+            rawReals += 3u;
+        }
+
+        //Rotation
+        if( mRotationEncoding == KfConstant )
+        {
+            outRot = *reinterpret_cast<const ArrayQuaternion*>( header );
+            header += sizeof(ArrayQuaternion);
+        }
+        else if( mRotationEncoding == KfQuantized )
+        {
+            outRot = decodeQuaternion( quantized );
+            quantized += ARRAY_PACKED_REALS * 3u;
+        }
+        else
+        {
+            outRot = *reinterpret_cast<const ArrayQuaternion*>( rawReals );
+            rawReals += 4u;
+        }
+
+        //Scale
+        if( mScaleEncoding == KfConstant )
+        {
+            outScale = *reinterpret_cast<const ArrayVector3*>( header );
+        }
+        else if( mScaleEncoding == KfQuantized )
+        {
+            const ArrayVector3 *minStep = reinterpret_cast<const ArrayVector3*>( header );
+            outScale = decodeVector3( quantized, minStep[0], minStep[1] );
+        }
+        else
+        {
+            outScale = *reinterpret_cast<const ArrayVector3*>( rawReals );
+        }
+    }
+    //-----------------------------------------------------------------------------------
     void SkeletonTrack::applyKeyFrameRigAt( KeyFrameRigVec::const_iterator &inOutLastKnownKeyFrameRig,
                                             float frame, ArrayReal animWeight,
                                             const ArrayReal * RESTRICT_ALIAS perBoneWeights,
@@ -137,17 +329,32 @@ namespace Ogre
         ArrayVector3 * RESTRICT_ALIAS finalScale    = boneTransforms[level].mScale + offset;
         ArrayQuaternion * RESTRICT_ALIAS finalRot   = boneTransforms[level].mOrientation + offset;
 
-        KfTransform * RESTRICT_ALIAS prevTransf = prevFrame->mBoneTransform;
-        KfTransform * RESTRICT_ALIAS nextTransf = nextFrame->mBoneTransform;
-
         ArrayVector3 interpPos, interpScale;
         ArrayQuaternion interpRot;
-        //Interpolate keyframes' rotation not using shortestPath to respect the original animation
-        interpPos   = Math::lerp( prevTransf->mPosition, nextTransf->mPosition, fTimeW );
-        interpRot   = ArrayQuaternion::nlerpShortest( fTimeW,
-                                                      prevTransf->mOrientation,
-                                                      nextTransf->mOrientation );
-        interpScale = Math::lerp( prevTransf->mScale, nextTransf->mScale, fTimeW );
+
+        if( !mCompressedData )
+        {
+            KfTransform * RESTRICT_ALIAS prevTransf = prevFrame->mBoneTransform;
+            KfTransform * RESTRICT_ALIAS nextTransf = nextFrame->mBoneTransform;
+
+            //Interpolate keyframes' rotation not using shortestPath to respect the original animation
+            interpPos   = Math::lerp( prevTransf->mPosition, nextTransf->mPosition, fTimeW );
+            interpRot   = ArrayQuaternion::nlerpShortest( fTimeW,
+                                                          prevTransf->mOrientation,
+                                                          nextTransf->mOrientation );
+            interpScale = Math::lerp( prevTransf->mScale, nextTransf->mScale, fTimeW );
+        }
+        else
+        {
+            ArrayVector3 prevPos, prevScale, nextPos, nextScale;
+            ArrayQuaternion prevRot, nextRot;
+            decompressKeyFrame( prevFrame - mKeyFrameRigs.begin(), prevPos, prevRot, prevScale );
+            decompressKeyFrame( nextFrame - mKeyFrameRigs.begin(), nextPos, nextRot, nextScale );
+
+            interpPos   = Math::lerp( prevPos, nextPos, fTimeW );
+            interpRot   = ArrayQuaternion::nlerpShortest( fTimeW, prevRot, nextRot );
+            interpScale = Math::lerp( prevScale, nextScale, fTimeW );
+        }
 
         //Combine our internal flag (that prevents blending
         //unanimated bones) with user's custom weights
@@ -165,6 +372,7 @@ namespace Ogre
     void SkeletonTrack::_bakeUnusedSlots(void)
     {
         assert( mUsedSlots <= ARRAY_PACKED_REALS );
+        assert( !mCompressedData );
 
         if( mUsedSlots <= (ARRAY_PACKED_REALS >> 1) )
         {
@@ -191,4 +399,325 @@ namespace Ogre
             }
         }
     }
+    //-----------------------------------------------------------------------------------
+    void SkeletonTrack::getKeyFrameTransform( size_t keyFrameIdx, uint32 slot, Vector3 &outPos,
+                                              Quaternion &outRot, Vector3 &outScale ) const
+    {
+        assert( keyFrameIdx < mKeyFrameRigs.size() && slot < ARRAY_PACKED_REALS );
+
+        if( !mCompressedData )
+        {
+            const KfTransform * RESTRICT_ALIAS kfTransform = mKeyFrameRigs[keyFrameIdx].mBoneTransform;
+            kfTransform->mPosition.getAsVector3( outPos, slot );
+            kfTransform->mOrientation.getAsQuaternion( outRot, slot );
+            kfTransform->mScale.getAsVector3( outScale, slot );
+        }
+        else
+        {
+            ArrayVector3 vPos, vScale;
+            ArrayQuaternion qRot;
+            decompressKeyFrame( keyFrameIdx, vPos, qRot, vScale );
+            vPos.getAsVector3( outPos, slot );
+            qRot.getAsQuaternion( outRot, slot );
+            vScale.getAsVector3( outScale, slot );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonTrack::getChannelRange( ArrayVector3 KfTransform::*channel,
+                                         ArrayVector3 &outMin, ArrayVector3 &outMax ) const
+    {
+        assert( !mKeyFrameRigs.empty() );
+
+        outMin = mKeyFrameRigs.front().mBoneTransform->*channel;
+        outMax = outMin;
+
+        KeyFrameRigVec::const_iterator itor = mKeyFrameRigs.begin() + 1;
+        KeyFrameRigVec::const_iterator end  = mKeyFrameRigs.end();
+
+        while( itor != end )
+        {
+            outMin.makeFloor( itor->mBoneTransform->*channel );
+            outMax.makeCeil( itor->mBoneTransform->*channel );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    uint8 SkeletonTrack::chooseVectorEncoding( ArrayVector3 KfTransform::*channel,
+                                               Real maxError ) const
+    {
+        ArrayVector3 vMinArray, vMaxArray;
+        getChannelRange( channel, vMinArray, vMaxArray );
+
+        Vector3 vMin[ARRAY_PACKED_REALS];
+        Vector3 vStep[ARRAY_PACKED_REALS];
+
+        bool isConstant = true;
+        for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+        {
+            Vector3 vMax;
+            vMinArray.getAsVector3( vMin[i], i );
+            vMaxArray.getAsVector3( vMax, i );
+            const Vector3 vExtent = vMax - vMin[i];
+            isConstant &= vExtent.x * 0.5f <= maxError &&
+                          vExtent.y * 0.5f <= maxError &&
+                          vExtent.z * 0.5f <= maxError;
+            vStep[i] = vExtent * c_vectorDequantizeScale;
+        }
+
+        if( isConstant )
+            return KfConstant;
+
+        //Quantization error is half a step, but floating point precision may
+        //make it worse for large values. Test the round trip of every value.
+        KeyFrameRigVec::const_iterator itor = mKeyFrameRigs.begin();
+        KeyFrameRigVec::const_iterator end  = mKeyFrameRigs.end();
+
+        while( itor != end )
+        {
+            const ArrayVector3 &value = itor->mBoneTransform->*channel;
+            for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+            {
+                Vector3 vOriginal;
+                value.getAsVector3( vOriginal, i );
+
+                uint16 quantized[ARRAY_PACKED_REALS * 3];
+                encodeVector3( vOriginal, vMin[i], vStep[i], quantized );
+
+                for( size_t j=0; j<3; ++j )
+                {
+                    const Real decoded = vMin[i][j] + quantized[ARRAY_PACKED_REALS * j] * vStep[i][j];
+                    if( Math::Abs( decoded - vOriginal[j] ) > maxError )
+                        return KfRaw;
+                }
+            }
+
+            ++itor;
+        }
+
+        return KfQuantized;
+    }
+    //-----------------------------------------------------------------------------------
+    uint8 SkeletonTrack::chooseRotationEncoding( Real maxError ) const
+    {
+        const ArrayQuaternion &firstRot = mKeyFrameRigs.front().mBoneTransform->mOrientation;
+
+        bool isConstant = true;
+        bool canQuantize = true;
+
+        KeyFrameRigVec::const_iterator itor = mKeyFrameRigs.begin();
+        KeyFrameRigVec::const_iterator end  = mKeyFrameRigs.end();
+
+        while( itor != end && (isConstant || canQuantize) )
+        {
+            const ArrayQuaternion &rot = itor->mBoneTransform->mOrientation;
+            for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+            {
+                Quaternion qFirst, qOriginal;
+                firstRot.getAsQuaternion( qFirst, i );
+                rot.getAsQuaternion( qOriginal, i );
+
+                for( size_t j=0; j<4; ++j )
+                    isConstant &= Math::Abs( qOriginal[j] - qFirst[j] ) <= maxError;
+
+                if( canQuantize )
+                {
+                    //Interpolated keyframes may not be unit length. Since quantization
+                    //normalizes them, the test below rejects those beyond the budget.
+                    uint16 quantized[ARRAY_PACKED_REALS * 3];
+                    memset( quantized, 0, sizeof( quantized ) );
+                    encodeQuaternion( qOriginal, quantized );
+
+                    const size_t largestIdx = (quantized[0] >> 15u) |
+                                              ((quantized[ARRAY_PACKED_REALS] >> 15u) << 1u);
+                    Real stored[3];
+                    Real dSq = 1.0f;
+                    for( size_t j=0; j<3; ++j )
+                    {
+                        stored[j] = (quantized[ARRAY_PACKED_REALS * j] & 0x7FFF) *
+                                    c_quatDequantizeScale - c_quatComponentMax;
+                        dSq -= stored[j] * stored[j];
+                    }
+
+                    Quaternion qDecoded;
+                    size_t k = 0;
+                    for( size_t j=0; j<4; ++j )
+                        qDecoded[j] = j == largestIdx ? Math::Sqrt( std::max( dSq, Real( 0 ) ) ) :
+                                                        stored[k++];
+
+                    const Real sign = qDecoded.Dot( qOriginal ) < 0 ? -1.0f : 1.0f;
+                    for( size_t j=0; j<4; ++j )
+                        canQuantize &= Math::Abs( qDecoded[j] * sign - qOriginal[j] ) <= maxError;
+                }
+            }
+
+            ++itor;
+        }
+
+        return isConstant ? KfConstant : (canQuantize ? KfQuantized : KfRaw);
+    }
+    //-----------------------------------------------------------------------------------
+    size_t SkeletonTrack::_prepareCompression( const KfCompressionSettings &settings )
+    {
+        assert( !mCompressedData && !mKeyFrameRigs.empty() );
+
+        mPositionEncoding   = chooseVectorEncoding( &KfTransform::mPosition, settings.maxPositionError );
+        mRotationEncoding   = chooseRotationEncoding( settings.maxRotationError );
+        mScaleEncoding      = chooseVectorEncoding( &KfTransform::mScale, settings.maxScaleError );
+
+        size_t headerSize   = 0;
+        size_t rawSize      = 0;
+        size_t numQuantized = 0;
+
+        const uint8 vectorEncodings[2] = { mPositionEncoding, mScaleEncoding };
+        for( size_t i=0; i<2; ++i )
+        {
+            if( vectorEncodings[i] == KfConstant )
+                headerSize += sizeof(ArrayVector3);
+            else if( vectorEncodings[i] == KfQuantized )
+                headerSize += sizeof(ArrayVector3) * 2u;
+            else
+                rawSize += sizeof(ArrayVector3);
+
+            numQuantized += vectorEncodings[i] == KfQuantized;
+        }
+
+        if( mRotationEncoding == KfConstant )
+            headerSize += sizeof(ArrayQuaternion);
+        else if( mRotationEncoding == KfRaw )
+            rawSize += sizeof(ArrayQuaternion);
+        numQuantized += mRotationEncoding == KfQuantized;
+
+        mCompressedHeaderSize = static_cast<uint32>( headerSize );
+        mCompressedKeyStride  = static_cast<uint32>(
+                    alignToNextMultiple( rawSize + numQuantized * sizeof(uint16) * 3u *
+                                         ARRAY_PACKED_REALS, sizeof(ArrayReal) ) );
+
+        return mCompressedHeaderSize + mCompressedKeyStride * mKeyFrameRigs.size();
+    }
+    //-----------------------------------------------------------------------------------
+    void SkeletonTrack::_compress( uint8 *dstData )
+    {
+        assert( !mCompressedData );
+        assert( !((size_t)dstData & (sizeof(ArrayReal) - 1u)) && "dstData must be SIMD aligned" );
+
+        const KfTransform &firstTransform = *mKeyFrameRigs.front().mBoneTransform;
+
+        //Header
+        uint8 * RESTRICT_ALIAS header = dstData;
+
+        Vector3 vPosMin[ARRAY_PACKED_REALS], vPosStep[ARRAY_PACKED_REALS];
+        Vector3 vScaleMin[ARRAY_PACKED_REALS], vScaleStep[ARRAY_PACKED_REALS];
+
+        ArrayVector3 KfTransform::*vectorChannels[2] = { &KfTransform::mPosition,
+                                                         &KfTransform::mScale };
+        const uint8 vectorEncodings[2] = { mPositionEncoding, mScaleEncoding };
+        Vector3 *vMins[2]   = { vPosMin, vScaleMin };
+        Vector3 *vSteps[2]  = { vPosStep, vScaleStep };
+
+        for( size_t i=0; i<2; ++i )
+        {
+            if( vectorEncodings[i] == KfConstant || vectorEncodings[i] == KfQuantized )
+            {
+                ArrayVector3 vMin, vMax;
+                getChannelRange( vectorChannels[i], vMin, vMax );
+                ArrayVector3 *dstVector = reinterpret_cast<ArrayVector3*>( header );
+
+                if( vectorEncodings[i] == KfConstant )
+                {
+                    //Midpoint, so that the error is at most half the extent
+                    *dstVector = vMin + (vMax - vMin) * 0.5f;
+                    header += sizeof(ArrayVector3);
+                }
+                else
+                {
+                    dstVector[0] = vMin;
+                    dstVector[1] = (vMax - vMin) * c_vectorDequantizeScale;
+
+                    for( size_t j=0; j<ARRAY_PACKED_REALS; ++j )
+                    {
+                        dstVector[0].getAsVector3( vMins[i][j], j );
+                        dstVector[1].getAsVector3( vSteps[i][j], j );
+                    }
+                    header += sizeof(ArrayVector3) * 2u;
+                }
+            }
+
+            if( i == 0 && mRotationEncoding == KfConstant )
+            {
+                *reinterpret_cast<ArrayQuaternion*>( header ) = firstTransform.mOrientation;
+                header += sizeof(ArrayQuaternion);
+            }
+        }
+
+        assert( static_cast<size_t>( header - dstData ) == mCompressedHeaderSize );
+
+        //Keyframes
+        uint8 * RESTRICT_ALIAS keyData = dstData + mCompressedHeaderSize;
+        KeyFrameRigVec::iterator itor = mKeyFrameRigs.begin();
+        KeyFrameRigVec::iterator end  = mKeyFrameRigs.end();
+
+        while( itor != end )
+        {
+            memset( keyData, 0, mCompressedKeyStride );
+
+            const KfTransform &kfTransform = *itor->mBoneTransform;
+            uint8 * RESTRICT_ALIAS rawData = keyData;
+
+            if( mPositionEncoding == KfRaw )
+            {
+                *reinterpret_cast<ArrayVector3*>( rawData ) = kfTransform.mPosition;
+                rawData += sizeof(ArrayVector3);
+            }
+            if( mRotationEncoding == KfRaw )
+            {
+                *reinterpret_cast<ArrayQuaternion*>( rawData ) = kfTransform.mOrientation;
+                rawData += sizeof(ArrayQuaternion);
+            }
+            if( mScaleEncoding == KfRaw )
+            {
+                *reinterpret_cast<ArrayVector3*>( rawData ) = kfTransform.mScale;
+                rawData += sizeof(ArrayVector3);
+            }
+
+            uint16 * RESTRICT_ALIAS quantized = reinterpret_cast<uint16*>( rawData );
+            for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+            {
+                Vector3 vTmp;
+                Quaternion qTmp;
+                uint16 * RESTRICT_ALIAS dst = quantized + i;
+
+                if( mPositionEncoding == KfQuantized )
+                {
+                    kfTransform.mPosition.getAsVector3( vTmp, i );
+                    encodeVector3( vTmp, vPosMin[i], vPosStep[i], dst );
+                    dst += ARRAY_PACKED_REALS * 3u;
+                }
+                if( mRotationEncoding == KfQuantized )
+                {
+                    kfTransform.mOrientation.getAsQuaternion( qTmp, i );
+                    encodeQuaternion( qTmp, dst );
+                    dst += ARRAY_PACKED_REALS * 3u;
+                }
+                if( mScaleEncoding == KfQuantized )
+                {
+                    kfTransform.mScale.getAsVector3( vTmp, i );
+                    encodeVector3( vTmp, vScaleMin[i], vScaleStep[i], dst );
+                }
+            }
+
+            keyData += mCompressedKeyStride;
+            ++itor;
+        }
+
+        //The KfTransforms are no longer referenced. Its memory manager may now go away.
+        itor = mKeyFrameRigs.begin();
+        while( itor != end )
+        {
+            itor->mBoneTransform = 0;
+            ++itor;
+        }
+
+        mLocalMemoryManager = 0;
+        mCompressedData = dstData;
+    }
 }
@@ -471,6 +471,8 @@ namespace Ogre
             ++itor;
         }
 
+        cullShadowMapsBatch( lodCamera, sceneManager );
+
         SceneManager::IlluminationRenderStage previous = sceneManager->_getCurrentRenderStage();
         sceneManager->_setCurrentRenderStage( SceneManager::IRS_RENDER_TO_TEXTURE );
 
@@ -480,6 +482,48 @@ namespace Ogre
         sceneManager->_setCurrentRenderStage( previous );
     }
     //-----------------------------------------------------------------------------------
+    void CompositorShadowNode::cullShadowMapsBatch( const Camera *lodCamera,
+                                                    SceneManager *sceneManager )
+    {
+        CullFrustumBatchEntryArray cullEntries;
+        cullEntries.reserve( mPasses.size() );
+
+        const uint8 executionMask = mWorkspace->getExecutionMask();
+
+        //Gather the scene passes that will get executed in CompositorNode::_update
+        CompositorPassVec::const_iterator itor = mPasses.begin();
+        CompositorPassVec::const_iterator end  = mPasses.end();
+
+        while( itor != end )
+        {
+            const CompositorPassDef *passDef = (*itor)->getDefinition();
+
+            if( passDef->getType() == PASS_SCENE && (executionMask & passDef->mExecutionMask) &&
+                isShadowMapIdxActive( passDef->mShadowMapIdx ) )
+            {
+                assert( dynamic_cast<CompositorPassScene*>( *itor ) );
+                const CompositorPassScene *passScene = static_cast<CompositorPassScene*>( *itor );
+                const CompositorPassSceneDef *passSceneDef = passScene->getDefinition();
+
+                //Cubemap passes reorient the camera right before culling
+                if( !passSceneDef->mCameraCubemapReorient )
+                {
+                    cullEntries.push_back( CullFrustumBatchEntry(
+                                               passScene->getCamera(),
+                                               passScene->_getUsedLodCamera( lodCamera ),
+                                               passSceneDef->mVisibilityMask,
+                                               passSceneDef->mFirstRQ, passSceneDef->mLastRQ ) );
+                }
+            }
+
+            ++itor;
+        }
+
+        //With only one camera there's nothing to share; let _cullPhase01 do the usual work.
+        if( cullEntries.size() > 1u )
+            sceneManager->cullFrustumBatch( cullEntries.begin(), cullEntries.size() );
+    }
+    //-----------------------------------------------------------------------------------
     void CompositorShadowNode::postInitializePass( CompositorPass *pass )
     {
         const CompositorPassDef *passDef = pass->getDefinition();
@@ -87,9 +87,7 @@ namespace Ogre
             --mNumPassesLeft;
         }
 
-        Camera const *usedLodCamera = mLodCamera;
-        if( lodCamera && mCamera == mLodCamera )
-            usedLodCamera = lodCamera;
+        Camera const *usedLodCamera = _getUsedLodCamera( lodCamera );
 
         //store the viewports current material scheme and use the one set in the scene pass def
         String oldViewportMatScheme = mViewport->getMaterialScheme();
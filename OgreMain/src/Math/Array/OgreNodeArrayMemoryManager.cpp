@@ -48,7 +48,8 @@ namespace Ogre
         3 * sizeof( Ogre::Real ),       //ArrayMemoryManager::DerivedScale
         16 * sizeof( Ogre::Real ),      //ArrayMemoryManager::WorldMat
         sizeof( bool ),                 //ArrayMemoryManager::InheritOrientation
-        sizeof( bool )                  //ArrayMemoryManager::InheritScale
+        sizeof( bool ),                 //ArrayMemoryManager::InheritScale
+        sizeof( bool )                  //ArrayMemoryManager::Dirty
     };
     const CleanupRoutines NodeArrayMemoryManager::NodeCleanupRoutines[NumMemoryTypes] =
     {
@@ -62,7 +63,8 @@ namespace Ogre
         cleanerArrayVector3,            //ArrayMemoryManager::DerivedScale
         cleanerFlat,                    //ArrayMemoryManager::WorldMat
         cleanerFlat,                    //ArrayMemoryManager::InheritOrientation
-        cleanerFlat                     //ArrayMemoryManager::InheritScale
+        cleanerFlat,                    //ArrayMemoryManager::InheritScale
+        cleanerFlat                     //ArrayMemoryManager::Dirty
     };
     //-----------------------------------------------------------------------------------
     NodeArrayMemoryManager::NodeArrayMemoryManager( uint16 depthLevel, size_t hintMaxNodes,
@@ -126,6 +128,8 @@ namespace Ogre
                                                 nextSlotBase * mElementsMemSizes[InheritOrientation] );
         outTransform.mInheritScale      = reinterpret_cast<bool*>( mMemoryPools[InheritScale] +
                                                 nextSlotBase * mElementsMemSizes[InheritScale] );
+        outTransform.mDirty             = reinterpret_cast<bool*>( mMemoryPools[Dirty] +
+                                                nextSlotBase * mElementsMemSizes[Dirty] );
 
         //Set default values
         outTransform.mParents[nextSlotIdx] = mDummyNode;
@@ -139,6 +143,7 @@ namespace Ogre
         outTransform.mDerivedTransform[nextSlotIdx] = Matrix4::IDENTITY;
         outTransform.mInheritOrientation[nextSlotIdx]   = true;
         outTransform.mInheritScale[nextSlotIdx]         = true;
+        outTransform.mDirty[nextSlotIdx]                = true;
     }
     //-----------------------------------------------------------------------------------
     void NodeArrayMemoryManager::destroyNode( Transform &inOutTransform )
@@ -169,6 +174,7 @@ namespace Ogre
         outTransform.mDerivedTransform  = reinterpret_cast<Matrix4*>( mMemoryPools[WorldMat] );
         outTransform.mInheritOrientation= reinterpret_cast<bool*>( mMemoryPools[InheritOrientation] );
         outTransform.mInheritScale      = reinterpret_cast<bool*>( mMemoryPools[InheritScale] );
+        outTransform.mDirty             = reinterpret_cast<bool*>( mMemoryPools[Dirty] );
 
         return mUsedMemory;
     }
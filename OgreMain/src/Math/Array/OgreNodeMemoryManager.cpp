@@ -57,6 +57,9 @@ namespace Ogre
         mDummyTransformPtrs.mDerivedTransform   = reinterpret_cast<Matrix4*>( OGRE_MALLOC_SIMD(
                                                 sizeof( Matrix4 ) * ARRAY_PACKED_REALS,
                                                 MEMCATEGORY_SCENE_OBJECTS ) );
+        mDummyTransformPtrs.mDirty              = reinterpret_cast<bool*>( OGRE_MALLOC_SIMD(
+                                                sizeof( bool ) * ARRAY_PACKED_REALS,
+                                                MEMCATEGORY_SCENE_OBJECTS ) );
 
         /*mDummyTransformPtrs.mDerivedTransform = reinterpret_cast<ArrayMatrix4*>( OGRE_MALLOC_SIMD(
                                                 sizeof( ArrayMatrix4 ), MEMCATEGORY_SCENE_OBJECTS ) );
@@ -70,6 +73,8 @@ namespace Ogre
         *mDummyTransformPtrs.mDerivedScale          = ArrayVector3::UNIT_SCALE;
         for( int i=0; i<ARRAY_PACKED_REALS; ++i )
             mDummyTransformPtrs.mDerivedTransform[i] = Matrix4::IDENTITY;
+        //The dummy node never changes, so it never forces its children to be updated.
+        memset( mDummyTransformPtrs.mDirty, 0, sizeof( bool ) * ARRAY_PACKED_REALS );
 
         mDummyNode = new SceneNode( mDummyTransformPtrs );
     }
@@ -97,6 +102,7 @@ namespace Ogre
         OGRE_FREE_SIMD( mDummyTransformPtrs.mDerivedPosition, MEMCATEGORY_SCENE_OBJECTS );
         OGRE_FREE_SIMD( mDummyTransformPtrs.mDerivedOrientation, MEMCATEGORY_SCENE_OBJECTS );
         OGRE_FREE_SIMD( mDummyTransformPtrs.mDerivedScale, MEMCATEGORY_SCENE_OBJECTS );
+        OGRE_FREE_SIMD( mDummyTransformPtrs.mDirty, MEMCATEGORY_SCENE_OBJECTS );
 
         /*OGRE_FREE_SIMD( mDummyTransformPtrs.mDerivedTransform, MEMCATEGORY_SCENE_OBJECTS );
         OGRE_FREE_SIMD( mDummyTransformPtrs.mInheritOrientation, MEMCATEGORY_SCENE_OBJECTS );
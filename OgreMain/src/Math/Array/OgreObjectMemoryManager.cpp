@@ -34,6 +34,8 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    const size_t ObjectMemoryManager::NUM_PACKS_PER_CLUSTER = 16;
+    //-----------------------------------------------------------------------------------
     ObjectMemoryManager::ObjectMemoryManager() :
             mTotalObjects( 0 ),
             mDummyNode( 0 ),
@@ -125,6 +127,9 @@ namespace Ogre
                                             ArrayMemoryManager::MAX_MEMORY_SLOTS, this ) );
             mMemoryManagers.back().initialize();
         }
+
+        if( mPackClusters.size() < mMemoryManagers.size() )
+            mPackClusters.resize( mMemoryManagers.size() );
     }
     //-----------------------------------------------------------------------------------
     void ObjectMemoryManager::objectCreated( ObjectData &outObjectData, size_t renderQueue )
@@ -133,6 +138,7 @@ namespace Ogre
 
         ObjectDataArrayMemoryManager& mgr = mMemoryManagers[renderQueue];
         mgr.createNewNode( outObjectData );
+        mPackClusters[renderQueue].dirty = true;
 
         ++mTotalObjects;
     }
@@ -150,6 +156,9 @@ namespace Ogre
         ObjectDataArrayMemoryManager &mgr = mMemoryManagers[oldRenderQueue];
         mgr.destroyNode( inOutObjectData );
 
+        mPackClusters[oldRenderQueue].dirty = true;
+        mPackClusters[newRenderQueue].dirty = true;
+
         inOutObjectData = tmp;
     }
     //-----------------------------------------------------------------------------------
@@ -157,6 +166,7 @@ namespace Ogre
     {
         ObjectDataArrayMemoryManager &mgr = mMemoryManagers[renderQueue];
         mgr.destroyNode( outObjectData );
+        mPackClusters[renderQueue].dirty = true;
 
         --mTotalObjects;
     }
@@ -193,6 +203,72 @@ namespace Ogre
         return mMemoryManagers[renderQueue].getFirstNode( outObjectData );
     }
     //-----------------------------------------------------------------------------------
+    void ObjectMemoryManager::setPackClusterCulling( size_t renderQueue, bool bEnable )
+    {
+        growToDepth( renderQueue );
+
+        PackClusters &packClusters = mPackClusters[renderQueue];
+        packClusters.enabled = bEnable;
+        packClusters.dirty   = true;
+        if( !bEnable )
+            packClusters.aabbs.clear();
+    }
+    //-----------------------------------------------------------------------------------
+    bool ObjectMemoryManager::getPackClusterCulling( size_t renderQueue ) const
+    {
+        return renderQueue < mPackClusters.size() && mPackClusters[renderQueue].enabled;
+    }
+    //-----------------------------------------------------------------------------------
+    void ObjectMemoryManager::_updatePackClusters( bool forceRebuild )
+    {
+        for( size_t i=0; i<mPackClusters.size(); ++i )
+        {
+            PackClusters &packClusters = mPackClusters[i];
+
+            if( packClusters.enabled && (packClusters.dirty || forceRebuild) )
+            {
+                ObjectData objData;
+                const size_t totalObjs = getFirstObjectData( objData, i );
+                const size_t numPacks  = (totalObjs + ARRAY_PACKED_REALS - 1) / ARRAY_PACKED_REALS;
+
+                packClusters.aabbs.clear();
+                packClusters.aabbs.resize( (numPacks + NUM_PACKS_PER_CLUSTER - 1) /
+                                           NUM_PACKS_PER_CLUSTER, Aabb::BOX_NULL );
+
+                for( size_t j=0; j<numPacks; ++j )
+                {
+                    Aabb &clusterAabb = packClusters.aabbs[j / NUM_PACKS_PER_CLUSTER];
+
+                    for( size_t k=0; k<ARRAY_PACKED_REALS; ++k )
+                    {
+                        //Empty slots have a zero Aabb at the origin, which would
+                        //needlessly enlarge the cluster. Leave them out.
+                        if( objData.mOwner[k] )
+                            clusterAabb.merge( objData.mWorldAabb->getAsAabb( k ) );
+                    }
+
+                    objData.advancePack();
+                }
+
+                packClusters.dirty = false;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    const Aabb* ObjectMemoryManager::_getPackClusters( size_t renderQueue ) const
+    {
+        const Aabb *retVal = 0;
+
+        if( renderQueue < mPackClusters.size() )
+        {
+            const PackClusters &packClusters = mPackClusters[renderQueue];
+            if( packClusters.enabled && !packClusters.dirty && !packClusters.aabbs.empty() )
+                retVal = packClusters.aabbs.begin();
+        }
+
+        return retVal;
+    }
+    //-----------------------------------------------------------------------------------
     void ObjectMemoryManager::buildDiffList( ArrayMemoryManager::ManagerType managerType, uint16 level,
                                                 const MemoryPoolVec &basePtrs,
                                                 ArrayMemoryManager::PtrdiffVec &outDiffsList )
@@ -220,6 +296,8 @@ namespace Ogre
                                             const MemoryPoolVec &newBasePtrs,
                                             const ArrayMemoryManager::PtrdiffVec &diffsList )
     {
+        mPackClusters[level].dirty = true;
+
         ObjectData objectData;
         const size_t numObjs = this->getFirstObjectData( objectData, level );
 
@@ -242,6 +320,8 @@ namespace Ogre
                                         const MemoryPoolVec &basePtrs, size_t const *elementsMemSizes,
                                         size_t startInstance, size_t diffInstances )
     {
+        mPackClusters[level].dirty = true;
+
         ObjectData objectData;
         const size_t numObjs = this->getFirstObjectData( objectData, level );
 
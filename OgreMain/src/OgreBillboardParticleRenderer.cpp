@@ -131,7 +131,7 @@ namespace v1 {
     }
     //-----------------------------------------------------------------------
     void BillboardParticleRenderer::_updateRenderQueue(RenderQueue* queue, Camera *camera,
-        const Camera *lodCamera, list<Particle*>::type& currentParticles, bool cullIndividually,
+        const Camera *lodCamera, vector<Particle*>::type& currentParticles, bool cullIndividually,
         RenderableArray &outRenderables )
     {
         mBillboardSet->setCullIndividually(cullIndividually);
@@ -140,7 +140,7 @@ namespace v1 {
         // Update billboard set geometry
         mBillboardSet->beginBillboards(currentParticles.size());
         Billboard bb;
-        for (list<Particle*>::type::iterator i = currentParticles.begin();
+        for (vector<Particle*>::type::iterator i = currentParticles.begin();
             i != currentParticles.end(); ++i)
         {
             Particle* p = *i;
@@ -116,6 +116,27 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    /// Merges dst with the last element when both the source & destination
+    /// regions are contiguous, so that it becomes a single copy.
+    static void addCoalescedDestination( StagingBuffer::DestinationVec &destinations,
+                                         const StagingBuffer::Destination &dst )
+    {
+        if( !destinations.empty() )
+        {
+            StagingBuffer::Destination &lastElement = destinations.back();
+
+            if( lastElement.destination == dst.destination &&
+                lastElement.dstOffset + lastElement.length == dst.dstOffset &&
+                lastElement.srcOffset + lastElement.length == dst.srcOffset )
+            {
+                lastElement.length += dst.length;
+                return;
+            }
+        }
+
+        destinations.push_back( dst );
+    }
+    //-----------------------------------------------------------------------------------
     void ConstBufferPool::uploadDirtyDatablocks(void)
     {
         if( mDirtyUsers.empty() )
@@ -124,16 +145,16 @@ namespace Ogre
         const size_t materialSizeInGpu = mBytesPerSlot;
         const size_t extraBufferSizeInGpu = mExtraBufferParams.bytesPerSlot;
 
+        //Sorting by pool, then slot makes neighbouring slots land next to each other in
+        //the staging buffer, so that each run of dirty slots becomes a single copy.
         std::sort( mDirtyUsers.begin(), mDirtyUsers.end(), OrderConstBufferPoolUserByPoolThenSlot );
 
+        //All the pools share the same staging buffer & mapping.
         const size_t uploadSize = (materialSizeInGpu + extraBufferSizeInGpu) * mDirtyUsers.size();
         StagingBuffer *stagingBuffer = _mVaoManager->getStagingBuffer( uploadSize, true );
 
-        StagingBuffer::DestinationVec destinations;
-        StagingBuffer::DestinationVec extraDestinations;
-
-        destinations.reserve( mDirtyUsers.size() );
-        extraDestinations.reserve( mDirtyUsers.size() );
+        mUploadDestinations.clear();
+        mUploadExtraDestinations.clear();
 
         ConstBufferPoolUserVec::const_iterator itor = mDirtyUsers.begin();
         ConstBufferPoolUserVec::const_iterator end  = mDirtyUsers.end();
@@ -154,65 +175,37 @@ namespace Ogre
 
             const BufferPool *usersPool = (*itor)->getAssignedPool();
 
-            StagingBuffer::Destination dst( usersPool->materialBuffer, dstOffset,
-                                            srcOffset, materialSizeInGpu );
-
-            if( !destinations.empty() )
-            {
-                StagingBuffer::Destination &lastElement = destinations.back();
-
-                if( lastElement.destination == dst.destination &&
-                    (lastElement.dstOffset + lastElement.length == dst.dstOffset) )
-                {
-                    lastElement.length += dst.length;
-                }
-                else
-                {
-                    destinations.push_back( dst );
-                }
-            }
-            else
-            {
-                destinations.push_back( dst );
-            }
+            addCoalescedDestination( mUploadDestinations,
+                                     StagingBuffer::Destination( usersPool->materialBuffer, dstOffset,
+                                                                 srcOffset, materialSizeInGpu ) );
 
             if( usersPool->extraBuffer )
             {
-                (*itor)->uploadToExtraBuffer( extraData );
-                extraData += extraBufferSizeInGpu;
-
                 const size_t extraSrcOffset = static_cast<size_t>( extraData - bufferStart );
                 const size_t extraDstOffset = (*itor)->getAssignedSlot() * extraBufferSizeInGpu;
 
-                StagingBuffer::Destination extraDst( usersPool->extraBuffer, extraDstOffset,
-                                                     extraSrcOffset, extraBufferSizeInGpu );
-
-                if( !extraDestinations.empty() )
-                {
-                    StagingBuffer::Destination &lastElement = extraDestinations.back();
+                (*itor)->uploadToExtraBuffer( extraData );
+                extraData += extraBufferSizeInGpu;
 
-                    if( lastElement.destination == dst.destination &&
-                        (lastElement.dstOffset + lastElement.length == dst.dstOffset) )
-                    {
-                        lastElement.length += dst.length;
-                    }
-                    else
-                    {
-                        extraDestinations.push_back( extraDst );
-                    }
-                }
-                else
-                {
-                    extraDestinations.push_back( extraDst );
-                }
+                addCoalescedDestination( mUploadExtraDestinations,
+                                         StagingBuffer::Destination( usersPool->extraBuffer,
+                                                                     extraDstOffset, extraSrcOffset,
+                                                                     extraBufferSizeInGpu ) );
             }
 
             ++itor;
         }
 
-        destinations.insert( destinations.end(), extraDestinations.begin(), extraDestinations.end() );
+        mUploadDestinations.insert( mUploadDestinations.end(), mUploadExtraDestinations.begin(),
+                                    mUploadExtraDestinations.end() );
+
+        //extraData starts right after all the material data.
+        mUploadStats.bytesUploaded  += static_cast<size_t>( extraData - bufferStart );
+        mUploadStats.numDirtyUsers  += mDirtyUsers.size();
+        mUploadStats.numCopies      += mUploadDestinations.size();
+        ++mUploadStats.numUploads;
 
-        stagingBuffer->unmap( destinations );
+        stagingBuffer->unmap( mUploadDestinations );
         stagingBuffer->removeReferenceCount();
 
         mDirtyUsers.clear();
@@ -411,6 +404,11 @@ namespace Ogre
         return mOptimizationStrategy;
     }
     //-----------------------------------------------------------------------------------
+    void ConstBufferPool::resetUploadStats(void)
+    {
+        mUploadStats = UploadStats();
+    }
+    //-----------------------------------------------------------------------------------
     void ConstBufferPool::_changeRenderSystem( RenderSystem *newRs )
     {
         if( _mVaoManager )
@@ -447,6 +445,14 @@ namespace Ogre
             freeSlots.push_back( (slotsPerPool - i) - 1 );
     }
     //-----------------------------------------------------------------------------------
+    ConstBufferPool::UploadStats::UploadStats() :
+        bytesUploaded( 0 ),
+        numDirtyUsers( 0 ),
+        numCopies( 0 ),
+        numUploads( 0 )
+    {
+    }
+    //-----------------------------------------------------------------------------------
     //-----------------------------------------------------------------------------------
     ConstBufferPool::ExtraBufferParams::ExtraBufferParams( size_t _bytesPerSlot, BufferType _bufferType,
                                                            bool _useTextureBuffers ) :
@@ -30,6 +30,20 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreException.h"
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  if !defined(NOMINMAX) && defined(_MSC_VER)
+#   define NOMINMAX // required to stop windows.h messing up std::min
+#  endif
+#  include <windows.h>
+#elif OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE || \
+      OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS || OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
+#  define OGRE_MMAP_SUPPORTED 1
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
 namespace Ogre {
 
     //-----------------------------------------------------------------------
@@ -470,6 +484,68 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    MappedFileDataStream::MappedFileDataStream( const String &name, void *mappedData, size_t size ) :
+        MemoryDataStream( name, mappedData, size, false, true )
+    {
+    }
+    //-----------------------------------------------------------------------
+    MappedFileDataStream::~MappedFileDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void* MappedFileDataStream::mapFile( const String &fullPath, size_t size )
+    {
+        void *retVal = 0;
+
+        if( !size )
+            return retVal;
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        HANDLE hFile = CreateFileA( fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+        if( hFile != INVALID_HANDLE_VALUE )
+        {
+            HANDLE hMapping = CreateFileMappingA( hFile, 0, PAGE_READONLY, 0, 0, 0 );
+            if( hMapping )
+            {
+                retVal = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, size );
+                //The view keeps the mapping (and the file) alive.
+                CloseHandle( hMapping );
+            }
+            CloseHandle( hFile );
+        }
+#elif OGRE_MMAP_SUPPORTED
+        int fd = open( fullPath.c_str(), O_RDONLY );
+        if( fd != -1 )
+        {
+            retVal = mmap( 0, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if( retVal == MAP_FAILED )
+                retVal = 0;
+            //The mapping keeps the file alive.
+            ::close( fd );
+        }
+#endif
+
+        return retVal;
+    }
+    //-----------------------------------------------------------------------
+    void MappedFileDataStream::close(void)
+    {
+        if( mData )
+        {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+            UnmapViewOfFile( mData );
+#elif OGRE_MMAP_SUPPORTED
+            munmap( mData, mSize );
+#endif
+            mData   = 0;
+            mPos    = 0;
+            mEnd    = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     FileStreamDataStream::FileStreamDataStream(std::ifstream* s, bool freeOnClose)
         : DataStream(), mInStream(s), mFStreamRO(s), mFStream(0), mFreeOnClose(freeOnClose)
     {
@@ -55,6 +55,7 @@ THE SOFTWARE.
 namespace Ogre {
 
     bool FileSystemArchive::msIgnoreHidden = true;
+    bool FileSystemArchive::msUseMemoryMapping = false;
 
     //-----------------------------------------------------------------------
     FileSystemArchive::FileSystemArchive(const String& name, const String& archType, bool readOnly )
@@ -225,6 +226,17 @@ namespace Ogre {
                         "FileSystemArchive::open");
         }
 
+        if (readOnly && msUseMemoryMapping)
+        {
+            void *mappedData = MappedFileDataStream::mapFile(full_path, (size_t)tagStat.st_size);
+            if (mappedData)
+            {
+                return DataStreamPtr(OGRE_NEW MappedFileDataStream(filename, mappedData,
+                                                                   (size_t)tagStat.st_size));
+            }
+            // Couldn't map it. Fall back to a regular stream
+        }
+
         if (!readOnly)
         {
             mode |= std::ios::out;
@@ -37,11 +37,122 @@ THE SOFTWARE.
 #include "Vao/OgreVaoManager.h"
 #include "Vao/OgreTexBufferPacked.h"
 
+#include "Math/Array/OgreArraySphere.h"
+#include "Math/Array/OgreArrayMatrix4.h"
+#include "Math/Array/OgreArrayMatrixAf4x3.h"
+
+#include "Threading/OgreChunkedTask.h"
+
 namespace Ogre
 {
     //Six variables * 4 (padded vec3) * 4 (bytes) * numLights
     const size_t c_numBytesPerLight = 6 * 4 * 4;
 
+    /// Below this amount of lights per chunk, it's not worth waking up the worker threads.
+    const size_t c_minLightsPerChunk = 64u;
+
+    /// Fraction of a slice to tolerate in getSliceAtDepth due to floating point error.
+    const Real c_sliceEpsilon = 1e-4f;
+
+    /// Projects the lights onto the slices, in blocks of ARRAY_PACKED_REALS lights.
+    class Forward3DLightProjectTask : public ChunkedTask
+    {
+        Forward3D       *mForward3D;
+        size_t          mNumBlocks;
+        size_t          mNumChunks;
+        Matrix4 const   &mViewMatrix;
+        Matrix4 const   &mProjMatrix;
+        Real const      *mProjSpaceSliceEnd;
+        Real            mNearPlane;
+        Real            mFarPlane;
+        Forward3D::CachedGrid const *mCachedGrid;
+
+    public:
+        Forward3DLightProjectTask( Forward3D *forward3D, size_t numBlocks, size_t numChunks,
+                                   const Matrix4 &viewMatrix, const Matrix4 &projMatrix,
+                                   const Real *projSpaceSliceEnd, Real nearPlane, Real farPlane,
+                                   const Forward3D::CachedGrid *cachedGrid ) :
+            mForward3D( forward3D ), mNumBlocks( numBlocks ), mNumChunks( numChunks ),
+            mViewMatrix( viewMatrix ), mProjMatrix( projMatrix ),
+            mProjSpaceSliceEnd( projSpaceSliceEnd ),
+            mNearPlane( nearPlane ), mFarPlane( farPlane ),
+            mCachedGrid( cachedGrid ) {}
+
+        virtual size_t getNumChunks(void) const     { return mNumChunks; }
+
+        virtual void executeChunk( size_t chunkIdx, size_t threadId )
+        {
+            const size_t blockStart = (mNumBlocks * chunkIdx) / mNumChunks;
+            const size_t blockEnd   = (mNumBlocks * (chunkIdx + 1u)) / mNumChunks;
+            const size_t numLights  = mForward3D->mCurrentLightList.size();
+
+            if( blockStart != blockEnd )
+            {
+                mForward3D->projectLights( blockStart * ARRAY_PACKED_REALS,
+                                           std::min( blockEnd * ARRAY_PACKED_REALS, numLights ),
+                                           mViewMatrix, mProjMatrix, mProjSpaceSliceEnd,
+                                           mNearPlane, mFarPlane, mCachedGrid );
+            }
+        }
+    };
+
+    /// Fills the grid. Each chunk owns a band of rows from one slice,
+    /// so no two chunks ever write to the same cell.
+    class Forward3DGridFillTask : public ChunkedTask
+    {
+        struct Band
+        {
+            uint32 slice;
+            uint32 rowStart;
+            uint32 rowEnd;
+        };
+
+        Forward3D           *mForward3D;
+        uint16              *mGridBuffer;
+        FastArray<Band>     mBands;
+
+    public:
+        Forward3DGridFillTask( Forward3D *forward3D, uint16 *gridBuffer, uint32 bandsPerSlice ) :
+            mForward3D( forward3D ), mGridBuffer( gridBuffer )
+        {
+            for( uint32 i=0; i<mForward3D->mNumSlices; ++i )
+            {
+                const uint32 numRows    = mForward3D->mResolutionAtSlice[i].height;
+                const uint32 numBands   = std::min( bandsPerSlice, numRows );
+                for( uint32 j=0; j<numBands; ++j )
+                {
+                    Band band;
+                    band.slice      = i;
+                    band.rowStart   = (numRows * j) / numBands;
+                    band.rowEnd     = (numRows * (j + 1u)) / numBands;
+                    mBands.push_back( band );
+                }
+            }
+        }
+
+        virtual size_t getNumChunks(void) const     { return mBands.size(); }
+
+        virtual void executeChunk( size_t chunkIdx, size_t threadId )
+        {
+            const Band &band = mBands[chunkIdx];
+            mForward3D->fillGridRows( mGridBuffer, band.slice, band.rowStart, band.rowEnd );
+        }
+    };
+
+    struct OrderStaticLightEntryByLight
+    {
+        template <typename T>
+        bool operator () ( const T &left, const Light *right ) const
+        {
+            return left.light < right;
+        }
+        template <typename T>
+        bool operator () ( const T &left, const T &right ) const
+        {
+            return left.light < right.light;
+        }
+    };
+
     Forward3D::Forward3D( uint32 width, uint32 height,
                           uint32 numSlices, uint32 lightsPerCell,
                           float minDistance, float maxDistance,
@@ -57,6 +168,8 @@ namespace Ogre
         mMinDistance( minDistance ),
         mMaxDistance( maxDistance ),
         mInvMaxDistance( 1.0f / mMaxDistance ),
+        mDepthSliceExponent( 0.0f ),
+        mExpSliceScale( 0.0f ),
         mVaoManager( 0 ),
         mSceneManager( sceneManager ),
         mDebugMode( false ),
@@ -68,13 +181,12 @@ namespace Ogre
 
         for( uint32 i=0; i<mNumSlices; ++i )
         {
-            mResolutionAtSlice.push_back( Resolution( sliceWidth, sliceHeight,
-                                                      getDepthAtSlice( i + 1 ) ) );
+            mResolutionAtSlice.push_back( Resolution( sliceWidth, sliceHeight, 0 ) );
             sliceWidth   *= 2;
             sliceHeight  *= 2;
         }
 
-        mResolutionAtSlice.back().zEnd = std::numeric_limits<Real>::max();
+        updateSliceDepths();
 
         const size_t p = -((1 - (1 << (mNumSlices << 1))) / 3);
         mLightCountInCell.resize( p * mWidth * mHeight, 0 );
@@ -141,7 +253,7 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
-    inline Real Forward3D::getDepthAtSlice( uint32 uSlice ) const
+    Real Forward3D::getDepthAtSlice( uint32 uSlice ) const
     {
         /*Real normalizedDepth = uSlice / static_cast<Real>( mNumSlices-1 );
 
@@ -152,10 +264,18 @@ namespace Ogre
 
         normalizedDepth = 1.0f - normalizedDepth;*/
         Real normalizedDepth = uSlice / static_cast<Real>( mNumSlices-1 );
+
+        //Exponential slicing: f(x) = (2^(k * x) - 1) / (2^k - 1)
+        if( mDepthSliceExponent > 0 )
+        {
+            normalizedDepth = (Math::Pow( 2.0f, mDepthSliceExponent * normalizedDepth ) - 1.0f) /
+                              mExpSliceScale;
+        }
+
         return -((normalizedDepth * mMaxDistance) - mMinDistance);
     }
     //-----------------------------------------------------------------------------------
-    inline uint32 Forward3D::getSliceAtDepth( Real depth ) const
+    uint32 Forward3D::getSliceAtDepth( Real depth ) const
     {
         //normalizedDepth is in range [0; 1]
         //We use the formula f(x) = 1 - (1 - (x + min)) ^ 8
@@ -166,7 +286,46 @@ namespace Ogre
         normalizedDepth = 1.0f - normalizedDepth;*/
         Real normalizedDepth = Math::saturate( (-depth + mMinDistance) * mInvMaxDistance );
 
-        return static_cast<uint32>( floorf( normalizedDepth * (mNumSlices-1) ) );
+        //Exponential slicing: f(x) = log2( x * (2^k - 1) + 1 ) / k
+        if( mDepthSliceExponent > 0 )
+        {
+            normalizedDepth = Math::Log2( normalizedDepth * mExpSliceScale + 1.0f ) /
+                              mDepthSliceExponent;
+        }
+
+        //The depth at which a slice starts may land a hair below it after the round trip
+        //through getDepthAtSlice. Nudge it so the slice boundaries map to the right slice.
+        return std::min( static_cast<uint32>( floorf( normalizedDepth * (mNumSlices-1) +
+                                                      c_sliceEpsilon ) ),
+                         mNumSlices - 1u );
+    }
+    //-----------------------------------------------------------------------------------
+    void Forward3D::updateSliceDepths(void)
+    {
+        for( uint32 i=0; i<mNumSlices; ++i )
+            mResolutionAtSlice[i].zEnd = getDepthAtSlice( i + 1 );
+
+        mResolutionAtSlice.back().zEnd = std::numeric_limits<Real>::max();
+    }
+    //-----------------------------------------------------------------------------------
+    void Forward3D::setDepthSliceExponent( float exponent )
+    {
+        assert( exponent >= 0 );
+
+        mDepthSliceExponent = exponent;
+        mExpSliceScale      = exponent > 0 ? Math::Pow( 2.0f, exponent ) - 1.0f : 0.0f;
+        updateSliceDepths();
+
+        //The cached projections are no longer valid.
+        CachedGridVec::iterator itor = mCachedGrid.begin();
+        CachedGridVec::iterator end  = mCachedGrid.end();
+
+        while( itor != end )
+        {
+            itor->staticLights.clear();
+            itor->staticLightRects.clear();
+            ++itor;
+        }
     }
     //-----------------------------------------------------------------------------------
     inline void Forward3D::projectionSpaceToGridSpace( const Vector2 &projSpace, uint32 slice,
@@ -263,7 +422,54 @@ namespace Ogre
         uint16 * RESTRICT_ALIAS gridBuffer = reinterpret_cast<uint16 * RESTRICT_ALIAS>(
                     cachedGrid->gridBuffer->map( 0, cachedGrid->gridBuffer->getNumElements() ) );
 
-        memset( mLightCountInCell.begin(), 0, mLightCountInCell.size() * sizeof(uint32) );
+        const size_t numChunks = std::min( mSceneManager->getNumWorkerThreads() * 4u,
+                                           numLights / c_minLightsPerChunk );
+        fillGrid( camera, cachedGrid, gridBuffer, numChunks );
+
+        cachedGrid->gridBuffer->unmap( UO_KEEP_PERSISTENT );
+
+        {
+            //Check if some of the caches are really old and delete them
+            CachedGridVec::iterator itor = mCachedGrid.begin();
+            CachedGridVec::iterator end  = mCachedGrid.end();
+
+            const uint32 currentFrame = mVaoManager->getFrameCount();
+
+            while( itor != end )
+            {
+                if( itor->lastFrame + 3 < currentFrame )
+                {
+                    if( itor->gridBuffer )
+                    {
+                        if( itor->gridBuffer->getMappingState() != MS_UNMAPPED )
+                            itor->gridBuffer->unmap( UO_UNMAP_ALL );
+                        mVaoManager->destroyTexBuffer( itor->gridBuffer );
+                        itor->gridBuffer = 0;
+                    }
+
+                    if( itor->globalLightListBuffer )
+                    {
+                        if( itor->globalLightListBuffer->getMappingState() != MS_UNMAPPED )
+                            itor->globalLightListBuffer->unmap( UO_UNMAP_ALL );
+                        mVaoManager->destroyTexBuffer( itor->globalLightListBuffer );
+                        itor->globalLightListBuffer = 0;
+                    }
+
+                    itor = efficientVectorRemove( mCachedGrid, itor );
+                    end  = mCachedGrid.end();
+                }
+                else
+                {
+                    ++itor;
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void Forward3D::fillGrid( Camera *camera, CachedGrid *cachedGrid,
+                              uint16 * RESTRICT_ALIAS gridBuffer, size_t numChunks )
+    {
+        const size_t numLights = mCurrentLightList.size();
 
         Matrix4 viewMat = camera->getViewMatrix();
         Matrix4 projMatrix = camera->getProjectionMatrix();
@@ -283,201 +489,347 @@ namespace Ogre
 
         projSpaceSliceEnd[mNumSlices-1] = 1.0f;
 
-        LightArray::const_iterator itLight = mCurrentLightList.begin();
+        //Static lights that haven't moved land in the same cells as long as the camera
+        //doesn't move either. Keep their rects while that's the case so we don't
+        //have to project them again.
+        const bool cameraStill = cachedGrid->viewMatrix == viewMat &&
+                                 cachedGrid->projMatrix == projMatrix;
+        if( !cameraStill )
+        {
+            cachedGrid->staticLights.clear();
+            cachedGrid->staticLightRects.clear();
+        }
+        cachedGrid->viewMatrix = viewMat;
+        cachedGrid->projMatrix = projMatrix;
+
+        mLightRects.resize( numLights * mNumSlices );
+        mLightWorldSpheres.resize( numLights );
+
+        {
+            const size_t numBlocks = (numLights + ARRAY_PACKED_REALS - 1u) / ARRAY_PACKED_REALS;
+            Forward3DLightProjectTask task( this, numBlocks, std::max<size_t>( numChunks, 1u ),
+                                            viewMat, projMatrix, projSpaceSliceEnd,
+                                            nearPlane, farPlane,
+                                            cachedGrid->staticLights.empty() ? 0 : cachedGrid );
+            if( numChunks > 1u )
+                mSceneManager->executeUserChunkedTask( &task );
+            else
+                task.executeChunk( 0, 0 );
+        }
+
+        if( cameraStill )
+            cacheStaticLights( cachedGrid );
 
-        for( size_t i=0; i<numLights; ++i )
         {
-            //Aabb lightAabb = (*itLight)->getWorldAabb();
-            //lightAabb.transformAffine( viewMat );
-            Aabb lightAabb = (*itLight)->getLocalAabb();
-            lightAabb.transformAffine( viewMat * (*itLight)->_getParentNodeFullTransform() );
+            const uint32 bandsPerSlice = static_cast<uint32>( (numChunks + mNumSlices - 1u) /
+                                                              mNumSlices );
+            Forward3DGridFillTask task( this, gridBuffer, std::max( bandsPerSlice, 1u ) );
+            if( numChunks > 1u )
+            {
+                mSceneManager->executeUserChunkedTask( &task );
+            }
+            else
+            {
+                for( size_t i=0; i<task.getNumChunks(); ++i )
+                    task.executeChunk( i, 0 );
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void Forward3D::projectLights( size_t lightStart, size_t lightEnd,
+                                   const Matrix4 &viewMatrix, const Matrix4 &projMatrix,
+                                   const Real *projSpaceSliceEnd, Real nearPlane, Real farPlane,
+                                   const CachedGrid *cachedGrid )
+    {
+        const ArrayMatrixAf4x3 viewMat = ArrayMatrixAf4x3::createAllFromMatrix4( viewMatrix );
+        const ArrayMatrix4 projMat = ArrayMatrix4::createAllFromMatrix4( projMatrix );
+
+        //Light space is backwards, in range [-farDistance; -nearDistance]
+        const ArrayReal nearZ   = Mathlib::SetAll( -nearPlane );
+        const ArrayReal farZ    = Mathlib::SetAll( -farPlane );
 
-            //Lower left origin
-            Vector3 vMin3 = lightAabb.getMinimum();
-            //Upper right
-            Vector3 vMax3 = lightAabb.getMaximum();
+        ArrayReal sliceEnd[256];
+        for( uint32 i=0; i<mNumSlices-1u; ++i )
+            sliceEnd[i] = Mathlib::SetAll( mResolutionAtSlice[i].zEnd );
 
-            //Light space is backwards, in range [-farDistance; -nearDistance]
-            std::swap( vMin3.z, vMax3.z );
+        for( size_t i=lightStart; i<lightEnd; i += ARRAY_PACKED_REALS )
+        {
+            const size_t numInBlock = std::min<size_t>( ARRAY_PACKED_REALS, lightEnd - i );
 
-            vMin3.z = Math::Clamp( vMin3.z, -farPlane, -nearPlane );
-            vMax3.z = Math::Clamp( vMax3.z, -farPlane, -nearPlane );
+            ArrayVector3 lightPos, aabbCenter, aabbHalfSize;
+            ArrayReal lightRange;
+            Real * RESTRICT_ALIAS aliasedRange = reinterpret_cast<Real*>( &lightRange );
 
-            // bottomLeft[0] = bottom left corner of front face of the AABB.
-            // bottomLeft[1] = bottom left corner of back face of the AABB.
-            // topRight[0] = top right corner of front face of the AABB.
-            // topRight[1] = top right corner of back face of the AABB.
-            // All of it in projection space in range [0; 1]
-            Vector3 bottomLeft[2], topRight[2];
+            for( size_t j=0; j<ARRAY_PACKED_REALS; ++j )
             {
-                Vector4 vStart4[2], vEnd4[2];
-                vStart4[0]  = Vector4( vMin3 );
-                vStart4[1]  = vStart4[0];
-                vEnd4[0]    = Vector4( vMax3 );
-                vEnd4[1]    = vEnd4[0];
+                //Repeat the last light in the unused slots of the block
+                const Light *light = mCurrentLightList[i + std::min( j, numInBlock - 1u )];
+                const Aabb worldAabb = light->getWorldAabb();
+                lightPos.setFromVector3( light->getParentNode()->_getDerivedPosition(), j );
+                aabbCenter.setFromVector3( worldAabb.mCenter, j );
+                aabbHalfSize.setFromVector3( worldAabb.mHalfSize, j );
+                aliasedRange[j] = light->getAttenuationRange();
+            }
 
-                vEnd4[0].z  = vMin3.z;
-                vStart4[1].z= vMax3.z;
+            //Use the tightest of the sphere around the light's range (exact for point
+            //lights) and the one enclosing its Aabb (tighter for narrow spot lights).
+            const ArrayReal aabbRadius = aabbHalfSize.length();
+            const ArraySphere worldSphere( Mathlib::Min( aabbRadius, lightRange ),
+                                           ArrayVector3::Cmov4( aabbCenter, lightPos,
+                                                                Mathlib::CompareLess(
+                                                                    aabbRadius, lightRange ) ) );
+
+            const ArrayVector3 viewCenter = viewMat * worldSphere.mCenter;
+            const ArrayReal radius = worldSphere.mRadius;
+
+            //The front face is the one closest to the camera, i.e. the highest z
+            const ArrayReal frontZ = Mathlib::Max( Mathlib::Min( viewCenter.mChunkBase[2] + radius,
+                                                                 nearZ ), farZ );
+            const ArrayReal backZ  = Mathlib::Max( Mathlib::Min( viewCenter.mChunkBase[2] - radius,
+                                                                 nearZ ), farZ );
+
+            //The slice at a given depth is the number of slices that end before it.
+            ArrayReal minSlice = ARRAY_REAL_ZERO;
+            ArrayReal maxSlice = ARRAY_REAL_ZERO;
+            for( uint32 j=0; j<mNumSlices-1u; ++j )
+            {
+                minSlice = minSlice + Mathlib::Cmov4( Mathlib::ONE, ARRAY_REAL_ZERO,
+                                                      Mathlib::CompareLessEqual( frontZ,
+                                                                                 sliceEnd[j] ) );
+                maxSlice = maxSlice + Mathlib::Cmov4( Mathlib::ONE, ARRAY_REAL_ZERO,
+                                                      Mathlib::CompareLessEqual( backZ,
+                                                                                 sliceEnd[j] ) );
+            }
 
-                for( int j=0; j<2; ++j )
+            // bottomLeft[0] = bottom left corner of front face of the sphere's bounds.
+            // bottomLeft[1] = bottom left corner of back face of the sphere's bounds.
+            // topRight[0] = top right corner of front face of the sphere's bounds.
+            // topRight[1] = top right corner of back face of the sphere's bounds.
+            // All of it in projection space; x & y in range [0; 1]
+            const ArrayReal minX = viewCenter.mChunkBase[0] - radius;
+            const ArrayReal minY = viewCenter.mChunkBase[1] - radius;
+            const ArrayReal maxX = viewCenter.mChunkBase[0] + radius;
+            const ArrayReal maxY = viewCenter.mChunkBase[1] + radius;
+
+            ArrayVector3 bottomLeft[2], topRight[2];
+            bottomLeft[0]   = projMat * ArrayVector3( minX, minY, frontZ );
+            bottomLeft[1]   = projMat * ArrayVector3( minX, minY, backZ );
+            topRight[0]     = projMat * ArrayVector3( maxX, maxY, frontZ );
+            topRight[1]     = projMat * ArrayVector3( maxX, maxY, backZ );
+
+            for( int j=0; j<2; ++j )
+            {
+                for( int k=0; k<2; ++k )
                 {
-                    vStart4[j]  = projMatrix * vStart4[j];
-                    vEnd4[j]    = projMatrix * vEnd4[j];
-
-                    const Real invStartW = 1.0f / vStart4[j].w;
-                    const Real invEndW = 1.0f / vEnd4[j].w;
-                    bottomLeft[j].x = (vStart4[j].x * invStartW) * 0.5f + 0.5f;
-                    bottomLeft[j].y = (vStart4[j].y * invStartW) * 0.5f + 0.5f;
-                    bottomLeft[j].z = (vStart4[j].z * invStartW);
-                    topRight[j].x   = (vEnd4[j].x * invEndW) * 0.5f + 0.5f;
-                    topRight[j].y   = (vEnd4[j].y * invEndW) * 0.5f + 0.5f;
-                    topRight[j].z   = (vEnd4[j].z * invEndW);
+                    bottomLeft[j].mChunkBase[k] = bottomLeft[j].mChunkBase[k] * Mathlib::HALF +
+                                                  Mathlib::HALF;
+                    topRight[j].mChunkBase[k]   = topRight[j].mChunkBase[k] * Mathlib::HALF +
+                                                  Mathlib::HALF;
                 }
             }
 
-            const Real lightSpaceMinDepth = bottomLeft[0].z;
-            const Real lightSpaceMaxDepth = bottomLeft[1].z;
-
-            uint32 minSlice = getSliceAtDepth( vMin3.z );
-            uint32 maxSlice = getSliceAtDepth( vMax3.z );
-
-            const Real invLightSpaceDepthDist = 1.0f / (lightSpaceMaxDepth - lightSpaceMinDepth);
-
-            //We will interpolate between the front and back faces of the AABB by view space
-            //depth at both the beginning of the current slice and the end of it.
-            //The 2D rectangle that encloses both slices defines the area occupied in the
-            //
-            //Since the end of the current slice is the beginning of the next one, we just
-            //copy the data from interpBL[1] onto interpBL[0] at the end of each iteration
-            //and only calculate interpBL[1] in every iteration (performance optimization)
-            Vector3 interpBL[2], interpTR[2];
-            interpBL[0] = bottomLeft[0];
-            interpTR[0] = topRight[0];
-
-            assert( (minSlice > maxSlice) || (minSlice < mNumSlices && maxSlice < mNumSlices) );
-
-            //Derive the offset analytically.
-            // Normally offset is =
-            //     = w * h * mLightsPerCell * 2 + w * 2 * h * 2 * mLightsPerCell * 2 +
-            //       w * 4 * h * 4 * mLightsPerCell * 2 + ...
-            //
-            //This is a **geometric series** of 4^n where n is minSlice+1.
-            //  The formula is:
-            //    = [(1 - 4^n) / (1 - 4)] * (w * h * mLightsPerCell * 2)
-            //    = [(1 - 4^n) / (1 - 4)] * mTableSize
-            //    = [(1 - (1 << (n * 2))) / (-3)] * mTableSize
-            const size_t p = -((1 - (1 << (minSlice << 1))) / 3);
-            size_t offset           = p * mTableSize;
-            size_t offsetLightCount = p * mWidth * mHeight;
-
-            for( uint32 slice=minSlice; slice<=maxSlice; ++slice )
+            const Real * RESTRICT_ALIAS aliasedRadius = reinterpret_cast<const Real*>( &radius );
+            const Real * RESTRICT_ALIAS aliasedMinSlice = reinterpret_cast<const Real*>( &minSlice );
+            const Real * RESTRICT_ALIAS aliasedMaxSlice = reinterpret_cast<const Real*>( &maxSlice );
+
+            for( size_t j=0; j<numInBlock; ++j )
             {
-                //The end of this slice may go past beyond the back face of the AABB.
-                //Clamp to avoid overestimating the rectangle's area
-                const Real depthAtSlice = Ogre::min( lightSpaceMaxDepth, projSpaceSliceEnd[slice] );
-
-                //Interpolate the back face
-                float fW = (depthAtSlice - lightSpaceMinDepth) * invLightSpaceDepthDist;
-                interpBL[1] = Math::lerp( bottomLeft[0], bottomLeft[1], fW );
-                interpTR[1] = Math::lerp( topRight[0], topRight[1], fW );
-
-                //Find the rectangle that encloses both the front and back faces.
-                const Vector2 finalBL( Ogre::min( interpBL[0].x, interpBL[1].x ),
-                                       Ogre::min( interpBL[0].y, interpBL[1].y ) );
-                const Vector2 finalTR( Ogre::max( interpTR[0].x, interpTR[1].x ),
-                                       Ogre::max( interpTR[0].y, interpTR[1].y ) );
-
-                uint32 startX, startY, endX, endY;
-                projectionSpaceToGridSpace( finalBL, slice, startX, startY );
-                projectionSpaceToGridSpace( finalTR, slice, endX, endY );
-
-                const Resolution &sliceRes = mResolutionAtSlice[slice];
-                for( uint32 y=startY; y<=endY; ++y )
+                const size_t lightIdx = i + j;
+                const Light *light = mCurrentLightList[lightIdx];
+                LightRect *outRects = mLightRects.begin() + lightIdx * mNumSlices;
+
+                Vector3 worldCenter;
+                worldSphere.mCenter.getAsVector3( worldCenter, j );
+                const Sphere lightSphere( worldCenter, aliasedRadius[j] );
+                mLightWorldSpheres[lightIdx] = lightSphere;
+
+                if( cachedGrid && light->isStatic() )
                 {
-                    for( uint32 x=startX; x<=endX; ++x )
+                    FastArray<StaticLightEntry>::const_iterator itEntry =
+                            std::lower_bound( cachedGrid->staticLights.begin(),
+                                              cachedGrid->staticLights.end(),
+                                              light, OrderStaticLightEntryByLight() );
+
+                    if( itEntry != cachedGrid->staticLights.end() && itEntry->light == light &&
+                        itEntry->worldSphere.getCenter() == lightSphere.getCenter() &&
+                        itEntry->worldSphere.getRadius() == lightSphere.getRadius() )
                     {
-                        FastArray<uint32>::iterator numLightsInCell = mLightCountInCell.begin() + offsetLightCount +
-                                                                        (y * sliceRes.width) + x;
-
-                        //assert( numLightsInCell < mLightCountInCell.end() );
-
-                        //mLightsPerCell - 1 because one slot is reserved
-                        //for the number of lights in cell
-                        if( *numLightsInCell < mLightsPerCell - 1 )
-                        {
-                            uint16 * RESTRICT_ALIAS cellElem = gridBuffer + offset +
-                                                                (y * sliceRes.width + x) * mLightsPerCell +
-                                                                (*numLightsInCell + 1);
-                            ++(*numLightsInCell);
-                            *cellElem = i * 6;
-                        }
+                        memcpy( outRects, cachedGrid->staticLightRects.begin() + itEntry->rectStart,
+                                mNumSlices * sizeof(LightRect) );
+                        continue;
                     }
                 }
 
-                //The old back face is the new front face.
-                interpBL[0] = interpBL[1];
-                interpTR[0] = interpTR[1];
-                offset           += sliceRes.width * sliceRes.height * mLightsPerCell;
-                offsetLightCount += sliceRes.width * sliceRes.height;
-            }
+                Vector3 vBottomLeft[2], vTopRight[2];
+                for( int k=0; k<2; ++k )
+                {
+                    bottomLeft[k].getAsVector3( vBottomLeft[k], j );
+                    topRight[k].getAsVector3( vTopRight[k], j );
+                }
 
-            ++itLight;
+                calculateLightRects( vBottomLeft, vTopRight,
+                                     static_cast<uint32>( aliasedMinSlice[j] ),
+                                     static_cast<uint32>( aliasedMaxSlice[j] ),
+                                     projSpaceSliceEnd, outRects );
+            }
         }
+    }
+    //-----------------------------------------------------------------------------------
+    void Forward3D::calculateLightRects( const Vector3 bottomLeft[2], const Vector3 topRight[2],
+                                         uint32 minSlice, uint32 maxSlice,
+                                         const Real *projSpaceSliceEnd,
+                                         LightRect *outRects ) const
+    {
+        assert( minSlice <= maxSlice && maxSlice < mNumSlices );
 
+        for( uint32 slice=0; slice<mNumSlices; ++slice )
         {
-            //Now write all the light counts
-            FastArray<uint32>::const_iterator itor = mLightCountInCell.begin();
-            FastArray<uint32>::const_iterator end  = mLightCountInCell.end();
-
-            const size_t cellSize = mLightsPerCell;
-            size_t gridIdx = 0;
-
-            while( itor != end )
-            {
-                gridBuffer[gridIdx] = static_cast<uint16>( *itor );
-                gridIdx += cellSize;
-                ++itor;
-            }
+            outRects[slice].startX  = 1u;
+            outRects[slice].startY  = 1u;
+            outRects[slice].endX    = 0;
+            outRects[slice].endY    = 0;
         }
 
-        cachedGrid->gridBuffer->unmap( UO_KEEP_PERSISTENT );
+        const Real lightSpaceMinDepth = bottomLeft[0].z;
+        const Real lightSpaceMaxDepth = bottomLeft[1].z;
+
+        //Both faces may have been clamped to the same plane
+        const Real invLightSpaceDepthDist = lightSpaceMaxDepth > lightSpaceMinDepth ?
+                    1.0f / (lightSpaceMaxDepth - lightSpaceMinDepth) : 0.0f;
+
+        //We will interpolate between the front and back faces of the AABB by view space
+        //depth at both the beginning of the current slice and the end of it.
+        //The 2D rectangle that encloses both slices defines the area occupied in the
+        //
+        //Since the end of the current slice is the beginning of the next one, we just
+        //copy the data from interpBL[1] onto interpBL[0] at the end of each iteration
+        //and only calculate interpBL[1] in every iteration (performance optimization)
+        Vector3 interpBL[2], interpTR[2];
+        interpBL[0] = bottomLeft[0];
+        interpTR[0] = topRight[0];
+
+        for( uint32 slice=minSlice; slice<=maxSlice; ++slice )
+        {
+            //The end of this slice may go past beyond the back face of the AABB.
+            //Clamp to avoid overestimating the rectangle's area
+            const Real depthAtSlice = Ogre::min( lightSpaceMaxDepth, projSpaceSliceEnd[slice] );
+
+            //Interpolate the back face
+            float fW = (depthAtSlice - lightSpaceMinDepth) * invLightSpaceDepthDist;
+            interpBL[1] = Math::lerp( bottomLeft[0], bottomLeft[1], fW );
+            interpTR[1] = Math::lerp( topRight[0], topRight[1], fW );
+
+            //Find the rectangle that encloses both the front and back faces.
+            const Vector2 finalBL( Ogre::min( interpBL[0].x, interpBL[1].x ),
+                                   Ogre::min( interpBL[0].y, interpBL[1].y ) );
+            const Vector2 finalTR( Ogre::max( interpTR[0].x, interpTR[1].x ),
+                                   Ogre::max( interpTR[0].y, interpTR[1].y ) );
+
+            LightRect &rect = outRects[slice];
+            projectionSpaceToGridSpace( finalBL, slice, rect.startX, rect.startY );
+            projectionSpaceToGridSpace( finalTR, slice, rect.endX, rect.endY );
+
+            //The old back face is the new front face.
+            interpBL[0] = interpBL[1];
+            interpTR[0] = interpTR[1];
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void Forward3D::fillGridRows( uint16 * RESTRICT_ALIAS gridBuffer, uint32 slice,
+                                  uint32 rowStart, uint32 rowEnd )
+    {
+        //Derive the offset analytically.
+        // Normally offset is =
+        //     = w * h * mLightsPerCell * 2 + w * 2 * h * 2 * mLightsPerCell * 2 +
+        //       w * 4 * h * 4 * mLightsPerCell * 2 + ...
+        //
+        //This is a **geometric series** of 4^n where n is slice+1.
+        //  The formula is:
+        //    = [(1 - 4^n) / (1 - 4)] * (w * h * mLightsPerCell * 2)
+        //    = [(1 - 4^n) / (1 - 4)] * mTableSize
+        //    = [(1 - (1 << (n * 2))) / (-3)] * mTableSize
+        const size_t p = -((1 - (1 << (slice << 1))) / 3);
+        const size_t offset             = p * mTableSize;
+        const size_t offsetLightCount   = p * mWidth * mHeight;
+
+        const Resolution &sliceRes = mResolutionAtSlice[slice];
+
+        uint32 * RESTRICT_ALIAS lightCountInCell = mLightCountInCell.begin() + offsetLightCount;
+        memset( lightCountInCell + rowStart * sliceRes.width, 0,
+                (rowEnd - rowStart) * sliceRes.width * sizeof(uint32) );
+
+        //Iterate in mCurrentLightList order, so that when a cell is
+        //full, it's the furthest lights the ones that get left out.
+        const size_t numLights = mCurrentLightList.size();
+        FastArray<LightRect>::const_iterator itRect = mLightRects.begin() + slice;
 
+        for( size_t i=0; i<numLights; ++i )
         {
-            //Check if some of the caches are really old and delete them
-            CachedGridVec::iterator itor = mCachedGrid.begin();
-            CachedGridVec::iterator end  = mCachedGrid.end();
+            const LightRect &rect = *itRect;
+            itRect += mNumSlices;
 
-            const uint32 currentFrame = mVaoManager->getFrameCount();
+            const uint32 startY = std::max( rect.startY, rowStart );
+            const uint32 endY   = std::min( rect.endY + 1u, rowEnd );
 
-            while( itor != end )
+            for( uint32 y=startY; y<endY; ++y )
             {
-                if( itor->lastFrame + 3 < currentFrame )
+                for( uint32 x=rect.startX; x<=rect.endX; ++x )
                 {
-                    if( itor->gridBuffer )
-                    {
-                        if( itor->gridBuffer->getMappingState() != MS_UNMAPPED )
-                            itor->gridBuffer->unmap( UO_UNMAP_ALL );
-                        mVaoManager->destroyTexBuffer( itor->gridBuffer );
-                        itor->gridBuffer = 0;
-                    }
+                    uint32 * RESTRICT_ALIAS numLightsInCell = lightCountInCell +
+                                                               (y * sliceRes.width) + x;
 
-                    if( itor->globalLightListBuffer )
+                    //mLightsPerCell - 1 because one slot is reserved
+                    //for the number of lights in cell
+                    if( *numLightsInCell < mLightsPerCell - 1 )
                     {
-                        if( itor->globalLightListBuffer->getMappingState() != MS_UNMAPPED )
-                            itor->globalLightListBuffer->unmap( UO_UNMAP_ALL );
-                        mVaoManager->destroyTexBuffer( itor->globalLightListBuffer );
-                        itor->globalLightListBuffer = 0;
+                        uint16 * RESTRICT_ALIAS cellElem = gridBuffer + offset +
+                                                            (y * sliceRes.width + x) * mLightsPerCell +
+                                                            (*numLightsInCell + 1);
+                        ++(*numLightsInCell);
+                        *cellElem = static_cast<uint16>( i * 6 );
                     }
-
-                    itor = efficientVectorRemove( mCachedGrid, itor );
-                    end  = mCachedGrid.end();
-                }
-                else
-                {
-                    ++itor;
                 }
             }
         }
+
+        //Now write the light counts of these rows
+        for( uint32 y=rowStart; y<rowEnd; ++y )
+        {
+            for( uint32 x=0; x<sliceRes.width; ++x )
+            {
+                const size_t cellIdx = y * sliceRes.width + x;
+                gridBuffer[offset + cellIdx * mLightsPerCell] =
+                        static_cast<uint16>( lightCountInCell[cellIdx] );
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void Forward3D::cacheStaticLights( CachedGrid *cachedGrid )
+    {
+        FastArray<StaticLightEntry> &staticLights = cachedGrid->staticLights;
+        FastArray<LightRect> &staticLightRects = cachedGrid->staticLightRects;
+
+        staticLights.clear();
+        staticLightRects.clear();
+
+        const size_t numLights = mCurrentLightList.size();
+        for( size_t i=0; i<numLights; ++i )
+        {
+            const Light *light = mCurrentLightList[i];
+            if( light->isStatic() )
+            {
+                StaticLightEntry entry;
+                entry.light         = light;
+                entry.worldSphere   = mLightWorldSpheres[i];
+                entry.rectStart     = static_cast<uint32>( staticLightRects.size() );
+                staticLights.push_back( entry );
+
+                staticLightRects.appendPOD( mLightRects.begin() + i * mNumSlices,
+                                            mLightRects.begin() + (i + 1u) * mNumSlices );
+            }
+        }
+
+        std::sort( staticLights.begin(), staticLights.end(), OrderStaticLightEntryByLight() );
     }
     //-----------------------------------------------------------------------------------
     void Forward3D::fillGlobalLightListBuffer( Camera *camera, TexBufferPacked *globalLightListBuffer )
@@ -595,6 +947,8 @@ namespace Ogre
 
         cachedGrid.gridBuffer               = 0;
         cachedGrid.globalLightListBuffer    = 0;
+        cachedGrid.viewMatrix               = Matrix4::ZERO;
+        cachedGrid.projMatrix               = Matrix4::ZERO;
 
         mCachedGrid.push_back( cachedGrid );
 
@@ -666,8 +1020,18 @@ namespace Ogre
     {
         //vec4 f3dData;
         *passBufferPtr++ = mMinDistance;
-        *passBufferPtr++ = mInvMaxDistance;
-        *passBufferPtr++ = static_cast<float>( mNumSlices - 1 );
+        if( mDepthSliceExponent > 0 )
+        {
+            //See getSliceAtDepth. The shader evaluates:
+            //  log2( x * invMaxDistance * (2^k - 1) + 1 ) * (numSlices - 1) / k
+            *passBufferPtr++ = mInvMaxDistance * mExpSliceScale;
+            *passBufferPtr++ = static_cast<float>( mNumSlices - 1 ) / mDepthSliceExponent;
+        }
+        else
+        {
+            *passBufferPtr++ = mInvMaxDistance;
+            *passBufferPtr++ = static_cast<float>( mNumSlices - 1 );
+        }
         *reinterpret_cast<uint32*RESTRICT_ALIAS>(passBufferPtr) = mTableSize;
         ++passBufferPtr;
 
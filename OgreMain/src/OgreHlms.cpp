@@ -41,6 +41,8 @@ THE SOFTWARE.
 #include "OgreLight.h"
 #include "OgreSceneManager.h"
 #include "OgreLogManager.h"
+#include "OgreDataStream.h"
+#include "OgreTimelineProfiler.h"
 #include "OgreForward3D.h"
 //#include "OgreMovableObject.h"
 //#include "OgreRenderable.h"
@@ -49,6 +51,9 @@ THE SOFTWARE.
 #include "OgreDepthBuffer.h"
 
 #include "OgreHlmsListener.h"
+#include "OgreRoot.h"
+
+#include "Hash/MurmurHash3.h"
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
     #include "iOS/macUtils.h"
@@ -117,6 +122,8 @@ namespace Ogre
     const IdString HlmsBaseProp::Forward3DDebug     = IdString( "hlms_forward3d_debug" );
     const IdString HlmsBaseProp::Forward3DFadeAttenRange
                                                     = IdString( "hlms_forward_fade_attenuation_range" );
+    const IdString HlmsBaseProp::Forward3DExponential
+                                                    = IdString( "hlms_forward3d_exponential" );
     const IdString HlmsBaseProp::VPos               = IdString( "hlms_vpos" );
 
     //Change per material (hash can be cached on the renderable)
@@ -180,6 +187,15 @@ namespace Ogre
 
     Hlms::Hlms( HlmsTypes type, const String &typeName, Archive *dataFolder,
                 ArchiveVec *libraryFolders ) :
+        mShaderCacheGeneration( 0 ),
+        mShaderCodeCacheEnabled( false ),
+        mShaderCodeCacheHits( 0 ),
+        mTemplateParses( 0 ),
+        mShaderCreationBudget( 0 ),
+        mShadersCreatedThisFrame( 0 ),
+        mShaderCreationFrame( 0 ),
+        mNumDeferredShaders( 0 ),
+        mTemplateSourcesLoaded( false ),
         mDataFolder( dataFolder ),
         mHlmsManager( 0 ),
         mLightGatheringMode( LightGatherForward ),
@@ -810,11 +826,7 @@ namespace Ogre
     //-----------------------------------------------------------------------------------
     void Hlms::copy( String &outBuffer, const SubStringRef &inSubString, size_t length )
     {
-        String::const_iterator itor = inSubString.begin();
-        String::const_iterator end  = inSubString.begin() + length;
-
-        while( itor != end )
-            outBuffer.push_back( *itor++ );
+        outBuffer.append( inSubString.begin(), inSubString.begin() + length );
     }
     //-----------------------------------------------------------------------------------
     void Hlms::repeat( String &outBuffer, const SubStringRef &inSubString, size_t length,
@@ -842,7 +854,10 @@ namespace Ogre
             }
             else
             {
-               outBuffer.push_back( *itor++ );
+                //Copy everything up to the next '@' in one go
+                String::const_iterator nextAt = std::find( itor + 1, end, '@' );
+                outBuffer.append( itor, nextAt );
+                itor = nextAt;
             }
         }
     }
@@ -1392,18 +1407,31 @@ namespace Ogre
         assert( mRenderableCache.size() <= HlmsBits::RenderableMask );
 
         RenderableCache cacheEntry( renderableSetProperties, pieces );
+        cacheEntry.hash = calculateRenderableCacheHash( cacheEntry );
+
+        if( (mRenderableCache.size() + 1u) * 2u > mRenderableCacheIndex.size() )
+            rebuildRenderableCacheIndex( std::max<size_t>( mRenderableCacheIndex.size() * 2u, 64u ) );
+
+        const size_t mask = mRenderableCacheIndex.size() - 1u;
+        size_t slot = getHashTableSlot( cacheEntry.hash, mask );
+
+        size_t idx = mRenderableCache.size();
+        while( mRenderableCacheIndex[slot] && idx == mRenderableCache.size() )
+        {
+            if( mRenderableCache[mRenderableCacheIndex[slot] - 1u] == cacheEntry )
+                idx = mRenderableCacheIndex[slot] - 1u;
+            else
+                slot = (slot + 1u) & mask;
+        }
 
-        RenderableCacheVec::iterator it = std::find( mRenderableCache.begin(), mRenderableCache.end(),
-                                                     cacheEntry );
-        if( it == mRenderableCache.end() )
+        if( idx == mRenderableCache.size() )
         {
             mRenderableCache.push_back( cacheEntry );
-            it = mRenderableCache.end() - 1;
+            mRenderableCacheIndex[slot] = static_cast<uint32>( idx + 1u );
         }
 
         //3 bits for mType (see getMaterial)
-        return (mType << HlmsBits::HlmsTypeShift) |
-                ((it - mRenderableCache.begin()) << HlmsBits::RenderableShift);
+        return (mType << HlmsBits::HlmsTypeShift) | (idx << HlmsBits::RenderableShift);
     }
     //-----------------------------------------------------------------------------------
     const Hlms::RenderableCache &Hlms::getRenderableCache( uint32 hash ) const
@@ -1468,6 +1496,10 @@ namespace Ogre
 
         mDataFolder = newDataFolder;
         enumeratePieceFiles();
+
+        //The templates changed, all the generated code is outdated.
+        mShaderCodeCache.clear();
+        mTemplateSourcesLoaded = false;
     }
     //-----------------------------------------------------------------------------------
     ArchiveVec Hlms::getPiecesLibraryAsArchiveVec(void) const
@@ -1589,6 +1621,182 @@ namespace Ogre
         return retVal;
     }
     //-----------------------------------------------------------------------------------
+    void Hlms::calculateTemplatesHash( uint64 outHash[2] ) const
+    {
+        String allFiles;
+
+        for( size_t i=0; i<NumShaderTypes; ++i )
+        {
+            LibraryVec::const_iterator itor = mLibrary.begin();
+            LibraryVec::const_iterator end  = mLibrary.end();
+
+            while( itor != end )
+            {
+                StringVector::const_iterator itFile = itor->pieceFiles[i].begin();
+                StringVector::const_iterator enFile = itor->pieceFiles[i].end();
+                while( itFile != enFile )
+                {
+                    allFiles += *itFile;
+                    allFiles += itor->dataFolder->open( *itFile )->getAsString();
+                    ++itFile;
+                }
+                ++itor;
+            }
+
+            StringVector::const_iterator itFile = mPieceFiles[i].begin();
+            StringVector::const_iterator enFile = mPieceFiles[i].end();
+            while( itFile != enFile )
+            {
+                allFiles += *itFile;
+                allFiles += mDataFolder->open( *itFile )->getAsString();
+                ++itFile;
+            }
+
+            const String filename = ShaderFiles[i] + mShaderFileExt;
+            if( mDataFolder && mDataFolder->exists( filename ) )
+            {
+                allFiles += filename;
+                allFiles += mDataFolder->open( filename )->getAsString();
+            }
+        }
+
+        MurmurHash3_x64_128( allFiles.c_str(), static_cast<int>( allFiles.size() ),
+                             IdString::Seed, outHash );
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::calculatePiecesHash( const PiecesMap *pieces, uint64 outHash[2] )
+    {
+        String allPieces;
+        for( size_t i=0; i<NumShaderTypes; ++i )
+        {
+            PiecesMap::const_iterator itor = pieces[i].begin();
+            PiecesMap::const_iterator end  = pieces[i].end();
+
+            while( itor != end )
+            {
+                const uint32 keyAndLength[2] = { itor->first.mHash,
+                                                 static_cast<uint32>( itor->second.size() ) };
+                allPieces.append( reinterpret_cast<const char*>( keyAndLength ),
+                                  sizeof( keyAndLength ) );
+                allPieces += itor->second;
+                ++itor;
+            }
+
+            //Stage separator
+            allPieces.push_back( '\0' );
+        }
+
+        MurmurHash3_x64_128( allPieces.c_str(), static_cast<int>( allPieces.size() ),
+                             IdString::Seed, outHash );
+    }
+    //-----------------------------------------------------------------------------------
+    uint32 Hlms::calculatePropertiesHash( const HlmsPropertyVec &properties, uint32 seed )
+    {
+        //Can't hash HlmsProperty directly due to IdString's debug string & padding
+        vector<uint32>::type keyValues;
+        keyValues.reserve( properties.size() * 2u );
+
+        HlmsPropertyVec::const_iterator itor = properties.begin();
+        HlmsPropertyVec::const_iterator end  = properties.end();
+
+        while( itor != end )
+        {
+            keyValues.push_back( itor->keyName.mHash );
+            keyValues.push_back( static_cast<uint32>( itor->value ) );
+            ++itor;
+        }
+
+        uint32 retVal = seed;
+        if( !keyValues.empty() )
+        {
+            MurmurHash3_x86_32( &keyValues[0],
+                                static_cast<int>( keyValues.size() * sizeof(uint32) ),
+                                seed, &retVal );
+        }
+
+        return retVal;
+    }
+    //-----------------------------------------------------------------------------------
+    uint64 Hlms::calculateRenderableCacheHash( const RenderableCache &renderableCache )
+    {
+        uint64 piecesHash[2];
+        calculatePiecesHash( renderableCache.pieces, piecesHash );
+        const uint32 propertiesHash = calculatePropertiesHash( renderableCache.setProperties,
+                                                               IdString::Seed );
+        return (static_cast<uint64>( propertiesHash ) << 32u) ^ piecesHash[0];
+    }
+    //-----------------------------------------------------------------------------------
+    size_t Hlms::getHashTableSlot( uint64 hash, size_t mask )
+    {
+        //Fibonacci hashing. Shader cache hashes are bitfields, not well distributed.
+        return static_cast<size_t>( (hash * 0x9E3779B97F4A7C15ULL) >> 32u ) & mask;
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::rebuildRenderableCacheIndex( size_t newSize )
+    {
+        mRenderableCacheIndex.clear();
+        mRenderableCacheIndex.resize( newSize, 0 );
+
+        const size_t mask = newSize - 1u;
+
+        for( size_t i=0; i<mRenderableCache.size(); ++i )
+        {
+            size_t slot = getHashTableSlot( mRenderableCache[i].hash, mask );
+            while( mRenderableCacheIndex[slot] )
+                slot = (slot + 1u) & mask;
+            mRenderableCacheIndex[slot] = static_cast<uint32>( i + 1u );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::rebuildShaderCacheIndex( size_t newSize )
+    {
+        mShaderCacheIndex.clear();
+        mShaderCacheIndex.resize( newSize, 0 );
+
+        const size_t mask = newSize - 1u;
+
+        HlmsCacheVec::const_iterator itor = mShaderCache.begin();
+        HlmsCacheVec::const_iterator end  = mShaderCache.end();
+
+        while( itor != end )
+        {
+            size_t slot = getHashTableSlot( (*itor)->hash, mask );
+            while( mShaderCacheIndex[slot] )
+                slot = (slot + 1u) & mask;
+            mShaderCacheIndex[slot] = *itor;
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    const Hlms::ShaderCodeCache* Hlms::findShaderCodeCache( const PiecesMap *pieces,
+                                                            uint64 outPiecesHash[2],
+                                                            uint32 &outHash ) const
+    {
+        calculatePiecesHash( pieces, outPiecesHash );
+        //Hash the properties and then the pieces' hash
+        const uint32 propertiesHash = calculatePropertiesHash( mSetProperties, 0 );
+        MurmurHash3_x86_32( outPiecesHash, sizeof(uint64) * 2u, propertiesHash, &outHash );
+
+        ShaderCodeCache toFind;
+        toFind.hash = outHash;
+        ShaderCodeCacheVec::const_iterator itor = std::lower_bound( mShaderCodeCache.begin(),
+                                                                    mShaderCodeCache.end(),
+                                                                    toFind );
+        while( itor != mShaderCodeCache.end() && itor->hash == outHash )
+        {
+            if( itor->piecesHash[0] == outPiecesHash[0] &&
+                itor->piecesHash[1] == outPiecesHash[1] &&
+                itor->inProperties == mSetProperties )
+            {
+                return &(*itor);
+            }
+
+            ++itor;
+        }
+
+        return 0;
+    }
+    //-----------------------------------------------------------------------------------
     const HlmsCache* Hlms::addShaderCache( uint32 hash, const HlmsPso &pso )
     {
         HlmsCache cache( hash, mType, pso );
@@ -1601,17 +1809,36 @@ namespace Ogre
         HlmsCache *retVal = new HlmsCache( cache );
         mShaderCache.insert( it, retVal );
 
+        if( mShaderCache.size() * 2u > mShaderCacheIndex.size() )
+        {
+            rebuildShaderCacheIndex( std::max<size_t>( mShaderCacheIndex.size() * 2u, 64u ) );
+        }
+        else
+        {
+            const size_t mask = mShaderCacheIndex.size() - 1u;
+            size_t slot = getHashTableSlot( hash, mask );
+            while( mShaderCacheIndex[slot] )
+                slot = (slot + 1u) & mask;
+            mShaderCacheIndex[slot] = retVal;
+        }
+
         return retVal;
     }
     //-----------------------------------------------------------------------------------
     const HlmsCache* Hlms::getShaderCache( uint32 hash ) const
     {
-        HlmsCache cache( hash, mType, HlmsPso() );
-        HlmsCacheVec::const_iterator it = std::lower_bound( mShaderCache.begin(), mShaderCache.end(),
-                                                            &cache, OrderCacheByHash );
+        if( mShaderCacheIndex.empty() )
+            return 0;
 
-        if( it != mShaderCache.end() && (*it)->hash == hash )
-            return *it;
+        const size_t mask = mShaderCacheIndex.size() - 1u;
+        size_t slot = getHashTableSlot( hash, mask );
+
+        while( mShaderCacheIndex[slot] )
+        {
+            if( mShaderCacheIndex[slot]->hash == hash )
+                return mShaderCacheIndex[slot];
+            slot = (slot + 1u) & mask;
+        }
 
         return 0;
     }
@@ -1631,37 +1858,95 @@ namespace Ogre
         }
 
         mShaderCache.clear();
+        mShaderCacheIndex.clear();
+        ++mShaderCacheGeneration;
     }
     //-----------------------------------------------------------------------------------
-    void Hlms::processPieces( Archive *archive, const StringVector &pieceFiles )
+    void Hlms::readTemplateSource( Archive *archive, const String &filename, String &outSource )
     {
-        StringVector::const_iterator itor = pieceFiles.begin();
-        StringVector::const_iterator end  = pieceFiles.end();
+        outSource.clear();
 
-        while( itor != end )
+        if( archive->exists( filename ) )
+        {
+            DataStreamPtr inFile = archive->open( filename );
+            outSource.resize( inFile->size() );
+            if( !outSource.empty() )
+                inFile->read( &outSource[0], outSource.size() );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::loadTemplateSources(void)
+    {
+        if( mTemplateSourcesLoaded )
+            return;
+
+        for( size_t i=0; i<NumShaderTypes; ++i )
         {
-            //Only open piece files with current render system extension
-            const String::size_type extPos = itor->find( mShaderFileExt );
-            if( extPos == itor->size() - mShaderFileExt.size() )
+            LibraryVec::iterator itor = mLibrary.begin();
+            LibraryVec::iterator end  = mLibrary.end();
+
+            while( itor != end )
             {
-                DataStreamPtr inFile = archive->open(*itor);
+                const StringVector &pieceFiles = itor->pieceFiles[i];
+                StringVector &pieceFileSources = itor->pieceFileSources[i];
+                pieceFileSources.clear();
+                pieceFileSources.resize( pieceFiles.size() );
+
+                for( size_t j=0; j<pieceFiles.size(); ++j )
+                {
+                    //Only load piece files with current render system extension
+                    const String::size_type extPos = pieceFiles[j].find( mShaderFileExt );
+                    if( extPos == pieceFiles[j].size() - mShaderFileExt.size() )
+                        readTemplateSource( itor->dataFolder, pieceFiles[j], pieceFileSources[j] );
+                }
+
+                ++itor;
+            }
+
+            mPieceFileSources[i].clear();
+            mTemplateSources[i].clear();
+
+            if( mDataFolder )
+            {
+                mPieceFileSources[i].resize( mPieceFiles[i].size() );
+
+                for( size_t j=0; j<mPieceFiles[i].size(); ++j )
+                {
+                    const String::size_type extPos = mPieceFiles[i][j].find( mShaderFileExt );
+                    if( extPos == mPieceFiles[i][j].size() - mShaderFileExt.size() )
+                        readTemplateSource( mDataFolder, mPieceFiles[i][j], mPieceFileSources[i][j] );
+                }
+
+                readTemplateSource( mDataFolder, ShaderFiles[i] + mShaderFileExt,
+                                    mTemplateSources[i] );
+            }
+        }
 
-                String inString;
-                String outString;
+        mTemplateSourcesLoaded = true;
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::processPieces( const StringVector &pieceFileSources )
+    {
+        String &inString  = mParseBuffer[0];
+        String &outString = mParseBuffer[1];
 
-                inString.resize(inFile->size());
-                inFile->read(&inString[0], inFile->size());
+        StringVector::const_iterator itor = pieceFileSources.begin();
+        StringVector::const_iterator end  = pieceFileSources.end();
 
-                this->parseMath(inString, outString);
+        while( itor != end )
+        {
+            if( !itor->empty() )
+            {
+                this->parseMath( *itor, outString );
                 while( outString.find( "@foreach" ) != String::npos )
                 {
-                    this->parseForEach(outString, inString);
+                    this->parseForEach( outString, inString );
                     inString.swap( outString );
                 }
-                this->parseProperties(outString, inString);
-                this->parseUndefPieces(inString, outString);
-                this->collectPieces(outString, inString);
-                this->parseCounter(inString, outString);
+                this->parseProperties( outString, inString );
+                this->parseUndefPieces( inString, outString );
+                this->collectPieces( outString, inString );
+                this->parseCounter( inString, outString );
             }
             ++itor;
         }
@@ -1671,6 +1956,8 @@ namespace Ogre
                                                    uint32 finalHash,
                                                    const QueuedRenderable &queuedRenderable )
     {
+        OgreTimelineScope( "Hlms::createShaderCacheEntry", TimelineProfiler::CurrentThreadTrack );
+
         //Set the properties by merging the cache from the pass, with the cache from renderable
         mSetProperties.clear();
         //If retVal is null, we did something wrong earlier
@@ -1701,120 +1988,164 @@ namespace Ogre
                 setProperty( *itor++, 1 );
         }
 
+        if( mShaderProfile == "glsl" ) //TODO: String comparision
+            setProperty( HlmsBaseProp::GL3Plus, 330 );
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
+        setProperty( HlmsBaseProp::iOS, 1 );
+#endif
+        setProperty( HlmsBaseProp::HighQuality, mHighQuality );
+
+        ShaderCodeCache newCodeCache;
+        const ShaderCodeCache *cachedCode = 0;
+
+        if( mShaderCodeCacheEnabled )
+        {
+            cachedCode = findShaderCodeCache( renderableCache.pieces, newCodeCache.piecesHash,
+                                              newCodeCache.hash );
+            if( !cachedCode )
+                newCodeCache.inProperties = mSetProperties;
+        }
+
+        if( cachedCode )
+        {
+            //Restore the properties the templates would've set.
+            mSetProperties = cachedCode->outProperties;
+            ++mShaderCodeCacheHits;
+        }
+        else
+        {
+            ++mTemplateParses;
+        }
+
+        if( !cachedCode )
+            loadTemplateSources();
+
         GpuProgramPtr shaders[NumShaderTypes];
         //Generate the shaders
         for( size_t i=0; i<NumShaderTypes; ++i )
         {
-            //Collect pieces
-            mPieces = renderableCache.pieces[i];
+            String &outString = mParseBuffer[1];
+            outString.clear();
+            bool stageDisabled = false;
 
-            const String filename = ShaderFiles[i] + mShaderFileExt;
-            if( mDataFolder->exists( filename ) )
+            if( cachedCode )
             {
-                if( mShaderProfile == "glsl" ) //TODO: String comparision
-                    setProperty( HlmsBaseProp::GL3Plus, 330 );
-
-#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
-                setProperty( HlmsBaseProp::iOS, 1 );
-#endif
-                setProperty( HlmsBaseProp::HighQuality, mHighQuality );
-
-                //Library piece files first
-                LibraryVec::const_iterator itor = mLibrary.begin();
-                LibraryVec::const_iterator end  = mLibrary.end();
+                outString = cachedCode->source[i];
+            }
+            else
+            {
+                //Collect pieces
+                mPieces = renderableCache.pieces[i];
 
-                while( itor != end )
+                if( !mTemplateSources[i].empty() )
                 {
-                    processPieces( itor->dataFolder, itor->pieceFiles[i] );
-                    ++itor;
-                }
-
-                //Main piece files
-                processPieces( mDataFolder, mPieceFiles[i] );
+                    //Library piece files first
+                    LibraryVec::const_iterator itor = mLibrary.begin();
+                    LibraryVec::const_iterator end  = mLibrary.end();
 
-                //Generate the shader file.
-                DataStreamPtr inFile = mDataFolder->open( filename );
+                    while( itor != end )
+                    {
+                        processPieces( itor->pieceFileSources[i] );
+                        ++itor;
+                    }
 
-                String inString;
-                String outString;
+                    //Main piece files
+                    processPieces( mPieceFileSources[i] );
 
-                inString.resize( inFile->size() );
-                inFile->read( &inString[0], inFile->size() );
+                    //Generate the shader file.
+                    String &inString = mParseBuffer[0];
 
-                bool syntaxError = false;
+                    bool syntaxError = false;
 
-                syntaxError |= this->parseMath( inString, outString );
-                while( !syntaxError && outString.find( "@foreach" ) != String::npos )
-                {
-                    syntaxError |= this->parseForEach( outString, inString );
-                    inString.swap( outString );
-                }
-                syntaxError |= this->parseProperties( outString, inString );
-                syntaxError |= this->parseUndefPieces( inString, outString );
-                while( !syntaxError  && (outString.find( "@piece" ) != String::npos ||
-                                         outString.find( "@insertpiece" ) != String::npos) )
-                {
-                    syntaxError |= this->collectPieces( outString, inString );
-                    syntaxError |= this->insertPieces( inString, outString );
-                }
-                syntaxError |= this->parseCounter( outString, inString );
+                    syntaxError |= this->parseMath( mTemplateSources[i], outString );
+                    while( !syntaxError && outString.find( "@foreach" ) != String::npos )
+                    {
+                        syntaxError |= this->parseForEach( outString, inString );
+                        inString.swap( outString );
+                    }
+                    syntaxError |= this->parseProperties( outString, inString );
+                    syntaxError |= this->parseUndefPieces( inString, outString );
+                    while( !syntaxError  && (outString.find( "@piece" ) != String::npos ||
+                                             outString.find( "@insertpiece" ) != String::npos) )
+                    {
+                        syntaxError |= this->collectPieces( outString, inString );
+                        syntaxError |= this->insertPieces( inString, outString );
+                    }
+                    syntaxError |= this->parseCounter( outString, inString );
 
-                outString.swap( inString );
+                    outString.swap( inString );
 
-                if( syntaxError )
-                {
-                    LogManager::getSingleton().logMessage( "There were HLMS syntax errors while parsing "
-                                                           + StringConverter::toString( finalHash ) +
-                                                           ShaderFiles[i] );
-                }
+                    if( syntaxError )
+                    {
+                        LogManager::getSingleton().logMessage( "There were HLMS syntax errors while parsing "
+                                                               + StringConverter::toString( finalHash ) +
+                                                               ShaderFiles[i] );
+                    }
 
-                String debugFilenameOutput;
+                    //Don't create and compile if template requested not to
+                    stageDisabled = getProperty( HlmsBaseProp::DisableStage ) != 0;
 
-                if( mDebugOutput )
-                {
-                    debugFilenameOutput = mOutputPath + "./" +
-                                            StringConverter::toString( finalHash ) +
-                                            ShaderFiles[i] + mShaderFileExt;
-                    std::ofstream outFile( debugFilenameOutput.c_str(),
-                                           std::ios::out | std::ios::binary );
-                    outFile.write( &outString[0], outString.size() );
+                    //Reset the disable flag.
+                    setProperty( HlmsBaseProp::DisableStage, 0 );
                 }
 
-                //Don't create and compile if template requested not to
-                if( !getProperty( HlmsBaseProp::DisableStage ) )
-                {
-                    HighLevelGpuProgramManager *gpuProgramManager =
-                            HighLevelGpuProgramManager::getSingletonPtr();
+                if( !stageDisabled )
+                    newCodeCache.source[i] = outString;
+            }
 
-                    HighLevelGpuProgramPtr gp = gpuProgramManager->createProgram(
-                                StringConverter::toString( finalHash ) + ShaderFiles[i],
-                                ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
-                                mShaderProfile, static_cast<GpuProgramType>(i) );
-                    gp->setSource( outString, debugFilenameOutput );
+            String debugFilenameOutput;
 
-                    if( mShaderTargets[i] )
-                    {
-                        //D3D-specific
-                        gp->setParameter( "target", *mShaderTargets[i] );
-                        gp->setParameter( "entry_point", "main" );
-                    }
+            if( mDebugOutput && !outString.empty() )
+            {
+                debugFilenameOutput = mOutputPath + "./" +
+                                        StringConverter::toString( finalHash ) +
+                                        ShaderFiles[i] + mShaderFileExt;
+                std::ofstream outFile( debugFilenameOutput.c_str(),
+                                       std::ios::out | std::ios::binary );
+                outFile.write( &outString[0], outString.size() );
+            }
 
-                    gp->setBuildParametersFromReflection( false );
-                    gp->setSkeletalAnimationIncluded( getProperty( HlmsBaseProp::Skeleton ) != 0 );
-                    gp->setMorphAnimationIncluded( false );
-                    gp->setPoseAnimationIncluded( getProperty( HlmsBaseProp::Pose ) );
-                    gp->setVertexTextureFetchRequired( false );
+            if( !outString.empty() && !stageDisabled )
+            {
+                HighLevelGpuProgramManager *gpuProgramManager =
+                        HighLevelGpuProgramManager::getSingletonPtr();
 
-                    gp->load();
+                HighLevelGpuProgramPtr gp = gpuProgramManager->createProgram(
+                            StringConverter::toString( finalHash ) + ShaderFiles[i],
+                            ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME,
+                            mShaderProfile, static_cast<GpuProgramType>(i) );
+                gp->setSource( outString, debugFilenameOutput );
 
-                    shaders[i] = gp;
+                if( mShaderTargets[i] )
+                {
+                    //D3D-specific
+                    gp->setParameter( "target", *mShaderTargets[i] );
+                    gp->setParameter( "entry_point", "main" );
                 }
 
-                //Reset the disable flag.
-                setProperty( HlmsBaseProp::DisableStage, 0 );
+                gp->setBuildParametersFromReflection( false );
+                gp->setSkeletalAnimationIncluded( getProperty( HlmsBaseProp::Skeleton ) != 0 );
+                gp->setMorphAnimationIncluded( false );
+                gp->setPoseAnimationIncluded( getProperty( HlmsBaseProp::Pose ) );
+                gp->setVertexTextureFetchRequired( false );
+
+                gp->load();
+
+                shaders[i] = gp;
             }
         }
 
+        if( mShaderCodeCacheEnabled && !cachedCode )
+        {
+            newCodeCache.outProperties = mSetProperties;
+
+            ShaderCodeCacheVec::iterator it = std::lower_bound( mShaderCodeCache.begin(),
+                                                                mShaderCodeCache.end(),
+                                                                newCodeCache );
+            mShaderCodeCache.insert( it, newCodeCache );
+        }
+
         HlmsPso pso;
         pso.initialize();
         pso.vertexShader                = shaders[VertexShader];
@@ -2085,6 +2416,8 @@ namespace Ogre
                 setProperty( HlmsBaseProp::Forward3DDebug,  forward3D->getDebugMode() );
                 setProperty( HlmsBaseProp::Forward3DFadeAttenRange,
                              forward3D->getFadeAttenuationRange() );
+                setProperty( HlmsBaseProp::Forward3DExponential,
+                             forward3D->getDepthSliceExponent() > 0 );
                 setProperty( HlmsBaseProp::VPos, 1 );
             }
 
@@ -2258,7 +2591,7 @@ namespace Ogre
     const HlmsCache* Hlms::getMaterial( HlmsCache const *lastReturnedValue,
                                         const HlmsCache &passCache,
                                         const QueuedRenderable &queuedRenderable,
-                                        uint8 inputLayout, bool casterPass )
+                                        uint8 inputLayout, bool casterPass, bool canDefer )
     {
         uint32 finalHash;
         uint32 hash[2];
@@ -2284,6 +2617,24 @@ namespace Ogre
 
             if( !lastReturnedValue )
             {
+                if( mShaderCreationBudget )
+                {
+                    const unsigned long currentFrame = Root::getSingleton().getNextFrameNumber();
+                    if( mShaderCreationFrame != currentFrame )
+                    {
+                        mShaderCreationFrame = currentFrame;
+                        mShadersCreatedThisFrame = 0;
+                    }
+
+                    if( canDefer && mShadersCreatedThisFrame >= mShaderCreationBudget )
+                    {
+                        ++mNumDeferredShaders;
+                        return 0;
+                    }
+
+                    ++mShadersCreatedThisFrame;
+                }
+
                 lastReturnedValue = createShaderCacheEntry( hash[0], passCache, finalHash,
                                                             queuedRenderable );
             }
@@ -2298,6 +2649,209 @@ namespace Ogre
         mOutputPath		= path;
     }
     //-----------------------------------------------------------------------------------
+    void Hlms::setShaderCreationBudget( uint32 maxShadersPerFrame )
+    {
+        mShaderCreationBudget = maxShadersPerFrame;
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::setShaderCodeCacheEnabled( bool bEnable )
+    {
+        mShaderCodeCacheEnabled = bEnable;
+        if( !bEnable )
+            mShaderCodeCache.clear();
+    }
+    //-----------------------------------------------------------------------------------
+    /// Bump whenever the format or the way hashes are calculated changes.
+    static const uint32 c_shaderCodeCacheVersion = 2;
+
+    /// Smallest possible size of a saved ShaderCodeCache entry (everything empty).
+    static const size_t c_minShaderCodeCacheEntrySize = sizeof(uint32) + sizeof(uint64) * 2u +
+                                                        sizeof(uint32) * 2u +
+                                                        sizeof(uint32) * NumShaderTypes;
+
+    static void writeString( DataStreamPtr &dataStream, const String &value )
+    {
+        const uint32 length = static_cast<uint32>( value.size() );
+        dataStream->write( &length, sizeof(uint32) );
+        if( length )
+            dataStream->write( value.c_str(), length );
+    }
+    /// Returns false if the stream ended before all the bytes could be read.
+    static bool readBytes( DataStreamPtr &dataStream, void *outData, size_t numBytes )
+    {
+        return dataStream->read( outData, numBytes ) == numBytes;
+    }
+    static size_t getRemainingBytes( const DataStreamPtr &dataStream )
+    {
+        const size_t position = dataStream->tell();
+        return dataStream->size() > position ? dataStream->size() - position : 0;
+    }
+    /// Returns false if the stream is truncated or the length is corrupt.
+    static bool readString( DataStreamPtr &dataStream, String &outValue )
+    {
+        uint32 length = 0;
+        if( !readBytes( dataStream, &length, sizeof(uint32) ) ||
+            length > getRemainingBytes( dataStream ) )
+        {
+            return false;
+        }
+
+        outValue.resize( length );
+        return !length || readBytes( dataStream, &outValue[0], length );
+    }
+    static void writeProperties( DataStreamPtr &dataStream, const HlmsPropertyVec &properties )
+    {
+        const uint32 numProperties = static_cast<uint32>( properties.size() );
+        dataStream->write( &numProperties, sizeof(uint32) );
+
+        HlmsPropertyVec::const_iterator itor = properties.begin();
+        HlmsPropertyVec::const_iterator end  = properties.end();
+
+        while( itor != end )
+        {
+            dataStream->write( &itor->keyName.mHash, sizeof(uint32) );
+            dataStream->write( &itor->value, sizeof(int32) );
+            ++itor;
+        }
+    }
+    /// Returns false if the stream is truncated or the number of properties is corrupt.
+    static bool readProperties( DataStreamPtr &dataStream, HlmsPropertyVec &outProperties )
+    {
+        uint32 numProperties = 0;
+        if( !readBytes( dataStream, &numProperties, sizeof(uint32) ) ||
+            numProperties > getRemainingBytes( dataStream ) / (sizeof(uint32) + sizeof(int32)) )
+        {
+            return false;
+        }
+
+        outProperties.clear();
+        outProperties.reserve( numProperties );
+
+        for( uint32 i=0; i<numProperties; ++i )
+        {
+            IdString keyName;
+            int32 value = 0;
+            if( !readBytes( dataStream, &keyName.mHash, sizeof(uint32) ) ||
+                !readBytes( dataStream, &value, sizeof(int32) ) )
+            {
+                return false;
+            }
+            outProperties.push_back( HlmsProperty( keyName, value ) );
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::saveShaderCodeCache( DataStreamPtr &dataStream ) const
+    {
+        if( !dataStream->isWriteable() )
+        {
+            OGRE_EXCEPT( Exception::ERR_CANNOT_WRITE_TO_FILE,
+                         "Unable to write to stream " + dataStream->getName(),
+                         "Hlms::saveShaderCodeCache" );
+        }
+
+        uint64 templatesHash[2];
+        calculateTemplatesHash( templatesHash );
+
+        dataStream->write( &c_shaderCodeCacheVersion, sizeof(uint32) );
+        writeString( dataStream, mShaderProfile );
+        dataStream->write( templatesHash, sizeof(templatesHash) );
+
+        const uint32 numEntries = static_cast<uint32>( mShaderCodeCache.size() );
+        dataStream->write( &numEntries, sizeof(uint32) );
+
+        ShaderCodeCacheVec::const_iterator itor = mShaderCodeCache.begin();
+        ShaderCodeCacheVec::const_iterator end  = mShaderCodeCache.end();
+
+        while( itor != end )
+        {
+            dataStream->write( &itor->hash, sizeof(uint32) );
+            dataStream->write( itor->piecesHash, sizeof(itor->piecesHash) );
+            writeProperties( dataStream, itor->inProperties );
+            writeProperties( dataStream, itor->outProperties );
+            for( size_t i=0; i<NumShaderTypes; ++i )
+                writeString( dataStream, itor->source[i] );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::loadShaderCodeCache( DataStreamPtr &dataStream )
+    {
+        mShaderCodeCacheEnabled = true;
+
+        //The lengths & counts are validated against the remaining bytes, so we need
+        //to know the stream's size. Buffer it in memory if the stream can't tell.
+        DataStreamPtr stream = dataStream;
+        if( !stream->size() )
+            stream = DataStreamPtr( OGRE_NEW MemoryDataStream( dataStream ) );
+
+        uint32 version = 0;
+        if( !readBytes( stream, &version, sizeof(uint32) ) || version != c_shaderCodeCacheVersion )
+        {
+            LogManager::getSingleton().logMessage( "Shader code cache '" + dataStream->getName() +
+                                                   "' has an unsupported version. Ignoring." );
+            return;
+        }
+
+        const String corruptMsg = "Shader code cache '" + dataStream->getName() +
+                                  "' is truncated or corrupt. Ignoring.";
+
+        String shaderProfile;
+        uint64 savedTemplatesHash[2];
+        if( !readString( stream, shaderProfile ) ||
+            !readBytes( stream, savedTemplatesHash, sizeof(savedTemplatesHash) ) )
+        {
+            LogManager::getSingleton().logMessage( corruptMsg );
+            return;
+        }
+
+        uint64 templatesHash[2];
+        calculateTemplatesHash( templatesHash );
+
+        if( shaderProfile != mShaderProfile ||
+            savedTemplatesHash[0] != templatesHash[0] || savedTemplatesHash[1] != templatesHash[1] )
+        {
+            LogManager::getSingleton().logMessage( "Shader code cache '" + dataStream->getName() +
+                                                   "' is outdated or for a different shading "
+                                                   "language. Ignoring." );
+            return;
+        }
+
+        uint32 numEntries = 0;
+        if( !readBytes( stream, &numEntries, sizeof(uint32) ) ||
+            numEntries > getRemainingBytes( stream ) / c_minShaderCodeCacheEntrySize )
+        {
+            LogManager::getSingleton().logMessage( corruptMsg );
+            return;
+        }
+
+        ShaderCodeCacheVec loadedEntries;
+        loadedEntries.resize( numEntries );
+
+        for( uint32 i=0; i<numEntries; ++i )
+        {
+            ShaderCodeCache &entry = loadedEntries[i];
+            bool isValid = readBytes( stream, &entry.hash, sizeof(uint32) ) &&
+                           readBytes( stream, entry.piecesHash, sizeof(entry.piecesHash) ) &&
+                           readProperties( stream, entry.inProperties ) &&
+                           readProperties( stream, entry.outProperties );
+            for( size_t j=0; j<NumShaderTypes && isValid; ++j )
+                isValid = readString( stream, entry.source[j] );
+
+            if( !isValid )
+            {
+                //Discard everything; a partially loaded cache can't be trusted.
+                LogManager::getSingleton().logMessage( corruptMsg );
+                return;
+            }
+        }
+
+        //Saved sorted. Merge with whatever we already had.
+        mShaderCodeCache.insert( mShaderCodeCache.end(), loadedEntries.begin(), loadedEntries.end() );
+        std::stable_sort( mShaderCodeCache.begin(), mShaderCodeCache.end() );
+    }
+    //-----------------------------------------------------------------------------------
     void Hlms::setListener( HlmsListener *listener )
     {
         if( !listener )
@@ -2329,6 +2883,7 @@ namespace Ogre
     {
         HlmsCacheVec::iterator itor = mShaderCache.begin();
         HlmsCacheVec::iterator end  = mShaderCache.end();
+        const size_t prevNumShaders = mShaderCache.size();
 
         while( itor != end )
         {
@@ -2344,12 +2899,19 @@ namespace Ogre
                 ++itor;
             }
         }
+
+        if( mShaderCache.size() != prevNumShaders )
+        {
+            rebuildShaderCacheIndex( mShaderCacheIndex.size() );
+            ++mShaderCacheGeneration;
+        }
     }
     //-----------------------------------------------------------------------------------
     void Hlms::_notifyBlendblockDestroyed( uint16 id )
     {
         HlmsCacheVec::iterator itor = mShaderCache.begin();
         HlmsCacheVec::iterator end  = mShaderCache.end();
+        const size_t prevNumShaders = mShaderCache.size();
 
         while( itor != end )
         {
@@ -2365,12 +2927,19 @@ namespace Ogre
                 ++itor;
             }
         }
+
+        if( mShaderCache.size() != prevNumShaders )
+        {
+            rebuildShaderCacheIndex( mShaderCacheIndex.size() );
+            ++mShaderCacheGeneration;
+        }
     }
     //-----------------------------------------------------------------------------------
     void Hlms::_notifyInputLayoutDestroyed( uint16 id )
     {
         HlmsCacheVec::iterator itor = mShaderCache.begin();
         HlmsCacheVec::iterator end  = mShaderCache.end();
+        const size_t prevNumShaders = mShaderCache.size();
 
         while( itor != end )
         {
@@ -2396,12 +2965,19 @@ namespace Ogre
                 ++itor;
             }
         }
+
+        if( mShaderCache.size() != prevNumShaders )
+        {
+            rebuildShaderCacheIndex( mShaderCacheIndex.size() );
+            ++mShaderCacheGeneration;
+        }
     }
     //-----------------------------------------------------------------------------------
     void Hlms::_notifyV1InputLayoutDestroyed( uint16 id )
     {
         HlmsCacheVec::iterator itor = mShaderCache.begin();
         HlmsCacheVec::iterator end  = mShaderCache.end();
+        const size_t prevNumShaders = mShaderCache.size();
 
         while( itor != end )
         {
@@ -2427,11 +3003,19 @@ namespace Ogre
                 ++itor;
             }
         }
+
+        if( mShaderCache.size() != prevNumShaders )
+        {
+            rebuildShaderCacheIndex( mShaderCacheIndex.size() );
+            ++mShaderCacheGeneration;
+        }
     }
     //-----------------------------------------------------------------------------------
     void Hlms::_changeRenderSystem( RenderSystem *newRs )
     {
         clearShaderCache();
+        mShaderCodeCache.clear();
+        mTemplateSourcesLoaded = false; //mShaderFileExt may change
         mRenderSystem = newRs;
 
         mShaderProfile = "unset!";
@@ -37,7 +37,8 @@ THE SOFTWARE.
 
 namespace Ogre
 {
-    HlmsTextureManager::HlmsTextureManager() : mRenderSystem( 0 ), mTextureId( 0 )
+    HlmsTextureManager::HlmsTextureManager() :
+        mRenderSystem( 0 ), mWorkerThreadsSceneManager( 0 ), mTextureId( 0 )
     {
         mDefaultTextureParameters[TEXTURE_TYPE_DIFFUSE].hwGammaCorrection   = true;
         mDefaultTextureParameters[TEXTURE_TYPE_MONOCHROME].pixelFormat      = PF_L8;
@@ -468,7 +469,9 @@ namespace Ogre
 
             if (image->getNumMipmaps() - baseMipLevel != (numMipmaps - baseMipLevel))
             {
-                if (image->generateMipmaps(mDefaultTextureParameters[mapType].hwGammaCorrection) == false)
+                if (image->generateMipmaps(mDefaultTextureParameters[mapType].hwGammaCorrection,
+                                           Image::FILTER_BILINEAR,
+                                           mWorkerThreadsSceneManager) == false)
                 {
                     //unable to generate preferred number of mipmaps, so use mipmaps of the input tex
                     numMipmaps = image->getNumMipmaps();
@@ -851,7 +854,8 @@ namespace Ogre
 
                     if( pack.hasMipmaps )
                     {
-                        if( !cubeMap.generateMipmaps( pack.hwGammaCorrection, Image::FILTER_GAUSSIAN ) )
+                        if( !cubeMap.generateMipmaps( pack.hwGammaCorrection, Image::FILTER_GAUSSIAN,
+                                                      mWorkerThreadsSceneManager ) )
                         {
                             LogManager::getSingleton().logMessage( "Couldn't generate mipmaps for '" +
                                                                     texInfo.name + "'", LML_CRITICAL );
@@ -877,7 +881,8 @@ namespace Ogre
                     //TODO
                     /*if( image.getNumMipmaps() != numMipmaps )
                     {
-                        image.generateMipmaps();
+                        image.generateMipmaps( pack.hwGammaCorrection, Image::FILTER_BILINEAR,
+                                               mWorkerThreadsSceneManager );
                     }*/
                 }
 
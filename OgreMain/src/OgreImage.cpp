@@ -35,8 +35,85 @@ THE SOFTWARE.
 #include "OgreImageResampler.h"
 #include "OgreImageDownsampler.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreSceneManager.h"
+#include "Threading/OgreChunkedTask.h"
 
 namespace Ogre {
+    /// Don't bother waking up the worker threads for less than this amount of pixels per chunk.
+    static const uint32 c_minDownsampledPixelsPerChunk = 64 * 1024;
+
+    /// Downsamples one mip level of an image, split in bands of rows (per face).
+    class ImageDownsampleTask : public ChunkedTask
+    {
+        const Image             *mImage;
+        uint8                   mDstMip;
+        ImageDownsampler2D      *mDownsampler2DFunc;
+        ImageDownsamplerCube    *mDownsamplerCubeFunc;
+        const FilterKernel      &mFilter;
+        uint32                  mDstWidth;
+        uint32                  mDstHeight;
+        uint32                  mSrcWidth;
+        uint32                  mSrcHeight;
+        size_t                  mNumFaces;
+        size_t                  mNumBands;
+
+    public:
+        ImageDownsampleTask( const Image *image, uint8 dstMip,
+                             ImageDownsampler2D *downsampler2DFunc,
+                             ImageDownsamplerCube *downsamplerCubeFunc,
+                             const FilterKernel &filter,
+                             uint32 dstWidth, uint32 dstHeight,
+                             uint32 srcWidth, uint32 srcHeight,
+                             size_t numFaces, size_t numBands ) :
+            mImage( image ), mDstMip( dstMip ),
+            mDownsampler2DFunc( downsampler2DFunc ),
+            mDownsamplerCubeFunc( downsamplerCubeFunc ),
+            mFilter( filter ),
+            mDstWidth( dstWidth ), mDstHeight( dstHeight ),
+            mSrcWidth( srcWidth ), mSrcHeight( srcHeight ),
+            mNumFaces( numFaces ), mNumBands( numBands ) {}
+
+        virtual size_t getNumChunks(void) const     { return mNumFaces * mNumBands; }
+
+        virtual void executeChunk( size_t chunkIdx, size_t threadId )
+        {
+            const size_t face   = chunkIdx / mNumBands;
+            const size_t band   = chunkIdx % mNumBands;
+            const int32 rowStart= static_cast<int32>( (mDstHeight * band) / mNumBands );
+            const int32 rowEnd  = static_cast<int32>( (mDstHeight * (band + 1u)) / mNumBands );
+
+            uint8 *dstPtr = reinterpret_cast<uint8*>( mImage->getPixelBox( face, mDstMip ).data );
+
+            if( mImage->hasFlag( IF_CUBEMAP ) )
+            {
+                uint8 const *upFaces[6];
+                for( size_t j=0; j<6; ++j )
+                {
+                    upFaces[j] = reinterpret_cast<uint8*>(
+                                mImage->getPixelBox( j, mDstMip - 1u ).data );
+                }
+
+                (*mDownsamplerCubeFunc)( dstPtr, upFaces,
+                                         mDstWidth, mDstHeight, mSrcWidth, mSrcHeight,
+                                         mFilter.kernel,
+                                         mFilter.kernelStartX, mFilter.kernelEndX,
+                                         mFilter.kernelStartY, mFilter.kernelEndY,
+                                         static_cast<uint8>( face ), rowStart, rowEnd );
+            }
+            else
+            {
+                (*mDownsampler2DFunc)( dstPtr,
+                                       reinterpret_cast<uint8*>(
+                                           mImage->getPixelBox( face, mDstMip - 1u ).data ),
+                                       mDstWidth, mDstHeight, mSrcWidth,
+                                       mFilter.kernel,
+                                       mFilter.kernelStartX, mFilter.kernelEndX,
+                                       mFilter.kernelStartY, mFilter.kernelEndY,
+                                       rowStart, rowEnd );
+            }
+        }
+    };
+
     ImageCodec::~ImageCodec() {
     }
 
@@ -580,7 +657,7 @@ namespace Ogre {
         Image::scale(temp.getPixelBox(), getPixelBox(), filter);
     }
     //-----------------------------------------------------------------------------
-    bool Image::generateMipmaps( bool gammaCorrected, Filter filter )
+    bool Image::generateMipmaps( bool gammaCorrected, Filter filter, SceneManager *sceneManager )
     {
         // resizing dynamic images is not supported
         assert(mAutoDelete);
@@ -768,31 +845,32 @@ namespace Ogre {
             dstWidth   = std::max<uint32>( 1, dstWidth >> 1 );
             dstHeight  = std::max<uint32>( 1, dstHeight >> 1 );
 
-            if( hasFlag( IF_CUBEMAP ) )
+            const size_t numDstFaces = hasFlag( IF_CUBEMAP ) ? 6u : 1u;
+
+            size_t numChunks = 1u;
+            if( sceneManager )
             {
-                uint8 const *upFaces[6];
-                for( size_t j=0; j<6; ++j )
-                    upFaces[j] = reinterpret_cast<uint8*>( this->getPixelBox( j, i - 1 ).data );
+                //A few chunks per thread so that the threads can balance the load.
+                numChunks = std::min<size_t>( sceneManager->getNumWorkerThreads() * 4u,
+                                              (dstWidth * dstHeight * numDstFaces) /
+                                              c_minDownsampledPixelsPerChunk );
+            }
 
-                for( size_t j=0; j<6; ++j )
-                {
-                    PixelBox downFace = this->getPixelBox( j, i );
-                    (*downsamplerCubeFunc)( reinterpret_cast<uint8*>( downFace.data ), upFaces,
-                                            dstWidth, dstHeight, srcWidth, srcHeight,
-                                            chosenFilter.kernel,
-                                            chosenFilter.kernelStartX, chosenFilter.kernelEndX,
-                                            chosenFilter.kernelStartY, chosenFilter.kernelEndY,
-                                            j );
-                }
+            const size_t numBands = Math::Clamp<size_t>( (numChunks + numDstFaces - 1u) /
+                                                         numDstFaces, 1u, dstHeight );
+
+            ImageDownsampleTask task( this, i, downsampler2DFunc, downsamplerCubeFunc,
+                                      chosenFilter, dstWidth, dstHeight, srcWidth, srcHeight,
+                                      numDstFaces, numBands );
+
+            if( numChunks > 1u )
+            {
+                sceneManager->executeUserChunkedTask( &task );
             }
             else
             {
-                (*downsampler2DFunc)( reinterpret_cast<uint8*>( this->getPixelBox( 0, i ).data ),
-                                      reinterpret_cast<uint8*>( this->getPixelBox( 0, i - 1 ).data ),
-                                      dstWidth, dstHeight, srcWidth,
-                                      chosenFilter.kernel,
-                                      chosenFilter.kernelStartX, chosenFilter.kernelEndX,
-                                      chosenFilter.kernelStartY, chosenFilter.kernelEndY );
+                for( size_t j=0; j<task.getNumChunks(); ++j )
+                    task.executeChunk( j, 0 );
             }
         }
 
@@ -35,6 +35,10 @@ THE SOFTWARE.
 
 #include "OgreImageDownsampler.h"
 
+#if __OGRE_HAVE_SSE
+    #include <emmintrin.h>
+#endif
+
 namespace Ogre
 {
     struct CubemapUVI
@@ -142,12 +146,12 @@ namespace Ogre
             0, 0
         },
         {
-            //Linear
+            //Linear (2x2 box). kernel[2][2] is the centre, i.e. the source pixel at 2x, 2y
             {
+                0, 0, 0, 0, 0,
                 0, 0, 0, 0, 0,
                 0, 0, 1, 1, 0,
                 0, 0, 1, 1, 0,
-                0, 0, 0, 0, 0,
                 0, 0, 0, 0, 0
             },
             0, 1,
@@ -166,6 +170,152 @@ namespace Ogre
             -2, 2
         }
     };
+
+    /// Returns true if it's the 2x2 box filter (c_filterKernels[1]), which our SIMD paths handle.
+    inline bool isBoxFilterKernel( const uint8 kernel[5][5],
+                                   const int8 kernelStartX, const int8 kernelEndX,
+                                   const int8 kernelStartY, const int8 kernelEndY )
+    {
+        return kernelStartX == 0 && kernelEndX == 1 && kernelStartY == 0 && kernelEndY == 1 &&
+               kernel[2][2] == 1 && kernel[2][3] == 1 && kernel[3][2] == 1 && kernel[3][3] == 1;
+    }
+
+#if __OGRE_HAVE_SSE
+    //-----------------------------------------------------------------------------------
+    //  SIMD box filters. They take two full source rows and output numPixels, returning
+    //  how many they actually wrote; the scalar code takes care of the rest. Results must
+    //  match the scalar versions bit for bit, so mipmaps don't depend on the CPU.
+    //-----------------------------------------------------------------------------------
+    inline int32 downscale2x_box_XXXA8888_SSE2( uint8 *dstPtr, const uint8 *srcRow0,
+                                                const uint8 *srcRow1, int32 numPixels )
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        int32 x = 0;
+        for( ; x + 4 <= numPixels; x += 4 )
+        {
+            //8 source pixels per row
+            const __m128i r0a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( srcRow0 ) );
+            const __m128i r0b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( srcRow0 + 16 ) );
+            const __m128i r1a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( srcRow1 ) );
+            const __m128i r1b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( srcRow1 + 16 ) );
+
+            //Vertical sums in 16 bits. Each register holds 2 horizontally adjacent pixels.
+            __m128i s0 = _mm_add_epi16( _mm_unpacklo_epi8( r0a, zero ), _mm_unpacklo_epi8( r1a, zero ) );
+            __m128i s1 = _mm_add_epi16( _mm_unpackhi_epi8( r0a, zero ), _mm_unpackhi_epi8( r1a, zero ) );
+            __m128i s2 = _mm_add_epi16( _mm_unpacklo_epi8( r0b, zero ), _mm_unpacklo_epi8( r1b, zero ) );
+            __m128i s3 = _mm_add_epi16( _mm_unpackhi_epi8( r0b, zero ), _mm_unpackhi_epi8( r1b, zero ) );
+
+            //Horizontal sums end up in the lower half
+            s0 = _mm_add_epi16( s0, _mm_srli_si128( s0, 8 ) );
+            s1 = _mm_add_epi16( s1, _mm_srli_si128( s1, 8 ) );
+            s2 = _mm_add_epi16( s2, _mm_srli_si128( s2, 8 ) );
+            s3 = _mm_add_epi16( s3, _mm_srli_si128( s3, 8 ) );
+
+            //accum / 4, same as truncating accum * 0.25f
+            const __m128i d01 = _mm_srli_epi16( _mm_unpacklo_epi64( s0, s1 ), 2 );
+            const __m128i d23 = _mm_srli_epi16( _mm_unpacklo_epi64( s2, s3 ), 2 );
+
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dstPtr ), _mm_packus_epi16( d01, d23 ) );
+
+            dstPtr  += 4 * 4;
+            srcRow0 += 8 * 4;
+            srcRow1 += 8 * 4;
+        }
+
+        return x;
+    }
+    //-----------------------------------------------------------------------------------
+    /// Gamma correct version. alphaIdx is the byte that holds alpha (0 or 3), which
+    /// isn't linearized.
+    inline int32 downscale2x_box_sRGB_8888_SSE2( uint8 *dstPtr, const uint8 *srcRow0,
+                                                 const uint8 *srcRow1, int32 numPixels,
+                                                 int alphaIdx )
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 quarter = _mm_set1_ps( 0.25f );
+
+        const __m128 alphaMask = _mm_castsi128_ps( alphaIdx == 0 ? _mm_set_epi32( 0, 0, 0, -1 ) :
+                                                                   _mm_set_epi32( -1, 0, 0, 0 ) );
+
+        int32 x = 0;
+        for( ; x < numPixels; ++x )
+        {
+            //2 source pixels per row, expanded to 32 bits
+            const __m128i r0 = _mm_unpacklo_epi8(
+                        _mm_loadl_epi64( reinterpret_cast<const __m128i*>( srcRow0 ) ), zero );
+            const __m128i r1 = _mm_unpacklo_epi8(
+                        _mm_loadl_epi64( reinterpret_cast<const __m128i*>( srcRow1 ) ), zero );
+
+            const __m128 a0 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( r0, zero ) );
+            const __m128 b0 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( r0, zero ) );
+            const __m128 a1 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( r1, zero ) );
+            const __m128 b1 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( r1, zero ) );
+
+            //All the sums are integers below 2^24, thus exact (like the scalar uint32 version)
+            __m128 linear = _mm_add_ps( _mm_add_ps( _mm_mul_ps( a0, a0 ), _mm_mul_ps( b0, b0 ) ),
+                                        _mm_add_ps( _mm_mul_ps( a1, a1 ), _mm_mul_ps( b1, b1 ) ) );
+            __m128 alpha  = _mm_add_ps( _mm_add_ps( a0, b0 ), _mm_add_ps( a1, b1 ) );
+
+            linear  = _mm_sqrt_ps( _mm_mul_ps( linear, quarter ) );
+            alpha   = _mm_mul_ps( alpha, quarter );
+
+            const __m128 result = _mm_or_ps( _mm_and_ps( alphaMask, alpha ),
+                                             _mm_andnot_ps( alphaMask, linear ) );
+
+            __m128i packed = _mm_cvttps_epi32( result );
+            packed = _mm_packs_epi32( packed, packed );
+            packed = _mm_packus_epi16( packed, packed );
+            *reinterpret_cast<uint32*>( dstPtr ) = static_cast<uint32>( _mm_cvtsi128_si32( packed ) );
+
+            dstPtr  += 4;
+            srcRow0 += 2 * 4;
+            srcRow1 += 2 * 4;
+        }
+
+        return x;
+    }
+    //-----------------------------------------------------------------------------------
+    inline int32 downscale2x_box_sRGB_XXXA8888_SSE2( uint8 *dstPtr, const uint8 *srcRow0,
+                                                     const uint8 *srcRow1, int32 numPixels )
+    {
+        return downscale2x_box_sRGB_8888_SSE2( dstPtr, srcRow0, srcRow1, numPixels, 3 );
+    }
+    //-----------------------------------------------------------------------------------
+    inline int32 downscale2x_box_sRGB_AXXX8888_SSE2( uint8 *dstPtr, const uint8 *srcRow0,
+                                                     const uint8 *srcRow1, int32 numPixels )
+    {
+        return downscale2x_box_sRGB_8888_SSE2( dstPtr, srcRow0, srcRow1, numPixels, 0 );
+    }
+    //-----------------------------------------------------------------------------------
+    inline int32 downscale2x_box_Float32_XXXA_SSE2( uint8 *_dstPtr, const uint8 *_srcRow0,
+                                                    const uint8 *_srcRow1, int32 numPixels )
+    {
+        float *dstPtr = reinterpret_cast<float*>( _dstPtr );
+        const float *srcRow0 = reinterpret_cast<const float*>( _srcRow0 );
+        const float *srcRow1 = reinterpret_cast<const float*>( _srcRow1 );
+
+        const __m128 quarter = _mm_set1_ps( 0.25f );
+
+        int32 x = 0;
+        for( ; x < numPixels; ++x )
+        {
+            //Same order of additions as the scalar version (starting from 0)
+            __m128 accum = _mm_add_ps( _mm_setzero_ps(), _mm_loadu_ps( srcRow0 ) );
+            accum = _mm_add_ps( accum, _mm_loadu_ps( srcRow0 + 4 ) );
+            accum = _mm_add_ps( accum, _mm_loadu_ps( srcRow1 ) );
+            accum = _mm_add_ps( accum, _mm_loadu_ps( srcRow1 + 4 ) );
+
+            _mm_storeu_ps( dstPtr, _mm_mul_ps( accum, quarter ) );
+
+            dstPtr  += 4;
+            srcRow0 += 2 * 4;
+            srcRow1 += 2 * 4;
+        }
+
+        return x;
+    }
+#endif
 }
 
     #define OGRE_GAM_TO_LIN( x ) x
@@ -181,6 +331,7 @@ namespace Ogre
     #define OGRE_TOTAL_SIZE 4
     #define DOWNSAMPLE_NAME downscale2x_XXXA8888
     #define DOWNSAMPLE_CUBE_NAME downscale2x_XXXA8888_cube
+    #define DOWNSAMPLE_BOX_SIMD_NAME downscale2x_box_XXXA8888_SSE2
     #include "OgreImageDownsampler.cpp"
 
     #define OGRE_DOWNSAMPLE_R 0
@@ -285,6 +436,7 @@ namespace Ogre
     #define OGRE_TOTAL_SIZE 4
     #define DOWNSAMPLE_NAME downscale2x_Float32_XXXA
     #define DOWNSAMPLE_CUBE_NAME downscale2x_Float32_XXXA_cube
+    #define DOWNSAMPLE_BOX_SIMD_NAME downscale2x_box_Float32_XXXA_SSE2
     #include "OgreImageDownsampler.cpp"
 
     #define OGRE_DOWNSAMPLE_R 0
@@ -342,6 +494,7 @@ namespace Ogre
     #define OGRE_TOTAL_SIZE 4
     #define DOWNSAMPLE_NAME downscale2x_sRGB_XXXA8888
     #define DOWNSAMPLE_CUBE_NAME downscale2x_sRGB_XXXA8888_cube
+    #define DOWNSAMPLE_BOX_SIMD_NAME downscale2x_box_sRGB_XXXA8888_SSE2
     #include "OgreImageDownsampler.cpp"
 
     #define OGRE_DOWNSAMPLE_A 0
@@ -351,6 +504,7 @@ namespace Ogre
     #define OGRE_TOTAL_SIZE 4
     #define DOWNSAMPLE_NAME downscale2x_sRGB_AXXX8888
     #define DOWNSAMPLE_CUBE_NAME downscale2x_sRGB_AXXX8888_cube
+    #define DOWNSAMPLE_BOX_SIMD_NAME downscale2x_box_sRGB_AXXX8888_SSE2
     #include "OgreImageDownsampler.cpp"
 
     #define OGRE_DOWNSAMPLE_R 0
@@ -405,14 +559,40 @@ namespace Ogre
                           int32 srcWidth,
                           const uint8 kernel[5][5],
                           const int8 kernelStartX, const int8 kernelEndX,
-                          const int8 kernelStartY, const int8 kernelEndY )
+                          const int8 kernelStartY, const int8 kernelEndY,
+                          int32 dstRowStart, int32 dstRowEnd )
     {
         OGRE_UINT8 *dstPtr = reinterpret_cast<OGRE_UINT8*>( _dstPtr );
         OGRE_UINT8 const *srcPtr = reinterpret_cast<OGRE_UINT8 const *>( _srcPtr );
 
-        for( int32 y=0; y<dstHeight; ++y )
+        dstPtr += dstRowStart * dstWidth * OGRE_TOTAL_SIZE;
+        srcPtr += dstRowStart * srcWidth * OGRE_TOTAL_SIZE * 2;
+
+    #if defined( DOWNSAMPLE_BOX_SIMD_NAME ) && __OGRE_HAVE_SSE
+        const bool boxFilter = isBoxFilterKernel( kernel, kernelStartX, kernelEndX,
+                                                  kernelStartY, kernelEndY );
+    #endif
+
+        for( int32 y=dstRowStart; y<dstRowEnd; ++y )
         {
-            for( int32 x=0; x<dstWidth; ++x )
+            int32 x = 0;
+
+    #if defined( DOWNSAMPLE_BOX_SIMD_NAME ) && __OGRE_HAVE_SSE
+            //The last row & column only take 1 sample vertically/horizontally; leave them to
+            //the scalar code.
+            if( boxFilter && y < dstHeight - 1 )
+            {
+                x = DOWNSAMPLE_BOX_SIMD_NAME( reinterpret_cast<uint8*>( dstPtr ),
+                                              reinterpret_cast<const uint8*>( srcPtr ),
+                                              reinterpret_cast<const uint8*>(
+                                                  srcPtr + srcWidth * OGRE_TOTAL_SIZE ),
+                                              dstWidth - 1 );
+                dstPtr += x * OGRE_TOTAL_SIZE;
+                srcPtr += x * OGRE_TOTAL_SIZE * 2;
+            }
+    #endif
+
+            for( ; x<dstWidth; ++x )
             {
                 int kStartY = std::max<int>( -y, kernelStartY );
                 int kEndY   = std::min<int>( dstHeight - 1 - y, kernelEndY );
@@ -494,9 +674,10 @@ namespace Ogre
                                const uint8 kernel[5][5],
                                const int8 kernelStartX, const int8 kernelEndX,
                                const int8 kernelStartY, const int8 kernelEndY,
-                               uint8 currentFace )
+                               uint8 currentFace, int32 dstRowStart, int32 dstRowEnd )
     {
         OGRE_UINT8 *dstPtr = reinterpret_cast<OGRE_UINT8*>( _dstPtr );
+        dstPtr += dstRowStart * dstWidth * OGRE_TOTAL_SIZE;
         OGRE_UINT8 const **allPtr = reinterpret_cast<OGRE_UINT8 const **>( _allPtr );
 
         Quaternion kRotations[5][5];
@@ -523,7 +704,7 @@ namespace Ogre
 
         OGRE_UINT8 const *srcPtr = 0;
 
-        for( int32 y=0; y<dstHeight; ++y )
+        for( int32 y=dstRowStart; y<dstRowEnd; ++y )
         {
             for( int32 x=0; x<dstWidth; ++x )
             {
@@ -618,5 +799,6 @@ namespace Ogre
     #undef OGRE_DOWNSAMPLE_B
     #undef DOWNSAMPLE_NAME
     #undef DOWNSAMPLE_CUBE_NAME
+    #undef DOWNSAMPLE_BOX_SIMD_NAME
     #undef OGRE_TOTAL_SIZE
 #endif
@@ -58,7 +58,10 @@ namespace Ogre {
     const long MSTREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
     //---------------------------------------------------------------------
     MeshSerializerImpl::MeshSerializerImpl( VaoManager *vaoManager ) :
-        mVaoManager( vaoManager )
+        mVaoManager( vaoManager ),
+        mInPlaceStream( 0 ),
+        mInPlaceVertexData( false ),
+        mInPlaceIndexData( false )
     {
         // Version number
         mVersion = "[MeshSerializer_v2.1 R2]";
@@ -121,6 +124,8 @@ namespace Ogre {
         // Determine endianness (must be the first thing we do!)
         determineEndianness(stream);
 
+        prepareInPlaceReads( stream, pMesh );
+
 #if OGRE_SERIALIZER_VALIDATE_CHUNKSIZE
         enableValidation();
 #endif
@@ -140,10 +145,53 @@ namespace Ogre {
         }
         popInnerChunk(stream);
 
+        mInPlaceStream      = 0;
+        mInPlaceVertexData  = false;
+        mInPlaceIndexData   = false;
+
         if( !pMesh->hasValidShadowMappingVaos() )
             pMesh->prepareForShadowMapping( false );
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::prepareInPlaceReads( DataStreamPtr &stream, const Mesh *pMesh )
+    {
+        mInPlaceStream = dynamic_cast<MemoryDataStream*>( stream.get() );
+
+        mInPlaceVertexData  = mInPlaceStream && !mFlipEndian && !pMesh->isVertexBufferShadowed();
+        mInPlaceIndexData   = mInPlaceStream && !mFlipEndian && !pMesh->isIndexBufferShadowed();
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::freeSubMeshLodData( SubMeshLodVec &submeshLods,
+                                                 bool vertexData, bool indexData )
+    {
+        SubMeshLodVec::iterator itor = submeshLods.begin();
+        SubMeshLodVec::iterator end  = submeshLods.end();
+
+        while( itor != end )
+        {
+            if( vertexData && !mInPlaceVertexData )
+            {
+                Uint8Vec::iterator it = itor->vertexBuffers.begin();
+                Uint8Vec::iterator en = itor->vertexBuffers.end();
+
+                while( it != en )
+                    OGRE_FREE_SIMD( *it++, MEMCATEGORY_GEOMETRY );
+            }
+
+            if( vertexData )
+                itor->vertexBuffers.clear();
+
+            if( indexData && itor->indexData )
+            {
+                if( !mInPlaceIndexData )
+                    OGRE_FREE_SIMD( itor->indexData, MEMCATEGORY_GEOMETRY );
+                itor->indexData = 0;
+            }
+
+            ++itor;
+        }
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::writeMesh(const Mesh* pMesh)
     {
         exportedLodCount = 1; // generate edge data for original mesh
@@ -824,30 +872,14 @@ namespace Ogre {
                 const uint8 *vertexData = totalSubmeshLods[0].vertexBuffers[indexSource];
                 sm->_buildBoneAssignmentsFromVertexData( vertexData );
             }
+
+            //The GPU buffers got a copy. Unless it's being kept as a shadow copy, we're done.
+            freeSubMeshLodData( totalSubmeshLods, !pMesh->isVertexBufferShadowed(),
+                                !pMesh->isIndexBufferShadowed() );
         }
         catch( Exception &e )
         {
-            SubMeshLodVec::iterator itor = totalSubmeshLods.begin();
-            SubMeshLodVec::iterator end  = totalSubmeshLods.end();
-
-            while( itor != end )
-            {
-                Uint8Vec::iterator it = itor->vertexBuffers.begin();
-                Uint8Vec::iterator en = itor->vertexBuffers.end();
-
-                while( it != en )
-                    OGRE_FREE_SIMD( *it++, MEMCATEGORY_GEOMETRY );
-
-                itor->vertexBuffers.clear();
-
-                if( itor->indexData )
-                {
-                    OGRE_FREE_SIMD( itor->indexData, MEMCATEGORY_GEOMETRY );
-                    itor->indexData = 0;
-                }
-
-                ++itor;
-            }
+            freeSubMeshLodData( totalSubmeshLods, true, true );
 
             //TODO: Delete created mVaos. Don't erase the data from those vaos?
 
@@ -1001,7 +1033,22 @@ namespace Ogre {
         {
             readBools( stream, &subLod->index32Bit, 1 );
 
-            if( subLod->index32Bit )
+            if( mInPlaceIndexData )
+            {
+                //Point straight into the stream's memory. createIndexBuffer copies it to the GPU.
+                const size_t sizeBytes = (subLod->index32Bit ? sizeof(uint32) : sizeof(uint16)) *
+                                            subLod->numIndices;
+                if( mInPlaceStream->size() - mInPlaceStream->tell() < sizeBytes )
+                {
+                    OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                                 "Index buffer exceeds the size of the stream " +
+                                 mInPlaceStream->getName(),
+                                 "MeshSerializerImpl::readIndexes" );
+                }
+                subLod->indexData = mInPlaceStream->getCurrentPtr();
+                mInPlaceStream->skip( static_cast<long>( sizeBytes ) );
+            }
+            else if( subLod->index32Bit )
             {
                 subLod->indexData = OGRE_MALLOC_SIMD( sizeof(uint32) * subLod->numIndices,
                                                       MEMCATEGORY_GEOMETRY );
@@ -1108,12 +1155,29 @@ namespace Ogre {
                         "MeshSerializerImpl::readVertexBuffer");
         }
 
+        const size_t sizeBytes = bytesPerVertex * subLod->numVertices;
+
+        if( mInPlaceVertexData )
+        {
+            //Point straight into the stream's memory. createVertexBuffer copies it to the GPU.
+            //No endian conversion is needed, otherwise we wouldn't be reading in place.
+            if( mInPlaceStream->size() - mInPlaceStream->tell() < sizeBytes )
+            {
+                OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                             "Vertex buffer exceeds the size of the stream " +
+                             mInPlaceStream->getName(),
+                             "MeshSerializerImpl::readVertexBuffer" );
+            }
+            subLod->vertexBuffers[source] = mInPlaceStream->getCurrentPtr();
+            mInPlaceStream->skip( static_cast<long>( sizeBytes ) );
+            return;
+        }
+
         uint8 *vertexData = reinterpret_cast<uint8*>( OGRE_MALLOC_SIMD(
-                                sizeof(uint8) * bytesPerVertex * subLod->numVertices,
-                                MEMCATEGORY_GEOMETRY ) );
+                                sizeof(uint8) * sizeBytes, MEMCATEGORY_GEOMETRY ) );
         subLod->vertexBuffers[source] = vertexData;
 
-        stream->read( vertexData, bytesPerVertex * subLod->numVertices );
+        stream->read( vertexData, sizeBytes );
 
         // Endian conversion
         flipLittleEndian( vertexData, subLod->numVertices, bytesPerVertex,
@@ -2232,30 +2296,14 @@ namespace Ogre {
                 createSubMeshVao( sm, submeshLods, i );
                 submeshLods.clear();
             }
+
+            //The GPU buffers got a copy. Unless it's being kept as a shadow copy, we're done.
+            freeSubMeshLodData( totalSubmeshLods, !pMesh->isVertexBufferShadowed(),
+                                !pMesh->isIndexBufferShadowed() );
         }
         catch( Exception &e )
         {
-            SubMeshLodVec::iterator itor = totalSubmeshLods.begin();
-            SubMeshLodVec::iterator end  = totalSubmeshLods.end();
-
-            while( itor != end )
-            {
-                Uint8Vec::iterator it = itor->vertexBuffers.begin();
-                Uint8Vec::iterator en = itor->vertexBuffers.end();
-
-                while( it != en )
-                    OGRE_FREE_SIMD( *it++, MEMCATEGORY_GEOMETRY );
-
-                itor->vertexBuffers.clear();
-
-                if( itor->indexData )
-                {
-                    OGRE_FREE_SIMD( itor->indexData, MEMCATEGORY_GEOMETRY );
-                    itor->indexData = 0;
-                }
-
-                ++itor;
-            }
+            freeSubMeshLodData( totalSubmeshLods, true, true );
 
             //TODO: Delete created mVaos. Don't erase the data from those vaos?
 
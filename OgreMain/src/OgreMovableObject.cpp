@@ -53,6 +53,7 @@ namespace Ogre {
     const uint32 VisibilityFlags::RESERVED_VISIBILITY_FLAGS = ~(LAYER_SHADOW_CASTER|LAYER_VISIBILITY);
     uint32 MovableObject::msDefaultQueryFlags = 0xFFFFFFFF;
     uint32 MovableObject::msDefaultVisibilityFlags = 0xFFFFFFFF & (~LAYER_VISIBILITY);
+    const size_t MovableObject::MAX_FRUSTUMS_PER_BATCH = 8;
     //-----------------------------------------------------------------------
     MovableObject::MovableObject( IdType id, ObjectMemoryManager *objectMemoryManager,
                                   SceneManager *manager, uint8 renderQueueId )
@@ -414,9 +415,55 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    /// Result of testing a whole cluster of packs against the frustum.
+    enum PackClusterVisibility
+    {
+        PACK_CLUSTER_OUTSIDE,
+        PACK_CLUSTER_PARTIAL,
+        PACK_CLUSTER_INSIDE
+    };
+
+    static PackClusterVisibility getPackClusterVisibility( const Aabb &clusterAabb,
+                                                           const Plane *frustumPlanes )
+    {
+        const Vector3 &halfSize = clusterAabb.mHalfSize;
+
+        //Every slot in the cluster was empty
+        if( halfSize.x < 0 )
+            return PACK_CLUSTER_OUTSIDE;
+
+        //Infinite Aabbs must always pass; let the per-object test handle them
+        if( halfSize.x == std::numeric_limits<Real>::infinity() ||
+            halfSize.y == std::numeric_limits<Real>::infinity() ||
+            halfSize.z == std::numeric_limits<Real>::infinity() )
+        {
+            return PACK_CLUSTER_PARTIAL;
+        }
+
+        PackClusterVisibility retVal = PACK_CLUSTER_INSIDE;
+
+        for( size_t i=0; i<6; ++i )
+        {
+            const Plane &plane = frustumPlanes[i];
+
+            //Same as in cullFrustum: distance to the plane from the center
+            //and the "radius" of the box projected onto the plane normal.
+            const Real dist     = plane.normal.dotProduct( clusterAabb.mCenter ) + plane.d;
+            const Real maxDist  = plane.normal.absDotProduct( halfSize );
+
+            if( dist + maxDist <= 0 )
+                return PACK_CLUSTER_OUTSIDE;
+            if( dist - maxDist <= 0 )
+                retVal = PACK_CLUSTER_PARTIAL;
+        }
+
+        return retVal;
+    }
+    //-----------------------------------------------------------------------
     void MovableObject::cullFrustum( const size_t numNodes, ObjectData objData, const Camera *frustum,
                                      uint32 sceneVisibilityFlags, MovableObjectArray &outCulledObjects,
-                                     const Camera *lodCamera )
+                                     const Camera *lodCamera, const Aabb *packClusters,
+                                     size_t firstPackIdx )
     {
         //On threaded environments, the internal variables from outCulledObjects cause
         //a false cache sharing because they're too close to each other. Perfoming
@@ -460,12 +507,39 @@ namespace Ogre {
         
         const ArrayMaskR ignoreRenderingDistance = CastIntToReal(
                     Mathlib::SetAll( lodCamera->getUseRenderingDistance() ? 0 : 0xffffffff ) );
+        const ArrayMaskR allPassMask = CastIntToReal( Mathlib::SetAll( 0xffffffff ) );
+
+        size_t packIdx = firstPackIdx;
+        PackClusterVisibility clusterVisibility = PACK_CLUSTER_PARTIAL;
 
         //TODO: Profile whether we should use XOR to flip the sign or simple multiplication.
         //In theory xor is faster, but some archs have a penalty for switching between integer
         //& floating point, even if it's simd sse
-        for( size_t i=0; i<numNodes; i += ARRAY_PACKED_REALS )
+        for( size_t i=0; i<numNodes; i += ARRAY_PACKED_REALS, ++packIdx )
         {
+            if( packClusters &&
+                (i == 0 || packIdx % ObjectMemoryManager::NUM_PACKS_PER_CLUSTER == 0) )
+            {
+                clusterVisibility = getPackClusterVisibility(
+                            packClusters[packIdx / ObjectMemoryManager::NUM_PACKS_PER_CLUSTER],
+                            frustumPlanes );
+
+                if( clusterVisibility == PACK_CLUSTER_OUTSIDE )
+                {
+                    //Skip the rest of this cluster (or until we're done)
+                    size_t packsToSkip = ObjectMemoryManager::NUM_PACKS_PER_CLUSTER -
+                                         packIdx % ObjectMemoryManager::NUM_PACKS_PER_CLUSTER;
+                    const size_t packsLeft = (numNodes - i + ARRAY_PACKED_REALS - 1) /
+                                             ARRAY_PACKED_REALS;
+                    packsToSkip = std::min( packsToSkip, packsLeft );
+
+                    objData.advanceFrustumPack( packsToSkip );
+                    i       += (packsToSkip - 1) * ARRAY_PACKED_REALS;
+                    packIdx += packsToSkip - 1;
+                    continue;
+                }
+            }
+
             ArrayInt * RESTRICT_ALIAS visibilityFlags = reinterpret_cast<ArrayInt*RESTRICT_ALIAS>
                                                                         (objData.mVisibilityFlags);
             ArrayReal * RESTRICT_ALIAS worldRadius = reinterpret_cast<ArrayReal*RESTRICT_ALIAS>
@@ -475,39 +549,44 @@ namespace Ogre {
             ArrayReal * RESTRICT_ALIAS distanceToCamera = reinterpret_cast<ArrayReal*RESTRICT_ALIAS>
                                                                         (objData.mDistanceToCamera);
 
+            ArrayMaskR mask = allPassMask;
+
             //Test all 6 planes and AND the dot product. If one is false, then we're not visible
-            ArrayReal dotResult;
-            ArrayMaskR mask;
-            ArrayVector3 centerPlusFlippedHS;
-            centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
-                                                                 planes[0].signFlip;
-            dotResult = planes[0].planeNormal.dotProduct( centerPlusFlippedHS );
-            mask = Mathlib::CompareGreater( dotResult, planes[0].planeNegD );
-
-            centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
-                                                                 planes[1].signFlip;
-            dotResult = planes[1].planeNormal.dotProduct( centerPlusFlippedHS );
-            mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult, planes[1].planeNegD ) );
-
-            centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
-                                                                 planes[2].signFlip;
-            dotResult = planes[2].planeNormal.dotProduct( centerPlusFlippedHS );
-            mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult, planes[2].planeNegD ) );
-
-            centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
-                                                                 planes[3].signFlip;
-            dotResult = planes[3].planeNormal.dotProduct( centerPlusFlippedHS );
-            mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult, planes[3].planeNegD ) );
-
-            centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
-                                                                 planes[4].signFlip;
-            dotResult = planes[4].planeNormal.dotProduct( centerPlusFlippedHS );
-            mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult, planes[4].planeNegD ) );
-
-            centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
-                                                                 planes[5].signFlip;
-            dotResult = planes[5].planeNormal.dotProduct( centerPlusFlippedHS );
-            mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult, planes[5].planeNegD ) );
+            //(unless the whole cluster is known to be fully inside the frustum)
+            if( clusterVisibility != PACK_CLUSTER_INSIDE )
+            {
+                ArrayReal dotResult;
+                ArrayVector3 centerPlusFlippedHS;
+                centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
+                                                                     planes[0].signFlip;
+                dotResult = planes[0].planeNormal.dotProduct( centerPlusFlippedHS );
+                mask = Mathlib::CompareGreater( dotResult, planes[0].planeNegD );
+
+                centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
+                                                                     planes[1].signFlip;
+                dotResult = planes[1].planeNormal.dotProduct( centerPlusFlippedHS );
+                mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult, planes[1].planeNegD ) );
+
+                centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
+                                                                     planes[2].signFlip;
+                dotResult = planes[2].planeNormal.dotProduct( centerPlusFlippedHS );
+                mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult, planes[2].planeNegD ) );
+
+                centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
+                                                                     planes[3].signFlip;
+                dotResult = planes[3].planeNormal.dotProduct( centerPlusFlippedHS );
+                mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult, planes[3].planeNegD ) );
+
+                centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
+                                                                     planes[4].signFlip;
+                dotResult = planes[4].planeNormal.dotProduct( centerPlusFlippedHS );
+                mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult, planes[4].planeNegD ) );
+
+                centerPlusFlippedHS = objData.mWorldAabb->mCenter + objData.mWorldAabb->mHalfSize *
+                                                                     planes[5].signFlip;
+                dotResult = planes[5].planeNormal.dotProduct( centerPlusFlippedHS );
+                mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult, planes[5].planeNegD ) );
+            }
 
             //Always pass the test if any of the components were
             //Infinity (dot product above could've caused nans)
@@ -557,6 +636,174 @@ namespace Ogre {
         culledObjects.swap( outCulledObjects );
     }
     //-----------------------------------------------------------------------
+    void MovableObject::cullFrustumBatch( const size_t numNodes, ObjectData objData,
+                                          const Camera * const *frustums,
+                                          const Camera * const *lodCameras,
+                                          const uint32 *sceneVisibilityFlags, size_t numFrustums,
+                                          MovableObjectArray * const *outCulledObjects,
+                                          const Aabb *packClusters, size_t firstPackIdx )
+    {
+        assert( numFrustums <= MAX_FRUSTUMS_PER_BATCH );
+
+        //Same math as in cullFrustum. The difference is that we load each pack once
+        //and test it against all frustums while it's still hot in the cache.
+        struct ArrayPlane
+        {
+            ArrayVector3    planeNormal;
+            ArrayVector3    signFlip;
+            ArrayReal       planeNegD;
+        };
+
+        struct FrustumData
+        {
+            ArrayPlane      planes[6];
+            ArrayVector3    lodCameraPos;
+            ArrayInt        includeNonCasters;
+            ArrayInt        sceneFlags;
+            ArrayMaskR      ignoreRenderingDistance;
+            Plane const     *frustumPlanes;
+            PackClusterVisibility clusterVisibility;
+        };
+
+        FrustumData frustumData[MAX_FRUSTUMS_PER_BATCH];
+
+        for( size_t i=0; i<numFrustums; ++i )
+        {
+            FrustumData &fd = frustumData[i];
+
+            uint32 visibilityFlags = sceneVisibilityFlags[i];
+            // Flip the bit from shadow caster, and leave only that in "includeNonCasters"
+            fd.includeNonCasters = Mathlib::SetAll( ((visibilityFlags & LAYER_SHADOW_CASTER) ^ -1)
+                                                    & LAYER_SHADOW_CASTER );
+            visibilityFlags &= RESERVED_VISIBILITY_FLAGS;
+            fd.sceneFlags = Mathlib::SetAll( visibilityFlags );
+
+            fd.lodCameraPos.setAll( lodCameras[i]->_getCachedDerivedPosition() );
+            fd.ignoreRenderingDistance = CastIntToReal(
+                    Mathlib::SetAll( lodCameras[i]->getUseRenderingDistance() ? 0 : 0xffffffff ) );
+
+            fd.frustumPlanes = frustums[i]->_getCachedFrustumPlanes();
+            for( size_t j=0; j<6; ++j )
+            {
+                fd.planes[j].planeNormal.setAll( fd.frustumPlanes[j].normal );
+                fd.planes[j].signFlip.setAll( fd.frustumPlanes[j].normal );
+                fd.planes[j].signFlip.setToSign();
+                fd.planes[j].planeNegD = Mathlib::SetAll( -fd.frustumPlanes[j].d );
+            }
+
+            fd.clusterVisibility = PACK_CLUSTER_PARTIAL;
+        }
+
+        const ArrayMaskR allPassMask = CastIntToReal( Mathlib::SetAll( 0xffffffff ) );
+
+        size_t packIdx = firstPackIdx;
+
+        for( size_t i=0; i<numNodes; i += ARRAY_PACKED_REALS, ++packIdx )
+        {
+            if( packClusters &&
+                (i == 0 || packIdx % ObjectMemoryManager::NUM_PACKS_PER_CLUSTER == 0) )
+            {
+                const Aabb &clusterAabb = packClusters[packIdx /
+                                                       ObjectMemoryManager::NUM_PACKS_PER_CLUSTER];
+                bool allOutside = true;
+                for( size_t j=0; j<numFrustums; ++j )
+                {
+                    frustumData[j].clusterVisibility =
+                            getPackClusterVisibility( clusterAabb, frustumData[j].frustumPlanes );
+                    allOutside &= frustumData[j].clusterVisibility == PACK_CLUSTER_OUTSIDE;
+                }
+
+                if( allOutside )
+                {
+                    //Skip the rest of this cluster (or until we're done)
+                    size_t packsToSkip = ObjectMemoryManager::NUM_PACKS_PER_CLUSTER -
+                                         packIdx % ObjectMemoryManager::NUM_PACKS_PER_CLUSTER;
+                    const size_t packsLeft = (numNodes - i + ARRAY_PACKED_REALS - 1) /
+                                             ARRAY_PACKED_REALS;
+                    packsToSkip = std::min( packsToSkip, packsLeft );
+
+                    objData.advanceFrustumPack( packsToSkip );
+                    i       += (packsToSkip - 1) * ARRAY_PACKED_REALS;
+                    packIdx += packsToSkip - 1;
+                    continue;
+                }
+            }
+
+            const ArrayInt visibilityFlags = *reinterpret_cast<ArrayInt*RESTRICT_ALIAS>
+                                                                        (objData.mVisibilityFlags);
+            const ArrayReal worldRadius = *reinterpret_cast<ArrayReal*RESTRICT_ALIAS>
+                                                                        (objData.mWorldRadius);
+            const ArrayReal upperDistance = *reinterpret_cast<ArrayReal*RESTRICT_ALIAS>
+                                                                        (objData.mUpperDistance);
+            const ArrayVector3 center   = objData.mWorldAabb->mCenter;
+            const ArrayVector3 halfSize = objData.mWorldAabb->mHalfSize;
+
+            //Always pass the test if any of the components were
+            //Infinity (dot product could've caused nans)
+            const ArrayMaskR isInfinite = Mathlib::Or(
+                            Mathlib::Or( Mathlib::isInfinity( halfSize.mChunkBase[0] ),
+                                         Mathlib::isInfinity( halfSize.mChunkBase[1] ) ),
+                            Mathlib::isInfinity( halfSize.mChunkBase[2] ) );
+
+            const ArrayMaskI isVisibleLayer = Mathlib::TestFlags4( visibilityFlags,
+                                                        Mathlib::SetAll( LAYER_VISIBILITY ) );
+
+            for( size_t j=0; j<numFrustums; ++j )
+            {
+                const FrustumData &fd = frustumData[j];
+
+                if( fd.clusterVisibility == PACK_CLUSTER_OUTSIDE )
+                    continue;
+
+                ArrayMaskR mask = allPassMask;
+
+                if( fd.clusterVisibility != PACK_CLUSTER_INSIDE )
+                {
+                    for( size_t k=0; k<6; ++k )
+                    {
+                        const ArrayVector3 centerPlusFlippedHS = center + halfSize *
+                                                                 fd.planes[k].signFlip;
+                        const ArrayReal dotResult = fd.planes[k].planeNormal.dotProduct(
+                                                                        centerPlusFlippedHS );
+                        mask = Mathlib::And( mask, Mathlib::CompareGreater( dotResult,
+                                                                          fd.planes[k].planeNegD ) );
+                    }
+                }
+
+                ArrayReal distance = fd.lodCameraPos.distance( center );
+                ArrayMaskR isCloseEnough = Mathlib::CompareLessEqual( distance,
+                                                                      worldRadius + upperDistance );
+                isCloseEnough = Mathlib::Or( fd.ignoreRenderingDistance, isCloseEnough );
+
+                mask = Mathlib::And( Mathlib::Or( mask, isInfinite ), isCloseEnough );
+
+                //isVisible = isVisible() && (isCaster || includeNonCasters)
+                ArrayMaskI isVisible = Mathlib::And( isVisibleLayer,
+                                Mathlib::TestFlags4( Mathlib::Or( visibilityFlags, fd.includeNonCasters ),
+                                                     Mathlib::SetAll( LAYER_SHADOW_CASTER ) ) );
+
+                ArrayMaskI finalMask = Mathlib::TestFlags4( CastRealToInt( mask ),
+                                                            Mathlib::And( fd.sceneFlags,
+                                                                          visibilityFlags ) );
+                finalMask               = Mathlib::And( finalMask, isVisible );
+
+                const uint32 scalarMask = BooleanMask4::getScalarMask( finalMask );
+
+                if( scalarMask )
+                {
+                    MovableObjectArray &culledObjects = *outCulledObjects[j];
+                    for( size_t k=0; k<ARRAY_PACKED_REALS; ++k )
+                    {
+                        if( IS_BIT_SET( k, scalarMask ) )
+                            culledObjects.push_back( objData.mOwner[k] );
+                    }
+                }
+            }
+
+            objData.advanceFrustumPack();
+        }
+    }
+    //-----------------------------------------------------------------------
     void MovableObject::cullLights( const size_t numNodes, ObjectData objData,
                                     LightListInfo &outGlobalLightList, const FrustumVec &frustums,
                                     const FrustumVec &cubemapFrustums )
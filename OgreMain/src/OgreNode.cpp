@@ -35,9 +35,10 @@ THE SOFTWARE.
 #include "Math/Array/OgreBooleanMask.h"
 
 #ifndef NDEBUG
-    #define CACHED_TRANSFORM_OUT_OF_DATE() this->_setCachedTransformOutOfDate()
+    #define CACHED_TRANSFORM_OUT_OF_DATE() this->_setCachedTransformOutOfDate(), \
+                                           this->_setTransformDirty()
 #else
-    #define CACHED_TRANSFORM_OUT_OF_DATE() ((void)0)
+    #define CACHED_TRANSFORM_OUT_OF_DATE() this->_setTransformDirty()
 #endif
 
 namespace Ogre {
@@ -350,11 +351,32 @@ namespace Ogre {
 #endif
     }
     //-----------------------------------------------------------------------
-    void Node::updateAllTransforms( const size_t numNodes, Transform t )
+    size_t Node::updateAllTransforms( const size_t numNodes, Transform t )
     {
+        size_t numUpdated = 0;
+
         ArrayMatrix4 derivedTransform;
         for( size_t i=0; i<numNodes; i += ARRAY_PACKED_REALS )
         {
+            //A node must be updated if it changed or its parent was updated. Propagate the
+            //parent's flag so our own children know it too. Parents are in the previous
+            //depth level which is already done, so there's no race.
+            bool anyDirty = false;
+            for( size_t j=0; j<ARRAY_PACKED_REALS; ++j )
+            {
+                const Transform &parentTransform = t.mParents[j]->mTransform;
+                t.mDirty[j] |= parentTransform.mDirty[parentTransform.mIndex];
+                anyDirty    |= t.mDirty[j];
+            }
+
+            if( !anyDirty )
+            {
+                t.advancePack();
+                continue;
+            }
+
+            numUpdated += std::min<size_t>( ARRAY_PACKED_REALS, numNodes - i );
+
             //Retrieve from parents. Unfortunately we need to do SoA -> AoS -> SoA conversion
             ArrayVector3 parentPos, parentScale;
             ArrayQuaternion parentRot;
@@ -403,6 +425,8 @@ namespace Ogre {
 
             t.advancePack();
         }
+
+        return numUpdated;
     }
     //-----------------------------------------------------------------------
     Node* Node::createChild( SceneMemoryMgrTypes sceneType,
@@ -495,6 +519,7 @@ namespace Ogre {
     void Node::resetOrientation(void)
     {
         mTransform.mOrientation->setFromQuaternion( Quaternion::IDENTITY, mTransform.mIndex );
+        CACHED_TRANSFORM_OUT_OF_DATE();
     }
 
     //-----------------------------------------------------------------------
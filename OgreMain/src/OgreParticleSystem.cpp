@@ -61,6 +61,7 @@ namespace Ogre {
 
     Real ParticleSystem::msDefaultIterationInterval = 0;
     Real ParticleSystem::msDefaultNonvisibleTimeout = 0;
+    bool ParticleSystem::msDefaultThreadedUpdate = false;
 
     //-----------------------------------------------------------------------
     // Local class for updating based on time
@@ -73,7 +74,7 @@ namespace Ogre {
 
         Real getValue(void) const { return 0; } // N/A
 
-        void setValue(Real value) { mTarget->_update(value); }
+        void setValue(Real value) { mTarget->_queueUpdate(value); }
 
     };
     //-----------------------------------------------------------------------
@@ -97,6 +98,9 @@ namespace Ogre {
         mTimeController(0),
         mEmittedEmitterPoolInitialised(false),
         mIsEmitting(true),
+        mQueuedUpdateTime(0),
+        mUpdateQueued(false),
+        mExecutingQueuedUpdate(false),
         mRenderer(0), 
         mCullIndividual(false),
         mPoolSize(0),
@@ -120,6 +124,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ParticleSystem::~ParticleSystem()
     {
+        if (mUpdateQueued)
+        {
+            mManager->_removeQueuedParticleSystemUpdate(this);
+            mUpdateQueued = false;
+        }
+
         if (mTimeController)
         {
             // Destroy controller
@@ -136,9 +146,9 @@ namespace Ogre {
         destroyVisualParticles(0, mParticlePool.size());
         // Free pool items
         ParticlePool::iterator i;
-        for (i = mParticlePool.begin(); i != mParticlePool.end(); ++i)
+        for (i = mParticlePoolBlocks.begin(); i != mParticlePoolBlocks.end(); ++i)
         {
-            OGRE_DELETE *i;
+            OGRE_DELETE [] *i;
         }
 
         if (mRenderer)
@@ -414,17 +424,56 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ParticleSystem::_queueUpdate(Real timeElapsed)
+    {
+        if (!msDefaultThreadedUpdate || !mManager)
+        {
+            _update(timeElapsed);
+            return;
+        }
+
+        if (!mUpdateQueued)
+        {
+            mManager->_queueParticleSystemUpdate(this);
+            mUpdateQueued = true;
+            mQueuedUpdateTime = 0;
+        }
+
+        mQueuedUpdateTime += timeElapsed;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_prepareQueuedUpdate(void)
+    {
+        if (!mParentNode)
+            return;
+
+        // These may create buffers and clone emitters through
+        // ParticleSystemManager, which isn't thread safe.
+        configureRenderer();
+        initialiseEmittedEmitters();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_executeQueuedUpdate(void)
+    {
+        const Real timeElapsed = mQueuedUpdateTime;
+        mQueuedUpdateTime = 0;
+        mUpdateQueued = false;
+
+        // Derived transforms are read instead of recomputed while this is set
+        mExecutingQueuedUpdate = true;
+        _update(timeElapsed);
+        mExecutingQueuedUpdate = false;
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystem::_expire(Real timeElapsed)
     {
-        ActiveParticleList::iterator i, itEnd;
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
 
-        itEnd = mActiveParticles.end();
-
-        for (i = mActiveParticles.begin(); i != itEnd; )
+        size_t i = 0;
+        while (i < mActiveParticles.size())
         {
-            pParticle = static_cast<Particle*>(*i);
+            pParticle = mActiveParticles[i];
             if (pParticle->mTimeToLive < timeElapsed)
             {
                 // Notify renderer
@@ -434,21 +483,23 @@ namespace Ogre {
                 if (pParticle->mParticleType == Particle::Visual)
                 {
                     // Destroy this one
-                    mFreeParticles.splice(mFreeParticles.end(), mActiveParticles, i++);
+                    mFreeParticles.push_back(pParticle);
                 }
                 else
                 {
                     // For now, it can only be an emitted emitter
-                    pParticleEmitter = static_cast<ParticleEmitter*>(*i);
+                    pParticleEmitter = static_cast<ParticleEmitter*>(pParticle);
                     list<ParticleEmitter*>::type* fee = findFreeEmittedEmitter(pParticleEmitter->getName());
                     fee->push_back(pParticleEmitter);
 
                     // Also erase from mActiveEmittedEmitters
                     removeFromActiveEmittedEmitters (pParticleEmitter);
-
-                    // And erase from mActiveParticles
-                    i = mActiveParticles.erase( i );
                 }
+
+                // Swap-remove from mActiveParticles. Don't advance; the
+                // particle moved into this slot hasn't been processed yet.
+                mActiveParticles[i] = mActiveParticles.back();
+                mActiveParticles.pop_back();
             }
             else
             {
@@ -456,15 +507,14 @@ namespace Ogre {
                 pParticle->mTimeToLive -= timeElapsed;
                 ++i;
             }
-
         }
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_triggerEmitters(Real timeElapsed)
     {
         // Add up requests for emission
-        static vector<unsigned>::type requested;
-        static vector<unsigned>::type emittedRequested;
+        vector<unsigned>::type &requested = mEmissionRequested;
+        vector<unsigned>::type &emittedRequested = mEmittedEmissionRequested;
 
         if( requested.size() != mEmitters.size() )
             requested.resize( mEmitters.size() );
@@ -545,9 +595,12 @@ namespace Ogre {
 
         Real timeInc = timeElapsed / requested;
 
-        //TODO: (dark_sylinc) Refactor this. ControllerManager gets executed before us
-        //(because it doesn't know if we'll update a SceneNode)
-        const Quaternion derivedOrientation( mParentNode->_getDerivedOrientationUpdated() );
+        //Queued updates run after SceneManager::updateAllTransforms, so the derived
+        //transform is current (and recomputing it from a worker thread would race).
+        //Direct calls to _update happen before (ControllerManager gets executed first).
+        const Quaternion derivedOrientation( mExecutingQueuedUpdate ?
+                                                 mParentNode->_getDerivedOrientation() :
+                                                 mParentNode->_getDerivedOrientationUpdated() );
         const Vector3 derivedPosition( mParentNode->_getDerivedPosition() );
         const Vector3 derivedScale( mParentNode->_getDerivedScale() );
 
@@ -647,10 +700,14 @@ namespace Ogre {
         mParticlePool.reserve(size);
         mParticlePool.resize(size);
 
-        // Create new particles
-        for( size_t i = oldSize; i < size; i++ )
+        // Create new particles in a single contiguous block
+        if( size > oldSize )
         {
-            mParticlePool[i] = OGRE_NEW Particle();
+            Particle *block = OGRE_NEW Particle[size - oldSize];
+            mParticlePoolBlocks.push_back( block );
+
+            for( size_t i = oldSize; i < size; i++ )
+                mParticlePool[i] = block + (i - oldSize);
         }
 
         if (mIsRendererConfigured)
@@ -669,9 +726,7 @@ namespace Ogre {
     Particle* ParticleSystem::getParticle(size_t index) 
     {
         assert (index < mActiveParticles.size() && "Index out of bounds!");
-        ActiveParticleList::iterator i = mActiveParticles.begin();
-        std::advance(i, index);
-        return *i;
+        return mActiveParticles[index];
     }
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::createParticle(void)
@@ -680,8 +735,9 @@ namespace Ogre {
         if (!mFreeParticles.empty())
         {
             // Fast creation (don't use superclass since emitter will init)
-            p = mFreeParticles.front();
-            mActiveParticles.splice(mActiveParticles.end(), mFreeParticles, mFreeParticles.begin());
+            p = mFreeParticles.back();
+            mFreeParticles.pop_back();
+            mActiveParticles.push_back(p);
 
             p->_notifyOwner(this);
         }
@@ -844,7 +900,9 @@ namespace Ogre {
                 // node transform, so reverse transform back since we're expected to 
                 // provide a local AABB
                 //TODO: (dark_sylinc) refactor the "Updated" part
-                aabb.transformAffine( mParentNode->_getFullTransformUpdated().inverseAffine() );
+                aabb.transformAffine( (mExecutingQueuedUpdate ? mParentNode->_getFullTransform() :
+                                                       mParentNode->_getFullTransformUpdated()).
+                                      inverseAffine() );
             }
 
             mObjectData.mLocalAabb->setFromAabb( aabb, mObjectData.mIndex );
@@ -993,8 +1051,16 @@ namespace Ogre {
             mRenderer->_notifyParticleCleared(mActiveParticles);
         }
 
-        // Move actives to free list
-        mFreeParticles.splice(mFreeParticles.end(), mActiveParticles);
+        // Move actives to free list (emitted emitters go back to their own free lists)
+        ActiveParticleList::const_iterator itor = mActiveParticles.begin();
+        ActiveParticleList::const_iterator end  = mActiveParticles.end();
+        while( itor != end )
+        {
+            if( (*itor)->mParticleType == Particle::Visual )
+                mFreeParticles.push_back( *itor );
+            ++itor;
+        }
+        mActiveParticles.clear();
 
         // Add active emitted emitters to free list
         addActiveEmittedEmittersToFreeList();
@@ -1032,11 +1098,10 @@ namespace Ogre {
         {
             this->increasePool(size);
 
-            for( size_t i = currSize; i < size; ++i )
-            {
-                // Add new items to the queue
-                mFreeParticles.push_back( mParticlePool[i] );
-            }
+            // Add new items to the stack, in reverse so that
+            // they get handed out in memory order
+            for( size_t i = size; i > currSize; --i )
+                mFreeParticles.push_back( mParticlePool[i - 1] );
 
             // Tell the renderer, if already configured
             if (mRenderer && mIsRendererConfigured)
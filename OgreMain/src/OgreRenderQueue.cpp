@@ -40,6 +40,7 @@ THE SOFTWARE.
 #include "OgreHlmsDatablock.h"
 #include "OgreHlmsManager.h"
 #include "OgreHlms.h"
+#include "OgreTimelineProfiler.h"
 
 #include "Vao/OgreVaoManager.h"
 #include "Vao/OgreVertexArrayObject.h"
@@ -172,11 +173,13 @@ namespace Ogre
             while( itor != end )
             {
                 itor->q.clear();
+                itor->sorted = false;
                 ++itor;
             }
 
             mRenderQueues[i].mQueuedRenderables.clear();
             mRenderQueues[i].mSorted = false;
+            mRenderQueues[i].mCurrentDrawCache = 0;
         }
     }
     //-----------------------------------------------------------------------
@@ -189,6 +192,16 @@ namespace Ogre
         mLastTextureHash= 0;
     }
     //-----------------------------------------------------------------------
+    void RenderQueue::_cameraDestroyed( const Camera *camera )
+    {
+        for( size_t i=0; i<sizeof( mRenderQueues ) / sizeof( mRenderQueues[0] ); ++i )
+        {
+            mRenderQueues[i].mPrevFrameSortOrder.erase( camera );
+            mRenderQueues[i].mDrawCache.erase( camera );
+            mRenderQueues[i].mCurrentDrawCache = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
     void RenderQueue::addRenderableV1( uint8 renderQueueId, bool casterPass, Renderable* pRend,
                                        const MovableObject *pMovableObject )
     {
@@ -287,13 +300,354 @@ namespace Ogre
 
         #undef OGRE_RQ_HASH
 
-        mRenderQueues[rqId].mQueuedRenderablesPerThread[threadIdx].q.push_back(
-                    QueuedRenderable( hash, pRend, pMovableObject ) );
+        ThreadRenderQueue &threadQueue = mRenderQueues[rqId].mQueuedRenderablesPerThread[threadIdx];
+        threadQueue.q.push_back( QueuedRenderable( hash, pRend, pMovableObject ) );
+        threadQueue.sorted = false;
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::_sortThreadQueues( size_t threadIdx, uint8 firstRq, uint8 lastRq )
+    {
+        for( size_t i=firstRq; i<lastRq; ++i )
+        {
+            RenderQueueGroup &renderQueueGroup = mRenderQueues[i];
+            if( renderQueueGroup.mDoSort && !renderQueueGroup.mTemporalCoherence )
+            {
+                ThreadRenderQueue &threadQueue =
+                        renderQueueGroup.mQueuedRenderablesPerThread[threadIdx];
+                if( !threadQueue.sorted )
+                {
+                    std::sort( threadQueue.q.begin(), threadQueue.q.end() );
+                    threadQueue.sorted = true;
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::mergeSortedThreadQueues( RenderQueueGroup &renderQueueGroup )
+    {
+        QueuedRenderableArray &queuedRenderables = renderQueueGroup.mQueuedRenderables;
+        QueuedRenderableArrayPerThread &perThreadQueue = renderQueueGroup.mQueuedRenderablesPerThread;
+
+        mMergeCursors.clear();
+
+        size_t numRenderables = 0;
+        QueuedRenderableArrayPerThread::iterator itor = perThreadQueue.begin();
+        QueuedRenderableArrayPerThread::iterator end  = perThreadQueue.end();
+
+        while( itor != end )
+        {
+            if( !itor->q.empty() )
+            {
+                //V1 objects are added from the main thread after the worker
+                //threads have finished, thus thread 0 may still be unsorted.
+                if( !itor->sorted )
+                {
+                    std::sort( itor->q.begin(), itor->q.end() );
+                    itor->sorted = true;
+                }
+
+                ThreadQueueCursor cursor;
+                cursor.itor = itor->q.begin();
+                cursor.end  = itor->q.end();
+                mMergeCursors.push_back( cursor );
+                numRenderables += itor->q.size();
+            }
+            ++itor;
+        }
+
+        queuedRenderables.reserve( numRenderables );
+
+        if( mMergeCursors.size() == 1u )
+        {
+            queuedRenderables.appendPOD( mMergeCursors[0].itor, mMergeCursors[0].end );
+            return;
+        }
+
+        std::make_heap( mMergeCursors.begin(), mMergeCursors.end() );
+
+        while( !mMergeCursors.empty() )
+        {
+            //Move the cursor with the smallest hash to the back. If there are other cursors
+            //left, copy everything that is still smaller than the next smallest one in one go.
+            std::pop_heap( mMergeCursors.begin(), mMergeCursors.end() );
+            ThreadQueueCursor &cursor = mMergeCursors.back();
+
+            QueuedRenderable const *runEnd = cursor.itor + 1;
+            if( mMergeCursors.size() > 1u )
+            {
+                const uint64 nextHash = mMergeCursors.front().itor->hash;
+                while( runEnd != cursor.end && runEnd->hash <= nextHash )
+                    ++runEnd;
+            }
+            else
+            {
+                runEnd = cursor.end;
+            }
+
+            queuedRenderables.appendPOD( cursor.itor, runEnd );
+            cursor.itor = runEnd;
+
+            if( cursor.itor != cursor.end )
+                std::push_heap( mMergeCursors.begin(), mMergeCursors.end() );
+            else
+                mMergeCursors.pop_back();
+        }
+    }
+    //-----------------------------------------------------------------------
+    /// Performs an insertion sort. Gives up half way through if it's
+    /// taking too long, leaving the array partially sorted.
+    /// @return True if the array ended up fully sorted.
+    template <typename T>
+    static bool insertionSortBounded( T *begin, T *end, size_t maxMoves )
+    {
+        size_t numMoves = 0;
+
+        for( T *itor = begin + 1; itor < end; ++itor )
+        {
+            if( *itor < *(itor - 1) )
+            {
+                T value = *itor;
+                T *hole = itor;
+
+                do
+                {
+                    *hole = *(hole - 1);
+                    --hole;
+                    ++numMoves;
+                }
+                while( hole != begin && value < *(hole - 1) );
+
+                *hole = value;
+
+                if( numMoves > maxMoves )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::sortWithTemporalCoherence( RenderQueueGroup &renderQueueGroup )
+    {
+        QueuedRenderableArray &queuedRenderables = renderQueueGroup.mQueuedRenderables;
+        QueuedRenderableArrayPerThread &perThreadQueue = renderQueueGroup.mQueuedRenderablesPerThread;
+
+        mTmpQueuedRenderables.clear();
+
+        QueuedRenderableArrayPerThread::const_iterator itor = perThreadQueue.begin();
+        QueuedRenderableArrayPerThread::const_iterator end  = perThreadQueue.end();
+
+        while( itor != end )
+        {
+            mTmpQueuedRenderables.appendPOD( itor->q.begin(), itor->q.end() );
+            ++itor;
+        }
+
+        const size_t numRenderables = mTmpQueuedRenderables.size();
+
+        SortOrderArray &sortOrder =
+                renderQueueGroup.mPrevFrameSortOrder[mSceneManager->getCameraInProgress()];
+
+        //If it grew since last frame, append the new ones at the end and
+        //let the insertion sort move them. If it shrank, the old indices are
+        //useless; start from scratch.
+        bool needsFullSort = false;
+        if( sortOrder.size() > numRenderables )
+        {
+            sortOrder.clear();
+            needsFullSort = true;
+        }
+
+        sortOrder.reserve( numRenderables );
+        for( size_t i=sortOrder.size(); i<numRenderables; ++i )
+            sortOrder.push_back( static_cast<uint32>( i ) );
+
+        mIndexedSortKeys.resize( numRenderables );
+        for( size_t i=0; i<numRenderables; ++i )
+        {
+            mIndexedSortKeys[i].hash = mTmpQueuedRenderables[sortOrder[i]].hash;
+            mIndexedSortKeys[i].idx  = sortOrder[i];
+        }
+
+        if( !needsFullSort )
+        {
+            //If the scene changed a lot (i.e. camera cut) fall back to a regular sort.
+            needsFullSort = !insertionSortBounded( mIndexedSortKeys.begin(), mIndexedSortKeys.end(),
+                                                   numRenderables * 8u );
+        }
+
+        if( needsFullSort )
+            std::sort( mIndexedSortKeys.begin(), mIndexedSortKeys.end() );
+
+        queuedRenderables.resize( numRenderables );
+        for( size_t i=0; i<numRenderables; ++i )
+        {
+            sortOrder[i] = mIndexedSortKeys[i].idx;
+            queuedRenderables[i] = mTmpQueuedRenderables[mIndexedSortKeys[i].idx];
+        }
+    }
+    //-----------------------------------------------------------------------
+    /// Total order used to compare the draw caches. Unlike QueuedRenderable::operator <,
+    /// it doesn't leave ties.
+    static bool QueuedRenderableCanonicalLess( const QueuedRenderable &_l,
+                                               const QueuedRenderable &_r )
+    {
+        if( _l.hash != _r.hash )
+            return _l.hash < _r.hash;
+        if( _l.renderable != _r.renderable )
+            return std::less<const Renderable*>()( _l.renderable, _r.renderable );
+        return std::less<const MovableObject*>()( _l.movableObject, _r.movableObject );
+    }
+    //-----------------------------------------------------------------------
+    static bool QueuedRenderableEqual( const QueuedRenderable &_l, const QueuedRenderable &_r )
+    {
+        return _l.hash == _r.hash && _l.renderable == _r.renderable &&
+               _l.movableObject == _r.movableObject;
+    }
+    //-----------------------------------------------------------------------
+    RenderQueue::DrawCache& RenderQueue::findDrawCache( RenderQueueGroup &renderQueueGroup )
+    {
+        DrawCache &drawCache = renderQueueGroup.mDrawCache[mSceneManager->getCameraInProgress()];
+        const QueuedRenderableArrayPerThread &perThreadQueue =
+                renderQueueGroup.mQueuedRenderablesPerThread;
+
+        size_t numRenderables = 0;
+        QueuedRenderableArrayPerThread::const_iterator itor = perThreadQueue.begin();
+        QueuedRenderableArrayPerThread::const_iterator end  = perThreadQueue.end();
+
+        while( itor != end )
+        {
+            numRenderables += itor->q.size();
+            ++itor;
+        }
+
+        //Threads grab the cull chunks on demand, thus the same Renderables can be
+        //split differently between them every frame. Compare them in a fixed order.
+        mTmpQueuedRenderables.clear();
+        mTmpQueuedRenderables.reserve( numRenderables );
+
+        itor = perThreadQueue.begin();
+        while( itor != end )
+        {
+            mTmpQueuedRenderables.appendPOD( itor->q.begin(), itor->q.end() );
+            ++itor;
+        }
+
+        std::sort( mTmpQueuedRenderables.begin(), mTmpQueuedRenderables.end(),
+                   QueuedRenderableCanonicalLess );
+
+        const bool sameRenderables =
+                numRenderables == drawCache.canonicalRenderables.size() &&
+                std::equal( mTmpQueuedRenderables.begin(), mTmpQueuedRenderables.end(),
+                            drawCache.canonicalRenderables.begin(), QueuedRenderableEqual );
+
+        drawCache.hit = sameRenderables;
+
+        if( sameRenderables )
+        {
+            renderQueueGroup.mQueuedRenderables.clear();
+            renderQueueGroup.mQueuedRenderables.appendPOD( drawCache.sortedRenderables.begin(),
+                                                           drawCache.sortedRenderables.end() );
+            renderQueueGroup.mSorted = true;
+        }
+        else
+        {
+            drawCache.canonicalRenderables.swap( mTmpQueuedRenderables );
+
+            if( renderQueueGroup.mDoSort && !renderQueueGroup.mTemporalCoherence )
+            {
+                //It's sorted by hash already; no need to merge the threads' queues.
+                renderQueueGroup.mQueuedRenderables.clear();
+                renderQueueGroup.mQueuedRenderables.appendPOD(
+                            drawCache.canonicalRenderables.begin(),
+                            drawCache.canonicalRenderables.end() );
+                renderQueueGroup.mSorted = true;
+            }
+        }
+
+        return drawCache;
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::updateDrawCache( DrawCache &drawCache, const RenderQueueGroup &renderQueueGroup )
+    {
+        drawCache.sortedRenderables.clear();
+        drawCache.sortedRenderables.appendPOD( renderQueueGroup.mQueuedRenderables.begin(),
+                                               renderQueueGroup.mQueuedRenderables.end() );
+        //Forces renderGL3 to resolve everything again.
+        drawCache.draws.clear();
+    }
+    //-----------------------------------------------------------------------
+    RenderQueue::DrawCache* RenderQueue::sortRenderQueue( RenderQueueGroup &renderQueueGroup )
+    {
+        QueuedRenderableArray &queuedRenderables = renderQueueGroup.mQueuedRenderables;
+        QueuedRenderableArrayPerThread &perThreadQueue = renderQueueGroup.mQueuedRenderablesPerThread;
+
+        DrawCache *drawCache = 0;
+
+        if( !renderQueueGroup.mSorted && renderQueueGroup.mDrawCaching &&
+            renderQueueGroup.mMode == FAST )
+        {
+            //May mark the queue as sorted.
+            drawCache = &findDrawCache( renderQueueGroup );
+            renderQueueGroup.mCurrentDrawCache = drawCache;
+        }
+
+        if( !renderQueueGroup.mSorted )
+        {
+            if( !renderQueueGroup.mDoSort )
+            {
+                size_t numRenderables = 0;
+                QueuedRenderableArrayPerThread::const_iterator itor = perThreadQueue.begin();
+                QueuedRenderableArrayPerThread::const_iterator end  = perThreadQueue.end();
+
+                while( itor != end )
+                {
+                    numRenderables += itor->q.size();
+                    ++itor;
+                }
+
+                queuedRenderables.reserve( numRenderables );
+
+                itor = perThreadQueue.begin();
+                while( itor != end )
+                {
+                    queuedRenderables.appendPOD( itor->q.begin(), itor->q.end() );
+                    ++itor;
+                }
+            }
+            else
+            {
+                //Exploit temporal coherence across frames then use insertion sorts.
+                //As explained by L. Spiro in
+                //http://www.gamedev.net/topic/661114-temporal-coherence-and-render-queue-sorting/?view=findpost&p=5181408
+                //Otherwise each thread already sorted its own queue (@see _sortThreadQueues)
+                //and we just need to merge them.
+                if( renderQueueGroup.mTemporalCoherence )
+                    sortWithTemporalCoherence( renderQueueGroup );
+                else
+                    mergeSortedThreadQueues( renderQueueGroup );
+
+                renderQueueGroup.mSorted = true;
+            }
+        }
+
+        if( drawCache && !drawCache->hit )
+            updateDrawCache( *drawCache, renderQueueGroup );
+
+        return renderQueueGroup.mCurrentDrawCache;
+    }
+    //-----------------------------------------------------------------------
+    bool RenderQueue::_sortRenderQueue( uint8 rqId )
+    {
+        DrawCache *drawCache = sortRenderQueue( mRenderQueues[rqId] );
+        return drawCache && drawCache->hit;
     }
     //-----------------------------------------------------------------------
     void RenderQueue::render( RenderSystem *rs, uint8 firstRq, uint8 lastRq,
                               bool casterPass, bool dualParaboloid )
     {
+        OgreTimelineScope( "RenderQueue::render", 0 );
+
         if( mLastWasCasterPass != casterPass )
         {
             clearState();
@@ -361,46 +715,7 @@ namespace Ogre
 
         for( size_t i=firstRq; i<lastRq; ++i )
         {
-            QueuedRenderableArray &queuedRenderables = mRenderQueues[i].mQueuedRenderables;
-            QueuedRenderableArrayPerThread &perThreadQueue = mRenderQueues[i].mQueuedRenderablesPerThread;
-
-            if( !mRenderQueues[i].mSorted )
-            {
-                size_t numRenderables = 0;
-                QueuedRenderableArrayPerThread::const_iterator itor = perThreadQueue.begin();
-                QueuedRenderableArrayPerThread::const_iterator end  = perThreadQueue.end();
-
-                while( itor != end )
-                {
-                    numRenderables += itor->q.size();
-                    ++itor;
-                }
-
-                queuedRenderables.reserve( numRenderables );
-
-                itor = perThreadQueue.begin();
-                while( itor != end )
-                {
-                    queuedRenderables.appendPOD( itor->q.begin(), itor->q.end() );
-                    ++itor;
-                }
-
-                //TODO: Exploit temporal coherence across frames then use insertion sorts.
-                //As explained by L. Spiro in
-                //http://www.gamedev.net/topic/661114-temporal-coherence-and-render-queue-sorting/?view=findpost&p=5181408
-                //Keep a list of sorted indices from the previous frame (one per camera).
-                //If we have the sorted list "5, 1, 4, 3, 2, 0":
-                //  * If it grew from last frame, append: 5, 1, 4, 3, 2, 0, 6, 7 and use insertion sort.
-                //  * If it's the same, leave it as is, and use insertion sort just in case.
-                //  * If it's shorter, reset the indices 0, 1, 2, 3, 4; probably use quicksort or other generic sort
-                //
-                //TODO2: Explore sorting first on multiple threads, then merge sort into one.
-                if( mRenderQueues[i].mDoSort )
-                {
-                    std::sort( queuedRenderables.begin(), queuedRenderables.end() );
-                    mRenderQueues[i].mSorted = true;
-                }
-            }
+            DrawCache *drawCache = sortRenderQueue( mRenderQueues[i] );
 
             if( mRenderQueues[i].mMode == V1_LEGACY )
             {
@@ -424,7 +739,8 @@ namespace Ogre
             else if( numNeededDraws > 0 /*&& mRenderQueues[i].mMode == FAST*/ )
             {
                 indirectDraw = renderGL3( casterPass, dualParaboloid, passCache, mRenderQueues[i],
-                                          indirectBuffer, indirectDraw, startIndirectDraw );
+                                          drawCache, indirectBuffer, indirectDraw,
+                                          startIndirectDraw );
             }
         }
 
@@ -515,6 +831,7 @@ namespace Ogre
     //-----------------------------------------------------------------------
     unsigned char* RenderQueue::renderGL3( bool casterPass, bool dualParaboloid, HlmsCache passCache[],
                                            const RenderQueueGroup &renderQueueGroup,
+                                           DrawCache *drawCache,
                                            IndirectBufferPacked *indirectBuffer,
                                            unsigned char *indirectDraw,
                                            unsigned char *startIndirectDraw )
@@ -533,6 +850,48 @@ namespace Ogre
 
         const QueuedRenderableArray &queuedRenderables = renderQueueGroup.mQueuedRenderables;
 
+        CachedDraw *cachedDraw = 0;
+        if( drawCache )
+        {
+            //The shaders resolved last time are only valid if the
+            //pass and the shader caches are still the same.
+            bool drawCacheValid = drawCache->casterPass == casterPass &&
+                                  drawCache->draws.size() == queuedRenderables.size() &&
+                                  drawCache->passHashes.size() == HLMS_MAX;
+            for( size_t i=0; i<HLMS_MAX && drawCacheValid; ++i )
+            {
+                Hlms *hlms = mHlmsManager->getHlms( static_cast<HlmsTypes>( i ) );
+                if( hlms )
+                {
+                    drawCacheValid = drawCache->passHashes[i] == passCache[i].hash &&
+                                     drawCache->shaderCacheGenerations[i] ==
+                                            hlms->_getShaderCacheGeneration();
+                }
+            }
+
+            if( !drawCacheValid )
+            {
+                drawCache->casterPass = casterPass;
+                drawCache->passHashes.resize( HLMS_MAX );
+                drawCache->shaderCacheGenerations.resize( HLMS_MAX );
+                for( size_t i=0; i<HLMS_MAX; ++i )
+                {
+                    Hlms *hlms = mHlmsManager->getHlms( static_cast<HlmsTypes>( i ) );
+                    drawCache->passHashes[i] = passCache[i].hash;
+                    drawCache->shaderCacheGenerations[i] = hlms ? hlms->_getShaderCacheGeneration() : 0;
+                }
+
+                CachedDraw emptyDraw;
+                emptyDraw.vao       = 0;
+                emptyDraw.hlmsHash  = 0;
+                emptyDraw.hlmsCache = 0;
+                drawCache->draws.clear();
+                drawCache->draws.resize( queuedRenderables.size(), emptyDraw );
+            }
+
+            cachedDraw = drawCache->draws.begin();
+        }
+
         QueuedRenderableArray::const_iterator itor = queuedRenderables.begin();
         QueuedRenderableArray::const_iterator end  = queuedRenderables.end();
 
@@ -549,11 +908,41 @@ namespace Ogre
             Hlms *hlms = mHlmsManager->getHlms( static_cast<HlmsTypes>( datablock->mType ) );
 
             lastHlmsCacheHash = lastHlmsCache->hash;
-            const HlmsCache *hlmsCache = hlms->getMaterial( lastHlmsCache,
-                                                            passCache[datablock->mType],
-                                                            queuedRenderable,
-                                                            vao->getInputLayoutId(),
-                                                            casterPass );
+            const HlmsCache *hlmsCache;
+            if( cachedDraw )
+            {
+                const uint32 hlmsHash = casterPass ? queuedRenderable.renderable->getHlmsCasterHash() :
+                                                     queuedRenderable.renderable->getHlmsHash();
+                if( cachedDraw->vao != vao || cachedDraw->hlmsHash != hlmsHash )
+                {
+                    cachedDraw->vao         = vao;
+                    cachedDraw->hlmsHash    = hlmsHash;
+                    cachedDraw->hlmsCache   = hlms->getMaterial( lastHlmsCache,
+                                                                 passCache[datablock->mType],
+                                                                 queuedRenderable,
+                                                                 vao->getInputLayoutId(),
+                                                                 casterPass, true );
+                    //Deferred shaders must be looked up again next time.
+                    if( !cachedDraw->hlmsCache )
+                        cachedDraw->vao = 0;
+                }
+                hlmsCache = cachedDraw->hlmsCache;
+                ++cachedDraw;
+            }
+            else
+            {
+                hlmsCache = hlms->getMaterial( lastHlmsCache, passCache[datablock->mType],
+                                               queuedRenderable, vao->getInputLayoutId(),
+                                               casterPass, true );
+            }
+
+            if( !hlmsCache )
+            {
+                //Shader creation was deferred to a later frame. Skip it.
+                ++itor;
+                continue;
+            }
+
             if( lastHlmsCacheHash != hlmsCache->hash )
             {
                 CbPipelineStateObject *psoCmd = mCommandBuffer->addCommand<CbPipelineStateObject>();
@@ -689,7 +1078,14 @@ namespace Ogre
                                                             passCache[datablock->mType],
                                                             queuedRenderable,
                                                             renderOp.vertexData->vertexDeclaration->
-                                                            getInputLayoutId(), casterPass );
+                                                            getInputLayoutId(), casterPass, true );
+            if( !hlmsCache )
+            {
+                //Shader creation was deferred to a later frame. Skip it.
+                ++itor;
+                continue;
+            }
+
             if( lastHlmsCache != hlmsCache )
             {
                 CbPipelineStateObject *psoCmd = mCommandBuffer->addCommand<CbPipelineStateObject>();
@@ -855,5 +1251,32 @@ namespace Ogre
     {
         return mRenderQueues[rqId].mDoSort;
     }
+    //-----------------------------------------------------------------------
+    void RenderQueue::setRenderQueueTemporalCoherence( uint8 rqId, bool bEnable )
+    {
+        mRenderQueues[rqId].mTemporalCoherence = bEnable;
+        if( !bEnable )
+            mRenderQueues[rqId].mPrevFrameSortOrder.clear();
+    }
+    //-----------------------------------------------------------------------
+    bool RenderQueue::getRenderQueueTemporalCoherence( uint8 rqId ) const
+    {
+        return mRenderQueues[rqId].mTemporalCoherence;
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::setRenderQueueDrawCaching( uint8 rqId, bool bEnable )
+    {
+        mRenderQueues[rqId].mDrawCaching = bEnable;
+        if( !bEnable )
+        {
+            mRenderQueues[rqId].mDrawCache.clear();
+            mRenderQueues[rqId].mCurrentDrawCache = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool RenderQueue::getRenderQueueDrawCaching( uint8 rqId ) const
+    {
+        return mRenderQueues[rqId].mDrawCaching;
+    }
 }
 
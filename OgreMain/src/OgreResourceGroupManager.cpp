@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreTimelineProfiler.h"
 #include "OgreException.h"
 #include "OgreArchive.h"
 #include "OgreArchiveManager.h"
@@ -34,9 +35,66 @@ THE SOFTWARE.
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 #include "OgreResourceManager.h"
+#include "Threading/OgreChunkedTask.h"
 
 namespace Ogre {
 
+    /// Prepares one resource per chunk. Resources vary wildly in size,
+    /// so let idle threads grab the next one.
+    class PrepareResourcesTask : public ChunkedTask
+    {
+        typedef vector<ResourcePtr>::type ResourcePtrVec;
+        const ResourcePtrVec    &mResources;
+        /// Why each resource failed to prepare; empty if it didn't. One per
+        /// chunk, so worker threads never write to the same entry.
+        StringVector            mErrors;
+
+    public:
+        PrepareResourcesTask( const vector<ResourcePtr>::type &resources ) :
+            mResources( resources ), mErrors( resources.size() ) {}
+
+        virtual size_t getNumChunks(void) const     { return mResources.size(); }
+
+        virtual void executeChunk( size_t chunkIdx, size_t threadId )
+        {
+            //Exceptions must not escape a worker thread. The resource is back to
+            //unloaded, so loadResourceGroup will try again in the calling thread
+            //(and raise the exception there if it happens again).
+            try
+            {
+                mResources[chunkIdx]->prepare( true );
+            }
+            catch( Exception &e )
+            {
+                mErrors[chunkIdx] = e.getFullDescription();
+            }
+            catch( std::exception &e )
+            {
+                mErrors[chunkIdx] = e.what();
+            }
+            catch( ... )
+            {
+                mErrors[chunkIdx] = "Unknown exception";
+            }
+        }
+
+        /// Logs the resources that failed. Call it from the calling thread after
+        /// the task is done.
+        void logErrors(void) const
+        {
+            for( size_t i=0; i<mErrors.size(); ++i )
+            {
+                if( !mErrors[i].empty() )
+                {
+                    LogManager::getSingleton().logMessage(
+                                "Failed to prepare resource '" + mResources[i]->getName() +
+                                "' in parallel; retrying while loading. Reason: " + mErrors[i],
+                                LML_CRITICAL );
+                }
+            }
+        }
+    };
+
     //-----------------------------------------------------------------------
     template<> ResourceGroupManager* Singleton<ResourceGroupManager>::msSingleton = 0;
     ResourceGroupManager* ResourceGroupManager::getSingletonPtr(void)
@@ -260,6 +318,8 @@ namespace Ogre {
         // Can only bulk-load one group at a time (reasonable limitation I think)
         OGRE_LOCK_AUTO_MUTEX;
 
+        OgreTimelineScope( "loadResourceGroup", TimelineProfiler::CurrentThreadTrack );
+
         LogManager::getSingleton().stream()
             << "Loading resource group '" << name << "' - Resources: "
             << loadMainResources << " World Geometry: " << loadWorldGeom;
@@ -354,6 +414,75 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("Finished loading resource group " + name);
     }
     //-----------------------------------------------------------------------
+    void ResourceGroupManager::loadResourceGroupParallel( const String& name,
+                                                          SceneManager *sceneManager,
+                                                          bool loadMainResources,
+                                                          bool loadWorldGeom )
+    {
+        OgreTimelineScope( "loadResourceGroupParallel", TimelineProfiler::CurrentThreadTrack );
+
+        vector<ResourcePtr>::type resources;
+
+        if( loadMainResources )
+        {
+            //Take a snapshot of the resources to prepare. Preparing needs these
+            //locks (i.e. to open files), so we can't hold them while the workers run.
+            OGRE_LOCK_AUTO_MUTEX;
+
+            ResourceGroup* grp = getResourceGroup(name);
+            if (!grp)
+            {
+                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
+                    "Cannot find a group named " + name, 
+                    "ResourceGroupManager::loadResourceGroupParallel");
+            }
+
+            OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex 
+
+            ResourceGroup::LoadResourceOrderMap::const_iterator oi;
+            for (oi = grp->loadResourceOrderMap.begin(); oi != grp->loadResourceOrderMap.end(); ++oi)
+            {
+                LoadUnloadResourceList::const_iterator l = oi->second->begin();
+                LoadUnloadResourceList::const_iterator e = oi->second->end();
+                while( l != e )
+                {
+                    if( (*l)->getLoadingState() == Resource::LOADSTATE_UNLOADED )
+                        resources.push_back( *l );
+                    ++l;
+                }
+            }
+        }
+
+        if( !resources.empty() )
+        {
+            LogManager::getSingleton().stream()
+                << "Preparing " << resources.size() << " resources of group '"
+                << name << "' in parallel";
+
+            PrepareResourcesTask task( resources );
+#if OGRE_THREAD_SUPPORT
+            sceneManager->executeUserChunkedTask( &task );
+#else
+            //Resource managers aren't thread safe without thread support.
+            for( size_t i=0; i<task.getNumChunks(); ++i )
+                task.executeChunk( i, 0 );
+#endif
+            task.logErrors();
+
+            //Listeners expect to be called from this thread.
+            vector<ResourcePtr>::type::const_iterator itor = resources.begin();
+            vector<ResourcePtr>::type::const_iterator end  = resources.end();
+            while( itor != end )
+            {
+                if( (*itor)->isPrepared() )
+                    (*itor)->_firePreparingComplete( false );
+                ++itor;
+            }
+        }
+
+        loadResourceGroup( name, loadMainResources, loadWorldGeom );
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::unloadResourceGroup(const String& name, bool reloadableOnly)
     {
         // Can only bulk-unload one group at a time (reasonable limitation I think)
@@ -46,6 +46,7 @@ THE SOFTWARE.
 #include "OgreParticleSystemManager.h"
 #include "OgreOldSkeletonManager.h"
 #include "OgreProfiler.h"
+#include "OgreTimelineProfiler.h"
 #include "OgreConfigDialog.h"
 #include "OgreArchiveManager.h"
 #include "OgrePlugin.h"
@@ -335,6 +336,7 @@ namespace Ogre {
 #if OGRE_PROFILING
         OGRE_DELETE mProfiler;
 #endif
+        TimelineProfiler::shutdown();
 
         OGRE_DELETE mLodStrategyManager;
 
@@ -56,6 +56,7 @@ THE SOFTWARE.
 #include "OgreParticleSystemManager.h"
 #include "OgreParticleSystem.h"
 #include "OgreProfiler.h"
+#include "OgreTimelineProfiler.h"
 #include "OgreInstanceBatch.h"
 #include "OgreInstancedEntity.h"
 #include "OgreRenderTexture.h"
@@ -70,12 +71,14 @@ THE SOFTWARE.
 #include "OgreWireAabb.h"
 #include "OgreHlmsManager.h"
 #include "OgreForward3D.h"
+#include "OgreSoftwareOcclusionCuller.h"
 #include "Animation/OgreSkeletonDef.h"
 #include "Animation/OgreSkeletonInstance.h"
 #include "Animation/OgreTagPoint.h"
 #include "Compositor/OgreCompositorShadowNode.h"
 #include "Threading/OgreBarrier.h"
 #include "Threading/OgreUniformScalableTask.h"
+#include "Threading/OgreChunkedTask.h"
 
 // This class implements the most basic scene manager
 
@@ -90,6 +93,29 @@ uint32 SceneManager::QUERY_STATICGEOMETRY_DEFAULT_MASK = 0x20000000;
 uint32 SceneManager::QUERY_LIGHT_DEFAULT_MASK          = 0x10000000;
 uint32 SceneManager::QUERY_FRUSTUM_DEFAULT_MASK        = 0x08000000;
 //-----------------------------------------------------------------------
+/// Updates a contiguous range of the queued particle systems per chunk.
+class ParticleSystemUpdateTask : public ChunkedTask
+{
+    FastArray<ParticleSystem*> const &mParticleSystems;
+    size_t  mNumChunks;
+
+public:
+    ParticleSystemUpdateTask( const FastArray<ParticleSystem*> &particleSystems, size_t numChunks ) :
+        mParticleSystems( particleSystems ), mNumChunks( numChunks ) {}
+
+    virtual size_t getNumChunks(void) const     { return mNumChunks; }
+
+    virtual void executeChunk( size_t chunkIdx, size_t threadId )
+    {
+        const size_t numSystems = mParticleSystems.size();
+        const size_t start  = (numSystems * chunkIdx) / mNumChunks;
+        const size_t end    = (numSystems * (chunkIdx + 1u)) / mNumChunks;
+
+        for( size_t i=start; i<end; ++i )
+            mParticleSystems[i]->_executeQueuedUpdate();
+    }
+};
+//-----------------------------------------------------------------------
 SceneManager::SceneManager(const String& name, size_t numWorkerThreads,
                            InstancingThreadedCullingMethod threadedCullingMethod) :
 mStaticMinDepthLevelDirty( 0 ),
@@ -97,6 +123,7 @@ mStaticEntitiesDirty( true ),
 mName(name),
 mRenderQueue( 0 ),
 mForward3DImpl( 0 ),
+mSoftwareOcclusionCuller( 0 ),
 mCameraInProgress(0),
 mCurrentViewport(0),
 mCurrentShadowNode(0),
@@ -138,9 +165,14 @@ mCompositorTarget( IdString(), 0 ),
 mVisibilityMask(0xFFFFFFFF & VisibilityFlags::RESERVED_VISIBILITY_FLAGS),
 mFindVisibleObjects(true),
 mNumWorkerThreads( numWorkerThreads ),
-mUpdateBoundsRequest( 0 ),
+mNumUpdatedTransforms( 0 ),
 mInstancingThreadedCullingMethod( threadedCullingMethod ),
 mUserTask( 0 ),
+mUserChunkedTask( 0 ),
+mNumUserChunks( 0 ),
+mNextChunkIdx( 0 ),
+mFixedCullChunks( false ),
+mCullFrustumBatchIdx( 0 ),
 mRequestType( NUM_REQUESTS ),
 mWorkerThreadsBarrier( 0 ),
 mSuppressRenderStateChanges(false),
@@ -182,6 +214,9 @@ mGpuParamsDirty((uint16)GPV_ALL)
 
     mGlobalLightListPerThread.resize( mNumWorkerThreads );
     mBuildLightListRequestPerThread.resize( mNumWorkerThreads );
+    mVisibleSkeletonsPerThread.resize( mNumWorkerThreads );
+    mCullFrustumBatchScratchPerThread.resize( mNumWorkerThreads );
+    mNumUpdatedTransformsPerThread.resize( mNumWorkerThreads, 0 );
     mVisibleObjects.resize( mNumWorkerThreads );
     mTmpVisibleObjects.resize( mNumWorkerThreads );
 
@@ -252,11 +287,13 @@ SceneManager::~SceneManager()
     }
     OGRE_DELETE mFullScreenQuad;
     OGRE_DELETE mForward3DImpl;
+    OGRE_DELETE mSoftwareOcclusionCuller;
     OGRE_DELETE mRenderQueue;
     OGRE_DELETE mAutoParamDataSource;
 
     mFullScreenQuad         = 0;
     mForward3DImpl          = 0;
+    mSoftwareOcclusionCuller= 0;
     mRenderQueue            = 0;
     mAutoParamDataSource    = 0;
 
@@ -332,6 +369,11 @@ void SceneManager::destroyCamera(Camera *cam)
 
     IdString camName( cam->getName() );
 
+    //Don't leave per-camera caches keyed by a dangling pointer
+    //(a new camera could be allocated at the same address).
+    if( mRenderQueue )
+        mRenderQueue->_cameraDestroyed( cam );
+
     // Find in list
     CameraList::iterator itor = mCameras.begin() + cam->mGlobalIndex;
     itor = efficientVectorRemove( mCameras, itor );
@@ -643,6 +685,20 @@ void SceneManager::destroyAllParticleSystems(void)
     destroyAllMovableObjectsByType(ParticleSystemFactory::FACTORY_TYPE_NAME);
 }
 //-----------------------------------------------------------------------
+void SceneManager::_queueParticleSystemUpdate( ParticleSystem *particleSystem )
+{
+    mQueuedParticleSystemUpdates.push_back( particleSystem );
+}
+//-----------------------------------------------------------------------
+void SceneManager::_removeQueuedParticleSystemUpdate( ParticleSystem *particleSystem )
+{
+    FastArray<ParticleSystem*>::iterator itor = std::find( mQueuedParticleSystemUpdates.begin(),
+                                                           mQueuedParticleSystemUpdates.end(),
+                                                           particleSystem );
+    if( itor != mQueuedParticleSystemUpdates.end() )
+        efficientVectorRemove( mQueuedParticleSystemUpdates, itor );
+}
+//-----------------------------------------------------------------------
 void SceneManager::clearScene(void)
 {
     destroyAllStaticGeometry();
@@ -843,6 +899,15 @@ void SceneManager::setForward3D( bool bEnable, uint32 width, uint32 height, uint
     }
 }
 //-----------------------------------------------------------------------
+void SceneManager::setSoftwareOcclusionCulling( bool bEnable, uint32 width, uint32 height )
+{
+    OGRE_DELETE mSoftwareOcclusionCuller;
+    mSoftwareOcclusionCuller = 0;
+
+    if( bEnable )
+        mSoftwareOcclusionCuller = OGRE_NEW SoftwareOcclusionCuller( width, height );
+}
+//-----------------------------------------------------------------------
 void SceneManager::prepareRenderQueue(void)
 {
     /* TODO: RENDER QUEUE
@@ -906,6 +971,7 @@ void SceneManager::_cullPhase01( Camera* camera, const Camera *lodCamera, Viewpo
                                  uint8 firstRq, uint8 lastRq )
 {
     OgreProfileGroup("_cullPhase01", OGREPROF_GENERAL);
+    OgreTimelineScope( "_cullPhase01", 0 );
 
     Root::getSingleton()._pushCurrentSceneManager(this);
     mAutoParamDataSource->setCurrentSceneManager(this);
@@ -955,7 +1021,34 @@ void SceneManager::_cullPhase01( Camera* camera, const Camera *lodCamera, Viewpo
             CullFrustumRequest cullRequest( realFirstRq, realLastRq,
                                             mIlluminationStage == IRS_RENDER_TO_TEXTURE, true,
                                             &mEntitiesMemoryManagerCulledList, camera, lodCamera );
-            fireCullFrustumThreads( cullRequest );
+
+            const size_t batchIdx = findCullFrustumBatchEntry(
+                        camera, lodCamera, camera->getLastViewport()->getVisibilityMask(),
+                        firstRq, lastRq );
+
+            if( batchIdx < mCullFrustumBatch.size() )
+            {
+                //Already culled by cullFrustumBatch. Just collect the results.
+                mCullFrustumBatch[batchIdx].camera = 0;
+                mCullFrustumBatchIdx        = batchIdx;
+                mCurrentCullFrustumRequest  = cullRequest;
+                mRequestType                = COLLECT_CULL_FRUSTUM_BATCH;
+                fireWorkerThreadsAndWait();
+                applyVisibleSkeletons();
+            }
+            else
+            {
+                if( mSoftwareOcclusionCuller && mIlluminationStage != IRS_RENDER_TO_TEXTURE &&
+                    mSoftwareOcclusionCuller->_prepare( camera ) )
+                {
+                    OgreProfileGroup( "Rasterize occluders", OGREPROF_CULLING );
+                    mRequestType = RASTERIZE_OCCLUDERS;
+                    fireWorkerThreadsAndWait();
+                    cullRequest.occlusionCuller = mSoftwareOcclusionCuller;
+                }
+
+                fireCullFrustumThreads( cullRequest );
+            }
         }
     } // end lock on scene graph mutex
 }
@@ -964,6 +1057,7 @@ void SceneManager::_renderPhase02(Camera* camera, const Camera *lodCamera, Viewp
                                   uint8 firstRq, uint8 lastRq, bool includeOverlays)
 {
     OgreProfileGroup("_renderPhase02", OGREPROF_GENERAL);
+    OgreTimelineScope( "_renderPhase02", 0 );
 
     // reset light hash so even if light list is the same, we refresh the content every frame
     LightList emptyLightList;
@@ -1792,6 +1886,10 @@ void SceneManager::notifyStaticDirty( Node *node )
 //-----------------------------------------------------------------------
 void SceneManager::updateAllAnimationsThread( size_t threadIdx )
 {
+    OgreTimelineScope( "updateAllAnimationsThread", threadIdx + 1u );
+
+    const uint32 frameNumber = static_cast<uint32>( Root::getSingleton().getNextFrameNumber() );
+
     SkeletonAnimManagerVec::const_iterator it = mSkeletonAnimManagerCulledList.begin();
     SkeletonAnimManagerVec::const_iterator en = mSkeletonAnimManagerCulledList.end();
 
@@ -1808,7 +1906,7 @@ void SceneManager::updateAllAnimationsThread( size_t threadIdx )
                                                                     itByDef->threadStarts[threadIdx+1];
             while( itor != end )
             {
-                (*itor)->update();
+                (*itor)->_updateFromPolicy( frameNumber );
                 ++itor;
             }
 
@@ -1879,20 +1977,32 @@ void SceneManager::updateAllAnimations()
 //-----------------------------------------------------------------------
 void SceneManager::updateAllTransformsThread( const UpdateTransformRequest &request, size_t threadIdx )
 {
-    Transform t( request.t );
-    const size_t toAdvance = std::min( threadIdx * request.numNodesPerThread,
-                                        request.numTotalNodes );
+    OgreTimelineScope( "updateAllTransformsThread", threadIdx + 1u );
+
+    size_t numUpdated = 0;
+    size_t toAdvance = grabNextChunkIdx() * request.numNodesPerChunk;
+
+    while( toAdvance < request.numTotalNodes )
+    {
+        //Prevent going out of bounds (usually in the last chunk, or
+        //when there are less nodes than ARRAY_PACKED_REALS
+        const size_t numNodes = std::min( request.numNodesPerChunk,
+                                          request.numTotalNodes - toAdvance );
+        Transform t( request.t );
+        t.advancePack( toAdvance / ARRAY_PACKED_REALS );
+
+        numUpdated += Node::updateAllTransforms( numNodes, t );
 
-    //Prevent going out of bounds (usually in the last threadIdx, or
-    //when there are less nodes than ARRAY_PACKED_REALS
-    const size_t numNodes = std::min( request.numNodesPerThread, request.numTotalNodes - toAdvance );
-    t.advancePack( toAdvance / ARRAY_PACKED_REALS );
+        toAdvance = grabNextChunkIdx() * request.numNodesPerChunk;
+    }
 
-    Node::updateAllTransforms( numNodes, t );
+    mNumUpdatedTransformsPerThread[threadIdx] += numUpdated;
 }
 //-----------------------------------------------------------------------
 void SceneManager::updateAllTransforms()
 {
+    std::fill( mNumUpdatedTransformsPerThread.begin(), mNumUpdatedTransformsPerThread.end(), 0 );
+
     mRequestType = UPDATE_ALL_TRANSFORMS;
     NodeMemoryManagerVec::const_iterator it = mNodeMemoryManagerUpdateList.begin();
     NodeMemoryManagerVec::const_iterator en = mNodeMemoryManagerUpdateList.end();
@@ -1911,16 +2021,15 @@ void SceneManager::updateAllTransforms()
             Transform t;
             const size_t numNodes = nodeMemoryManager->getFirstNode( t, i );
 
-            //nodesPerThread must be multiple of ARRAY_PACKED_REALS
-            size_t nodesPerThread = ( numNodes + (mNumWorkerThreads-1) ) / mNumWorkerThreads;
-            nodesPerThread        = ( (nodesPerThread + ARRAY_PACKED_REALS - 1) / ARRAY_PACKED_REALS ) *
-                                    ARRAY_PACKED_REALS;
+            //nodesPerChunk must be multiple of ARRAY_PACKED_REALS
+            const size_t numPacks = ( numNodes + ARRAY_PACKED_REALS - 1 ) / ARRAY_PACKED_REALS;
+            const size_t nodesPerChunk = calculateNumPacksPerChunk( numPacks ) * ARRAY_PACKED_REALS;
 
             if( numNodes )
             {
                 //Send them to worker threads. We need to go depth by depth because
                 //we may depend on parents which could be processed by different threads.
-                mUpdateTransformRequest = UpdateTransformRequest( t, nodesPerThread, numNodes );
+                mUpdateTransformRequest = UpdateTransformRequest( t, nodesPerChunk, numNodes );
                 fireWorkerThreadsAndWait();
                 //Node::updateAllTransforms( numNodes, t );
             }
@@ -1929,6 +2038,34 @@ void SceneManager::updateAllTransforms()
         ++it;
     }
 
+    //Children have seen the dirty flags of their parents by now (dynamic nodes can have
+    //static parents, so wait until all managers are done). Clear them so that only the
+    //nodes that change until next frame get updated.
+    it = mNodeMemoryManagerUpdateList.begin();
+    while( it != en )
+    {
+        NodeMemoryManager *nodeMemoryManager = *it;
+        const size_t numDepths = nodeMemoryManager->getNumDepths();
+
+        size_t start = nodeMemoryManager->getMemoryManagerType() == SCENE_STATIC ?
+                                                    mStaticMinDepthLevelDirty : 0;
+
+        for( size_t i=start; i<numDepths; ++i )
+        {
+            Transform t;
+            const size_t numNodes = nodeMemoryManager->getFirstNode( t, i );
+            const size_t numSlots = ( (numNodes + ARRAY_PACKED_REALS - 1) / ARRAY_PACKED_REALS ) *
+                                    ARRAY_PACKED_REALS;
+            memset( t.mDirty, 0, numSlots * sizeof( bool ) );
+        }
+
+        ++it;
+    }
+
+    mNumUpdatedTransforms = 0;
+    for( size_t i=0; i<mNumWorkerThreads; ++i )
+        mNumUpdatedTransforms += mNumUpdatedTransformsPerThread[i];
+
     //Call all listeners
     SceneNodeList::const_iterator itor = mSceneNodesWithListeners.begin();
     SceneNodeList::const_iterator end  = mSceneNodesWithListeners.end();
@@ -1940,6 +2077,39 @@ void SceneManager::updateAllTransforms()
     }
 }
 //-----------------------------------------------------------------------
+void SceneManager::updateAllParticleSystems(void)
+{
+    if( mQueuedParticleSystemUpdates.empty() )
+        return;
+
+    OgreProfile( "updateAllParticleSystems" );
+
+    //Anything that may touch ParticleSystemManager or create GPU buffers stays in this thread
+    FastArray<ParticleSystem*>::const_iterator itor = mQueuedParticleSystemUpdates.begin();
+    FastArray<ParticleSystem*>::const_iterator end  = mQueuedParticleSystemUpdates.end();
+    while( itor != end )
+    {
+        (*itor)->_prepareQueuedUpdate();
+        ++itor;
+    }
+
+    const size_t numSystems = mQueuedParticleSystemUpdates.size();
+    const size_t numChunks = std::min( mNumWorkerThreads * 4u, numSystems );
+
+    if( numChunks > 1u )
+    {
+        ParticleSystemUpdateTask task( mQueuedParticleSystemUpdates, numChunks );
+        executeUserChunkedTask( &task );
+    }
+    else
+    {
+        for( size_t i=0; i<numSystems; ++i )
+            mQueuedParticleSystemUpdates[i]->_executeQueuedUpdate();
+    }
+
+    mQueuedParticleSystemUpdates.clear();
+}
+//-----------------------------------------------------------------------
 void SceneManager::updateAllTagPoints()
 {
     NodeMemoryManagerVec::const_iterator it = mTagPointNodeMemoryManagerUpdateList.begin();
@@ -1959,16 +2129,15 @@ void SceneManager::updateAllTagPoints()
             Transform t;
             const size_t numNodes = nodeMemoryManager->getFirstNode( t, i );
 
-            //nodesPerThread must be multiple of ARRAY_PACKED_REALS
-            size_t nodesPerThread = ( numNodes + (mNumWorkerThreads-1) ) / mNumWorkerThreads;
-            nodesPerThread        = ( (nodesPerThread + ARRAY_PACKED_REALS - 1) / ARRAY_PACKED_REALS ) *
-                                    ARRAY_PACKED_REALS;
+            //nodesPerChunk must be multiple of ARRAY_PACKED_REALS
+            const size_t numPacks = ( numNodes + ARRAY_PACKED_REALS - 1 ) / ARRAY_PACKED_REALS;
+            const size_t nodesPerChunk = calculateNumPacksPerChunk( numPacks ) * ARRAY_PACKED_REALS;
 
             if( numNodes )
             {
                 //Send them to worker threads. We need to go depth by depth because
                 //we may depend on parents which could be processed by different threads.
-                mUpdateTransformRequest = UpdateTransformRequest( t, nodesPerThread, numNodes );
+                mUpdateTransformRequest = UpdateTransformRequest( t, nodesPerChunk, numNodes );
                 fireWorkerThreadsAndWait();
             }
         }
@@ -1980,34 +2149,64 @@ void SceneManager::updateAllTagPoints()
 void SceneManager::updateAllTransformsBoneToTagThread( const UpdateTransformRequest &request,
                                                        size_t threadIdx )
 {
-    Transform t( request.t );
-    const size_t toAdvance = std::min( threadIdx * request.numNodesPerThread,
-                                        request.numTotalNodes );
+    OgreTimelineScope( "updateAllTransformsBoneToTagThread", threadIdx + 1u );
 
-    //Prevent going out of bounds (usually in the last threadIdx, or
-    //when there are less nodes than ARRAY_PACKED_REALS
-    const size_t numNodes = std::min( request.numNodesPerThread, request.numTotalNodes - toAdvance );
-    t.advancePack( toAdvance / ARRAY_PACKED_REALS );
+    size_t toAdvance = grabNextChunkIdx() * request.numNodesPerChunk;
 
-    TagPoint::updateAllTransformsBoneToTag( numNodes, t );
+    while( toAdvance < request.numTotalNodes )
+    {
+        //Prevent going out of bounds (usually in the last chunk, or
+        //when there are less nodes than ARRAY_PACKED_REALS
+        const size_t numNodes = std::min( request.numNodesPerChunk,
+                                          request.numTotalNodes - toAdvance );
+        Transform t( request.t );
+        t.advancePack( toAdvance / ARRAY_PACKED_REALS );
+
+        TagPoint::updateAllTransformsBoneToTag( numNodes, t );
+
+        toAdvance = grabNextChunkIdx() * request.numNodesPerChunk;
+    }
 }
 //-----------------------------------------------------------------------
 void SceneManager::updateAllTransformsTagOnTagThread( const UpdateTransformRequest &request,
                                                       size_t threadIdx )
 {
-    Transform t( request.t );
-    const size_t toAdvance = std::min( threadIdx * request.numNodesPerThread,
-                                        request.numTotalNodes );
+    OgreTimelineScope( "updateAllTransformsTagOnTagThread", threadIdx + 1u );
 
-    //Prevent going out of bounds (usually in the last threadIdx, or
-    //when there are less nodes than ARRAY_PACKED_REALS
-    const size_t numNodes = std::min( request.numNodesPerThread, request.numTotalNodes - toAdvance );
-    t.advancePack( toAdvance / ARRAY_PACKED_REALS );
+    size_t toAdvance = grabNextChunkIdx() * request.numNodesPerChunk;
 
-    TagPoint::updateAllTransformsTagOnTag( numNodes, t );
+    while( toAdvance < request.numTotalNodes )
+    {
+        //Prevent going out of bounds (usually in the last chunk, or
+        //when there are less nodes than ARRAY_PACKED_REALS
+        const size_t numNodes = std::min( request.numNodesPerChunk,
+                                          request.numTotalNodes - toAdvance );
+        Transform t( request.t );
+        t.advancePack( toAdvance / ARRAY_PACKED_REALS );
+
+        TagPoint::updateAllTransformsTagOnTag( numNodes, t );
+
+        toAdvance = grabNextChunkIdx() * request.numNodesPerChunk;
+    }
 }
 //-----------------------------------------------------------------------
-void SceneManager::updateAllBoundsThread( const ObjectMemoryManagerVec &objectMemManager, size_t threadIdx )
+size_t SceneManager::calculateNumPacksPerChunk( size_t numPacks ) const
+{
+    //Aim for a few chunks per thread so that threads that finish early can take
+    //work from the rest, but keep them big enough (and aligned to pack clusters)
+    //so that grabbing a chunk is cheap compared to processing it.
+    const size_t numChunksPerThread = 4;
+    const size_t packsPerCluster = ObjectMemoryManager::NUM_PACKS_PER_CLUSTER;
+
+    size_t packsPerChunk = ( numPacks + mNumWorkerThreads * numChunksPerThread - 1 ) /
+                            ( mNumWorkerThreads * numChunksPerThread );
+    packsPerChunk = ( (packsPerChunk + packsPerCluster - 1) / packsPerCluster ) * packsPerCluster;
+
+    return std::max( packsPerChunk, packsPerCluster );
+}
+//-----------------------------------------------------------------------
+void SceneManager::addObjectDataChunks( const ObjectMemoryManagerVec &objectMemManager,
+                                        size_t firstRq, size_t lastRq )
 {
     ObjectMemoryManagerVec::const_iterator it = objectMemManager.begin();
     ObjectMemoryManagerVec::const_iterator en = objectMemManager.end();
@@ -2017,76 +2216,106 @@ void SceneManager::updateAllBoundsThread( const ObjectMemoryManagerVec &objectMe
         ObjectMemoryManager *memoryManager = *it;
         const size_t numRenderQueues = memoryManager->getNumRenderQueues();
 
-        for( size_t i=0; i<numRenderQueues; ++i )
+        const size_t rqStart = std::min( firstRq, numRenderQueues );
+        const size_t rqEnd   = std::min( lastRq,  numRenderQueues );
+
+        for( size_t i=rqStart; i<rqEnd; ++i )
         {
             ObjectData objData;
             const size_t totalObjs = memoryManager->getFirstObjectData( objData, i );
+            const size_t numPacks = ( totalObjs + ARRAY_PACKED_REALS - 1 ) / ARRAY_PACKED_REALS;
+            const size_t packsPerChunk = calculateNumPacksPerChunk( numPacks );
 
-            //Distribute the work evenly across all threads (not perfect), taking into
-            //account we need to distribute in multiples of ARRAY_PACKED_REALS
-            size_t numObjs  = ( totalObjs + (mNumWorkerThreads-1) ) / mNumWorkerThreads;
-            numObjs         = ( (numObjs + ARRAY_PACKED_REALS - 1) / ARRAY_PACKED_REALS ) *
-                                ARRAY_PACKED_REALS;
+            for( size_t firstPack=0; firstPack<numPacks; firstPack += packsPerChunk )
+            {
+                const size_t toAdvance = firstPack * ARRAY_PACKED_REALS;
+                const size_t numObjs = std::min( packsPerChunk * ARRAY_PACKED_REALS,
+                                                 totalObjs - toAdvance );
+                mObjectDataChunks.push_back( ObjectDataChunk( memoryManager, i,
+                                                              firstPack, numObjs ) );
+            }
+        }
 
-            const size_t toAdvance = std::min( threadIdx * numObjs, totalObjs );
+        ++it;
+    }
+}
+//-----------------------------------------------------------------------
+size_t SceneManager::grabNextChunkIdx(void)
+{
+    mChunkMutex.lock();
+    const size_t retVal = mNextChunkIdx++;
+    mChunkMutex.unlock();
+    return retVal;
+}
+//-----------------------------------------------------------------------
+size_t SceneManager::grabNextCullChunkIdx( size_t threadIdx, size_t prevChunkIdx )
+{
+    if( !mFixedCullChunks )
+        return grabNextChunkIdx();
 
-            //Prevent going out of bounds (usually in the last threadIdx, or
-            //when there are less entities than ARRAY_PACKED_REALS
-            numObjs = std::min( numObjs, totalObjs - toAdvance );
-            objData.advancePack( toAdvance / ARRAY_PACKED_REALS );
+    if( prevChunkIdx == std::numeric_limits<size_t>::max() )
+        return threadIdx;
 
-            MovableObject::updateAllBounds( numObjs, objData );
-        }
+    return prevChunkIdx + mNumWorkerThreads;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::needsFixedCullChunks( uint8 firstRq, uint8 lastRq ) const
+{
+    bool retVal = false;
+    for( size_t i=firstRq; i<lastRq && !retVal; ++i )
+        retVal = mRenderQueue->getRenderQueueTemporalCoherence( static_cast<uint8>( i ) );
+    return retVal;
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateAllBoundsThread( size_t threadIdx )
+{
+    OgreTimelineScope( "updateAllBoundsThread", threadIdx + 1u );
 
-        ++it;
+    size_t chunkIdx = grabNextChunkIdx();
+
+    while( chunkIdx < mObjectDataChunks.size() )
+    {
+        const ObjectDataChunk &chunk = mObjectDataChunks[chunkIdx];
+
+        ObjectData objData;
+        chunk.objectMemManager->getFirstObjectData( objData, chunk.renderQueue );
+        objData.advancePack( chunk.firstPack );
+
+        MovableObject::updateAllBounds( chunk.numObjs, objData );
+
+        chunkIdx = grabNextChunkIdx();
     }
 }
 //-----------------------------------------------------------------------
 void SceneManager::updateAllBounds( const ObjectMemoryManagerVec &objectMemManager )
 {
-    mUpdateBoundsRequest    = &objectMemManager;
-    mRequestType            = UPDATE_ALL_BOUNDS;
+    mObjectDataChunks.clear();
+    addObjectDataChunks( objectMemManager, 0, std::numeric_limits<size_t>::max() );
+    mRequestType = UPDATE_ALL_BOUNDS;
     fireWorkerThreadsAndWait();
 }
 //-----------------------------------------------------------------------
 void SceneManager::updateAllLodsThread( const UpdateLodRequest &request, size_t threadIdx )
 {
+    OgreTimelineScope( "updateAllLodsThread", threadIdx + 1u );
+
     LodStrategy *lodStrategy = LodStrategyManager::getSingleton().getDefaultStrategy();
 
     const Camera *lodCamera = request.lodCamera;
-    ObjectMemoryManagerVec::const_iterator it = request.objectMemManager->begin();
-    ObjectMemoryManagerVec::const_iterator en = request.objectMemManager->end();
-
-    while( it != en )
-    {
-        ObjectMemoryManager *memoryManager = *it;
-        const size_t numRenderQueues = memoryManager->getNumRenderQueues();
-
-        size_t firstRq = std::min<size_t>( request.firstRq, numRenderQueues );
-        size_t lastRq  = std::min<size_t>( request.lastRq,  numRenderQueues );
 
-        for( size_t i=firstRq; i<lastRq; ++i )
-        {
-            ObjectData objData;
-            const size_t totalObjs = memoryManager->getFirstObjectData( objData, i );
-
-            //Distribute the work evenly across all threads (not perfect), taking into
-            //account we need to distribute in multiples of ARRAY_PACKED_REALS
-            size_t numObjs  = ( totalObjs + (mNumWorkerThreads-1) ) / mNumWorkerThreads;
-            numObjs         = ( (numObjs + ARRAY_PACKED_REALS - 1) / ARRAY_PACKED_REALS ) *
-                                ARRAY_PACKED_REALS;
+    size_t chunkIdx = grabNextChunkIdx();
 
-            const size_t toAdvance = std::min( threadIdx * numObjs, totalObjs );
+    while( chunkIdx < mObjectDataChunks.size() )
+    {
+        const ObjectDataChunk &chunk = mObjectDataChunks[chunkIdx];
 
-            //Prevent going out of bounds (usually in the last threadIdx, or
-            //when there are less entities than ARRAY_PACKED_REALS
-            numObjs = std::min( numObjs, totalObjs - toAdvance );
-            objData.advancePack( toAdvance / ARRAY_PACKED_REALS );
+        ObjectData objData;
+        chunk.objectMemManager->getFirstObjectData( objData, chunk.renderQueue );
+        objData.advancePack( chunk.firstPack );
 
-            lodStrategy->lodUpdateImpl( numObjs, objData, lodCamera, request.lodBias );
-        }
+        lodStrategy->lodUpdateImpl( chunk.numObjs, objData, lodCamera, request.lodBias );
 
-        ++it;
+        chunkIdx = grabNextChunkIdx();
     }
 }
 //-----------------------------------------------------------------------
@@ -2099,6 +2328,9 @@ void SceneManager::updateAllLods( const Camera *lodCamera, Real lodBias, uint8 f
     mUpdateLodRequest.camera->getFrustumPlanes();
     mUpdateLodRequest.lodCamera->getFrustumPlanes();
 
+    mObjectDataChunks.clear();
+    addObjectDataChunks( *mUpdateLodRequest.objectMemManager, firstRq, lastRq );
+
     fireWorkerThreadsAndWait();
 }
 //-----------------------------------------------------------------------
@@ -2124,10 +2356,211 @@ void SceneManager::instanceBatchCullFrustumThread( const InstanceBatchCullReques
     }
 }
 //-----------------------------------------------------------------------
-void SceneManager::cullFrustum( const CullFrustumRequest &request, size_t threadIdx )
+VisibleObjectsPerRq& SceneManager::resetVisibleObjects( size_t threadIdx )
 {
     VisibleObjectsPerRq &visibleObjectsPerRq = *(mVisibleObjects.begin() + threadIdx);
+    visibleObjectsPerRq.resize( 255 );
+    VisibleObjectsPerRq::iterator itor = visibleObjectsPerRq.begin();
+    VisibleObjectsPerRq::iterator end  = visibleObjectsPerRq.end();
+
+    while( itor != end )
+    {
+        itor->clear();
+        ++itor;
+    }
+
+    return visibleObjectsPerRq;
+}
+//-----------------------------------------------------------------------
+void SceneManager::addVisibleObjectsToRenderQueue( size_t threadIdx, uint8 rqId, bool casterPass,
+                                                   MovableObject::MovableObjectArray &inOutVisibleObjects )
+{
+    //V2 meshes can be added to the render queue in parallel
+    MovableObject::MovableObjectArray::const_iterator itor = inOutVisibleObjects.begin();
+    MovableObject::MovableObjectArray::const_iterator end  = inOutVisibleObjects.end();
+
+    while( itor != end )
+    {
+        RenderableArray::const_iterator itRend = (*itor)->mRenderables.begin();
+        RenderableArray::const_iterator enRend = (*itor)->mRenderables.end();
+
+        while( itRend != enRend )
+        {
+            mRenderQueue->addRenderableV2( threadIdx, rqId, casterPass, *itRend, *itor );
+            ++itRend;
+        }
+        ++itor;
+    }
+
+    inOutVisibleObjects.clear();
+}
+//-----------------------------------------------------------------------
+void SceneManager::notifyVisibleSkeletons( const MovableObject::MovableObjectArray &visibleObjects,
+                                           size_t firstIdx, bool casterPass, size_t threadIdx )
+{
+    VisibleSkeletonArray &visibleSkeletons = mVisibleSkeletonsPerThread[threadIdx];
+
+    MovableObject::MovableObjectArray::const_iterator itor = visibleObjects.begin() + firstIdx;
+    MovableObject::MovableObjectArray::const_iterator end  = visibleObjects.end();
+
+    while( itor != end )
+    {
+        SkeletonInstance *skeletonInstance = (*itor)->getSkeletonInstance();
+        if( skeletonInstance )
+        {
+            visibleSkeletons.push_back( VisibleSkeleton(
+                                            skeletonInstance,
+                                            casterPass ? std::numeric_limits<Real>::max() :
+                                                         (*itor)->getCachedDistanceToCameraAsReal() ) );
+        }
+        ++itor;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::applyVisibleSkeletons(void)
+{
+    const uint32 frameNumber = static_cast<uint32>( Root::getSingleton().getNextFrameNumber() );
+
+    FastArray<VisibleSkeletonArray>::iterator itThread = mVisibleSkeletonsPerThread.begin();
+    FastArray<VisibleSkeletonArray>::iterator enThread = mVisibleSkeletonsPerThread.end();
+
+    while( itThread != enThread )
+    {
+        VisibleSkeletonArray::const_iterator itor = itThread->begin();
+        VisibleSkeletonArray::const_iterator end  = itThread->end();
+
+        while( itor != end )
+        {
+            itor->skeletonInstance->_notifyVisible( frameNumber, itor->distanceToCamera );
+            ++itor;
+        }
+
+        itThread->clear();
+        ++itThread;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::cullFrustum( const CullFrustumRequest &request, size_t threadIdx )
+{
+    OgreTimelineScope( "cullFrustum", threadIdx + 1u );
+
+    VisibleObjectsPerRq &visibleObjectsPerRq = resetVisibleObjects( threadIdx );
+
+    const Camera *camera    = request.camera;
+    const Camera *lodCamera = request.lodCamera;
+    const uint32 visibilityMask =
+            (camera->getLastViewport()->getVisibilityMask() & getVisibilityMask()) |
+            (camera->getLastViewport()->getVisibilityMask() &
+                                ~VisibilityFlags::RESERVED_VISIBILITY_FLAGS);
+
+    size_t chunkIdx = grabNextCullChunkIdx( threadIdx, std::numeric_limits<size_t>::max() );
+
+    while( chunkIdx < mObjectDataChunks.size() )
     {
+        const ObjectDataChunk &chunk = mObjectDataChunks[chunkIdx];
+        const size_t i = chunk.renderQueue;
+
+        MovableObject::MovableObjectArray &outVisibleObjects = *(visibleObjectsPerRq.begin() + i);
+
+        ObjectData objData;
+        chunk.objectMemManager->getFirstObjectData( objData, i );
+        objData.advancePack( chunk.firstPack );
+
+        const size_t prevNumVisible = outVisibleObjects.size();
+
+        MovableObject::cullFrustum( chunk.numObjs, objData, camera, visibilityMask,
+                                    outVisibleObjects, lodCamera,
+                                    chunk.objectMemManager->_getPackClusters( i ),
+                                    chunk.firstPack );
+
+        if( request.occlusionCuller )
+            request.occlusionCuller->_cullOccluded( outVisibleObjects, prevNumVisible );
+
+        notifyVisibleSkeletons( outVisibleObjects, prevNumVisible, request.casterPass, threadIdx );
+
+        if( mRenderQueue->getRenderQueueMode(i) == RenderQueue::FAST && request.addToRenderQueue )
+            addVisibleObjectsToRenderQueue( threadIdx, i, request.casterPass, outVisibleObjects );
+
+        chunkIdx = grabNextCullChunkIdx( threadIdx, chunkIdx );
+    }
+
+    //Sort what we've just added while we're still in parallel;
+    //the main thread will only have to merge the results.
+    if( request.addToRenderQueue )
+        mRenderQueue->_sortThreadQueues( threadIdx, request.firstRq, request.lastRq );
+}
+//-----------------------------------------------------------------------
+void SceneManager::cullFrustumBatch( const CullFrustumBatchEntry *entries, size_t numEntries )
+{
+    OgreProfileGroup( "cullFrustumBatch", OGREPROF_CULLING );
+
+    mCullFrustumBatch.clear();
+
+    if( !mFindVisibleObjects || !numEntries )
+        return;
+
+    mCullFrustumBatch.appendPOD( entries, entries + numEntries );
+
+    if( mCullFrustumBatchResults.size() < numEntries )
+    {
+        mCullFrustumBatchResults.resize( numEntries,
+                                         VisibleObjectsPerThreadArray( mNumWorkerThreads,
+                                                                       VisibleObjectsPerRq() ) );
+    }
+
+    uint8 firstRq = std::numeric_limits<uint8>::max();
+    uint8 lastRq  = 0;
+
+    CullFrustumBatchEntryArray::const_iterator itor = mCullFrustumBatch.begin();
+    CullFrustumBatchEntryArray::const_iterator end  = mCullFrustumBatch.end();
+
+    while( itor != end )
+    {
+        //Update the frustum planes now; see fireCullFrustumThreads
+        itor->camera->getFrustumPlanes();
+        itor->lodCamera->getFrustumPlanes();
+        firstRq = std::min( firstRq, itor->firstRq );
+        lastRq  = std::max( lastRq, itor->lastRq );
+        ++itor;
+    }
+
+    mObjectDataChunks.clear();
+    addObjectDataChunks( mEntitiesMemoryManagerCulledList, firstRq, lastRq );
+    mFixedCullChunks = needsFixedCullChunks( firstRq, lastRq );
+    mRequestType = CULL_FRUSTUM_BATCH;
+    fireWorkerThreadsAndWait();
+}
+//-----------------------------------------------------------------------
+size_t SceneManager::findCullFrustumBatchEntry( const Camera *camera, const Camera *lodCamera,
+                                                uint32 viewportVisibilityMask,
+                                                uint8 firstRq, uint8 lastRq ) const
+{
+    size_t retVal = 0;
+
+    CullFrustumBatchEntryArray::const_iterator itor = mCullFrustumBatch.begin();
+    CullFrustumBatchEntryArray::const_iterator end  = mCullFrustumBatch.end();
+
+    while( itor != end &&
+           !(itor->camera == camera && itor->lodCamera == lodCamera &&
+             itor->viewportVisibilityMask == viewportVisibilityMask &&
+             itor->firstRq == firstRq && itor->lastRq == lastRq) )
+    {
+        ++retVal;
+        ++itor;
+    }
+
+    return retVal;
+}
+//-----------------------------------------------------------------------
+void SceneManager::cullFrustumBatchThread( size_t threadIdx )
+{
+    OgreTimelineScope( "cullFrustumBatchThread", threadIdx + 1u );
+
+    const size_t numEntries = mCullFrustumBatch.size();
+
+    for( size_t i=0; i<numEntries; ++i )
+    {
+        VisibleObjectsPerRq &visibleObjectsPerRq = mCullFrustumBatchResults[i][threadIdx];
         visibleObjectsPerRq.resize( 255 );
         VisibleObjectsPerRq::iterator itor = visibleObjectsPerRq.begin();
         VisibleObjectsPerRq::iterator end  = visibleObjectsPerRq.end();
@@ -2139,71 +2572,99 @@ void SceneManager::cullFrustum( const CullFrustumRequest &request, size_t thread
         }
     }
 
-    const Camera *camera    = request.camera;
-    const Camera *lodCamera = request.lodCamera;
-    ObjectMemoryManagerVec::const_iterator it = request.objectMemManager->begin();
-    ObjectMemoryManagerVec::const_iterator en = request.objectMemManager->end();
+    //Only the entries that want the render queue of the current chunk.
+    CullFrustumBatchScratch &scratch = mCullFrustumBatchScratchPerThread[threadIdx];
+    FastArray<const Camera*> &cameras = scratch.cameras;
+    FastArray<const Camera*> &lodCameras = scratch.lodCameras;
+    FastArray<uint32> &visibilityFlags = scratch.visibilityFlags;
+    FastArray<MovableObject::MovableObjectArray*> &outVisibleObjects = scratch.outVisibleObjects;
+    cameras.reserve( numEntries );
+    lodCameras.reserve( numEntries );
+    visibilityFlags.reserve( numEntries );
+    outVisibleObjects.reserve( numEntries );
 
-    while( it != en )
+    size_t chunkIdx = grabNextCullChunkIdx( threadIdx, std::numeric_limits<size_t>::max() );
+
+    while( chunkIdx < mObjectDataChunks.size() )
     {
-        ObjectMemoryManager *memoryManager = *it;
-        const size_t numRenderQueues = memoryManager->getNumRenderQueues();
+        const ObjectDataChunk &chunk = mObjectDataChunks[chunkIdx];
+        const size_t rqId = chunk.renderQueue;
 
-        size_t firstRq = std::min<size_t>( request.firstRq, numRenderQueues );
-        size_t lastRq  = std::min<size_t>( request.lastRq,  numRenderQueues );
+        cameras.clear();
+        lodCameras.clear();
+        visibilityFlags.clear();
+        outVisibleObjects.clear();
 
-        for( size_t i=firstRq; i<lastRq; ++i )
+        for( size_t i=0; i<numEntries; ++i )
         {
-            MovableObject::MovableObjectArray &outVisibleObjects = *(visibleObjectsPerRq.begin() + i);
+            const CullFrustumBatchEntry &entry = mCullFrustumBatch[i];
+            if( rqId >= entry.firstRq && rqId < entry.lastRq )
+            {
+                cameras.push_back( entry.camera );
+                lodCameras.push_back( entry.lodCamera );
+                visibilityFlags.push_back( (entry.viewportVisibilityMask & getVisibilityMask()) |
+                                           (entry.viewportVisibilityMask &
+                                            ~VisibilityFlags::RESERVED_VISIBILITY_FLAGS) );
+                outVisibleObjects.push_back( &mCullFrustumBatchResults[i][threadIdx][rqId] );
+            }
+        }
+
+        for( size_t i=0; i<cameras.size(); i += MovableObject::MAX_FRUSTUMS_PER_BATCH )
+        {
+            const size_t numFrustums = std::min( cameras.size() - i,
+                                                 MovableObject::MAX_FRUSTUMS_PER_BATCH );
 
             ObjectData objData;
-            const size_t totalObjs = memoryManager->getFirstObjectData( objData, i );
+            chunk.objectMemManager->getFirstObjectData( objData, rqId );
+            objData.advancePack( chunk.firstPack );
+
+            MovableObject::cullFrustumBatch( chunk.numObjs, objData, cameras.begin() + i,
+                                             lodCameras.begin() + i, visibilityFlags.begin() + i,
+                                             numFrustums, outVisibleObjects.begin() + i,
+                                             chunk.objectMemManager->_getPackClusters( rqId ),
+                                             chunk.firstPack );
+        }
 
-            //Distribute the work evenly across all threads (not perfect), taking into
-            //account we need to distribute in multiples of ARRAY_PACKED_REALS
-            size_t numObjs  = ( totalObjs + (mNumWorkerThreads-1) ) / mNumWorkerThreads;
-            numObjs         = ( (numObjs + ARRAY_PACKED_REALS - 1) / ARRAY_PACKED_REALS ) *
-                                ARRAY_PACKED_REALS;
+        chunkIdx = grabNextCullChunkIdx( threadIdx, chunkIdx );
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::collectCullFrustumBatchThread( const CullFrustumRequest &request,
+                                                  size_t threadIdx )
+{
+    OgreTimelineScope( "collectCullFrustumBatchThread", threadIdx + 1u );
 
-            const size_t toAdvance = std::min( threadIdx * numObjs, totalObjs );
+    VisibleObjectsPerRq &visibleObjectsPerRq = resetVisibleObjects( threadIdx );
+    VisibleObjectsPerRq &batchResults = mCullFrustumBatchResults[mCullFrustumBatchIdx][threadIdx];
 
-            //Prevent going out of bounds (usually in the last threadIdx, or
-            //when there are less entities than ARRAY_PACKED_REALS
-            numObjs = std::min( numObjs, totalObjs - toAdvance );
-            objData.advancePack( toAdvance / ARRAY_PACKED_REALS );
+    const Vector3 &cameraPos = request.camera->_getCachedDerivedPosition();
 
-            MovableObject::cullFrustum( numObjs, objData, camera,
-                    (camera->getLastViewport()->getVisibilityMask() & getVisibilityMask()) |
-                    (camera->getLastViewport()->getVisibilityMask() &
-                                        ~VisibilityFlags::RESERVED_VISIBILITY_FLAGS),
-                    outVisibleObjects, lodCamera );
+    for( size_t i=request.firstRq; i<request.lastRq; ++i )
+    {
+        MovableObject::MovableObjectArray &culledObjects = batchResults[i];
+        MovableObject::MovableObjectArray &outVisibleObjects = visibleObjectsPerRq[i];
 
-            if( mRenderQueue->getRenderQueueMode(i) == RenderQueue::FAST && request.addToRenderQueue )
-            {
-                //V2 meshes can be added to the render queue in parallel
-                bool casterPass = request.casterPass;
-                MovableObject::MovableObjectArray::const_iterator itor = outVisibleObjects.begin();
-                MovableObject::MovableObjectArray::const_iterator end  = outVisibleObjects.end();
+        //cullFrustumBatch couldn't do this, as the distance is per camera
+        MovableObject::MovableObjectArray::const_iterator itor = culledObjects.begin();
+        MovableObject::MovableObjectArray::const_iterator end  = culledObjects.end();
+        while( itor != end )
+        {
+            (*itor)->_updateCachedDistanceToCamera( cameraPos );
+            ++itor;
+        }
 
-                while( itor != end )
-                {
-                    RenderableArray::const_iterator itRend = (*itor)->mRenderables.begin();
-                    RenderableArray::const_iterator enRend = (*itor)->mRenderables.end();
+        outVisibleObjects.swap( culledObjects );
+        notifyVisibleSkeletons( outVisibleObjects, 0, request.casterPass, threadIdx );
 
-                    while( itRend != enRend )
-                    {
-                        mRenderQueue->addRenderableV2( threadIdx, i, casterPass, *itRend, *itor );
-                        ++itRend;
-                    }
-                    ++itor;
-                }
-
-                outVisibleObjects.clear();
-            }
+        if( mRenderQueue->getRenderQueueMode(i) == RenderQueue::FAST && request.addToRenderQueue )
+        {
+            addVisibleObjectsToRenderQueue( threadIdx, static_cast<uint8>( i ),
+                                            request.casterPass, outVisibleObjects );
         }
-
-        ++it;
     }
+
+    if( request.addToRenderQueue )
+        mRenderQueue->_sortThreadQueues( threadIdx, request.firstRq, request.lastRq );
 }
 //-----------------------------------------------------------------------
 inline bool OrderLightByShadowCastThenId( const Light *_l, const Light *_r )
@@ -2431,6 +2892,8 @@ void SceneManager::buildLightList()
 void SceneManager::buildLightListThread01( const BuildLightListRequest &buildLightListRequest,
                                            size_t threadIdx )
 {
+    OgreTimelineScope( "buildLightListThread01", threadIdx + 1u );
+
     LightArray &outVisibleLights = *(mGlobalLightListPerThread.begin() + threadIdx);
     outVisibleLights.clear();
 
@@ -2483,6 +2946,8 @@ void SceneManager::buildLightListThread01( const BuildLightListRequest &buildLig
 //-----------------------------------------------------------------------
 void SceneManager::buildLightListThread02( size_t threadIdx )
 {
+    OgreTimelineScope( "buildLightListThread02", threadIdx + 1u );
+
     //Global light list built. Now build a per-movable object light list
     ObjectMemoryManagerVec::const_iterator it = mEntitiesMemoryManagerCulledList.begin();
     ObjectMemoryManagerVec::const_iterator en = mEntitiesMemoryManagerCulledList.end();
@@ -2525,6 +2990,13 @@ void SceneManager::highLevelCull()
     mSkeletonAnimManagerCulledList.clear();
     mTagPointNodeMemoryManagerUpdateList.clear();
 
+    if( mStaticMinDepthLevelDirty < mNodeMemoryManager[SCENE_STATIC].getNumDepths() )
+    {
+        //Nodes have changed. Update them before the dynamic ones,
+        //since dynamic nodes may have static parents.
+        mNodeMemoryManagerUpdateList.push_back( &mNodeMemoryManager[SCENE_STATIC] );
+    }
+
     mNodeMemoryManagerUpdateList.push_back( &mNodeMemoryManager[SCENE_DYNAMIC] );
     mEntitiesMemoryManagerCulledList.push_back( &mEntityMemoryManager[SCENE_DYNAMIC] );
     mEntitiesMemoryManagerCulledList.push_back( &mEntityMemoryManager[SCENE_STATIC] );
@@ -2539,15 +3011,12 @@ void SceneManager::highLevelCull()
         mEntitiesMemoryManagerUpdateList.push_back( &mEntityMemoryManager[SCENE_STATIC] );
     }
 
-    if( mStaticMinDepthLevelDirty < mNodeMemoryManager[SCENE_STATIC].getNumDepths() )
-    {
-        //Nodes have changed
-        mNodeMemoryManagerUpdateList.push_back( &mNodeMemoryManager[SCENE_STATIC] );
-    }
 }
 //-----------------------------------------------------------------------
 void SceneManager::updateSceneGraph()
 {
+    OgreTimelineScope( "updateSceneGraph", 0 );
+
     //TODO: Enable auto tracking again, first manually update the tracked scene nodes for correct math. (dark_sylinc)
     // Update scene graph for this camera (can happen multiple times per frame)
     /*{
@@ -2567,17 +3036,29 @@ void SceneManager::updateSceneGraph()
     // Update controllers 
     ControllerManager::getSingleton().updateAllControllers();
 
+    //Results from cullFrustumBatch are stale once objects move
+    mCullFrustumBatch.clear();
+
     highLevelCull();
     _applySceneAnimations();
     updateAllTransforms();
     updateAllAnimations();
     updateAllTagPoints();
+    updateAllParticleSystems();
 #ifdef OGRE_LEGACY_ANIMATIONS
     updateInstanceManagerAnimations();
 #endif
     updateInstanceManagers();
-    updateAllBounds( mEntitiesMemoryManagerUpdateList );
-    updateAllBounds( mLightsMemoryManagerCulledList );
+    {
+        //Entities and lights don't depend on each other; update them
+        //all in the same request so threads don't wait in between.
+        mObjectDataChunks.clear();
+        addObjectDataChunks( mEntitiesMemoryManagerUpdateList, 0, std::numeric_limits<size_t>::max() );
+        addObjectDataChunks( mLightsMemoryManagerCulledList, 0, std::numeric_limits<size_t>::max() );
+        mRequestType = UPDATE_ALL_BOUNDS;
+        fireWorkerThreadsAndWait();
+    }
+    mEntityMemoryManager[SCENE_STATIC]._updatePackClusters( mStaticEntitiesDirty );
 
     {
         // Auto-track nodes
@@ -4441,6 +4922,8 @@ void SceneManager::updateInstanceManagerAnimations(void)
 //---------------------------------------------------------------------
 void SceneManager::updateInstanceManagersThread( size_t threadIdx )
 {
+    OgreTimelineScope( "updateInstanceManagersThread", threadIdx + 1u );
+
     InstanceManagerVec::const_iterator itor = mInstanceManagers.begin();
     InstanceManagerVec::const_iterator end  = mInstanceManagers.end();
 
@@ -5042,6 +5525,7 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
 }
 void SceneManager::fireWorkerThreadsAndWait(void)
 {
+    mNextChunkIdx = 0;
 #if OGRE_PLATFORM == OGRE_PLATFORM_EMSCRIPTEN
     _updateWorkerThread( NULL );
 #else
@@ -5060,7 +5544,12 @@ void SceneManager::fireCullFrustumThreads( const CullFrustumRequest &request )
     //in case they weren't up to date.
     mCurrentCullFrustumRequest.camera->getFrustumPlanes();
     mCurrentCullFrustumRequest.lodCamera->getFrustumPlanes();
+    mObjectDataChunks.clear();
+    addObjectDataChunks( *request.objectMemManager, request.firstRq, request.lastRq );
+    mFixedCullChunks = request.addToRenderQueue &&
+                       needsFixedCullChunks( request.firstRq, request.lastRq );
     fireWorkerThreadsAndWait();
+    applyVisibleSkeletons();
 }
 //---------------------------------------------------------------------
 void SceneManager::fireCullFrustumInstanceBatchThreads( const InstanceBatchCullRequest &request )
@@ -5086,6 +5575,14 @@ void SceneManager::executeUserScalableTask( UniformScalableTask *task, bool bBlo
 #endif
 }
 //---------------------------------------------------------------------
+void SceneManager::executeUserChunkedTask( ChunkedTask *task )
+{
+    mRequestType        = USER_CHUNKED_TASK;
+    mUserChunkedTask    = task;
+    mNumUserChunks      = task->getNumChunks();
+    fireWorkerThreadsAndWait();
+}
+//---------------------------------------------------------------------
 void SceneManager::waitForPendingUserScalableTask()
 {
 #if OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
@@ -5132,6 +5629,7 @@ unsigned long SceneManager::_updateWorkerThread( ThreadHandle *threadHandle )
 #if OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
     bool exitThread = false;
     size_t threadIdx = threadHandle->getThreadIdx();
+    TimelineProfiler::setCurrentThreadTrack( threadIdx + 1u );
     while( !exitThread )
     {
         mWorkerThreadsBarrier->sync();
@@ -5144,6 +5642,12 @@ unsigned long SceneManager::_updateWorkerThread( ThreadHandle *threadHandle )
         case CULL_FRUSTUM:
             cullFrustum( mCurrentCullFrustumRequest, threadIdx );
             break;
+        case CULL_FRUSTUM_BATCH:
+            cullFrustumBatchThread( threadIdx );
+            break;
+        case COLLECT_CULL_FRUSTUM_BATCH:
+            collectCullFrustumBatchThread( mCurrentCullFrustumRequest, threadIdx );
+            break;
         case UPDATE_ALL_ANIMATIONS:
             updateAllAnimationsThread( threadIdx );
             break;
@@ -5157,7 +5661,7 @@ unsigned long SceneManager::_updateWorkerThread( ThreadHandle *threadHandle )
             updateAllTransformsTagOnTagThread( mUpdateTransformRequest, threadIdx );
             break;
         case UPDATE_ALL_BOUNDS:
-            updateAllBoundsThread( *mUpdateBoundsRequest, threadIdx );
+            updateAllBoundsThread( threadIdx );
             break;
         case UPDATE_ALL_LODS:
             updateAllLodsThread( mUpdateLodRequest, threadIdx );
@@ -5172,7 +5676,33 @@ unsigned long SceneManager::_updateWorkerThread( ThreadHandle *threadHandle )
             buildLightListThread02( threadIdx );
             break;
         case USER_UNIFORM_SCALABLE_TASK:
-            mUserTask->execute( threadIdx, mNumWorkerThreads );
+            {
+                OgreTimelineScope( "UniformScalableTask", threadIdx + 1u );
+                mUserTask->execute( threadIdx, mNumWorkerThreads );
+            }
+            break;
+        case USER_CHUNKED_TASK:
+            {
+                OgreTimelineScope( "ChunkedTask", threadIdx + 1u );
+                size_t chunkIdx = grabNextChunkIdx();
+                while( chunkIdx < mNumUserChunks )
+                {
+                    mUserChunkedTask->executeChunk( chunkIdx, threadIdx );
+                    chunkIdx = grabNextChunkIdx();
+                }
+            }
+            break;
+        case RASTERIZE_OCCLUDERS:
+            {
+                OgreTimelineScope( "rasterizeOccluders", threadIdx + 1u );
+                const size_t numTiles = mSoftwareOcclusionCuller->_getNumTiles();
+                size_t tileIdx = grabNextChunkIdx();
+                while( tileIdx < numTiles )
+                {
+                    mSoftwareOcclusionCuller->_rasterizeTile( tileIdx );
+                    tileIdx = grabNextChunkIdx();
+                }
+            }
             break;
         case STOP_THREADS:
             exitThread = true;
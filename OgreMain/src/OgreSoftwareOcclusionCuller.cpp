@@ -0,0 +1,434 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "OgreSoftwareOcclusionCuller.h"
+#include "OgreCamera.h"
+
+#include "Math/Array/OgreMathlib.h"
+#include "Math/Array/OgreBooleanMask.h"
+
+namespace Ogre
+{
+    const uint32 SoftwareOcclusionCuller::TILE_WIDTH    = 32;
+    const uint32 SoftwareOcclusionCuller::TILE_HEIGHT   = 32;
+
+    /// Vertices with a smaller w are considered to be behind the camera.
+    static const Real c_minW = 1e-5f;
+
+    SoftwareOcclusionCuller::SoftwareOcclusionCuller( uint32 width, uint32 height ) :
+        mWidth( static_cast<uint32>( alignToNextMultiple( std::max( width, 1u ), TILE_WIDTH ) ) ),
+        mHeight( static_cast<uint32>( alignToNextMultiple( std::max( height, 1u ), TILE_HEIGHT ) ) ),
+        mNumTilesX( 0 ),
+        mNumTilesY( 0 ),
+        mDepthBuffer( 0 ),
+        mViewProjMatrix( Matrix4::IDENTITY )
+    {
+        assert( TILE_WIDTH % ARRAY_PACKED_REALS == 0 );
+
+        mNumTilesX = mWidth / TILE_WIDTH;
+        mNumTilesY = mHeight / TILE_HEIGHT;
+        mTileBins.resize( mNumTilesX * mNumTilesY );
+
+        mDepthBuffer = reinterpret_cast<Real*>( OGRE_MALLOC_SIMD( mWidth * mHeight * sizeof(Real),
+                                                                  MEMCATEGORY_SCENE_CONTROL ) );
+        std::fill( mDepthBuffer, mDepthBuffer + mWidth * mHeight,
+                   std::numeric_limits<Real>::max() );
+    }
+    //-----------------------------------------------------------------------------------
+    SoftwareOcclusionCuller::~SoftwareOcclusionCuller()
+    {
+        OGRE_FREE_SIMD( mDepthBuffer, MEMCATEGORY_SCENE_CONTROL );
+        mDepthBuffer = 0;
+    }
+    //-----------------------------------------------------------------------------------
+    void SoftwareOcclusionCuller::addOccluder( const MovableObject *movableObject,
+                                               const Vector3 *vertices, size_t numVertices,
+                                               const uint32 *indices, size_t numIndices )
+    {
+        assert( numIndices % 3 == 0 && "Occluders must be triangle lists" );
+
+        mOccluders.push_back( Occluder() );
+        Occluder &occluder = mOccluders.back();
+        occluder.movableObject = movableObject;
+        occluder.vertices.assign( vertices, vertices + numVertices );
+        occluder.indices.assign( indices, indices + numIndices - numIndices % 3 );
+
+#if OGRE_DEBUG_MODE
+        for( size_t i=0; i<occluder.indices.size(); ++i )
+            assert( occluder.indices[i] < numVertices && "Occluder index out of bounds" );
+#endif
+    }
+    //-----------------------------------------------------------------------------------
+    void SoftwareOcclusionCuller::removeOccluder( const MovableObject *movableObject )
+    {
+        OccluderVec::iterator itor = mOccluders.begin();
+
+        while( itor != mOccluders.end() )
+        {
+            if( itor->movableObject == movableObject )
+                itor = efficientVectorRemove( mOccluders, itor );
+            else
+                ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void SoftwareOcclusionCuller::removeAllOccluders(void)
+    {
+        mOccluders.clear();
+    }
+    //-----------------------------------------------------------------------------------
+    bool SoftwareOcclusionCuller::_prepare( const Camera *camera )
+    {
+        mViewProjMatrix = camera->getProjectionMatrix() * camera->getViewMatrix();
+
+        mTriangles.clear();
+        FastArray<TriangleIndexArray>::iterator itBin = mTileBins.begin();
+        FastArray<TriangleIndexArray>::iterator enBin = mTileBins.end();
+        while( itBin != enBin )
+        {
+            itBin->clear();
+            ++itBin;
+        }
+
+        OccluderVec::const_iterator itor = mOccluders.begin();
+        OccluderVec::const_iterator end  = mOccluders.end();
+
+        while( itor != end )
+        {
+            if( itor->movableObject->isAttached() && itor->movableObject->getVisible() )
+                transformAndBinOccluder( *itor );
+            ++itor;
+        }
+
+        return !mTriangles.empty();
+    }
+    //-----------------------------------------------------------------------------------
+    void SoftwareOcclusionCuller::transformAndBinOccluder( const Occluder &occluder )
+    {
+        const Matrix4 worldViewProj = mViewProjMatrix *
+                                      occluder.movableObject->_getParentNodeFullTransform();
+
+        const Real halfWidth  = mWidth * 0.5f;
+        const Real halfHeight = mHeight * 0.5f;
+
+        mScreenVertices.resize( occluder.vertices.size() );
+
+        for( size_t i=0; i<occluder.vertices.size(); ++i )
+        {
+            const Vector4 clipPos = worldViewProj * Vector4( occluder.vertices[i] );
+            Vector4 &screenPos = mScreenVertices[i];
+            screenPos.w = clipPos.w;
+
+            if( clipPos.w > c_minW )
+            {
+                const Real invW = 1.0f / clipPos.w;
+                screenPos.x = (clipPos.x * invW + 1.0f) * halfWidth;
+                screenPos.y = (1.0f - clipPos.y * invW) * halfHeight;
+                screenPos.z = clipPos.z * invW;
+            }
+        }
+
+        const size_t numIndices = occluder.indices.size();
+        for( size_t i=0; i<numIndices; i += 3 )
+        {
+            const Vector4 *v0 = &mScreenVertices[occluder.indices[i+0]];
+            const Vector4 *v1 = &mScreenVertices[occluder.indices[i+1]];
+            const Vector4 *v2 = &mScreenVertices[occluder.indices[i+2]];
+
+            //Triangles crossing the near plane are skipped. This is conservative:
+            //we just lose a bit of occlusion, but never hide something visible.
+            if( v0->w <= c_minW || v1->w <= c_minW || v2->w <= c_minW )
+                continue;
+
+            Real area = (v1->x - v0->x) * (v2->y - v0->y) - (v2->x - v0->x) * (v1->y - v0->y);
+
+            if( Math::Abs( area ) < 1e-6f )
+                continue;
+
+            //Rasterize both windings
+            if( area < 0 )
+            {
+                std::swap( v1, v2 );
+                area = -area;
+            }
+
+            const Real minXf = Math::Clamp( std::min( std::min( v0->x, v1->x ), v2->x ),
+                                            Real( 0 ), Real( mWidth ) );
+            const Real maxXf = Math::Clamp( std::max( std::max( v0->x, v1->x ), v2->x ),
+                                            Real( 0 ), Real( mWidth ) );
+            const Real minYf = Math::Clamp( std::min( std::min( v0->y, v1->y ), v2->y ),
+                                            Real( 0 ), Real( mHeight ) );
+            const Real maxYf = Math::Clamp( std::max( std::max( v0->y, v1->y ), v2->y ),
+                                            Real( 0 ), Real( mHeight ) );
+
+            ScreenTriangle tri;
+            tri.minX = static_cast<uint32>( Math::Floor( minXf ) );
+            tri.maxX = static_cast<uint32>( Math::Ceil( maxXf ) );
+            tri.minY = static_cast<uint32>( Math::Floor( minYf ) );
+            tri.maxY = static_cast<uint32>( Math::Ceil( maxYf ) );
+
+            if( tri.minX >= tri.maxX || tri.minY >= tri.maxY )
+                continue;
+
+            //Edge function of the edge from a to b, for the
+            //edges opposite to v2, v0 & v1 respectively.
+            const Vector4 *edgeStart[3] = { v0, v1, v2 };
+            const Vector4 *edgeEnd[3]   = { v1, v2, v0 };
+            for( size_t j=0; j<3; ++j )
+            {
+                tri.edgeA[j] = edgeStart[j]->y - edgeEnd[j]->y;
+                tri.edgeB[j] = edgeEnd[j]->x - edgeStart[j]->x;
+                tri.edgeC[j] = -(tri.edgeA[j] * edgeStart[j]->x + tri.edgeB[j] * edgeStart[j]->y);
+            }
+
+            //Barycentric weights of v0, v1, v2 are edge[1], edge[2], edge[0] over area
+            const Real invArea = 1.0f / area;
+            tri.depthA = (tri.edgeA[1] * v0->z + tri.edgeA[2] * v1->z + tri.edgeA[0] * v2->z) * invArea;
+            tri.depthB = (tri.edgeB[1] * v0->z + tri.edgeB[2] * v1->z + tri.edgeB[0] * v2->z) * invArea;
+            tri.depthC = (tri.edgeC[1] * v0->z + tri.edgeC[2] * v1->z + tri.edgeC[0] * v2->z) * invArea;
+
+            const uint32 triIdx = static_cast<uint32>( mTriangles.size() );
+            mTriangles.push_back( tri );
+
+            const uint32 firstTileX = tri.minX / TILE_WIDTH;
+            const uint32 lastTileX  = (tri.maxX - 1u) / TILE_WIDTH;
+            const uint32 firstTileY = tri.minY / TILE_HEIGHT;
+            const uint32 lastTileY  = (tri.maxY - 1u) / TILE_HEIGHT;
+
+            for( uint32 y=firstTileY; y<=lastTileY; ++y )
+            {
+                for( uint32 x=firstTileX; x<=lastTileX; ++x )
+                    mTileBins[y * mNumTilesX + x].push_back( triIdx );
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void SoftwareOcclusionCuller::_rasterizeTile( size_t tileIdx )
+    {
+        const uint32 tileX = static_cast<uint32>( tileIdx % mNumTilesX ) * TILE_WIDTH;
+        const uint32 tileY = static_cast<uint32>( tileIdx / mNumTilesX ) * TILE_HEIGHT;
+
+        //Clear the tile
+        const ArrayReal farDepth = Mathlib::SetAll( std::numeric_limits<Real>::max() );
+        for( uint32 y=tileY; y<tileY + TILE_HEIGHT; ++y )
+        {
+            ArrayReal * RESTRICT_ALIAS depthRow = reinterpret_cast<ArrayReal*RESTRICT_ALIAS>(
+                                                        mDepthBuffer + y * mWidth + tileX );
+            for( uint32 x=0; x<TILE_WIDTH; x += ARRAY_PACKED_REALS )
+                *depthRow++ = farDepth;
+        }
+
+        //Offsets of the center of each pixel in a pack
+        OGRE_ALIGNED_DECL( Real, laneOffsets[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+        for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+            laneOffsets[i] = i + 0.5f;
+        const ArrayReal pixelCenterOffsets = *reinterpret_cast<const ArrayReal*>( laneOffsets );
+
+        const ArrayReal zero = Mathlib::SetAll( 0.0f );
+
+        //Occluders must be rasterized conservatively: a pixel is only written if the
+        //triangle covers it entirely (inner coverage), and with the farthest depth the
+        //triangle has inside that pixel. Otherwise a partially covered pixel, or the
+        //closer half of a covered one, could hide objects that are actually visible.
+        const TriangleIndexArray &bin = mTileBins[tileIdx];
+        TriangleIndexArray::const_iterator itor = bin.begin();
+        TriangleIndexArray::const_iterator end  = bin.end();
+
+        while( itor != end )
+        {
+            const ScreenTriangle &tri = mTriangles[*itor];
+
+            //tileX is a multiple of ARRAY_PACKED_REALS, so is startX; and
+            //we never write outside the tile.
+            uint32 startX = std::max( tri.minX, tileX );
+            startX -= startX % ARRAY_PACKED_REALS;
+            const uint32 endX   = std::min( tri.maxX, tileX + TILE_WIDTH );
+            const uint32 startY = std::max( tri.minY, tileY );
+            const uint32 endY   = std::min( tri.maxY, tileY + TILE_HEIGHT );
+
+            const ArrayReal edgeA0 = Mathlib::SetAll( tri.edgeA[0] );
+            const ArrayReal edgeA1 = Mathlib::SetAll( tri.edgeA[1] );
+            const ArrayReal edgeA2 = Mathlib::SetAll( tri.edgeA[2] );
+            const ArrayReal depthA = Mathlib::SetAll( tri.depthA );
+
+            //Evaluated at the pixel center, the edge functions are at most
+            //0.5 * (|A| + |B|) bigger than at the pixel's worst corner. Same with the
+            //depth plane, but we want its biggest value (the farthest corner).
+            Real innerBias[3];
+            for( size_t j=0; j<3; ++j )
+                innerBias[j] = 0.5f * (Math::Abs( tri.edgeA[j] ) + Math::Abs( tri.edgeB[j] ));
+            const Real farBias = 0.5f * (Math::Abs( tri.depthA ) + Math::Abs( tri.depthB ));
+
+            for( uint32 y=startY; y<endY; ++y )
+            {
+                const Real pixelY = y + 0.5f;
+                const ArrayReal rowEdge0 = Mathlib::SetAll( tri.edgeB[0] * pixelY + tri.edgeC[0] -
+                                                            innerBias[0] );
+                const ArrayReal rowEdge1 = Mathlib::SetAll( tri.edgeB[1] * pixelY + tri.edgeC[1] -
+                                                            innerBias[1] );
+                const ArrayReal rowEdge2 = Mathlib::SetAll( tri.edgeB[2] * pixelY + tri.edgeC[2] -
+                                                            innerBias[2] );
+                const ArrayReal rowDepth = Mathlib::SetAll( tri.depthB * pixelY + tri.depthC +
+                                                            farBias );
+
+                ArrayReal * RESTRICT_ALIAS depthRow = reinterpret_cast<ArrayReal*RESTRICT_ALIAS>(
+                                                            mDepthBuffer + y * mWidth + startX );
+
+                for( uint32 x=startX; x<endX; x += ARRAY_PACKED_REALS )
+                {
+                    const ArrayReal pixelX = Mathlib::SetAll( Real( x ) ) + pixelCenterOffsets;
+
+                    ArrayMaskR inside = Mathlib::CompareGreaterEqual( edgeA0 * pixelX + rowEdge0, zero );
+                    inside = Mathlib::And( inside, Mathlib::CompareGreaterEqual(
+                                                        edgeA1 * pixelX + rowEdge1, zero ) );
+                    inside = Mathlib::And( inside, Mathlib::CompareGreaterEqual(
+                                                        edgeA2 * pixelX + rowEdge2, zero ) );
+
+                    const ArrayReal depth = depthA * pixelX + rowDepth;
+                    *depthRow = Mathlib::CmovRobust( Mathlib::Min( *depthRow, depth ),
+                                                     *depthRow, inside );
+                    ++depthRow;
+                }
+            }
+
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    bool SoftwareOcclusionCuller::isOccluded( const Aabb &worldAabb ) const
+    {
+        const Real infinity = std::numeric_limits<Real>::infinity();
+        if( worldAabb.mHalfSize.x == infinity || worldAabb.mHalfSize.y == infinity ||
+            worldAabb.mHalfSize.z == infinity )
+        {
+            return false;
+        }
+
+        const Vector3 minimum = worldAabb.getMinimum();
+        const Vector3 maximum = worldAabb.getMaximum();
+
+        Real minX = std::numeric_limits<Real>::max();
+        Real minY = std::numeric_limits<Real>::max();
+        Real maxX = -std::numeric_limits<Real>::max();
+        Real maxY = -std::numeric_limits<Real>::max();
+        Real minZ = std::numeric_limits<Real>::max();
+
+        const Real halfWidth  = mWidth * 0.5f;
+        const Real halfHeight = mHeight * 0.5f;
+
+        for( size_t i=0; i<8; ++i )
+        {
+            const Vector3 corner( (i & 1) ? maximum.x : minimum.x,
+                                  (i & 2) ? maximum.y : minimum.y,
+                                  (i & 4) ? maximum.z : minimum.z );
+            const Vector4 clipPos = mViewProjMatrix * Vector4( corner );
+
+            //Crosses the near plane. We can't tell.
+            if( clipPos.w <= c_minW )
+                return false;
+
+            const Real invW = 1.0f / clipPos.w;
+            const Real screenX = (clipPos.x * invW + 1.0f) * halfWidth;
+            const Real screenY = (1.0f - clipPos.y * invW) * halfHeight;
+            minX = std::min( minX, screenX );
+            maxX = std::max( maxX, screenX );
+            minY = std::min( minY, screenY );
+            maxY = std::max( maxY, screenY );
+            minZ = std::min( minZ, clipPos.z * invW );
+        }
+
+        //Outer coverage: every pixel the box touches, even partially, must be
+        //covered by an occluder that is closer than the closest point of the box
+        const uint32 startX = static_cast<uint32>( Math::Floor( Math::Clamp( minX, Real( 0 ),
+                                                                             Real( mWidth ) ) ) );
+        const uint32 endX   = static_cast<uint32>( Math::Ceil( Math::Clamp( maxX, Real( 0 ),
+                                                                            Real( mWidth ) ) ) );
+        const uint32 startY = static_cast<uint32>( Math::Floor( Math::Clamp( minY, Real( 0 ),
+                                                                             Real( mHeight ) ) ) );
+        const uint32 endY   = static_cast<uint32>( Math::Ceil( Math::Clamp( maxY, Real( 0 ),
+                                                                            Real( mHeight ) ) ) );
+
+        //Outside the screen; that's frustum culling's business.
+        if( startX >= endX || startY >= endY )
+            return false;
+
+        OGRE_ALIGNED_DECL( Real, laneOffsets[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+        for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+            laneOffsets[i] = static_cast<Real>( i );
+        const ArrayReal pixelOffsets = *reinterpret_cast<const ArrayReal*>( laneOffsets );
+
+        const ArrayReal objectDepth = Mathlib::SetAll( minZ );
+        const ArrayReal rangeStart  = Mathlib::SetAll( Real( startX ) );
+        const ArrayReal rangeEnd    = Mathlib::SetAll( Real( endX ) );
+        const uint32 alignedStartX  = startX - startX % ARRAY_PACKED_REALS;
+
+        for( uint32 y=startY; y<endY; ++y )
+        {
+            const ArrayReal * RESTRICT_ALIAS depthRow = reinterpret_cast<const ArrayReal*RESTRICT_ALIAS>(
+                                                            mDepthBuffer + y * mWidth + alignedStartX );
+
+            for( uint32 x=alignedStartX; x<endX; x += ARRAY_PACKED_REALS )
+            {
+                const ArrayReal pixelX = Mathlib::SetAll( Real( x ) ) + pixelOffsets;
+                const ArrayMaskR inRange = Mathlib::And(
+                                                Mathlib::CompareGreaterEqual( pixelX, rangeStart ),
+                                                Mathlib::CompareLess( pixelX, rangeEnd ) );
+
+                //Visible if the closest occluder isn't in front of the closest point of the box
+                const ArrayMaskR visible = Mathlib::And(
+                                                Mathlib::CompareGreaterEqual( *depthRow, objectDepth ),
+                                                inRange );
+
+                if( BooleanMask4::getScalarMask( visible ) )
+                    return false;
+
+                ++depthRow;
+            }
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------------------
+    void SoftwareOcclusionCuller::_cullOccluded( MovableObject::MovableObjectArray &inOutObjects,
+                                                 size_t firstIdx ) const
+    {
+        size_t numVisible = firstIdx;
+
+        const size_t numObjects = inOutObjects.size();
+        for( size_t i=firstIdx; i<numObjects; ++i )
+        {
+            MovableObject *movableObject = inOutObjects[i];
+            if( !isOccluded( movableObject->getWorldAabb() ) )
+                inOutObjects[numVisible++] = movableObject;
+        }
+
+        inOutObjects.resize( numVisible );
+    }
+}
@@ -0,0 +1,208 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "OgreTimelineProfiler.h"
+#include "OgreTimer.h"
+#include "OgreBitwise.h"
+#include "OgreStringConverter.h"
+
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC
+    #define OGRE_TIMELINE_THREAD_LOCAL __declspec( thread )
+#else
+    #define OGRE_TIMELINE_THREAD_LOCAL __thread
+#endif
+
+namespace Ogre
+{
+    const size_t TimelineProfiler::CurrentThreadTrack = ~static_cast<size_t>( 0 );
+
+    /// Track of the calling thread. Must be POD and not exported, to be thread local in C++98.
+    static OGRE_TIMELINE_THREAD_LOCAL size_t gCurrentThreadTrack = ~static_cast<size_t>( 0 );
+
+    /// Writes str as the contents of a JSON string, escaping what needs to be escaped.
+    static void writeJsonString( StringStream &stream, const char *str )
+    {
+        while( *str )
+        {
+            const unsigned char c = static_cast<unsigned char>( *str );
+            if( c == '"' || c == '\\' )
+            {
+                stream << '\\' << *str;
+            }
+            else if( c < 0x20 )
+            {
+                //Control characters must be written as \u00XX
+                const char *hexDigits = "0123456789abcdef";
+                stream << "\\u00" << hexDigits[c >> 4u] << hexDigits[c & 0x0Fu];
+            }
+            else
+            {
+                stream << *str;
+            }
+            ++str;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    bool TimelineProfiler::msEnabled = false;
+    TimelineProfiler::Track *TimelineProfiler::msTracks = 0;
+    size_t TimelineProfiler::msNumTracks = 0;
+
+    //-----------------------------------------------------------------------------------
+    void TimelineProfiler::destroyTracks(void)
+    {
+        for( size_t i=0; i<msNumTracks; ++i )
+        {
+            OGRE_DELETE msTracks[i].timer;
+            OGRE_FREE( msTracks[i].events, MEMCATEGORY_GENERAL );
+        }
+
+        OGRE_DELETE_ARRAY_T( msTracks, Track, msNumTracks, MEMCATEGORY_GENERAL );
+        msTracks = 0;
+        msNumTracks = 0;
+    }
+    //-----------------------------------------------------------------------------------
+    void TimelineProfiler::enable( size_t numTracks, size_t eventsPerTrack )
+    {
+        msEnabled = false;
+        destroyTracks();
+
+        eventsPerTrack = Bitwise::firstPO2From( static_cast<uint32>( std::max<size_t>(
+                                                                        eventsPerTrack, 1u ) ) );
+
+        msTracks = OGRE_NEW_ARRAY_T( Track, numTracks, MEMCATEGORY_GENERAL );
+        msNumTracks = numTracks;
+
+        for( size_t i=0; i<numTracks; ++i )
+        {
+            msTracks[i].timer       = OGRE_NEW Timer();
+            msTracks[i].events      = reinterpret_cast<Event*>( OGRE_MALLOC(
+                                            sizeof(Event) * eventsPerTrack, MEMCATEGORY_GENERAL ) );
+            msTracks[i].mask        = eventsPerTrack - 1u;
+            msTracks[i].numWritten  = 0;
+            msTracks[i].name        = i == 0 ? "Main" :
+                                               "Worker " + StringConverter::toString( i - 1u );
+        }
+
+        setCurrentThreadTrack( 0 );
+
+        //Restart all the timers together so that the timelines are aligned.
+        for( size_t i=0; i<numTracks; ++i )
+            msTracks[i].timer->reset();
+
+        msEnabled = true;
+    }
+    //-----------------------------------------------------------------------------------
+    void TimelineProfiler::disable(void)
+    {
+        msEnabled = false;
+    }
+    //-----------------------------------------------------------------------------------
+    void TimelineProfiler::shutdown(void)
+    {
+        msEnabled = false;
+        destroyTracks();
+    }
+    //-----------------------------------------------------------------------------------
+    void TimelineProfiler::setTrackName( size_t trackIdx, const String &name )
+    {
+        assert( trackIdx < msNumTracks );
+        msTracks[trackIdx].name = name;
+    }
+    //-----------------------------------------------------------------------------------
+    void TimelineProfiler::setCurrentThreadTrack( size_t trackIdx )
+    {
+        gCurrentThreadTrack = trackIdx;
+    }
+    //-----------------------------------------------------------------------------------
+    size_t TimelineProfiler::getCurrentThreadTrack(void)
+    {
+        return gCurrentThreadTrack;
+    }
+    //-----------------------------------------------------------------------------------
+    TimelineProfiler::Track* TimelineProfiler::_getTrack( size_t trackIdx )
+    {
+        if( trackIdx == CurrentThreadTrack )
+            trackIdx = gCurrentThreadTrack;
+        return trackIdx < msNumTracks ? &msTracks[trackIdx] : 0;
+    }
+    //-----------------------------------------------------------------------------------
+    uint64 TimelineProfiler::_getTime( Track *track )
+    {
+        return track->timer->getMicroseconds();
+    }
+    //-----------------------------------------------------------------------------------
+    void TimelineProfiler::_addEvent( Track *track, const char *name, uint64 start )
+    {
+        Event &evt = track->events[track->numWritten & track->mask];
+        evt.name    = name;
+        evt.start   = start;
+        evt.end     = track->timer->getMicroseconds();
+        ++track->numWritten;
+    }
+    //-----------------------------------------------------------------------------------
+    void TimelineProfiler::exportChromeTrace( String &outString )
+    {
+        StringStream stream;
+        stream << "{\"traceEvents\":[";
+
+        bool firstEvent = true;
+
+        for( size_t i=0; i<msNumTracks; ++i )
+        {
+            const Track &track = msTracks[i];
+
+            if( !firstEvent )
+                stream << ",";
+            firstEvent = false;
+
+            stream << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i
+                   << ",\"args\":{\"name\":\"";
+            writeJsonString( stream, track.name.c_str() );
+            stream << "\"}}";
+
+            //Only the last (mask + 1) events are still in the ring buffer.
+            const size_t capacity = track.mask + 1u;
+            const size_t firstIdx = track.numWritten > capacity ? track.numWritten - capacity : 0;
+
+            for( size_t j=firstIdx; j<track.numWritten; ++j )
+            {
+                const Event &evt = track.events[j & track.mask];
+                stream << ",\n{\"name\":\"";
+                writeJsonString( stream, evt.name );
+                stream << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << i
+                       << ",\"ts\":" << evt.start << ",\"dur\":" << (evt.end - evt.start) << "}";
+            }
+        }
+
+        stream << "\n]}\n";
+
+        outString += stream.str();
+    }
+}
@@ -28,6 +28,9 @@ THE SOFTWARE.
 #include "OgreDeflectorPlaneAffector.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+
+#include "Math/Array/OgreArrayVector3.h"
+#include "Math/Array/OgreBooleanMask.h"
 #include "OgreStringConverter.h"
 
 
@@ -64,30 +67,63 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void DeflectorPlaneAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
     {
-        // precalculate distance of plane from origin
-        Real planeDistance = - mPlaneNormal.dotProduct(mPlanePoint) / Math::Sqrt(mPlaneNormal.dotProduct(mPlaneNormal));
-        Vector3 directionPart;
+        const vector<Particle*>::type &particles = pSystem->_getActiveParticles();
+        const size_t numParticles = particles.size();
 
-        ParticleIterator pi = pSystem->_getIterator();
-
-        while (!pi.end())
+        // precalculate distance of plane from origin
+        const ArrayReal planeDistance = Mathlib::SetAll(
+                    - mPlaneNormal.dotProduct(mPlanePoint) / Math::Sqrt(mPlaneNormal.dotProduct(mPlaneNormal)) );
+        ArrayVector3 planeNormal;
+        planeNormal.setAll( mPlaneNormal );
+        const ArrayReal dt      = Mathlib::SetAll( timeElapsed );
+        const ArrayReal bounce  = Mathlib::SetAll( mBounce );
+        const ArrayReal two     = Mathlib::SetAll( 2.0f );
+
+        for( size_t i=0; i<numParticles; i += ARRAY_PACKED_REALS )
         {
-            Particle *p = pi.getNext();
+            Particle * const *block = &particles[i];
+            const size_t numInBlock = std::min<size_t>( numParticles - i, ARRAY_PACKED_REALS );
+
+            // Unused lanes repeat the last particle; they're never written back
+            ArrayVector3 position, direction;
+            for( size_t j=0; j<ARRAY_PACKED_REALS; ++j )
+            {
+                const Particle *p = block[std::min( j, numInBlock - 1u )];
+                position.setFromVector3( p->mPosition, j );
+                direction.setFromVector3( p->mDirection, j );
+            }
 
-            Vector3 direction(p->mDirection * timeElapsed);
-            if (mPlaneNormal.dotProduct(p->mPosition + direction) + planeDistance <= 0.0)
+            const ArrayVector3 step( direction * dt );
+            const ArrayReal b = planeNormal.dotProduct( position + step ) + planeDistance;
+            const ArrayReal a = planeNormal.dotProduct( position ) + planeDistance;
+
+            const ArrayMaskR crossing       = Mathlib::CompareLessEqual( b, ARRAY_REAL_ZERO );
+            const ArrayMaskR wasInFront     = Mathlib::CompareGreater( a, ARRAY_REAL_ZERO );
+
+            if( !BooleanMask4::getScalarMask( crossing ) || !BooleanMask4::getScalarMask( wasInFront ) )
+                continue;
+
+            // for intersection point. Lanes not hitting the plane may divide by
+            // zero, but they're discarded below.
+            const ArrayVector3 directionPart( step * (Mathlib::NEG_ONE * a /
+                                                      step.dotProduct( planeNormal )) );
+            // new position
+            ArrayVector3 newPosition( (position + directionPart) + ((directionPart - step) * bounce) );
+            // reflect direction vector
+            ArrayVector3 newDirection( (direction - planeNormal *
+                                        (two * direction.dotProduct( planeNormal ))) * bounce );
+
+            //newPosition = crossing && wasInFront ? newPosition : position
+            newPosition.Cmov4( crossing, position );
+            newPosition.Cmov4( wasInFront, position );
+            newDirection.Cmov4( crossing, direction );
+            newDirection.Cmov4( wasInFront, direction );
+
+            for( size_t j=0; j<numInBlock; ++j )
             {
-                Real a = mPlaneNormal.dotProduct(p->mPosition) + planeDistance;
-                if (a > 0.0)
-                {
-                    // for intersection point
-                    directionPart = direction * (- a / direction.dotProduct( mPlaneNormal ));
-                    // set new position
-                    p->mPosition = (p->mPosition + ( directionPart )) + (((directionPart) - direction) * mBounce);
-
-                    // reflect direction vector
-                    p->mDirection = (p->mDirection - (2.0f * p->mDirection.dotProduct( mPlaneNormal ) * mPlaneNormal)) * mBounce;
-                }
+                Particle *p = block[j];
+                newPosition.getAsVector3( p->mPosition, j );
+                newDirection.getAsVector3( p->mDirection, j );
             }
         }
     }
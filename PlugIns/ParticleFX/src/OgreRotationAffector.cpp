@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
 
+#include "Math/Array/OgreMathlib.h"
+
 
 namespace Ogre {
     
@@ -88,23 +90,41 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RotationAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
     {
-        ParticleIterator pi = pSystem->_getIterator();
-        Particle *p;
-        Real ds;
+        const vector<Particle*>::type &particles = pSystem->_getActiveParticles();
+        const size_t numParticles = particles.size();
 
         // Rotation adjustments by time
-        ds = timeElapsed;
+        const ArrayReal ds = Mathlib::SetAll( timeElapsed );
 
-        Radian NewRotation;
+        bool anyRotated = false;
 
-        while (!pi.end())
+        for( size_t i=0; i<numParticles; i += ARRAY_PACKED_REALS )
         {
-            p = pi.getNext();
-
-            NewRotation = p->mRotation + (ds * p->mRotationSpeed);
-            p->setRotation( NewRotation );
+            Particle * const *block = &particles[i];
+            const size_t numInBlock = std::min<size_t>( numParticles - i, ARRAY_PACKED_REALS );
+
+            // Unused lanes repeat the last particle; they're never written back
+            ArrayReal rotation, rotationSpeed;
+            for( size_t j=0; j<ARRAY_PACKED_REALS; ++j )
+            {
+                const Particle *p = block[std::min( j, numInBlock - 1u )];
+                reinterpret_cast<Real*>( &rotation )[j]      = p->mRotation.valueRadians();
+                reinterpret_cast<Real*>( &rotationSpeed )[j] = p->mRotationSpeed.valueRadians();
+            }
+
+            rotation = rotation + ds * rotationSpeed;
+
+            for( size_t j=0; j<numInBlock; ++j )
+            {
+                const Real newRotation = reinterpret_cast<const Real*>( &rotation )[j];
+                block[j]->mRotation = Radian( newRotation );
+                anyRotated |= newRotation != 0;
+            }
         }
 
+        // Same as Particle::setRotation, but notified once for the whole system
+        if( anyRotated )
+            pSystem->_notifyParticleRotated();
     }
     //-----------------------------------------------------------------------
     const Radian& RotationAffector::getRotationSpeedRangeStart(void) const
@@ -30,6 +30,9 @@ THE SOFTWARE.
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
 
+#include "Math/Array/OgreMathlib.h"
+#include "Math/Array/OgreBooleanMask.h"
+
 
 namespace Ogre {
     
@@ -56,33 +59,48 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ScaleAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
     {
-        ParticleIterator pi = pSystem->_getIterator();
-        Particle *p;
-        Real ds;
+        const vector<Particle*>::type &particles = pSystem->_getActiveParticles();
+        const size_t numParticles = particles.size();
 
-        // Scale adjustments by time
-        ds = mScaleAdj * timeElapsed;
+        if( !numParticles )
+            return;
 
-        Real NewWide, NewHigh;
+        // Scale adjustments by time
+        const ArrayReal ds = Mathlib::SetAll( mScaleAdj * timeElapsed );
+        const ArrayReal defaultWidth    = Mathlib::SetAll( pSystem->getDefaultWidth() );
+        const ArrayReal defaultHeight   = Mathlib::SetAll( pSystem->getDefaultHeight() );
 
-        while (!pi.end())
+        for( size_t i=0; i<numParticles; i += ARRAY_PACKED_REALS )
         {
-            p = pi.getNext();
+            Particle * const *block = &particles[i];
+            const size_t numInBlock = std::min<size_t>( numParticles - i, ARRAY_PACKED_REALS );
 
-            if( p->hasOwnDimensions() == false )
+            // Unused lanes repeat the last particle; they're never written back
+            ArrayReal width, height;
+            bool ownDimensions[ARRAY_PACKED_REALS];
+            for( size_t j=0; j<ARRAY_PACKED_REALS; ++j )
             {
-                NewWide = pSystem->getDefaultWidth() + ds;
-                NewHigh = pSystem->getDefaultHeight() + ds;
-
+                const Particle *p = block[std::min( j, numInBlock - 1u )];
+                reinterpret_cast<Real*>( &width )[j]  = p->mWidth;
+                reinterpret_cast<Real*>( &height )[j] = p->mHeight;
+                ownDimensions[j] = p->mOwnDimensions;
             }
-            else
+
+            const ArrayMaskR ownMask = BooleanMask4::getMask( ownDimensions );
+            width   = Mathlib::Cmov4( width, defaultWidth, ownMask ) + ds;
+            height  = Mathlib::Cmov4( height, defaultHeight, ownMask ) + ds;
+
+            for( size_t j=0; j<numInBlock; ++j )
             {
-                NewWide = p->getOwnWidth()  + ds;
-                NewHigh = p->getOwnHeight() + ds;
+                Particle *p = block[j];
+                p->mWidth           = reinterpret_cast<const Real*>( &width )[j];
+                p->mHeight          = reinterpret_cast<const Real*>( &height )[j];
+                p->mOwnDimensions   = true;
             }
-            p->setDimensions( NewWide, NewHigh ); 
         }
 
+        // Same as Particle::setDimensions, but notified once for the whole system
+        pSystem->_notifyParticleResized();
     }
     //-----------------------------------------------------------------------
     void ScaleAffector::setAdjust( Real rate )
@@ -52,8 +52,8 @@ layout(binding = 0) uniform PassBuffer
 
 @property( hlms_forward3d )
 	//f3dData.x = minDistance;
-	//f3dData.y = invMaxDistance;
-	//f3dData.z = f3dNumSlicesSub1;
+	//f3dData.y = invMaxDistance; (* (2^k - 1) with exponential slices)
+	//f3dData.z = f3dNumSlicesSub1; (/ k with exponential slices)
 	//f3dData.w = uint cellsPerTableOnGrid0 (floatBitsToUint);
 	vec4 f3dData;
 	vec4 f3dGridHWW[@value( hlms_forward3d )];
@@ -40,7 +40,7 @@ out block
 
 // START UNIFORM DECLARATION
 @insertpiece( PassDecl )
-@property( hlms_skeleton || hlms_shadowcaster )@insertpiece( InstanceDecl )@end
+@property( hlms_skeleton || hlms_shadowcaster || shared_world_matrices )@insertpiece( InstanceDecl )@end
 layout(binding = 0) uniform samplerBuffer worldMatBuf;
 @insertpiece( custom_vs_uniformDeclaration )
 // END UNIFORM DECLARATION
@@ -51,11 +51,16 @@ layout(binding = 0) uniform samplerBuffer worldMatBuf;
 @insertpiece( DeclQuat_yAxis )
 @end @end
 
-@property( !hlms_skeleton )
+@property( !hlms_skeleton && !shared_world_matrices )
 @piece( local_vertex )vertex@end
 @piece( local_normal )normal@end
 @piece( local_tangent )tangent@end
 @end
+@property( !hlms_skeleton && shared_world_matrices )
+@piece( local_vertex )worldPos@end
+@piece( local_normal )(normal * mat3(worldMat))@end
+@piece( local_tangent )(tangent * mat3(worldMat))@end
+@end
 @property( hlms_skeleton )
 @piece( local_vertex )worldPos@end
 @piece( local_normal )worldNorm@end
@@ -112,9 +117,9 @@ layout(binding = 0) uniform samplerBuffer worldMatBuf;
 	worldPos.w = 1.0;
 @end @end //SkeletonTransform // !hlms_skeleton
 
-@property( hlms_skeleton )
+@property( hlms_skeleton || shared_world_matrices )
     @piece( worldViewMat )pass.view@end
-@end @property( !hlms_skeleton )
+@end @property( !hlms_skeleton && !shared_world_matrices )
     @piece( worldViewMat )worldView@end
 @end
 
@@ -146,10 +151,14 @@ void main()
 {
     @insertpiece( custom_vs_preExecution )
 @property( !hlms_skeleton )
+@property( !shared_world_matrices )
 	mat3x4 worldMat = UNPACK_MAT3x4( worldMatBuf, drawId @property( !hlms_shadowcaster )<< 1u@end );
 	@property( hlms_normal || hlms_qtangent )
     mat4 worldView = UNPACK_MAT4( worldMatBuf, (drawId << 1u) + 1u );
 	@end
+@end @property( shared_world_matrices )
+	mat3x4 worldMat = UNPACK_MAT3x4( worldMatBuf, instance.worldMaterialIdx[drawId].x >> 9u );
+@end
 
 	vec4 worldPos = vec4( (vertex * worldMat).xyz, 1.0f );
 @end
@@ -55,8 +55,8 @@ cbuffer PassBuffer : register(b0)
 
 @property( hlms_forward3d )
 	//f3dData.x = minDistance;
-	//f3dData.y = invMaxDistance;
-	//f3dData.z = f3dNumSlicesSub1;
+	//f3dData.y = invMaxDistance; (* (2^k - 1) with exponential slices)
+	//f3dData.z = f3dNumSlicesSub1; (/ k with exponential slices)
 	//f3dData.w = uint cellsPerTableOnGrid0 (floatBitsToUint);
 	float4 f3dData;
 	float4 f3dGridHWW[@value( hlms_forward3d )];
@@ -30,7 +30,7 @@ struct PS_INPUT
 
 // START UNIFORM DECLARATION
 @insertpiece( PassDecl )
-@property( hlms_skeleton || hlms_shadowcaster )@insertpiece( InstanceDecl )@end
+@property( hlms_skeleton || hlms_shadowcaster || shared_world_matrices )@insertpiece( InstanceDecl )@end
 Buffer<float4> worldMatBuf : register(t0);
 @insertpiece( custom_vs_uniformDeclaration )
 // END UNIFORM DECLARATION
@@ -41,11 +41,16 @@ Buffer<float4> worldMatBuf : register(t0);
 @insertpiece( DeclQuat_yAxis )
 @end @end
 
-@property( !hlms_skeleton )
+@property( !hlms_skeleton && !shared_world_matrices )
 @piece( local_vertex )input.vertex@end
 @piece( local_normal )normal@end
 @piece( local_tangent )tangent@end
 @end
+@property( !hlms_skeleton && shared_world_matrices )
+@piece( local_vertex )worldPos@end
+@piece( local_normal )mul( normal, (float3x3)worldMat )@end
+@piece( local_tangent )mul( tangent, (float3x3)worldMat )@end
+@end
 @property( hlms_skeleton )
 @piece( local_vertex )worldPos@end
 @piece( local_normal )worldNorm@end
@@ -102,9 +107,9 @@ Buffer<float4> worldMatBuf : register(t0);
 	worldPos.w = 1.0;
 @end @end  //SkeletonTransform // !hlms_skeleton
 
-@property( hlms_skeleton )
+@property( hlms_skeleton || shared_world_matrices )
 	@piece( worldViewMat )passBuf.view@end
-@end @property( !hlms_skeleton )
+@end @property( !hlms_skeleton && !shared_world_matrices )
     @piece( worldViewMat )worldView@end
 @end
 
@@ -137,10 +142,14 @@ PS_INPUT main( VS_INPUT input )
 	PS_INPUT outVs;
 	@insertpiece( custom_vs_preExecution )
 @property( !hlms_skeleton )
+@property( !shared_world_matrices )
 	float4x3 worldMat = UNPACK_MAT4x3( worldMatBuf, input.drawId @property( !hlms_shadowcaster )<< 1u@end );
 	@property( hlms_normal || hlms_qtangent )
     float4x4 worldView = UNPACK_MAT4( worldMatBuf, (input.drawId << 1u) + 1u );
 	@end
+@end @property( shared_world_matrices )
+	float4x3 worldMat = UNPACK_MAT4x3( worldMatBuf, worldMaterialIdx[input.drawId].x >> 9u );
+@end
 
 	float4 worldPos = float4( mul( input.vertex, worldMat ).xyz, 1.0f );
 @end
@@ -10,8 +10,15 @@
 	fSlice = (fSlice * fSlice) * (fSlice * fSlice);
 	fSlice = (fSlice * fSlice);
 	fSlice = floor( (1.0 - fSlice) * f3dNumSlicesSub1 );*/
+@property( !hlms_forward3d_exponential )
 	float fSlice = clamp( (-inPs.pos.z + f3dMinDistance) * f3dInvMaxDistance, 0.0, 1.0 );
 	fSlice = floor( fSlice * f3dNumSlicesSub1 );
+@end @property( hlms_forward3d_exponential )
+	//f3dInvMaxDistance has been premultiplied by (2^k - 1), f3dNumSlicesSub1 divided by k
+	float fSlice = max( (-inPs.pos.z + f3dMinDistance) * f3dInvMaxDistance, 0.0 );
+	fSlice = log2( fSlice + 1.0 ) * f3dNumSlicesSub1;
+	fSlice = min( floor( fSlice ), float( @value( hlms_forward3d ) - 1 ) );
+@end
 	uint slice = uint( fSlice );
 
 	//TODO: Profile performance: derive this mathematically or use a lookup table?
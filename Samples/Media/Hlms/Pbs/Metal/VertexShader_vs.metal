@@ -47,11 +47,16 @@ struct PS_INPUT
 @insertpiece( DeclQuat_yAxis )
 @end @end
 
-@property( !hlms_skeleton )
+@property( !hlms_skeleton && !shared_world_matrices )
 @piece( local_vertex )input.position@end
 @piece( local_normal )normal@end
 @piece( local_tangent )tangent@end
 @end
+@property( !hlms_skeleton && shared_world_matrices )
+@piece( local_vertex )worldPos@end
+@piece( local_normal )(normal * float3x3( worldMat[0].xyz, worldMat[1].xyz, worldMat[2].xyz ))@end
+@piece( local_tangent )(tangent * float3x3( worldMat[0].xyz, worldMat[1].xyz, worldMat[2].xyz ))@end
+@end
 @property( hlms_skeleton )
 @piece( local_vertex )worldPos@end
 @piece( local_normal )worldNorm@end
@@ -108,9 +113,9 @@ struct PS_INPUT
 	worldPos.w = 1.0;
 @end @end  //SkeletonTransform // !hlms_skeleton
 
-@property( hlms_skeleton )
+@property( hlms_skeleton || shared_world_matrices )
 	@piece( worldViewMat )pass.view@end
-@end @property( !hlms_skeleton )
+@end @property( !hlms_skeleton && !shared_world_matrices )
 	@piece( worldViewMat )worldView@end
 @end
 
@@ -163,10 +168,14 @@ vertex PS_INPUT main_metal
 	PS_INPUT outVs;
 	@insertpiece( custom_vs_preExecution )
 @property( !hlms_skeleton )
+@property( !shared_world_matrices )
 	float3x4 worldMat = UNPACK_MAT3x4( worldMatBuf, drawId @property( !hlms_shadowcaster )<< 1u@end );
 	@property( hlms_normal || hlms_qtangent )
 	float4x4 worldView = UNPACK_MAT4( worldMatBuf, (drawId << 1u) + 1u );
 	@end
+@end @property( shared_world_matrices )
+	float3x4 worldMat = UNPACK_MAT3x4( worldMatBuf, worldMaterialIdx[drawId].x >> 9u );
+@end
 
 	float4 worldPos = float4( ( input.position * worldMat ).xyz, 1.0f );
 @end
@@ -0,0 +1,75 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ArrayMathTests_H__
+#define __ArrayMathTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+/** Checks every lane of the SoA ArrayMath types against the scalar math.
+    Written against ARRAY_PACKED_REALS so it covers whichever backend
+    (C, SSE2, NEON, AVX2) OgreMain was built with; run it under both
+    OGRE_SIMD_AVX2=OFF and ON builds.
+*/
+class ArrayMathTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(ArrayMathTests);
+    CPPUNIT_TEST(testPackedRealsMatchBackend);
+    CPPUNIT_TEST(testVector3Lanes);
+    CPPUNIT_TEST(testQuaternionLanes);
+    CPPUNIT_TEST(testMatrix4AoSRoundTrip);
+    CPPUNIT_TEST(testMatrix4Concatenate);
+    CPPUNIT_TEST(testMatrixAf4x3Lanes);
+    CPPUNIT_TEST(testAabbLanes);
+    CPPUNIT_TEST(testSphereLanes);
+    CPPUNIT_TEST(testBooleanMaskLanes);
+    CPPUNIT_TEST(testCmovLanes);
+    CPPUNIT_TEST(testSinCos4Lanes);
+    CPPUNIT_TEST(testNodeTransforms);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testPackedRealsMatchBackend();
+    void testVector3Lanes();
+    void testQuaternionLanes();
+    void testMatrix4AoSRoundTrip();
+    void testMatrix4Concatenate();
+    void testMatrixAf4x3Lanes();
+    void testAabbLanes();
+    void testSphereLanes();
+    void testBooleanMaskLanes();
+    void testCmovLanes();
+    void testSinCos4Lanes();
+    void testNodeTransforms();
+};
+
+#endif
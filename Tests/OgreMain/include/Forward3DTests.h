@@ -0,0 +1,75 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __Forward3DTests_H__
+#define __Forward3DTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgrePrerequisites.h"
+
+/** Builds Forward3D's light grid headless, with the NULL RenderSystem, serially and
+    on the worker threads, and checks both produce exactly the same grid.
+*/
+class Forward3DTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(Forward3DTests);
+    CPPUNIT_TEST(testThreadedGridMatchesSerial);
+    CPPUNIT_TEST(testThreadedGridMatchesSerialExponential);
+    CPPUNIT_TEST(testSliceDepthRoundTrip);
+    CPPUNIT_TEST_SUITE_END();
+
+    static const size_t NumLights = 300;
+
+    Ogre::Root          *mRoot;
+    Ogre::RenderSystem  *mRenderSystem;
+    Ogre::SceneManager  *mSceneMgr;
+    Ogre::Camera        *mCamera;
+    Ogre::Forward3D     *mForward3D;
+    Ogre::Light         *mLights[NumLights];
+
+    /** Fills a zeroed grid with all the lights, as seen from mCamera.
+    @param numChunks
+        See Forward3D::fillGrid. 0 to fill it serially.
+    */
+    void fillGrid( size_t numChunks, std::vector<Ogre::uint16> &outGrid );
+
+    /// Fills the grid serially and threaded, and asserts they're identical.
+    void checkThreadedGridMatchesSerial(void);
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testThreadedGridMatchesSerial();
+    void testThreadedGridMatchesSerialExponential();
+    void testSliceDepthRoundTrip();
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __HlmsShaderCodeCacheTests_H__
+#define __HlmsShaderCodeCacheTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgrePrerequisites.h"
+
+class HlmsShaderCodeCacheTestHlms;
+class HlmsShaderCodeCacheTestRenderable;
+
+/** Runs Hlms' shader code cache headless, with the NULL RenderSystem and
+    a minimal Hlms whose templates are written to a temporary folder.
+*/
+class HlmsShaderCodeCacheTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(HlmsShaderCodeCacheTests);
+    CPPUNIT_TEST(testCacheHitsAfterReload);
+    CPPUNIT_TEST(testTruncatedCacheIsDiscarded);
+    CPPUNIT_TEST(testCorruptCacheIsDiscarded);
+    CPPUNIT_TEST_SUITE_END();
+
+    Ogre::Root                          *mRoot;
+    Ogre::RenderSystem                  *mRenderSystem;
+    HlmsShaderCodeCacheTestHlms         *mHlms;
+    HlmsShaderCodeCacheTestRenderable   *mRenderable;
+
+    /// Creates the shaders for mRenderable. finalHash must be unique.
+    void createShaders( Ogre::uint32 finalHash );
+
+    /// Saves the shader code cache of mHlms into outData.
+    void saveCache( std::vector<Ogre::uint8> &outData );
+
+    /// Replaces the shader code cache of mHlms with the one in data.
+    void loadCache( std::vector<Ogre::uint8> &data, size_t numBytes );
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testCacheHitsAfterReload();
+    void testTruncatedCacheIsDiscarded();
+    void testCorruptCacheIsDiscarded();
+};
+
+#endif
@@ -0,0 +1,78 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ImageMipmapTests_H__
+#define __ImageMipmapTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgrePrerequisites.h"
+#include "OgrePixelFormat.h"
+
+/** Checks that Image::generateMipmaps' box filter (FILTER_BILINEAR) gives the
+    exact same results as the scalar code, whether it takes the SSE2 paths or
+    not, and whether it runs in worker threads or not.
+*/
+class ImageMipmapTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(ImageMipmapTests);
+    CPPUNIT_TEST(testBoxFilterRGBA8);
+    CPPUNIT_TEST(testBoxFilterRGBA8Gamma);
+    CPPUNIT_TEST(testBoxFilterARGB8Gamma);
+    CPPUNIT_TEST(testBoxFilterFloat32RGBA);
+    CPPUNIT_TEST(testThreadedMatchesSerial);
+    CPPUNIT_TEST_SUITE_END();
+
+    Ogre::Root          *mRoot;
+    Ogre::RenderSystem  *mRenderSystem;
+    Ogre::SceneManager  *mSceneMgr;
+
+    /// Creates an image filled with pseudo random values. Same seed, same image.
+    static void createRandomImage( Ogre::Image &image, Ogre::uint32 width, Ogre::uint32 height,
+                                   Ogre::PixelFormat format, Ogre::uint32 seed );
+
+    /** Generates the mipmaps of an image of each size in the given format, and checks
+        each mip against the scalar reference.
+    @param alphaIdx
+        Byte that holds alpha (only for 8-bit formats).
+    */
+    void checkBoxFilter( Ogre::PixelFormat format, bool gammaCorrected, int alphaIdx );
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testBoxFilterRGBA8();
+    void testBoxFilterRGBA8Gamma();
+    void testBoxFilterARGB8Gamma();
+    void testBoxFilterFloat32RGBA();
+    void testThreadedMatchesSerial();
+};
+
+#endif
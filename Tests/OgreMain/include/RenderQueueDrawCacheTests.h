@@ -0,0 +1,76 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __RenderQueueDrawCacheTests_H__
+#define __RenderQueueDrawCacheTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgrePrerequisites.h"
+
+class RenderQueueDrawCacheTestRenderable;
+
+/** Runs RenderQueue's draw cache headless, with the NULL RenderSystem. The same
+    Renderables are added from different worker threads on each frame, which must
+    not make the cache miss.
+*/
+class RenderQueueDrawCacheTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(RenderQueueDrawCacheTests);
+    CPPUNIT_TEST(testHitWhenThreadsSwapRenderables);
+    CPPUNIT_TEST(testMissWhenRenderablesChange);
+    CPPUNIT_TEST_SUITE_END();
+
+    static const size_t NumRenderables = 6;
+
+    Ogre::Root                          *mRoot;
+    Ogre::RenderSystem                  *mRenderSystem;
+    Ogre::SceneManager                  *mSceneMgr;
+    Ogre::RenderQueue                   *mRenderQueue;
+    Ogre::VertexArrayObject             *mVao;
+    Ogre::uint8                         mRqId;
+    Ogre::Light                         *mMovableObjects[NumRenderables];
+    RenderQueueDrawCacheTestRenderable  *mRenderables[NumRenderables];
+
+    /** Clears the queue, adds the first numRenderables Renderables, each from
+        the worker thread in threadIdx[i], and sorts.
+    @return
+        True if the draw cache was hit.
+    */
+    bool renderFrame( const size_t *threadIdx, size_t numRenderables );
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testHitWhenThreadsSwapRenderables();
+    void testMissWhenRenderablesChange();
+};
+
+#endif
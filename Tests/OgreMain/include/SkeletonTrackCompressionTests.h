@@ -0,0 +1,74 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SkeletonTrackCompressionTests_H__
+#define __SkeletonTrackCompressionTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Animation/OgreSkeletonTrack.h"
+
+/** Compresses a SkeletonTrack and compares it against an identical uncompressed
+    one, through both getKeyFrameTransform and applyKeyFrameRigAt. Written against
+    ARRAY_PACKED_REALS so every lane is covered; run it under both
+    OGRE_SIMD_AVX2=OFF and ON builds.
+*/
+class SkeletonTrackCompressionTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(SkeletonTrackCompressionTests);
+    CPPUNIT_TEST(testRawEncoding);
+    CPPUNIT_TEST(testQuantizedEncoding);
+    CPPUNIT_TEST(testConstantEncoding);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    /// Fills the transform of the given keyframe and SIMD slot.
+    typedef void (*KeyFrameGenerator)( size_t keyFrame, size_t slot, Ogre::Vector3 &outPos,
+                                       Ogre::Quaternion &outRot, Ogre::Vector3 &outScale );
+
+protected:
+    /** Builds two tracks with the keyframes from the generator, compresses one of them
+        with the given settings, checks the chosen encodings, and checks that both
+        tracks produce the same transforms within the settings' tolerances.
+    */
+    void checkCompression( KeyFrameGenerator generator, const Ogre::KfCompressionSettings &settings,
+                           Ogre::SkeletonTrack::KfChannelEncoding expectedPosEncoding,
+                           Ogre::SkeletonTrack::KfChannelEncoding expectedRotEncoding,
+                           Ogre::SkeletonTrack::KfChannelEncoding expectedScaleEncoding );
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testRawEncoding();
+    void testQuantizedEncoding();
+    void testConstantEncoding();
+};
+
+#endif
@@ -0,0 +1,82 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SoftwareOcclusionCullerTests_H__
+#define __SoftwareOcclusionCullerTests_H__
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "OgrePrerequisites.h"
+
+namespace Ogre
+{
+    class SoftwareOcclusionCuller;
+}
+
+/** Runs SoftwareOcclusionCuller headless, with the NULL RenderSystem.
+    An orthographic 64x64 camera maps one world unit to one pixel, so that
+    we can place occluders & objects at exact sub-pixel positions.
+*/
+class SoftwareOcclusionCullerTests : public CppUnit::TestFixture
+{
+    // CppUnit macros for setting up the test suite
+    CPPUNIT_TEST_SUITE(SoftwareOcclusionCullerTests);
+    CPPUNIT_TEST(testOccludedBehindWall);
+    CPPUNIT_TEST(testVisibleInFrontOfWall);
+    CPPUNIT_TEST(testPartiallyCoveredPixel);
+    CPPUNIT_TEST(testFarthestDepthInPixel);
+    CPPUNIT_TEST_SUITE_END();
+
+    Ogre::Root                      *mRoot;
+    Ogre::RenderSystem              *mRenderSystem;
+    Ogre::SceneManager              *mSceneMgr;
+    Ogre::Camera                    *mCamera;
+    Ogre::Light                     *mOccluderObject;
+    Ogre::SoftwareOcclusionCuller   *mCuller;
+
+    /** Makes a wall the only occluder and rasterizes it. It covers the whole screen
+        height, from the left border of the screen up to pixel rightEdge. Its distance
+        to the camera goes linearly from leftDistance to rightDistance.
+    */
+    void setWall( Ogre::Real rightEdge, Ogre::Real leftDistance, Ogre::Real rightDistance );
+
+    /// Tests a box covering pixels [startX; endX) horizontally, and [16; 48) vertically.
+    bool isOccluded( Ogre::Real startX, Ogre::Real endX,
+                     Ogre::Real nearDistance, Ogre::Real farDistance );
+
+public:
+    void setUp();
+    void tearDown();
+
+    void testOccludedBehindWall();
+    void testVisibleInFrontOfWall();
+    void testPartiallyCoveredPixel();
+    void testFarthestDepthInPixel();
+};
+
+#endif
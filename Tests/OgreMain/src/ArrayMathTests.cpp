@@ -0,0 +1,611 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ArrayMathTests.h"
+#include "OgreMath.h"
+#include "OgreMatrix4.h"
+#include "OgreSceneNode.h"
+#include "Math/Array/OgreArrayVector3.h"
+#include "Math/Array/OgreArrayQuaternion.h"
+#include "Math/Array/OgreArrayMatrix4.h"
+#include "Math/Array/OgreArrayMatrixAf4x3.h"
+#include "Math/Array/OgreArrayAabb.h"
+#include "Math/Array/OgreArraySphere.h"
+#include "Math/Array/OgreBooleanMask.h"
+#include "Math/Array/OgreMathlib.h"
+#include "Math/Array/OgreNodeMemoryManager.h"
+#include "OgreSphere.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ArrayMathTests);
+
+static const Real c_tolerance = 1e-4f;
+
+//--------------------------------------------------------------------------
+static Vector3 randomVector3(void)
+{
+    return Vector3( Math::RangeRandom( -10, 10 ),
+                    Math::RangeRandom( -10, 10 ),
+                    Math::RangeRandom( -10, 10 ) );
+}
+//--------------------------------------------------------------------------
+static Quaternion randomQuaternion(void)
+{
+    Vector3 axis = randomVector3();
+    axis.normalise();
+    return Quaternion( Radian( Math::RangeRandom( -Math::PI, Math::PI ) ), axis );
+}
+//--------------------------------------------------------------------------
+static Aabb randomAabb(void)
+{
+    return Aabb( randomVector3(), Vector3( Math::RangeRandom( 0.5f, 5.0f ),
+                                           Math::RangeRandom( 0.5f, 5.0f ),
+                                           Math::RangeRandom( 0.5f, 5.0f ) ) );
+}
+//--------------------------------------------------------------------------
+static Real getLane( const ArrayReal &value, size_t lane )
+{
+    return reinterpret_cast<const Real*>( &value )[lane];
+}
+//--------------------------------------------------------------------------
+/// values must be SIMD aligned and hold ARRAY_PACKED_REALS entries
+static ArrayReal loadLanes( const Real *values )
+{
+    return *reinterpret_cast<const ArrayReal*>( values );
+}
+//--------------------------------------------------------------------------
+/// outMatrices must be SIMD aligned and hold ARRAY_PACKED_REALS entries
+static void storeLanes( const ArrayMatrixAf4x3 &arrayMat, Matrix4 *outMatrices )
+{
+    OGRE_ALIGNED_DECL( SimpleMatrixAf4x3, simpleMat[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+    arrayMat.storeToAoS( simpleMat );
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+        simpleMat[i].store( &outMatrices[i] );
+}
+//--------------------------------------------------------------------------
+static void assertVector3Equal( const Vector3 &expected, const Vector3 &actual )
+{
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.x, actual.x, c_tolerance );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.y, actual.y, c_tolerance );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.z, actual.z, c_tolerance );
+}
+//--------------------------------------------------------------------------
+static void assertMatrix4Equal( const Matrix4 &expected, const Matrix4 &actual )
+{
+    for( size_t i=0; i<4; ++i )
+    {
+        for( size_t j=0; j<4; ++j )
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( expected[i][j], actual[i][j], c_tolerance );
+    }
+}
+//--------------------------------------------------------------------------
+static void assertQuaternionEqual( const Quaternion &expected, Quaternion actual )
+{
+    //q and -q are the same rotation
+    if( expected.Dot( actual ) < 0 )
+        actual = -actual;
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.w, actual.w, c_tolerance );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.x, actual.x, c_tolerance );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.y, actual.y, c_tolerance );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.z, actual.z, c_tolerance );
+}
+//--------------------------------------------------------------------------
+static void assertAabbEqual( const Aabb &expected, const Aabb &actual )
+{
+    assertVector3Equal( expected.mCenter, actual.mCenter );
+    assertVector3Equal( expected.mHalfSize, actual.mHalfSize );
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+    srand(0);
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testPackedRealsMatchBackend()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+#if OGRE_USE_SIMD == 1 && __OGRE_HAVE_AVX
+    CPPUNIT_ASSERT_EQUAL( 8, ARRAY_PACKED_REALS );
+#elif OGRE_USE_SIMD == 1
+    CPPUNIT_ASSERT_EQUAL( 4, ARRAY_PACKED_REALS );
+#else
+    CPPUNIT_ASSERT_EQUAL( 1, ARRAY_PACKED_REALS );
+#endif
+    CPPUNIT_ASSERT_EQUAL( (size_t)0, sizeof( ArrayReal ) % (ARRAY_PACKED_REALS * sizeof( Real )) );
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testVector3Lanes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Vector3 a[ARRAY_PACKED_REALS], b[ARRAY_PACKED_REALS];
+    ArrayVector3 arrayA, arrayB;
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        a[i] = randomVector3();
+        b[i] = randomVector3();
+        arrayA.setFromVector3( a[i], i );
+        arrayB.setFromVector3( b[i], i );
+    }
+
+    const ArrayVector3 sum      = arrayA + arrayB;
+    const ArrayVector3 product  = arrayA * arrayB;
+    const ArrayVector3 cross    = arrayA.crossProduct( arrayB );
+    const ArrayReal dot         = arrayA.dotProduct( arrayB );
+    ArrayVector3 normalised     = arrayA;
+    normalised.normalise();
+
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        Vector3 tmp;
+        sum.getAsVector3( tmp, i );
+        assertVector3Equal( a[i] + b[i], tmp );
+        product.getAsVector3( tmp, i );
+        assertVector3Equal( a[i] * b[i], tmp );
+        cross.getAsVector3( tmp, i );
+        assertVector3Equal( a[i].crossProduct( b[i] ), tmp );
+        normalised.getAsVector3( tmp, i );
+        assertVector3Equal( a[i].normalisedCopy(), tmp );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( a[i].dotProduct( b[i] ),
+                                      reinterpret_cast<const Real*>( &dot )[i], c_tolerance );
+    }
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testQuaternionLanes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Quaternion q0[ARRAY_PACKED_REALS], q1[ARRAY_PACKED_REALS];
+    Vector3 v[ARRAY_PACKED_REALS];
+    ArrayQuaternion arrayQ0, arrayQ1;
+    ArrayVector3 arrayV;
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        q0[i] = randomQuaternion();
+        q1[i] = randomQuaternion();
+        v[i]  = randomVector3();
+        arrayQ0.setFromQuaternion( q0[i], i );
+        arrayQ1.setFromQuaternion( q1[i], i );
+        arrayV.setFromVector3( v[i], i );
+    }
+
+    const ArrayQuaternion concat = arrayQ0 * arrayQ1;
+    const ArrayVector3 rotated   = arrayQ0 * arrayV;
+
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        Quaternion q;
+        concat.getAsQuaternion( q, i );
+        const Quaternion expected = q0[i] * q1[i];
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.w, q.w, c_tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.x, q.x, c_tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.y, q.y, c_tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.z, q.z, c_tolerance );
+
+        Vector3 tmp;
+        rotated.getAsVector3( tmp, i );
+        assertVector3Equal( q0[i] * v[i], tmp );
+    }
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testMatrix4AoSRoundTrip()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    //Each lane must land in its own matrix (AVX transposes each 128-bit half separately)
+    OGRE_ALIGNED_DECL( Matrix4, src[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+    OGRE_ALIGNED_DECL( Matrix4, dst[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        for( size_t j=0; j<16; ++j )
+            src[i][j / 4][j % 4] = Real( i * 16 + j );
+        dst[i] = Matrix4::ZERO;
+    }
+
+    ArrayMatrix4 arrayMat;
+    arrayMat.loadFromAoS( src );
+    arrayMat.storeToAoS( dst );
+
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        Matrix4 lane;
+        arrayMat.getAsMatrix4( lane, i );
+        assertMatrix4Equal( src[i], lane );
+        assertMatrix4Equal( src[i], dst[i] );
+    }
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testMatrix4Concatenate()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Matrix4 m0[ARRAY_PACKED_REALS], m1[ARRAY_PACKED_REALS];
+    ArrayMatrix4 arrayM0, arrayM1;
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        m0[i].makeTransform( randomVector3(), Vector3( 1.5f, 0.5f, 2.0f ), randomQuaternion() );
+        m1[i].makeTransform( randomVector3(), Vector3( 0.5f, 1.0f, 3.0f ), randomQuaternion() );
+        arrayM0.setFromMatrix4( m0[i], i );
+        arrayM1.setFromMatrix4( m1[i], i );
+    }
+
+    const ArrayMatrix4 concat = arrayM0 * arrayM1;
+
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        Matrix4 lane;
+        concat.getAsMatrix4( lane, i );
+        assertMatrix4Equal( m0[i] * m1[i], lane );
+    }
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testMatrixAf4x3Lanes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    OGRE_ALIGNED_DECL( Matrix4, m0[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+    OGRE_ALIGNED_DECL( Matrix4, m1[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+    Vector3 pos[ARRAY_PACKED_REALS], scale[ARRAY_PACKED_REALS], v[ARRAY_PACKED_REALS];
+    Quaternion rot[ARRAY_PACKED_REALS];
+    ArrayVector3 arrayPos, arrayScale, arrayV;
+    ArrayQuaternion arrayRot;
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        pos[i]   = randomVector3();
+        scale[i] = Vector3( Math::RangeRandom( 0.5f, 2.0f ),
+                            Math::RangeRandom( 0.5f, 2.0f ),
+                            Math::RangeRandom( 0.5f, 2.0f ) );
+        rot[i]   = randomQuaternion();
+        v[i]     = randomVector3();
+        m0[i].makeTransform( pos[i], scale[i], rot[i] );
+        m1[i].makeTransform( randomVector3(), Vector3( 1.5f, 0.5f, 2.0f ), randomQuaternion() );
+        arrayPos.setFromVector3( pos[i], i );
+        arrayScale.setFromVector3( scale[i], i );
+        arrayRot.setFromQuaternion( rot[i], i );
+        arrayV.setFromVector3( v[i], i );
+    }
+
+    ArrayMatrixAf4x3 arrayM0, arrayM1, madeTransform;
+    arrayM0.loadFromAoS( m0 );
+    arrayM1.loadFromAoS( m1 );
+    madeTransform.makeTransform( arrayPos, arrayScale, arrayRot );
+
+    const ArrayMatrixAf4x3 concat   = arrayM0 * arrayM1;
+    const ArrayVector3 transformed  = arrayM0 * arrayV;
+    ArrayMatrixAf4x3 inverse        = arrayM0;
+    inverse.setToInverse();
+    ArrayVector3 decomposedPos, decomposedScale;
+    ArrayQuaternion decomposedRot;
+    arrayM0.decomposition( decomposedPos, decomposedScale, decomposedRot );
+
+    OGRE_ALIGNED_DECL( Matrix4, lanes[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+
+    storeLanes( arrayM0, lanes );
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+        assertMatrix4Equal( m0[i], lanes[i] );
+
+    storeLanes( madeTransform, lanes );
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+        assertMatrix4Equal( m0[i], lanes[i] );
+
+    storeLanes( concat, lanes );
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+        assertMatrix4Equal( m0[i].concatenateAffine( m1[i] ), lanes[i] );
+
+    storeLanes( inverse, lanes );
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+        assertMatrix4Equal( m0[i].inverseAffine(), lanes[i] );
+
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        Vector3 tmp;
+        Quaternion qTmp;
+        transformed.getAsVector3( tmp, i );
+        assertVector3Equal( m0[i].transformAffine( v[i] ), tmp );
+        decomposedPos.getAsVector3( tmp, i );
+        assertVector3Equal( pos[i], tmp );
+        decomposedScale.getAsVector3( tmp, i );
+        assertVector3Equal( scale[i], tmp );
+        decomposedRot.getAsQuaternion( qTmp, i );
+        assertQuaternionEqual( rot[i], qTmp );
+    }
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testAabbLanes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Aabb a[ARRAY_PACKED_REALS], b[ARRAY_PACKED_REALS];
+    Vector3 points[ARRAY_PACKED_REALS];
+    Matrix4 transforms[ARRAY_PACKED_REALS];
+    ArrayAabb arrayA( ArrayAabb::BOX_ZERO ), arrayB( ArrayAabb::BOX_ZERO );
+    ArrayVector3 arrayPoints;
+    ArrayMatrix4 arrayTransforms;
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        a[i] = randomAabb();
+        //Odd lanes hold a box (and lanes 2 & 3 mod 4 a point) inside a[i],
+        //so that contains() sees both outcomes.
+        if( i & 0x01 )
+            b[i] = Aabb( a[i].mCenter + a[i].mHalfSize * 0.25f, a[i].mHalfSize * 0.5f );
+        else
+            b[i] = randomAabb();
+        points[i] = (i & 0x02) ? a[i].mCenter - a[i].mHalfSize * 0.5f : randomVector3();
+        transforms[i].makeTransform( randomVector3(), Vector3( 0.5f, 1.5f, 2.0f ),
+                                     randomQuaternion() );
+
+        arrayA.setFromAabb( a[i], i );
+        arrayB.setFromAabb( b[i], i );
+        arrayPoints.setFromVector3( points[i], i );
+        arrayTransforms.setFromMatrix4( transforms[i], i );
+    }
+
+    ArrayAabb merged = arrayA;
+    merged.merge( arrayB );
+    ArrayAabb mergedPoints = arrayA;
+    mergedPoints.merge( arrayPoints );
+    ArrayAabb transformed = arrayA;
+    transformed.transformAffine( arrayTransforms );
+
+    const uint32 intersectsMask     = BooleanMask4::getScalarMask( arrayA.intersects( arrayB ) );
+    const uint32 containsMask       = BooleanMask4::getScalarMask( arrayA.contains( arrayB ) );
+    const uint32 containsPointMask  = BooleanMask4::getScalarMask( arrayA.contains( arrayPoints ) );
+    const ArrayReal distance        = arrayA.distance( arrayPoints );
+    const ArrayReal volume          = arrayA.volume();
+
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        Aabb tmp;
+        arrayA.getAsAabb( tmp, i );
+        assertAabbEqual( a[i], tmp );
+
+        Aabb expected = a[i];
+        expected.merge( b[i] );
+        merged.getAsAabb( tmp, i );
+        assertAabbEqual( expected, tmp );
+
+        expected = a[i];
+        expected.merge( points[i] );
+        mergedPoints.getAsAabb( tmp, i );
+        assertAabbEqual( expected, tmp );
+
+        expected = a[i];
+        expected.transformAffine( transforms[i] );
+        transformed.getAsAabb( tmp, i );
+        assertAabbEqual( expected, tmp );
+
+        CPPUNIT_ASSERT_EQUAL( a[i].intersects( b[i] ), IS_BIT_SET( i, intersectsMask ) );
+        CPPUNIT_ASSERT_EQUAL( a[i].contains( b[i] ), IS_BIT_SET( i, containsMask ) );
+        CPPUNIT_ASSERT_EQUAL( a[i].contains( points[i] ), IS_BIT_SET( i, containsPointMask ) );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( a[i].distance( points[i] ), getLane( distance, i ),
+                                      c_tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( a[i].volume(), getLane( volume, i ),
+                                      c_tolerance * a[i].volume() );
+    }
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testSphereLanes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    Sphere s0[ARRAY_PACKED_REALS], s1[ARRAY_PACKED_REALS];
+    Vector3 points[ARRAY_PACKED_REALS];
+    ArraySphere arrayS0, arrayS1;
+    ArrayVector3 arrayPoints;
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        s0[i] = Sphere( randomVector3(), Math::RangeRandom( 1.0f, 8.0f ) );
+        s1[i] = Sphere( randomVector3(), Math::RangeRandom( 1.0f, 8.0f ) );
+        points[i] = randomVector3();
+        arrayS0.setFromSphere( s0[i], i );
+        arrayS1.setFromSphere( s1[i], i );
+        arrayPoints.setFromVector3( points[i], i );
+    }
+
+    const uint32 intersectsMask     = BooleanMask4::getScalarMask( arrayS0.intersects( arrayS1 ) );
+    const uint32 containsPointMask  = BooleanMask4::getScalarMask(
+                                                        arrayS0.intersects( arrayPoints ) );
+
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        Sphere tmp;
+        arrayS0.getAsSphere( tmp, i );
+        assertVector3Equal( s0[i].getCenter(), tmp.getCenter() );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( s0[i].getRadius(), tmp.getRadius(), c_tolerance );
+
+        CPPUNIT_ASSERT_EQUAL( s0[i].intersects( s1[i] ), IS_BIT_SET( i, intersectsMask ) );
+        CPPUNIT_ASSERT_EQUAL( s0[i].intersects( points[i] ), IS_BIT_SET( i, containsPointMask ) );
+    }
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testBooleanMaskLanes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    bool allTrue[ARRAY_PACKED_REALS];
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+        allTrue[i] = true;
+
+    //Every combination of lanes
+    const uint32 allLanes = (1u << ARRAY_PACKED_REALS) - 1u;
+    for( uint32 pattern=0; pattern<=allLanes; ++pattern )
+    {
+        bool booleans[ARRAY_PACKED_REALS];
+        for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+            booleans[i] = IS_BIT_SET( i, pattern );
+
+        CPPUNIT_ASSERT_EQUAL( pattern, BooleanMask4::getScalarMask(
+                                            BooleanMask4::getMask( booleans ) ) );
+        CPPUNIT_ASSERT_EQUAL( pattern == allLanes, BooleanMask4::allBitsSet( booleans, allTrue ) );
+    }
+
+    //Masks produced by comparisons
+    OGRE_ALIGNED_DECL( Real, a[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+    OGRE_ALIGNED_DECL( Real, b[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+    uint32 expected = 0;
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        a[i] = Math::RangeRandom( -10, 10 );
+        b[i] = Math::RangeRandom( -10, 10 );
+        expected |= (a[i] < b[i] ? 1u : 0u) << i;
+    }
+
+    CPPUNIT_ASSERT_EQUAL( expected, BooleanMask4::getScalarMask(
+                                        Mathlib::CompareLess( loadLanes( a ), loadLanes( b ) ) ) );
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testCmovLanes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    OGRE_ALIGNED_DECL( Real, finite1[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+    OGRE_ALIGNED_DECL( Real, finite2[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+    OGRE_ALIGNED_DECL( Real, infinite[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+    for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+    {
+        finite1[i]  = Math::RangeRandom( -10, 10 );
+        finite2[i]  = Math::RangeRandom( -10, 10 );
+        infinite[i] = (i & 0x01) ? -std::numeric_limits<Real>::infinity() :
+                                    std::numeric_limits<Real>::infinity();
+    }
+
+    const uint32 allLanes = (1u << ARRAY_PACKED_REALS) - 1u;
+    for( uint32 pattern=0; pattern<=allLanes; ++pattern )
+    {
+        bool booleans[ARRAY_PACKED_REALS];
+        for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+            booleans[i] = IS_BIT_SET( i, pattern );
+        const ArrayMaskR mask = BooleanMask4::getMask( booleans );
+
+        const ArrayReal cmov    = Mathlib::Cmov4( loadLanes( finite1 ), loadLanes( finite2 ), mask );
+        //Cmov4 can't deal with infinity, CmovRobust must copy it as is
+        const ArrayReal robust  = Mathlib::CmovRobust( loadLanes( infinite ),
+                                                       loadLanes( finite2 ), mask );
+
+        for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( booleans[i] ? finite1[i] : finite2[i],
+                                          getLane( cmov, i ), c_tolerance );
+            CPPUNIT_ASSERT_EQUAL( booleans[i] ? infinite[i] : finite2[i], getLane( robust, i ) );
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testSinCos4Lanes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    OGRE_ALIGNED_DECL( Real, angles[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+
+    for( size_t j=0; j<16; ++j )
+    {
+        for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+            angles[i] = Math::RangeRandom( -Math::TWO_PI, Math::TWO_PI );
+
+        const ArrayReal sin = Mathlib::Sin4( loadLanes( angles ) );
+        const ArrayReal cos = Mathlib::Cos4( loadLanes( angles ) );
+        ArrayReal sinCosSin, sinCosCos;
+        Mathlib::SinCos4( loadLanes( angles ), sinCosSin, sinCosCos );
+
+        for( size_t i=0; i<ARRAY_PACKED_REALS; ++i )
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( Math::Sin( angles[i] ), getLane( sin, i ), c_tolerance );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( Math::Cos( angles[i] ), getLane( cos, i ), c_tolerance );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( Math::Sin( angles[i] ), getLane( sinCosSin, i ),
+                                          c_tolerance );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( Math::Cos( angles[i] ), getLane( sinCosCos, i ),
+                                          c_tolerance );
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void ArrayMathTests::testNodeTransforms()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    //Two full packs plus a partial one, so the padding lanes get exercised too
+    const size_t numChildren = ARRAY_PACKED_REALS * 2 + (ARRAY_PACKED_REALS + 1) / 2;
+
+    NodeMemoryManager nodeMemoryManager;
+    SceneNode *rootNode = OGRE_NEW SceneNode( 0, 0, &nodeMemoryManager, 0 );
+    rootNode->setPosition( randomVector3() );
+    rootNode->setOrientation( randomQuaternion() );
+    rootNode->setScale( 2.0f, 0.5f, 1.5f );
+
+    vector<SceneNode*>::type children;
+    for( size_t i=0; i<numChildren; ++i )
+    {
+        SceneNode *child = OGRE_NEW SceneNode( i + 1, 0, &nodeMemoryManager, 0 );
+        rootNode->addChild( child );
+        child->setPosition( randomVector3() );
+        child->setOrientation( randomQuaternion() );
+        child->setScale( Vector3( Math::RangeRandom( 0.5f, 2.0f ) ) );
+        children.push_back( child );
+    }
+
+    //Same as SceneManager::updateAllTransforms, single threaded
+    for( size_t i=0; i<nodeMemoryManager.getNumDepths(); ++i )
+    {
+        Transform t;
+        const size_t numNodes = nodeMemoryManager.getFirstNode( t, i );
+        Node::updateAllTransforms( numNodes, t );
+    }
+
+    Matrix4 rootTransform;
+    rootTransform.makeTransform( rootNode->getPosition(), rootNode->getScale(),
+                                 rootNode->getOrientation() );
+    assertMatrix4Equal( rootTransform, rootNode->_getFullTransform() );
+
+    for( size_t i=0; i<numChildren; ++i )
+    {
+        const SceneNode *child = children[i];
+        const Vector3 derivedPos = rootNode->getOrientation() *
+                                    (rootNode->getScale() * child->getPosition()) +
+                                    rootNode->getPosition();
+        const Quaternion derivedRot = rootNode->getOrientation() * child->getOrientation();
+        const Vector3 derivedScale  = rootNode->getScale() * child->getScale();
+
+        Matrix4 expected;
+        expected.makeTransform( derivedPos, derivedScale, derivedRot );
+        assertMatrix4Equal( expected, child->_getFullTransform() );
+    }
+
+    for( size_t i=0; i<numChildren; ++i )
+        OGRE_DELETE children[i];
+    OGRE_DELETE rootNode;
+}
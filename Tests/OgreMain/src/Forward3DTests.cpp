@@ -0,0 +1,188 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "Forward3DTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreCamera.h"
+#include "OgreLight.h"
+#include "OgreForward3D.h"
+#include "OgreNULLRenderSystem.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(Forward3DTests);
+
+//--------------------------------------------------------------------------
+void Forward3DTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root( BLANKSTRING );
+    mRenderSystem = OGRE_NEW NULLRenderSystem();
+    mRoot->addRenderSystem( mRenderSystem );
+    mRoot->setRenderSystem( mRenderSystem );
+    mRoot->initialise( true );
+
+    mSceneMgr = mRoot->createSceneManager( ST_GENERIC, 4, INSTANCING_CULLING_SINGLETHREAD );
+
+    //Few lights per cell, so that cells fill up and the order in which
+    //lights are assigned to them matters.
+    mForward3D = OGRE_NEW Forward3D( 4, 4, 5, 8, 3.0f, 200.0f, mSceneMgr );
+
+    mCamera = mSceneMgr->createCamera( "Forward3DTests" );
+    mCamera->setPosition( Vector3( 0, 5.0f, 15.0f ) );
+    mCamera->lookAt( Vector3( 0, 0, -50.0f ) );
+    mCamera->setNearClipDistance( 0.5f );
+    mCamera->setFarClipDistance( 300.0f );
+    mCamera->setAspectRatio( 16.0f / 9.0f );
+
+    //Fixed light set, spread in front of the camera (and some of them behind or
+    //partially outside the frustum) at all depths. Every fifth one is a spot light.
+    for( size_t i=0; i<NumLights; ++i )
+    {
+        const Vector3 position( static_cast<Real>( (i * 37u) % 41u ) * 3.0f - 60.0f,
+                                static_cast<Real>( (i * 53u) % 29u ) * 2.0f - 28.0f,
+                                10.0f - static_cast<Real>( (i * 71u) % 220u ) );
+
+        mLights[i] = mSceneMgr->createLight();
+        SceneNode *sceneNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+        sceneNode->setPosition( position );
+        sceneNode->attachObject( mLights[i] );
+
+        if( i % 5u == 0 )
+        {
+            mLights[i]->setType( Light::LT_SPOTLIGHT );
+            mLights[i]->setDirection( Vector3( 0, -1.0f, -1.0f ).normalisedCopy() );
+            mLights[i]->setSpotlightRange( Degree( 20.0f ), Degree( 30.0f ) );
+        }
+        else
+        {
+            mLights[i]->setType( Light::LT_POINT );
+        }
+
+        mLights[i]->setAttenuation( 2.0f + static_cast<Real>( i % 7u ) * 3.0f, 1.0f, 0, 0 );
+    }
+
+    mSceneMgr->updateSceneGraph();
+}
+//--------------------------------------------------------------------------
+void Forward3DTests::tearDown()
+{
+    OGRE_DELETE mForward3D;
+    mForward3D = 0;
+
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mRenderSystem;
+    mRoot = 0;
+    mRenderSystem = 0;
+}
+//--------------------------------------------------------------------------
+void Forward3DTests::fillGrid( size_t numChunks, std::vector<uint16> &outGrid )
+{
+    const size_t p = -((1 - (1 << (mForward3D->mNumSlices << 1))) / 3);
+    outGrid.clear();
+    outGrid.resize( p * mForward3D->mTableSize, 0 );
+
+    mForward3D->mCurrentLightList.clear();
+    mForward3D->mCurrentLightList.appendPOD( mLights, mLights + NumLights );
+
+    //A new cache every time, so nothing is reused from the previous fill.
+    Forward3D::CachedGrid cachedGrid;
+    cachedGrid.viewMatrix = Matrix4::ZERO;
+    cachedGrid.projMatrix = Matrix4::ZERO;
+
+    mForward3D->fillGrid( mCamera, &cachedGrid, &outGrid[0], numChunks );
+}
+//--------------------------------------------------------------------------
+void Forward3DTests::checkThreadedGridMatchesSerial(void)
+{
+    std::vector<uint16> serialGrid;
+    std::vector<uint16> threadedGrid;
+
+    fillGrid( 0, serialGrid );
+    fillGrid( mSceneMgr->getNumWorkerThreads() * 4u, threadedGrid );
+
+    //Make sure the lights actually landed in the grid.
+    size_t numAssigned = 0;
+    for( size_t i=0; i<serialGrid.size(); i += mForward3D->mLightsPerCell )
+        numAssigned += serialGrid[i];
+    CPPUNIT_ASSERT( numAssigned > 0 );
+
+    CPPUNIT_ASSERT_EQUAL( serialGrid.size(), threadedGrid.size() );
+    CPPUNIT_ASSERT( memcmp( &serialGrid[0], &threadedGrid[0],
+                            serialGrid.size() * sizeof(uint16) ) == 0 );
+}
+//--------------------------------------------------------------------------
+void Forward3DTests::testThreadedGridMatchesSerial()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    checkThreadedGridMatchesSerial();
+}
+//--------------------------------------------------------------------------
+void Forward3DTests::testThreadedGridMatchesSerialExponential()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    mForward3D->setDepthSliceExponent( 4.0f );
+    checkThreadedGridMatchesSerial();
+}
+//--------------------------------------------------------------------------
+void Forward3DTests::testSliceDepthRoundTrip()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    //Many slices, so that i / (numSlices - 1) isn't exact in floating point.
+    Forward3D *forward3Ds[2] =
+    {
+        mForward3D,
+        OGRE_NEW Forward3D( 1, 1, 10, 8, 3.0f, 200.0f, mSceneMgr )
+    };
+
+    const float exponents[4] = { 0.0f, 2.0f, 4.5f, 8.0f };
+
+    for( size_t i=0; i<2u; ++i )
+    {
+        Forward3D *forward3D = forward3Ds[i];
+        for( size_t j=0; j<4u; ++j )
+        {
+            forward3D->setDepthSliceExponent( exponents[j] );
+
+            for( uint32 k=0; k<forward3D->mNumSlices; ++k )
+            {
+                const Real depth = forward3D->getDepthAtSlice( k );
+                CPPUNIT_ASSERT_EQUAL( k, forward3D->getSliceAtDepth( depth ) );
+            }
+        }
+    }
+
+    OGRE_DELETE forward3Ds[1];
+}
@@ -0,0 +1,258 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "HlmsShaderCodeCacheTests.h"
+#include "OgreRoot.h"
+#include "OgreHlms.h"
+#include "OgreHlmsManager.h"
+#include "OgreHlmsDatablock.h"
+#include "OgreRenderable.h"
+#include "OgreRenderQueue.h"
+#include "OgreRenderOperation.h"
+#include "OgreVertexIndexData.h"
+#include "OgreArchiveManager.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreDataStream.h"
+#include "OgreNULLRenderSystem.h"
+
+#include "UnitTestSuite.h"
+
+#include <fstream>
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(HlmsShaderCodeCacheTests);
+
+static const char *c_templateFolder = "HlmsShaderCodeCacheTests";
+
+/// Exposes what the tests need from Hlms.
+class HlmsShaderCodeCacheTestHlms : public Hlms
+{
+public:
+    HlmsShaderCodeCacheTestHlms( Archive *dataFolder ) :
+        Hlms( HLMS_USER0, "ShaderCodeCacheTest", dataFolder, 0 )
+    {
+    }
+
+    using Hlms::createShaderCacheEntry;
+
+    //Nothing gets rendered
+    virtual uint32 fillBuffersFor( const HlmsCache *cache, const QueuedRenderable &queuedRenderable,
+                                   bool casterPass, uint32 lastCacheHash,
+                                   uint32 lastTextureHash )                     { return 0; }
+    virtual uint32 fillBuffersForV1( const HlmsCache *cache,
+                                     const QueuedRenderable &queuedRenderable,
+                                     bool casterPass, uint32 lastCacheHash,
+                                     CommandBuffer *commandBuffer )             { return 0; }
+    virtual uint32 fillBuffersForV2( const HlmsCache *cache,
+                                     const QueuedRenderable &queuedRenderable,
+                                     bool casterPass, uint32 lastCacheHash,
+                                     CommandBuffer *commandBuffer )             { return 0; }
+
+    size_t getNumCodeCacheEntries(void) const       { return mShaderCodeCache.size(); }
+    const String& getShaderFileExt(void) const      { return mShaderFileExt; }
+    const String& getShaderProfile(void) const      { return mShaderProfile; }
+};
+
+/// v1 Renderable without any vertex element.
+class HlmsShaderCodeCacheTestRenderable : public Renderable
+{
+    v1::VertexData  *mVertexData;
+    LightList       mLightList;
+
+public:
+    HlmsShaderCodeCacheTestRenderable() :
+        mVertexData( OGRE_NEW v1::VertexData() )
+    {
+    }
+
+    ~HlmsShaderCodeCacheTestRenderable()
+    {
+        OGRE_DELETE mVertexData;
+    }
+
+    virtual void getRenderOperation( v1::RenderOperation &op, bool casterPass )
+    {
+        op.vertexData       = mVertexData;
+        op.indexData        = 0;
+        op.useIndexes       = false;
+        op.operationType    = OT_TRIANGLE_LIST;
+    }
+    virtual void getWorldTransforms( Matrix4 *xform ) const     { *xform = Matrix4::IDENTITY; }
+    virtual const LightList& getLights(void) const              { return mLightList; }
+};
+
+//--------------------------------------------------------------------------
+void HlmsShaderCodeCacheTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root( BLANKSTRING );
+    mRenderSystem = OGRE_NEW NULLRenderSystem();
+    mRoot->addRenderSystem( mRenderSystem );
+    mRoot->setRenderSystem( mRenderSystem );
+    mRoot->initialise( true );
+
+    FileSystemLayer::createDirectory( c_templateFolder );
+    Archive *dataFolder = ArchiveManager::getSingleton().load( c_templateFolder, "FileSystem", true );
+
+    mHlms = new HlmsShaderCodeCacheTestHlms( dataFolder );
+    mRoot->getHlmsManager()->registerHlms( mHlms );
+
+    //The extension depends on the RenderSystem. Templates are loaded on demand.
+    const char *templateSource = "@property( hlms_skeleton )skeleton@end void main() {}";
+    const char *shaderFiles[2] = { "VertexShader_vs", "PixelShader_ps" };
+    for( size_t i=0; i<2; ++i )
+    {
+        const String filename = String( c_templateFolder ) + "/" + shaderFiles[i] +
+                                mHlms->getShaderFileExt();
+        std::ofstream outFile( filename.c_str(), std::ios::out | std::ios::binary );
+        outFile << templateSource;
+    }
+
+    HlmsDatablock *datablock = mHlms->createDatablock( "ShaderCodeCacheTest", "ShaderCodeCacheTest",
+                                                       HlmsMacroblock(), HlmsBlendblock(),
+                                                       HlmsParamVec() );
+    mRenderable = new HlmsShaderCodeCacheTestRenderable();
+    mRenderable->setDatablock( datablock );
+
+    mHlms->setShaderCodeCacheEnabled( true );
+}
+//--------------------------------------------------------------------------
+void HlmsShaderCodeCacheTests::tearDown()
+{
+    delete mRenderable;
+    mRenderable = 0;
+    mHlms = 0;
+
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mRenderSystem;
+    mRoot = 0;
+    mRenderSystem = 0;
+}
+//--------------------------------------------------------------------------
+void HlmsShaderCodeCacheTests::createShaders( uint32 finalHash )
+{
+    HlmsPso pso;
+    pso.initialize();
+    const HlmsCache passCache( 0, HLMS_USER0, pso );
+    mHlms->createShaderCacheEntry( mRenderable->getHlmsHash(), passCache, finalHash,
+                                   QueuedRenderable( 0, mRenderable, 0 ) );
+}
+//--------------------------------------------------------------------------
+void HlmsShaderCodeCacheTests::saveCache( std::vector<uint8> &outData )
+{
+    DataStreamPtr stream( OGRE_NEW MemoryDataStream( 1024u * 1024u ) );
+    mHlms->saveShaderCodeCache( stream );
+    const size_t numBytes = stream->tell();
+
+    const uint8 *data = static_cast<MemoryDataStream*>( stream.get() )->getPtr();
+    outData.assign( data, data + numBytes );
+}
+//--------------------------------------------------------------------------
+void HlmsShaderCodeCacheTests::loadCache( std::vector<uint8> &data, size_t numBytes )
+{
+    mHlms->setShaderCodeCacheEnabled( false );
+    DataStreamPtr stream( OGRE_NEW MemoryDataStream( numBytes ? &data[0] : 0, numBytes,
+                                                     false, true ) );
+    mHlms->loadShaderCodeCache( stream );
+}
+//--------------------------------------------------------------------------
+void HlmsShaderCodeCacheTests::testCacheHitsAfterReload()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    createShaders( 1u );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), mHlms->getNumTemplateParses() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), mHlms->getShaderCodeCacheHits() );
+
+    //Same properties again: served from the cache
+    createShaders( 2u );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), mHlms->getNumTemplateParses() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), mHlms->getShaderCodeCacheHits() );
+
+    std::vector<uint8> data;
+    saveCache( data );
+    loadCache( data, data.size() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), mHlms->getNumCodeCacheEntries() );
+
+    createShaders( 3u );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), mHlms->getNumTemplateParses() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), mHlms->getShaderCodeCacheHits() );
+}
+//--------------------------------------------------------------------------
+void HlmsShaderCodeCacheTests::testTruncatedCacheIsDiscarded()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    createShaders( 1u );
+
+    std::vector<uint8> data;
+    saveCache( data );
+
+    for( size_t i=0; i<data.size(); ++i )
+    {
+        loadCache( data, i );
+        CPPUNIT_ASSERT_EQUAL( size_t( 0 ), mHlms->getNumCodeCacheEntries() );
+    }
+
+    //Nothing got loaded, so the templates must be parsed again
+    createShaders( 2u );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), mHlms->getNumTemplateParses() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), mHlms->getShaderCodeCacheHits() );
+}
+//--------------------------------------------------------------------------
+void HlmsShaderCodeCacheTests::testCorruptCacheIsDiscarded()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    createShaders( 1u );
+
+    std::vector<uint8> data;
+    saveCache( data );
+
+    const uint32 hugeValue = 0x7FFFFFFF;
+
+    //Number of entries, right after the version, shader profile & templates' hash.
+    std::vector<uint8> corruptData( data );
+    const size_t numEntriesOffset = sizeof(uint32) * 2u + mHlms->getShaderProfile().size() +
+                                    sizeof(uint64) * 2u;
+    memcpy( &corruptData[numEntriesOffset], &hugeValue, sizeof(uint32) );
+    loadCache( corruptData, corruptData.size() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), mHlms->getNumCodeCacheEntries() );
+
+    //Length of the last shader stage's source, at the end of the stream.
+    corruptData = data;
+    memcpy( &corruptData[corruptData.size() - sizeof(uint32)], &hugeValue, sizeof(uint32) );
+    loadCache( corruptData, corruptData.size() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), mHlms->getNumCodeCacheEntries() );
+
+    //The untouched data still loads
+    loadCache( data, data.size() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), mHlms->getNumCodeCacheEntries() );
+}
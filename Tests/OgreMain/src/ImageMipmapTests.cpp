@@ -0,0 +1,262 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ImageMipmapTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreImage.h"
+#include "OgrePixelBox.h"
+#include "OgreNULLRenderSystem.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ImageMipmapTests);
+
+namespace
+{
+    /// Odd & even sizes, so that the SIMD paths have leftovers & the last row/column
+    /// (which only takes 1 sample) is hit.
+    const uint32 c_testSizes[][2] =
+    {
+        { 64, 64 }, { 37, 21 }, { 128, 9 }, { 3, 70 }, { 1, 16 }
+    };
+
+    //--------------------------------------------------------------------------
+    /** Scalar 2x2 box filter for 8-bit RGBA formats. Same math as the scalar loop of
+        the downscale2x_* functions in OgreImageDownsampler.cpp: the last row & column
+        only take one sample vertically/horizontally, and results are truncated.
+    */
+    void downscaleBoxReference( const uint8 *src, uint8 *dst, uint32 srcWidth,
+                                uint32 dstWidth, uint32 dstHeight,
+                                bool gammaCorrected, int alphaIdx )
+    {
+        for( uint32 y=0; y<dstHeight; ++y )
+        {
+            for( uint32 x=0; x<dstWidth; ++x )
+            {
+                const uint32 kEndY = std::min<uint32>( dstHeight - 1u - y, 1u );
+                const uint32 kEndX = std::min<uint32>( dstWidth - 1u - x, 1u );
+
+                uint32 accum[4] = { 0, 0, 0, 0 };
+                uint32 divisor = 0;
+
+                for( uint32 k_y=0; k_y<=kEndY; ++k_y )
+                {
+                    for( uint32 k_x=0; k_x<=kEndX; ++k_x )
+                    {
+                        const uint8 *srcPixel = src + ((y * 2u + k_y) * srcWidth +
+                                                       (x * 2u + k_x)) * 4u;
+                        for( int i=0; i<4; ++i )
+                        {
+                            const uint32 val = srcPixel[i];
+                            accum[i] += (gammaCorrected && i != alphaIdx) ? val * val : val;
+                        }
+                        ++divisor;
+                    }
+                }
+
+                const float invDivisor = 1.0f / divisor;
+                uint8 *dstPixel = dst + (y * dstWidth + x) * 4u;
+                for( int i=0; i<4; ++i )
+                {
+                    if( i == alphaIdx )
+                        dstPixel[i] = static_cast<uint8>( accum[i] / divisor );
+                    else if( gammaCorrected )
+                        dstPixel[i] = static_cast<uint8>( sqrtf( accum[i] * invDivisor ) );
+                    else
+                        dstPixel[i] = static_cast<uint8>( accum[i] * invDivisor );
+                }
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    /// Same as above, for PF_FLOAT32_RGBA.
+    void downscaleBoxReference( const float *src, float *dst, uint32 srcWidth,
+                                uint32 dstWidth, uint32 dstHeight )
+    {
+        for( uint32 y=0; y<dstHeight; ++y )
+        {
+            for( uint32 x=0; x<dstWidth; ++x )
+            {
+                const uint32 kEndY = std::min<uint32>( dstHeight - 1u - y, 1u );
+                const uint32 kEndX = std::min<uint32>( dstWidth - 1u - x, 1u );
+
+                float accum[4] = { 0, 0, 0, 0 };
+                uint32 divisor = 0;
+
+                for( uint32 k_y=0; k_y<=kEndY; ++k_y )
+                {
+                    for( uint32 k_x=0; k_x<=kEndX; ++k_x )
+                    {
+                        const float *srcPixel = src + ((y * 2u + k_y) * srcWidth +
+                                                       (x * 2u + k_x)) * 4u;
+                        for( int i=0; i<4; ++i )
+                            accum[i] += srcPixel[i];
+                        ++divisor;
+                    }
+                }
+
+                const float invDivisor = 1.0f / divisor;
+                float *dstPixel = dst + (y * dstWidth + x) * 4u;
+                for( int i=0; i<3; ++i )
+                    dstPixel[i] = accum[i] * invDivisor;
+                dstPixel[3] = accum[3] / divisor;
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------
+void ImageMipmapTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root( BLANKSTRING );
+    mRenderSystem = OGRE_NEW NULLRenderSystem();
+    mRoot->addRenderSystem( mRenderSystem );
+    mRoot->setRenderSystem( mRenderSystem );
+    mRoot->initialise( true );
+
+    mSceneMgr = mRoot->createSceneManager( ST_GENERIC, 4, INSTANCING_CULLING_SINGLETHREAD );
+}
+//--------------------------------------------------------------------------
+void ImageMipmapTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mRenderSystem;
+    mRoot = 0;
+    mRenderSystem = 0;
+}
+//--------------------------------------------------------------------------
+void ImageMipmapTests::createRandomImage( Image &image, uint32 width, uint32 height,
+                                          PixelFormat format, uint32 seed )
+{
+    const size_t bufSize = PixelUtil::getMemorySize( width, height, 1, format );
+    uint8 *data = OGRE_ALLOC_T( uint8, bufSize, MEMCATEGORY_GENERAL );
+
+    if( format == PF_FLOAT32_RGBA )
+    {
+        float *dataF32 = reinterpret_cast<float*>( data );
+        for( size_t i=0; i<bufSize / sizeof(float); ++i )
+        {
+            seed = seed * 1664525u + 1013904223u;
+            dataF32[i] = static_cast<float>( seed >> 8u ) / 4096.0f;
+        }
+    }
+    else
+    {
+        for( size_t i=0; i<bufSize; ++i )
+        {
+            seed = seed * 1664525u + 1013904223u;
+            data[i] = static_cast<uint8>( seed >> 24u );
+        }
+    }
+
+    image.loadDynamicImage( data, width, height, 1, format, true );
+}
+//--------------------------------------------------------------------------
+void ImageMipmapTests::checkBoxFilter( PixelFormat format, bool gammaCorrected, int alphaIdx )
+{
+    const size_t numSizes = sizeof( c_testSizes ) / sizeof( c_testSizes[0] );
+    for( size_t i=0; i<numSizes; ++i )
+    {
+        Image image;
+        createRandomImage( image, c_testSizes[i][0], c_testSizes[i][1], format,
+                           static_cast<uint32>( i ) );
+        CPPUNIT_ASSERT( image.generateMipmaps( gammaCorrected, Image::FILTER_BILINEAR ) );
+        CPPUNIT_ASSERT( image.getNumMipmaps() > 0 );
+
+        for( uint8 mip=1; mip<=image.getNumMipmaps(); ++mip )
+        {
+            const PixelBox srcBox = image.getPixelBox( 0, mip - 1u );
+            const PixelBox dstBox = image.getPixelBox( 0, mip );
+
+            vector<uint8>::type expected( dstBox.getConsecutiveSize() );
+            if( format == PF_FLOAT32_RGBA )
+            {
+                downscaleBoxReference( reinterpret_cast<const float*>( srcBox.data ),
+                                       reinterpret_cast<float*>( &expected[0] ),
+                                       srcBox.getWidth(),
+                                       dstBox.getWidth(), dstBox.getHeight() );
+            }
+            else
+            {
+                downscaleBoxReference( reinterpret_cast<const uint8*>( srcBox.data ),
+                                       &expected[0], srcBox.getWidth(),
+                                       dstBox.getWidth(), dstBox.getHeight(),
+                                       gammaCorrected, alphaIdx );
+            }
+
+            CPPUNIT_ASSERT( memcmp( &expected[0], dstBox.data, expected.size() ) == 0 );
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void ImageMipmapTests::testBoxFilterRGBA8()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+    checkBoxFilter( PF_R8G8B8A8, false, 3 );
+}
+//--------------------------------------------------------------------------
+void ImageMipmapTests::testBoxFilterRGBA8Gamma()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+    checkBoxFilter( PF_R8G8B8A8, true, 3 );
+}
+//--------------------------------------------------------------------------
+void ImageMipmapTests::testBoxFilterARGB8Gamma()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+    //Alpha is the first byte in memory on little endian
+    checkBoxFilter( PF_A8R8G8B8, true, OGRE_ENDIAN == OGRE_ENDIAN_BIG ? 3 : 0 );
+}
+//--------------------------------------------------------------------------
+void ImageMipmapTests::testBoxFilterFloat32RGBA()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+    checkBoxFilter( PF_FLOAT32_RGBA, false, 3 );
+}
+//--------------------------------------------------------------------------
+void ImageMipmapTests::testThreadedMatchesSerial()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    //Big enough for the first mips to be split in several bands
+    Image serial;
+    Image threaded;
+    createRandomImage( serial, 1024, 768, PF_R8G8B8A8, 1234u );
+    createRandomImage( threaded, 1024, 768, PF_R8G8B8A8, 1234u );
+
+    CPPUNIT_ASSERT( serial.generateMipmaps( true, Image::FILTER_BILINEAR ) );
+    CPPUNIT_ASSERT( threaded.generateMipmaps( true, Image::FILTER_BILINEAR, mSceneMgr ) );
+
+    CPPUNIT_ASSERT_EQUAL( serial.getSize(), threaded.getSize() );
+    CPPUNIT_ASSERT( memcmp( serial.getData(), threaded.getData(), serial.getSize() ) == 0 );
+}
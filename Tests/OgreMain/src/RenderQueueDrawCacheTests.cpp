@@ -0,0 +1,169 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "RenderQueueDrawCacheTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreLight.h"
+#include "OgreRenderQueue.h"
+#include "OgreRenderable.h"
+#include "OgreHlmsManager.h"
+#include "OgreHlms.h"
+#include "Vao/OgreVaoManager.h"
+#include "Vao/OgreVertexArrayObject.h"
+#include "OgreNULLRenderSystem.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(RenderQueueDrawCacheTests);
+
+/// Bare Renderable. The RenderQueue only needs its datablock, hash & Vao to queue it.
+class RenderQueueDrawCacheTestRenderable : public Renderable
+{
+public:
+    RenderQueueDrawCacheTestRenderable( HlmsDatablock *datablock, VertexArrayObject *vao )
+    {
+        //Not linked to the datablock; we don't want its Hlms to compute our hash.
+        mHlmsDatablock = datablock;
+        mHlmsHash = 0;
+        mHlmsCasterHash = 0;
+        mVaoPerLod[VpNormal].push_back( vao );
+        mVaoPerLod[VpShadow].push_back( vao );
+    }
+    virtual ~RenderQueueDrawCacheTestRenderable()
+    {
+        mHlmsDatablock = 0;
+    }
+
+    virtual void getRenderOperation( v1::RenderOperation& op, bool casterPass ) {}
+    virtual void getWorldTransforms( Matrix4* xform ) const {}
+    virtual const LightList& getLights(void) const  { return mLights; }
+
+private:
+    LightList mLights;
+};
+
+//--------------------------------------------------------------------------
+void RenderQueueDrawCacheTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root( BLANKSTRING );
+    mRenderSystem = OGRE_NEW NULLRenderSystem();
+    mRoot->addRenderSystem( mRenderSystem );
+    mRoot->setRenderSystem( mRenderSystem );
+    mRoot->initialise( true );
+
+    mSceneMgr = mRoot->createSceneManager( ST_GENERIC, 2, INSTANCING_CULLING_SINGLETHREAD );
+
+    mRenderQueue = OGRE_NEW RenderQueue( mRoot->getHlmsManager(), mSceneMgr,
+                                         mRenderSystem->getVaoManager() );
+
+    HlmsDatablock *datablock =
+            mRoot->getHlmsManager()->getHlms( HLMS_LOW_LEVEL )->getDefaultDatablock();
+    mVao = OGRE_NEW VertexArrayObject( 0, 0, 0, VertexBufferPackedVec(), 0, OT_TRIANGLE_LIST );
+
+    //Same hash for all of them, so that only the pointers tell them apart.
+    for( size_t i=0; i<NumRenderables; ++i )
+    {
+        mMovableObjects[i] = mSceneMgr->createLight();
+        mRenderables[i] = OGRE_NEW RenderQueueDrawCacheTestRenderable( datablock, mVao );
+    }
+
+    mRqId = mMovableObjects[0]->getRenderQueueGroup();
+    mRenderQueue->setRenderQueueMode( mRqId, RenderQueue::FAST );
+    mRenderQueue->setRenderQueueDrawCaching( mRqId, true );
+}
+//--------------------------------------------------------------------------
+void RenderQueueDrawCacheTests::tearDown()
+{
+    for( size_t i=0; i<NumRenderables; ++i )
+    {
+        OGRE_DELETE mRenderables[i];
+        mRenderables[i] = 0;
+    }
+
+    OGRE_DELETE mVao;
+    OGRE_DELETE mRenderQueue;
+    mVao = 0;
+    mRenderQueue = 0;
+
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mRenderSystem;
+    mRoot = 0;
+    mRenderSystem = 0;
+}
+//--------------------------------------------------------------------------
+bool RenderQueueDrawCacheTests::renderFrame( const size_t *threadIdx, size_t numRenderables )
+{
+    mRenderQueue->clear();
+
+    for( size_t i=0; i<numRenderables; ++i )
+    {
+        mRenderQueue->addRenderableV2( threadIdx[i], mRqId, false,
+                                       mRenderables[i], mMovableObjects[i] );
+    }
+
+    return mRenderQueue->_sortRenderQueue( mRqId );
+}
+//--------------------------------------------------------------------------
+void RenderQueueDrawCacheTests::testHitWhenThreadsSwapRenderables()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t split[NumRenderables]      = { 0, 0, 0, 1, 1, 1 };
+    const size_t swapped[NumRenderables]    = { 1, 1, 1, 0, 0, 0 };
+    const size_t interleaved[NumRenderables]= { 0, 1, 0, 1, 0, 1 };
+    const size_t allInOne[NumRenderables]   = { 1, 1, 1, 1, 1, 1 };
+
+    CPPUNIT_ASSERT( !renderFrame( split, NumRenderables ) );
+    CPPUNIT_ASSERT( renderFrame( split, NumRenderables ) );
+    CPPUNIT_ASSERT( renderFrame( swapped, NumRenderables ) );
+    CPPUNIT_ASSERT( renderFrame( interleaved, NumRenderables ) );
+    CPPUNIT_ASSERT( renderFrame( allInOne, NumRenderables ) );
+}
+//--------------------------------------------------------------------------
+void RenderQueueDrawCacheTests::testMissWhenRenderablesChange()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t split[NumRenderables] = { 0, 0, 0, 1, 1, 1 };
+
+    CPPUNIT_ASSERT( !renderFrame( split, NumRenderables ) );
+    CPPUNIT_ASSERT( renderFrame( split, NumRenderables ) );
+
+    //One less
+    CPPUNIT_ASSERT( !renderFrame( split, NumRenderables - 1u ) );
+    CPPUNIT_ASSERT( renderFrame( split, NumRenderables - 1u ) );
+
+    //Same amount, different MovableObject
+    std::swap( mMovableObjects[0], mMovableObjects[NumRenderables - 1u] );
+    CPPUNIT_ASSERT( !renderFrame( split, NumRenderables - 1u ) );
+}
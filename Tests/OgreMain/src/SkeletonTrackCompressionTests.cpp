@@ -0,0 +1,273 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SkeletonTrackCompressionTests.h"
+#include "OgreMath.h"
+#include "Animation/OgreSkeletonAnimationDef.h"
+#include "Math/Array/OgreMathlib.h"
+#include "Math/Array/OgreBoneTransform.h"
+#include "Math/Array/OgreKfTransform.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(SkeletonTrackCompressionTests);
+
+static const size_t c_numKeyFrames = 8;
+/// Slack for floating point differences between the compressed and
+/// uncompressed paths of applyKeyFrameRigAt; not a compression error.
+static const Real c_interpolationEpsilon = 1e-6f;
+
+namespace
+{
+    /// Creates its track directly instead of importing it from a v1::Skeleton.
+    class SkeletonTrackTestAnimationDef : public SkeletonAnimationDef
+    {
+    public:
+        void createTrack( SkeletonTrackCompressionTests::KeyFrameGenerator generator )
+        {
+            //One keyframe per frame
+            TimestampsPerBlock timestampsByBlock;
+            TimestampVec &timestamps = timestampsByBlock[0];
+            for( size_t i=0; i<c_numKeyFrames; ++i )
+                timestamps.push_back( static_cast<Real>( i ) );
+
+            allocateCacheFriendlyKeyframes( timestampsByBlock, 1.0f );
+            mNumFrames = static_cast<Real>( c_numKeyFrames - 1u );
+
+            SkeletonTrack &track = mTracks.back();
+            KeyFrameRigVec &keyFrames = track._getKeyFrames();
+            for( size_t i=0; i<keyFrames.size(); ++i )
+            {
+                KfTransform *kfTransform = keyFrames[i].mBoneTransform;
+                for( size_t j=0; j<ARRAY_PACKED_REALS; ++j )
+                {
+                    Vector3 vPos, vScale;
+                    Quaternion qRot;
+                    generator( i, j, vPos, qRot, vScale );
+                    kfTransform->mPosition.setFromVector3( vPos, j );
+                    kfTransform->mOrientation.setFromQuaternion( qRot, j );
+                    kfTransform->mScale.setFromVector3( vScale, j );
+                }
+            }
+
+            track._setMaxUsedSlot( ARRAY_PACKED_REALS - 1u );
+        }
+
+        const SkeletonTrack& getTrack(void) const   { return mTracks.back(); }
+    };
+}
+
+//--------------------------------------------------------------------------
+/// Rotates slowly around a per slot axis. The largest component is w, x, y or z
+/// depending on the slot, and the sign flips every keyframe, so that the smallest
+/// three encoding has to drop each component with either sign.
+static Quaternion smoothRotation( size_t keyFrame, size_t slot )
+{
+    static const Quaternion c_bases[4] =
+    {
+        Quaternion( 1, 0, 0, 0 ), Quaternion( 0, 1, 0, 0 ),
+        Quaternion( 0, 0, 1, 0 ), Quaternion( 0, 0, 0, 1 )
+    };
+
+    Vector3 axis( 1.0f, 2.0f + slot, -1.0f );
+    axis.normalise();
+
+    Quaternion retVal = c_bases[slot % 4u] * Quaternion( Radian( keyFrame * 0.1f ), axis );
+    if( (keyFrame + slot) & 0x01 )
+        retVal = -retVal;
+    return retVal;
+}
+//--------------------------------------------------------------------------
+static void varyingKeyFrame( size_t keyFrame, size_t slot, Vector3 &outPos,
+                             Quaternion &outRot, Vector3 &outScale )
+{
+    const Real t = keyFrame + slot * 0.37f;
+    outPos   = Vector3( 10.0f * Math::Sin( t ), 0.5f * t - 3.0f, 2.0f * Math::Cos( t * 0.5f ) );
+    outRot   = smoothRotation( keyFrame, slot );
+    //y never changes, so its quantization step is zero
+    outScale = Vector3( 1.0f + 0.5f * Math::Sin( t ), 1.0f, 0.75f + 0.25f * Math::Cos( t ) );
+}
+//--------------------------------------------------------------------------
+static void constantKeyFrame( size_t keyFrame, size_t slot, Vector3 &outPos,
+                              Quaternion &outRot, Vector3 &outScale )
+{
+    //Jitter well below the default error budget
+    const Real jitter = (keyFrame & 0x01) ? 1e-5f : -1e-5f;
+    outPos   = Vector3( slot * 1.5f, -2.0f, 0.25f ) + jitter;
+    outRot   = Quaternion( Radian( 0.3f + slot * 0.5f ), Vector3::UNIT_Y );
+    outScale = Vector3( 1.0f + slot * 0.1f ) + jitter;
+}
+//--------------------------------------------------------------------------
+static void assertVector3Equal( const Vector3 &expected, const Vector3 &actual, Real tolerance )
+{
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.x, actual.x, tolerance );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.y, actual.y, tolerance );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.z, actual.z, tolerance );
+}
+//--------------------------------------------------------------------------
+static void assertQuaternionEqual( const Quaternion &expected, Quaternion actual, Real tolerance )
+{
+    //q and -q are the same rotation
+    if( expected.Dot( actual ) < 0 )
+        actual = -actual;
+
+    for( size_t i=0; i<4; ++i )
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected[i], actual[i], tolerance );
+}
+//--------------------------------------------------------------------------
+void SkeletonTrackCompressionTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void SkeletonTrackCompressionTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void SkeletonTrackCompressionTests::checkCompression( KeyFrameGenerator generator,
+                                                      const KfCompressionSettings &settings,
+                                                      SkeletonTrack::KfChannelEncoding expectedPosEncoding,
+                                                      SkeletonTrack::KfChannelEncoding expectedRotEncoding,
+                                                      SkeletonTrack::KfChannelEncoding expectedScaleEncoding )
+{
+    SkeletonTrackTestAnimationDef uncompressed;
+    SkeletonTrackTestAnimationDef compressed;
+    uncompressed.createTrack( generator );
+    compressed.createTrack( generator );
+    compressed.compressKeyFrames( settings );
+
+    const SkeletonTrack &refTrack   = uncompressed.getTrack();
+    const SkeletonTrack &track      = compressed.getTrack();
+
+    CPPUNIT_ASSERT( !refTrack.isCompressed() );
+    CPPUNIT_ASSERT( track.isCompressed() );
+    CPPUNIT_ASSERT_EQUAL( expectedPosEncoding, track.getPositionEncoding() );
+    CPPUNIT_ASSERT_EQUAL( expectedRotEncoding, track.getRotationEncoding() );
+    CPPUNIT_ASSERT_EQUAL( expectedScaleEncoding, track.getScaleEncoding() );
+
+    //The keyframes themselves
+    for( size_t i=0; i<c_numKeyFrames; ++i )
+    {
+        for( uint32 j=0; j<ARRAY_PACKED_REALS; ++j )
+        {
+            Vector3 refPos, refScale, vPos, vScale;
+            Quaternion refRot, qRot;
+            refTrack.getKeyFrameTransform( i, j, refPos, refRot, refScale );
+            track.getKeyFrameTransform( i, j, vPos, qRot, vScale );
+
+            assertVector3Equal( refPos, vPos, settings.maxPositionError );
+            assertQuaternionEqual( refRot, qRot, settings.maxRotationError );
+            assertVector3Equal( refScale, vScale, settings.maxScaleError );
+        }
+    }
+
+    //Interpolated between keyframes, the way SkeletonAnimation applies them
+    ArrayVector3 refPos, refScale, vPos, vScale;
+    ArrayQuaternion refRot, qRot;
+
+    TransformArray refTransforms( 1, BoneTransform() );
+    refTransforms[0].mPosition      = &refPos;
+    refTransforms[0].mOrientation   = &refRot;
+    refTransforms[0].mScale         = &refScale;
+
+    TransformArray transforms( 1, BoneTransform() );
+    transforms[0].mPosition     = &vPos;
+    transforms[0].mOrientation  = &qRot;
+    transforms[0].mScale        = &vScale;
+
+    const ArrayReal perBoneWeight = Mathlib::ONE;
+    KeyFrameRigVec::const_iterator refLastKnownKeyFrame = refTrack.getKeyFrames().begin();
+    KeyFrameRigVec::const_iterator lastKnownKeyFrame    = track.getKeyFrames().begin();
+
+    for( size_t i=0; i<=(c_numKeyFrames - 1u) * 4u; ++i )
+    {
+        const float frame = i * 0.25f;
+
+        refPos      = ArrayVector3::ZERO;
+        refRot      = ArrayQuaternion::IDENTITY;
+        refScale    = ArrayVector3::UNIT_SCALE;
+        vPos        = ArrayVector3::ZERO;
+        qRot        = ArrayQuaternion::IDENTITY;
+        vScale      = ArrayVector3::UNIT_SCALE;
+
+        refTrack.applyKeyFrameRigAt( refLastKnownKeyFrame, frame, Mathlib::ONE,
+                                     &perBoneWeight, refTransforms );
+        track.applyKeyFrameRigAt( lastKnownKeyFrame, frame, Mathlib::ONE,
+                                  &perBoneWeight, transforms );
+
+        for( size_t j=0; j<ARRAY_PACKED_REALS; ++j )
+        {
+            Vector3 refPosJ, refScaleJ, vPosJ, vScaleJ;
+            Quaternion refRotJ, qRotJ;
+            refPos.getAsVector3( refPosJ, j );
+            refRot.getAsQuaternion( refRotJ, j );
+            refScale.getAsVector3( refScaleJ, j );
+            vPos.getAsVector3( vPosJ, j );
+            qRot.getAsQuaternion( qRotJ, j );
+            vScale.getAsVector3( vScaleJ, j );
+
+            assertVector3Equal( refPosJ, vPosJ, settings.maxPositionError + c_interpolationEpsilon );
+            assertQuaternionEqual( refRotJ, qRotJ,
+                                   settings.maxRotationError + c_interpolationEpsilon );
+            assertVector3Equal( refScaleJ, vScaleJ, settings.maxScaleError + c_interpolationEpsilon );
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void SkeletonTrackCompressionTests::testRawEncoding()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    //Nothing can be compressed without any error
+    KfCompressionSettings settings;
+    settings.maxPositionError   = 0;
+    settings.maxRotationError   = 0;
+    settings.maxScaleError      = 0;
+
+    checkCompression( varyingKeyFrame, settings, SkeletonTrack::KfRaw,
+                      SkeletonTrack::KfRaw, SkeletonTrack::KfRaw );
+}
+//--------------------------------------------------------------------------
+void SkeletonTrackCompressionTests::testQuantizedEncoding()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    //Vectors to 16 bits, rotations to the smallest three
+    checkCompression( varyingKeyFrame, KfCompressionSettings(), SkeletonTrack::KfQuantized,
+                      SkeletonTrack::KfQuantized, SkeletonTrack::KfQuantized );
+}
+//--------------------------------------------------------------------------
+void SkeletonTrackCompressionTests::testConstantEncoding()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    checkCompression( constantKeyFrame, KfCompressionSettings(), SkeletonTrack::KfConstant,
+                      SkeletonTrack::KfConstant, SkeletonTrack::KfConstant );
+}
@@ -0,0 +1,153 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "SoftwareOcclusionCullerTests.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreCamera.h"
+#include "OgreLight.h"
+#include "OgreSoftwareOcclusionCuller.h"
+#include "OgreNULLRenderSystem.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(SoftwareOcclusionCullerTests);
+
+//--------------------------------------------------------------------------
+void SoftwareOcclusionCullerTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+
+    mRoot = OGRE_NEW Root( BLANKSTRING );
+    mRenderSystem = OGRE_NEW NULLRenderSystem();
+    mRoot->addRenderSystem( mRenderSystem );
+    mRoot->setRenderSystem( mRenderSystem );
+    mRoot->initialise( true );
+
+    mSceneMgr = mRoot->createSceneManager( ST_GENERIC, 1, INSTANCING_CULLING_SINGLETHREAD );
+    mSceneMgr->setSoftwareOcclusionCulling( true, 64, 64 );
+    mCuller = mSceneMgr->getSoftwareOcclusionCuller();
+
+    //One world unit per pixel. Pixel (0, 0) is at the top left corner of
+    //the screen, and pixel (32, 32) at the center.
+    mCamera = mSceneMgr->createCamera( "OcclusionCullerTests" );
+    mCamera->setProjectionType( PT_ORTHOGRAPHIC );
+    mCamera->setOrthoWindow( 64.0f, 64.0f );
+    mCamera->setNearClipDistance( 1.0f );
+    mCamera->setFarClipDistance( 100.0f );
+    mCamera->setPosition( Vector3::ZERO );
+    mCamera->setOrientation( Quaternion::IDENTITY );
+
+    //Any attached MovableObject can own occluder geometry
+    mOccluderObject = mSceneMgr->createLight();
+    SceneNode *sceneNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    sceneNode->attachObject( mOccluderObject );
+    sceneNode->_getFullTransformUpdated();
+}
+//--------------------------------------------------------------------------
+void SoftwareOcclusionCullerTests::tearDown()
+{
+    OGRE_DELETE mRoot;
+    OGRE_DELETE mRenderSystem;
+    mRoot = 0;
+    mRenderSystem = 0;
+}
+//--------------------------------------------------------------------------
+void SoftwareOcclusionCullerTests::setWall( Real rightEdge, Real leftDistance, Real rightDistance )
+{
+    const Vector3 vertices[4] =
+    {
+        Vector3( -32.0f,            -32.0f, -leftDistance ),
+        Vector3( rightEdge - 32.0f, -32.0f, -rightDistance ),
+        Vector3( rightEdge - 32.0f,  32.0f, -rightDistance ),
+        Vector3( -32.0f,             32.0f, -leftDistance )
+    };
+    const uint32 indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+    mCuller->removeAllOccluders();
+    mCuller->addOccluder( mOccluderObject, vertices, 4, indices, 6 );
+
+    CPPUNIT_ASSERT( mCuller->_prepare( mCamera ) );
+    for( size_t i=0; i<mCuller->_getNumTiles(); ++i )
+        mCuller->_rasterizeTile( i );
+}
+//--------------------------------------------------------------------------
+bool SoftwareOcclusionCullerTests::isOccluded( Real startX, Real endX,
+                                               Real nearDistance, Real farDistance )
+{
+    //The wall's diagonal crosses rows [16; 48) between pixels 8 and 25, so boxes
+    //that start after pixel 26 don't touch it (pixels along the diagonal aren't
+    //fully covered by either triangle, hence never occlude).
+    const Vector3 center( (startX + endX) * 0.5f - 32.0f, 0.0f,
+                          -(nearDistance + farDistance) * 0.5f );
+    const Vector3 halfSize( (endX - startX) * 0.5f, 16.0f, (farDistance - nearDistance) * 0.5f );
+    return mCuller->isOccluded( Aabb( center, halfSize ) );
+}
+//--------------------------------------------------------------------------
+void SoftwareOcclusionCullerTests::testOccludedBehindWall()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    setWall( 32.6f, 10.0f, 10.0f );
+    CPPUNIT_ASSERT( isOccluded( 26.0f, 32.0f, 20.0f, 30.0f ) );
+    CPPUNIT_ASSERT( isOccluded( 26.0f, 32.0f, 10.5f, 11.0f ) );
+}
+//--------------------------------------------------------------------------
+void SoftwareOcclusionCullerTests::testVisibleInFrontOfWall()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    setWall( 32.6f, 10.0f, 10.0f );
+    CPPUNIT_ASSERT( !isOccluded( 26.0f, 32.0f, 5.0f, 8.0f ) );
+    //Crosses the wall
+    CPPUNIT_ASSERT( !isOccluded( 26.0f, 32.0f, 9.5f, 30.0f ) );
+}
+//--------------------------------------------------------------------------
+void SoftwareOcclusionCullerTests::testPartiallyCoveredPixel()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    //The wall covers 60% of column 32, including its center. The box pokes out of
+    //the wall in that column, so it must not be culled.
+    setWall( 32.6f, 10.0f, 10.0f );
+    CPPUNIT_ASSERT( !isOccluded( 26.0f, 32.9f, 20.0f, 30.0f ) );
+    CPPUNIT_ASSERT( !isOccluded( 26.0f, 32.4f, 20.0f, 30.0f ) );
+}
+//--------------------------------------------------------------------------
+void SoftwareOcclusionCullerTests::testFarthestDepthInPixel()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    //In column 31 the wall is 11.9325 units away at the pixel's center, but
+    //11.9632 at its right border. A box 11.95 units away peeks in front of it.
+    setWall( 32.6f, 10.0f, 12.0f );
+    CPPUNIT_ASSERT( !isOccluded( 30.0f, 32.0f, 11.95f, 30.0f ) );
+    CPPUNIT_ASSERT( isOccluded( 30.0f, 32.0f, 12.5f, 30.0f ) );
+}